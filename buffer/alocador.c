@@ -0,0 +1,338 @@
+/**
+ * Arquivo: alocador.c
+ * Versão : 1.0
+ * Data   : 2026-10-19 01:50
+ * -------------------------
+ * Este arquivo implementa a interface alocador.h. A arena e a reserva da
+ * thread são a mesma estrutura, uma "reserva": uma lista de pedaços de
+ * TAMPEDACO bytes, dos quais os blocos pequenos são cortados em sequência, e
+ * uma lista de blocos livres para cada tamanho (em grãos). Um bloco devolvido
+ * vai para a lista do seu tamanho e é o primeiro a ser reutilizado; os
+ * pedaços só voltam ao sistema quando a reserva inteira é liberada. Os blocos
+ * grandes são obtidos com malloc, precedidos por um cabeçalho que os mantém em
+ * uma lista duplamente encadeada, para que possam ser devolvidos um a um ou
+ * liberados junto com a reserva.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#include "alocador.h"
+#include "genlib.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: GRAO, CLASSES, TAMPEDACO
+ * ------------------------------------
+ * O tamanho de um grão (o alinhamento máximo da plataforma), a quantidade de
+ * listas de blocos livres (uma para cada tamanho, de 1 a CLASSES grãos) e o
+ * tamanho dos pedaços dos quais os blocos pequenos são cortados.
+ */
+
+#define GRAO _Alignof(max_align_t)
+#define CLASSES 16
+#define TAMPEDACO 65536
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: pedacoT
+ * -------------
+ * Um pedaço de memória obtido com malloc: um pedaço do qual os blocos
+ * pequenos são cortados (ligado aos outros por "anterior") ou um bloco grande
+ * (ligado aos outros blocos grandes por "anterior" e "proximo"). Os dados
+ * começam alinhados como os de malloc.
+ */
+
+typedef struct pedacoTCD
+{
+    struct pedacoTCD *anterior;
+    struct pedacoTCD *proximo;
+    max_align_t dados[];
+} pedacoT;
+
+/**
+ * Tipo: livreT
+ * ------------
+ * Um bloco pequeno devolvido, na lista de blocos livres do seu tamanho.
+ */
+
+typedef struct livreTCD
+{
+    struct livreTCD *proximo;
+} livreT;
+
+/**
+ * Tipo: reservaT
+ * --------------
+ * A memória de uma arena ou da reserva de uma thread:
+ *
+ *     pedacos    o último pedaço obtido (os demais ligados por "anterior")
+ *     grandes    o primeiro bloco grande em uso
+ *     livre      início da parte ainda não cortada do último pedaço
+ *     restante   tamanho, em bytes, dessa parte
+ *     listas     os blocos livres com 1, 2, ..., CLASSES grãos
+ */
+
+typedef struct
+{
+    pedacoT *pedacos;
+    pedacoT *grandes;
+    char *livre;
+    size_t restante;
+    livreT *listas[CLASSES];
+} reservaT;
+
+/*** Variáveis Globais ***/
+
+/**
+ * Variável: reserva_da_thread
+ * ---------------------------
+ * A reserva usada por alocador_da_thread; cada thread tem a sua.
+ */
+
+static _Thread_local reservaT reserva_da_thread;
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void *reservar_malloc (void *contexto, size_t n);
+static void devolver_malloc (void *contexto, void *bloco, size_t n);
+static void *reservar_da_reserva (void *contexto, size_t n);
+static void devolver_a_reserva (void *contexto, void *bloco, size_t n);
+static void liberar_arena (void *contexto);
+static void esvaziar_reserva (reservaT *reserva);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: alocador_padrao
+ * Uso: alocador = alocador_padrao( );
+ * -----------------------------------
+ * O alocador padrão não tem contexto.
+ */
+
+alocadorT alocador_padrao (void)
+{
+    alocadorT alocador = {reservar_malloc, devolver_malloc, NULL, NULL};
+    return alocador;
+}
+
+/**
+ * Predicado: criar_arena
+ * Uso: if (criar_arena(&alocador)) . . .
+ * --------------------------------------
+ * A reserva da arena começa vazia; o primeiro pedaço só é obtido na primeira
+ * reserva de um bloco pequeno.
+ */
+
+bool criar_arena (alocadorT *alocador)
+{
+    if (alocador == NULL)
+    {
+        fprintf(stderr, "Erro: arena sem alocador.\n");
+        return FALSE;
+    }
+
+    reservaT *reserva = calloc(1, sizeof(reservaT));
+    if (reserva == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar arena.\n");
+        return FALSE;
+    }
+
+    alocador->reservar = reservar_da_reserva;
+    alocador->devolver = devolver_a_reserva;
+    alocador->liberar_tudo = liberar_arena;
+    alocador->contexto = reserva;
+    return TRUE;
+}
+
+/**
+ * Função: alocador_da_thread
+ * Uso: alocador = alocador_da_thread( );
+ * --------------------------------------
+ * O contexto é o endereço da reserva da thread que chamou a função.
+ */
+
+alocadorT alocador_da_thread (void)
+{
+    alocadorT alocador = {reservar_da_reserva, devolver_a_reserva, NULL,
+                          &reserva_da_thread};
+    return alocador;
+}
+
+/**
+ * Procedimento: esvaziar_reserva_da_thread
+ * Uso: esvaziar_reserva_da_thread( );
+ * -----------------------------------
+ * Libera os pedaços e os blocos grandes e deixa a reserva vazia, pronta para
+ * ser usada de novo.
+ */
+
+void esvaziar_reserva_da_thread (void)
+{
+    esvaziar_reserva(&reserva_da_thread);
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Funções: reservar_malloc, devolver_malloc
+ * Uso: bloco = reservar_malloc(NULL, n);
+ *      devolver_malloc(NULL, bloco, n);
+ * -----------------------------------------
+ * As funções do alocador padrão.
+ */
+
+static void *reservar_malloc (void *contexto, size_t n)
+{
+    (void) contexto;
+    return malloc(n > 0 ? n : 1);
+}
+
+static void devolver_malloc (void *contexto, void *bloco, size_t n)
+{
+    (void) contexto;
+    (void) n;
+    free(bloco);
+}
+
+/**
+ * Função: reservar_da_reserva
+ * Uso: bloco = reservar_da_reserva(reserva, n);
+ * ---------------------------------------------
+ * Um bloco pequeno sai da lista do seu tamanho ou, se ela estiver vazia, é
+ * cortado do último pedaço (obtendo um pedaço novo se não couber; o final do
+ * pedaço anterior é desperdiçado). Um bloco grande é obtido com malloc e
+ * colocado na lista dos blocos grandes.
+ */
+
+static void *reservar_da_reserva (void *contexto, size_t n)
+{
+    reservaT *reserva = contexto;
+    size_t graos = (n > 0) ? (n + GRAO - 1) / GRAO : 1;
+
+    if (graos > CLASSES)
+    {
+        if (graos > (SIZE_MAX - sizeof(pedacoT)) / GRAO)
+            return NULL;
+        pedacoT *grande = malloc(sizeof(pedacoT) + graos * GRAO);
+        if (grande == NULL)
+            return NULL;
+        grande->anterior = NULL;
+        grande->proximo = reserva->grandes;
+        if (reserva->grandes != NULL)
+            reserva->grandes->anterior = grande;
+        reserva->grandes = grande;
+        return grande->dados;
+    }
+
+    livreT *bloco = reserva->listas[graos - 1];
+    if (bloco != NULL)
+    {
+        reserva->listas[graos - 1] = bloco->proximo;
+        return bloco;
+    }
+
+    size_t tamanho = graos * GRAO;
+    if (reserva->restante < tamanho)
+    {
+        pedacoT *pedaco = malloc(sizeof(pedacoT) + TAMPEDACO);
+        if (pedaco == NULL)
+            return NULL;
+        pedaco->anterior = reserva->pedacos;
+        pedaco->proximo = NULL;
+        reserva->pedacos = pedaco;
+        reserva->livre = (char *) pedaco->dados;
+        reserva->restante = TAMPEDACO;
+    }
+
+    void *novo = reserva->livre;
+    reserva->livre += tamanho;
+    reserva->restante -= tamanho;
+    return novo;
+}
+
+/**
+ * Procedimento: devolver_a_reserva
+ * Uso: devolver_a_reserva(reserva, bloco, n);
+ * -------------------------------------------
+ * Um bloco pequeno vai para o início da lista do seu tamanho; um bloco grande
+ * é retirado da lista dos blocos grandes e liberado.
+ */
+
+static void devolver_a_reserva (void *contexto, void *bloco, size_t n)
+{
+    reservaT *reserva = contexto;
+    size_t graos = (n > 0) ? (n + GRAO - 1) / GRAO : 1;
+
+    if (graos > CLASSES)
+    {
+        pedacoT *grande = (pedacoT *) ((char *) bloco -
+                                       offsetof(pedacoT, dados));
+        if (grande->anterior != NULL)
+            grande->anterior->proximo = grande->proximo;
+        else
+            reserva->grandes = grande->proximo;
+        if (grande->proximo != NULL)
+            grande->proximo->anterior = grande->anterior;
+        free(grande);
+        return;
+    }
+
+    livreT *livre = bloco;
+    livre->proximo = reserva->listas[graos - 1];
+    reserva->listas[graos - 1] = livre;
+}
+
+/**
+ * Procedimento: liberar_arena
+ * Uso: liberar_arena(reserva);
+ * ----------------------------
+ * A função "liberar_tudo" da arena: esvazia a reserva e libera a própria
+ * reserva.
+ */
+
+static void liberar_arena (void *contexto)
+{
+    esvaziar_reserva(contexto);
+    free(contexto);
+}
+
+/**
+ * Procedimento: esvaziar_reserva
+ * Uso: esvaziar_reserva(reserva);
+ * -------------------------------
+ * Libera todos os pedaços e blocos grandes da reserva e a deixa vazia.
+ */
+
+static void esvaziar_reserva (reservaT *reserva)
+{
+    pedacoT *p, *seguinte;
+
+    for (p = reserva->pedacos; p != NULL; p = seguinte)
+    {
+        seguinte = p->anterior;
+        free(p);
+    }
+    for (p = reserva->grandes; p != NULL; p = seguinte)
+    {
+        seguinte = p->proximo;
+        free(p);
+    }
+    memset(reserva, 0, sizeof(reservaT));
+}
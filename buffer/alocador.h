@@ -0,0 +1,161 @@
+/**
+ * Arquivo: alocador.h
+ * Versão : 1.0
+ * Data   : 2026-10-19 01:50
+ * -------------------------
+ * Este arquivo define uma interface para os alocadores de memória usados pelas
+ * implementações de buffer.h. Um buffer criado com criar_buffer_com_alocador
+ * obtém e devolve a sua memória (a estrutura do buffer e, em lsebuff.c, cada
+ * célula da lista) pelo alocador informado, em vez de chamar malloc e free.
+ *
+ * Um alocador é apenas um par de funções, "reservar" e "devolver", mais um
+ * contexto passado a elas. Há três alocadores prontos:
+ *
+ *     alocador_padrao      malloc e free, como nos buffers criados com
+ *                          criar_buffer;
+ *
+ *     criar_arena          uma arena para um único buffer: a memória é tirada
+ *                          de pedaços grandes, e os blocos devolvidos ficam em
+ *                          listas por tamanho para serem reutilizados. A arena
+ *                          pertence ao buffer, e liberar_buffer libera os
+ *                          pedaços de uma só vez, sem visitar cada célula;
+ *
+ *     alocador_da_thread   o mesmo esquema, mas com uma reserva por thread,
+ *                          compartilhada por todos os buffers criados e
+ *                          liberados naquela thread (por exemplo, os buffers
+ *                          de curta duração de um servidor que atende uma
+ *                          requisição por vez em cada thread). Não há travas:
+ *                          um buffer deve ser liberado pela mesma thread que
+ *                          o criou.
+ *
+ * Os alocadores por tamanho dividem a memória em grãos do alinhamento máximo
+ * da plataforma (16 bytes, em geral); blocos de até CLASSES grãos são
+ * servidos pelas listas, e blocos maiores vão direto para malloc.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _ALOCADOR_H
+#define _ALOCADOR_H
+
+/*** Includes ***/
+
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: alocadorT
+ * ---------------
+ * Um alocador de memória:
+ *
+ *     reservar       retorna um bloco de "n" bytes, alinhado para qualquer
+ *                    tipo, ou NULL se não houver memória
+ *     devolver       devolve um bloco obtido de "reservar" com o mesmo "n"
+ *     liberar_tudo   se não for NULL, o alocador pertence ao buffer que o
+ *                    recebeu, e esta função libera de uma só vez toda a
+ *                    memória dele (inclusive o próprio contexto); o buffer
+ *                    então não precisa devolver os blocos um a um
+ *     contexto       passado como primeiro argumento às três funções
+ */
+
+typedef struct
+{
+    void *(*reservar) (void *contexto, size_t n);
+    void (*devolver) (void *contexto, void *bloco, size_t n);
+    void (*liberar_tudo) (void *contexto);
+    void *contexto;
+} alocadorT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: alocador_padrao
+ * Uso: alocador = alocador_padrao( );
+ * -----------------------------------
+ * Retorna o alocador que usa malloc e free.
+ */
+
+alocadorT alocador_padrao (void);
+
+/**
+ * PREDICADO: criar_arena
+ * Uso: if (criar_arena(&alocador)) . . .
+ * --------------------------------------
+ * Cria uma arena nova e guarda em "alocador" o alocador que a usa. A arena
+ * deve ser entregue a um único buffer (com criar_buffer_com_alocador), que
+ * passa a ser o seu dono. Retorna FALSE se não houver memória.
+ */
+
+bool criar_arena (alocadorT *alocador);
+
+/**
+ * FUNÇÃO: alocador_da_thread
+ * Uso: alocador = alocador_da_thread( );
+ * --------------------------------------
+ * Retorna o alocador que usa a reserva da thread que o chamou. O mesmo
+ * alocador pode ser entregue a vários buffers daquela thread.
+ */
+
+alocadorT alocador_da_thread (void);
+
+/**
+ * PROCEDIMENTO: esvaziar_reserva_da_thread
+ * Uso: esvaziar_reserva_da_thread( );
+ * -----------------------------------
+ * Devolve ao sistema toda a memória da reserva da thread que o chamou. Só
+ * pode ser chamado quando todos os buffers da thread criados com
+ * alocador_da_thread já foram liberados (por exemplo, antes de a thread
+ * terminar).
+ */
+
+void esvaziar_reserva_da_thread (void);
+
+/**
+ * FUNÇÕES: alocar, desalocar
+ * Uso: bloco = alocar(&alocador, n);
+ *      desalocar(&alocador, bloco, n);
+ * ---------------------------------------
+ * Chamam as funções "reservar" e "devolver" do alocador. "desalocar" não faz
+ * nada se o bloco for NULL.
+ */
+
+static inline void *alocar (const alocadorT *alocador, size_t n)
+{
+    return alocador->reservar(alocador->contexto, n);
+}
+
+static inline void desalocar (const alocadorT *alocador, void *bloco,
+                              size_t n)
+{
+    if (bloco != NULL)
+        alocador->devolver(alocador->contexto, bloco, n);
+}
+
+/**
+ * PROCEDIMENTO: liberar_alocador
+ * Uso: liberar_alocador(&alocador);
+ * ---------------------------------
+ * Se o alocador tiver "liberar_tudo" (uma arena), libera toda a sua memória;
+ * senão, não faz nada. Chamado pelo buffer dono do alocador, por último.
+ */
+
+static inline void liberar_alocador (const alocadorT *alocador)
+{
+    if (alocador->liberar_tudo != NULL)
+        alocador->liberar_tudo(alocador->contexto);
+}
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -0,0 +1,637 @@
+/**
+ * Arquivo: aplicador.c
+ * Versão : 1.0
+ * Data   : 2026-10-18 21:50
+ * -------------------------
+ * Este arquivo implementa a interface aplicador.h. A fila é um array circular
+ * de entradas, e cada entrada tem um número atômico que diz de quem ela é: a
+ * entrada de índice i está livre para a reserva "r" (com r % capacidade == i)
+ * quando o número vale r, e está preenchida pela reserva "r" quando vale
+ * r + 1. Uma produtora pega a próxima reserva com atomic_fetch_add, espera a
+ * entrada ficar livre (só acontece com a fila cheia), copia a edição e
+ * escreve r + 1; a aplicadora lê as entradas na ordem das reservas e, depois
+ * de copiar cada uma, escreve r + capacidade, liberando a entrada para a
+ * próxima volta. As travas só são usadas para dormir: pela aplicadora, quando
+ * a fila está vazia, e pelas threads que esperam uma edição ser aplicada.
+ *
+ * Textos de até CURTO caracteres são copiados dentro da própria entrada; os
+ * maiores são copiados para um array alocado pela produtora e liberado pela
+ * aplicadora.
+ *
+ * A aplicadora mantém uma edição "pendente", que ainda não foi feita no
+ * buffer, e tenta juntar a ela cada edição lida: uma inserção dentro (ou nas
+ * pontas) do texto pendente é encaixada nele, uma remoção de parte do texto
+ * pendente o encurta, e uma remoção que encosta em uma remoção pendente a
+ * aumenta. Quando não é possível juntar, a pendente é feita no buffer e a
+ * edição lida passa a ser a pendente. Como a aplicadora acompanha o tamanho
+ * que o buffer terá, as posições além do final são ajustadas antes de juntar,
+ * e o resultado é sempre o mesmo de aplicar as edições uma a uma.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "aplicador.h"
+#include "buffer.h"
+#include "genlib.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTE: CURTO
+ * ----------------
+ * Maior texto copiado dentro da própria entrada da fila, sem alocação.
+ */
+
+#define CURTO 48
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: entradaT
+ * --------------
+ * Uma posição da fila:
+ *
+ *     sequencia   de quem é a entrada (veja o comentário do arquivo)
+ *     remocao     TRUE para uma remoção, FALSE para uma inserção
+ *     posicao, n  posição da edição e quantidade de caracteres
+ *     texto       texto da inserção, se for maior do que CURTO
+ *     curto       texto da inserção, se couber na entrada
+ */
+
+typedef struct
+{
+    atomic_ullong sequencia;
+    bool remocao;
+    size_t posicao;
+    size_t n;
+    char *texto;
+    char curto[CURTO];
+} entradaT;
+
+/**
+ * Tipo: pendenteT
+ * ---------------
+ * A edição pendente da aplicadora. Para uma inserção, o texto fica em "texto",
+ * um array com capacidade "capacidade" reaproveitado entre os lotes.
+ */
+
+typedef enum {NENHUMA, INSERCAO, REMOCAO} tipo_edicaoT;
+
+typedef struct
+{
+    tipo_edicaoT tipo;
+    size_t posicao;
+    size_t n;
+    char *texto;
+    size_t capacidade;
+} pendenteT;
+
+/**
+ * Tipo: aplicadorTCD
+ * ------------------
+ * Representação concreta do aplicador:
+ *
+ *     buffer        o buffer editado
+ *     entradas      a fila, com "mascara + 1" entradas
+ *     proxima       próxima reserva a ser entregue a uma produtora
+ *     aplicadas     quantidade de edições já aplicadas
+ *     lida          próxima reserva a ser lida (só usada pela aplicadora)
+ *     tamanho       tamanho que o buffer terá depois da edição pendente
+ *     pendente      edição pendente (só usada pela aplicadora)
+ *     dormindo      TRUE enquanto a aplicadora espera a fila encher
+ *     esperando     quantidade de threads em aguardar_edicao
+ *     encerrar      TRUE se a aplicadora deve terminar
+ *     lotes, operacoes, esperas   métricas
+ *     trava, pedido, concluido    sincronização para dormir e acordar
+ */
+
+struct aplicadorTCD
+{
+    bufferTAD buffer;
+    entradaT *entradas;
+    unsigned long long mascara;
+    atomic_ullong proxima;
+    atomic_ullong aplicadas;
+    unsigned long long lida;
+    size_t tamanho;
+    pendenteT pendente;
+    atomic_bool dormindo;
+    atomic_int esperando;
+    atomic_bool encerrar;
+    atomic_ullong lotes;
+    atomic_ullong operacoes;
+    atomic_ullong esperas;
+    pthread_mutex_t trava;
+    pthread_cond_t pedido;
+    pthread_cond_t concluido;
+    pthread_t aplicadora;
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static unsigned long long enviar (aplicadorTAD aplicador, bool remocao,
+                                  size_t posicao, const char *texto, size_t n);
+static void *aplicar_edicoes (void *arg);
+static bool entrada_pronta (aplicadorTAD aplicador);
+static void dormir (aplicadorTAD aplicador);
+static void drenar_lote (aplicadorTAD aplicador);
+static void juntar_insercao (aplicadorTAD aplicador, size_t posicao,
+                             const char *texto, size_t n);
+static void juntar_remocao (aplicadorTAD aplicador, size_t posicao, size_t n);
+static void fazer_pendente (aplicadorTAD aplicador);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: iniciar_aplicador
+ * Uso: a = iniciar_aplicador(buffer, capacidade);
+ * -----------------------------------------------
+ * Aloca a fila, marca cada entrada como livre para a primeira volta e cria a
+ * thread aplicadora.
+ */
+
+aplicadorTAD iniciar_aplicador (bufferTAD buffer, int capacidade)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: aplicador para buffer null.\n");
+        exit(1);
+    }
+
+    unsigned long long n = 2;
+    while (n < (unsigned long long) capacidade)
+        n *= 2;
+
+    aplicadorTAD A = calloc(1, sizeof(struct aplicadorTCD));
+    entradaT *entradas = A != NULL ? calloc(n, sizeof(entradaT)) : NULL;
+    if (entradas == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar aplicador.\n");
+        free(A);
+        return NULL;
+    }
+
+    A->buffer = buffer;
+    A->entradas = entradas;
+    A->mascara = n - 1;
+    for (unsigned long long i = 0; i < n; i++)
+        atomic_init(&entradas[i].sequencia, i);
+    atomic_init(&A->proxima, 0);
+    atomic_init(&A->aplicadas, 0);
+    atomic_init(&A->dormindo, FALSE);
+    atomic_init(&A->esperando, 0);
+    atomic_init(&A->encerrar, FALSE);
+    atomic_init(&A->lotes, 0);
+    atomic_init(&A->operacoes, 0);
+    atomic_init(&A->esperas, 0);
+    A->tamanho = tamanho_buffer(buffer);
+
+    pthread_mutex_init(&A->trava, NULL);
+    pthread_cond_init(&A->pedido, NULL);
+    pthread_cond_init(&A->concluido, NULL);
+    if (pthread_create(&A->aplicadora, NULL, aplicar_edicoes, A) != 0)
+    {
+        fprintf(stderr, "Erro: impossível criar a thread aplicadora.\n");
+        pthread_mutex_destroy(&A->trava);
+        pthread_cond_destroy(&A->pedido);
+        pthread_cond_destroy(&A->concluido);
+        free(entradas);
+        free(A);
+        return NULL;
+    }
+
+    return A;
+}
+
+/**
+ * Funções: enviar_insercao, enviar_remocao
+ * Uso: seq = enviar_insercao(a, posicao, texto, n);
+ *      seq = enviar_remocao(a, posicao, n);
+ * -------------------------------------------------
+ * Apenas chamam "enviar" com o tipo da edição.
+ */
+
+unsigned long long enviar_insercao (aplicadorTAD aplicador, size_t posicao,
+                                    const char *texto, size_t n)
+{
+    if (n > 0 && texto == NULL)
+    {
+        fprintf(stderr, "Erro: inserção de texto null.\n");
+        exit(1);
+    }
+
+    return enviar(aplicador, FALSE, posicao, texto, n);
+}
+
+unsigned long long enviar_remocao (aplicadorTAD aplicador, size_t posicao,
+                                   size_t n)
+{
+    return enviar(aplicador, TRUE, posicao, NULL, n);
+}
+
+/**
+ * Procedimento: aguardar_edicao
+ * Uso: aguardar_edicao(a, seq);
+ * -----------------------------
+ * Se a edição ainda não foi aplicada, dorme até a aplicadora avisar que
+ * terminou um lote que a inclui. A thread se registra em "esperando" antes de
+ * conferir "aplicadas", e a aplicadora atualiza "aplicadas" antes de conferir
+ * "esperando", de modo que o aviso nunca se perde.
+ */
+
+void aguardar_edicao (aplicadorTAD aplicador, unsigned long long sequencia)
+{
+    if (aplicador == NULL)
+    {
+        fprintf(stderr, "Erro: espera em aplicador null.\n");
+        exit(1);
+    }
+    else if (sequencia > atomic_load(&aplicador->proxima))
+    {
+        fprintf(stderr, "Erro: a edição %llu não foi enviada.\n", sequencia);
+        exit(1);
+    }
+
+    if (atomic_load(&aplicador->aplicadas) >= sequencia)
+        return;
+
+    pthread_mutex_lock(&aplicador->trava);
+    atomic_fetch_add(&aplicador->esperando, 1);
+    while (atomic_load(&aplicador->aplicadas) < sequencia)
+        pthread_cond_wait(&aplicador->concluido, &aplicador->trava);
+    atomic_fetch_sub(&aplicador->esperando, 1);
+    pthread_mutex_unlock(&aplicador->trava);
+}
+
+/**
+ * Função: edicoes_aplicadas
+ * Uso: n = edicoes_aplicadas(a);
+ * ------------------------------
+ * Lê o contador atualizado pela aplicadora ao final de cada lote.
+ */
+
+unsigned long long edicoes_aplicadas (aplicadorTAD aplicador)
+{
+    if (aplicador == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a aplicador null.\n");
+        exit(1);
+    }
+
+    return atomic_load(&aplicador->aplicadas);
+}
+
+/**
+ * Procedimento: obter_metricas_aplicador
+ * Uso: obter_metricas_aplicador(a, &metricas);
+ * --------------------------------------------
+ * Lê os contadores atômicos, sem travar a fila.
+ */
+
+void obter_metricas_aplicador (aplicadorTAD aplicador,
+                               metricas_aplicadorT *metricas)
+{
+    if (aplicador == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a aplicador null.\n");
+        exit(1);
+    }
+
+    metricas->enviadas = atomic_load(&aplicador->proxima);
+    metricas->aplicadas = atomic_load(&aplicador->aplicadas);
+    metricas->lotes = atomic_load(&aplicador->lotes);
+    metricas->operacoes = atomic_load(&aplicador->operacoes);
+    metricas->esperas = atomic_load(&aplicador->esperas);
+}
+
+/**
+ * Procedimento: encerrar_aplicador
+ * Uso: encerrar_aplicador(&a);
+ * ----------------------------
+ * Acorda a aplicadora com o pedido de encerramento; ela só termina depois de
+ * aplicar todas as reservas já entregues.
+ */
+
+void encerrar_aplicador (aplicadorTAD *aplicador)
+{
+    if (aplicador == NULL || *aplicador == NULL)
+        return;
+
+    aplicadorTAD A = *aplicador;
+    pthread_mutex_lock(&A->trava);
+    atomic_store(&A->encerrar, TRUE);
+    pthread_cond_broadcast(&A->pedido);
+    pthread_mutex_unlock(&A->trava);
+    pthread_join(A->aplicadora, NULL);
+
+    pthread_mutex_destroy(&A->trava);
+    pthread_cond_destroy(&A->pedido);
+    pthread_cond_destroy(&A->concluido);
+    free(A->pendente.texto);
+    free(A->entradas);
+    free(A);
+    *aplicador = NULL;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: enviar
+ * Uso: seq = enviar(a, remocao, posicao, texto, n);
+ * -------------------------------------------------
+ * Copia um texto longo antes de reservar a entrada (para que uma falha de
+ * alocação não deixe uma reserva sem edição), reserva a entrada, espera que
+ * ela esteja livre, preenche e publica. Se a aplicadora estiver dormindo, ela
+ * é acordada: a publicação vem antes da leitura de "dormindo", e a aplicadora
+ * marca "dormindo" antes de conferir a fila, de modo que uma das duas threads
+ * sempre vê a outra.
+ */
+
+static unsigned long long enviar (aplicadorTAD aplicador, bool remocao,
+                                  size_t posicao, const char *texto, size_t n)
+{
+    if (aplicador == NULL)
+    {
+        fprintf(stderr, "Erro: edição em aplicador null.\n");
+        exit(1);
+    }
+
+    aplicadorTAD A = aplicador;
+    char *longo = NULL;
+    if (!remocao && n > CURTO)
+    {
+        longo = malloc(n);
+        if (longo == NULL)
+        {
+            fprintf(stderr, "Erro: impossível copiar o texto da edição.\n");
+            return 0;
+        }
+        memcpy(longo, texto, n);
+    }
+
+    unsigned long long reserva = atomic_fetch_add(&A->proxima, 1);
+    entradaT *e = &A->entradas[reserva & A->mascara];
+    if (atomic_load_explicit(&e->sequencia, memory_order_acquire) != reserva)
+    {
+        atomic_fetch_add(&A->esperas, 1);
+        while (atomic_load_explicit(&e->sequencia, memory_order_acquire) !=
+               reserva)
+            sched_yield();
+    }
+
+    e->remocao = remocao;
+    e->posicao = posicao;
+    e->n = n;
+    e->texto = longo;
+    if (!remocao && longo == NULL && n > 0)
+        memcpy(e->curto, texto, n);
+    atomic_store(&e->sequencia, reserva + 1);
+
+    if (atomic_load(&A->dormindo))
+    {
+        pthread_mutex_lock(&A->trava);
+        pthread_cond_signal(&A->pedido);
+        pthread_mutex_unlock(&A->trava);
+    }
+
+    return reserva + 1;
+}
+
+/**
+ * Função: aplicar_edicoes
+ * Uso: pthread_create(&aplicadora, NULL, aplicar_edicoes, a);
+ * -----------------------------------------------------------
+ * Corpo da thread aplicadora: drena um lote sempre que a próxima entrada está
+ * preenchida e dorme quando a fila está vazia. Com o pedido de encerramento,
+ * termina quando todas as reservas entregues foram aplicadas (uma produtora
+ * que já reservou mas ainda não publicou é esperada).
+ */
+
+static void *aplicar_edicoes (void *arg)
+{
+    aplicadorTAD A = arg;
+
+    while (TRUE)
+    {
+        if (entrada_pronta(A))
+            drenar_lote(A);
+        else if (!atomic_load(&A->encerrar))
+            dormir(A);
+        else if (A->lida == atomic_load(&A->proxima))
+            break;
+        else
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+/**
+ * Função: entrada_pronta
+ * Uso: if (entrada_pronta(a)) . . .
+ * ---------------------------------
+ * Retorna TRUE se a entrada da próxima reserva a ser lida já foi publicada.
+ */
+
+static bool entrada_pronta (aplicadorTAD A)
+{
+    entradaT *e = &A->entradas[A->lida & A->mascara];
+    return atomic_load(&e->sequencia) == A->lida + 1;
+}
+
+/**
+ * Procedimento: dormir
+ * Uso: dormir(a);
+ * ---------------
+ * Marca a aplicadora como dormindo e espera até uma entrada ser publicada ou
+ * o encerramento ser pedido.
+ */
+
+static void dormir (aplicadorTAD A)
+{
+    pthread_mutex_lock(&A->trava);
+    atomic_store(&A->dormindo, TRUE);
+    while (!entrada_pronta(A) && !atomic_load(&A->encerrar))
+        pthread_cond_wait(&A->pedido, &A->trava);
+    atomic_store(&A->dormindo, FALSE);
+    pthread_mutex_unlock(&A->trava);
+}
+
+/**
+ * Procedimento: drenar_lote
+ * Uso: drenar_lote(a);
+ * --------------------
+ * Lê as entradas publicadas, em ordem, juntando cada edição à pendente e
+ * liberando a entrada logo em seguida, até encontrar uma entrada não
+ * publicada (ou ler uma volta inteira da fila). Ao final faz a edição
+ * pendente, publica a quantidade de edições aplicadas e acorda quem estiver
+ * esperando.
+ */
+
+static void drenar_lote (aplicadorTAD A)
+{
+    unsigned long long capacidade = A->mascara + 1;
+    unsigned long long limite = A->lida + capacidade;
+
+    while (A->lida < limite && entrada_pronta(A))
+    {
+        entradaT *e = &A->entradas[A->lida & A->mascara];
+        if (e->remocao)
+            juntar_remocao(A, e->posicao, e->n);
+        else
+        {
+            juntar_insercao(A, e->posicao, e->texto != NULL ? e->texto :
+                                                              e->curto, e->n);
+            free(e->texto);
+        }
+        atomic_store_explicit(&e->sequencia, A->lida + capacidade,
+                              memory_order_release);
+        A->lida++;
+    }
+    fazer_pendente(A);
+    atomic_fetch_add(&A->lotes, 1);
+
+    atomic_store(&A->aplicadas, A->lida);
+    if (atomic_load(&A->esperando) > 0)
+    {
+        pthread_mutex_lock(&A->trava);
+        pthread_cond_broadcast(&A->concluido);
+        pthread_mutex_unlock(&A->trava);
+    }
+}
+
+/**
+ * Procedimento: juntar_insercao
+ * Uso: juntar_insercao(a, posicao, texto, n);
+ * -------------------------------------------
+ * Encaixa a inserção no texto da inserção pendente, se a posição estiver
+ * dentro dele ou em uma das pontas; senão, faz a pendente e começa outra.
+ */
+
+static void juntar_insercao (aplicadorTAD A, size_t posicao, const char *texto,
+                             size_t n)
+{
+    pendenteT *p = &A->pendente;
+
+    if (posicao > A->tamanho)
+        posicao = A->tamanho;
+    if (n == 0)
+        return;
+
+    if (p->tipo != INSERCAO || posicao < p->posicao ||
+        posicao > p->posicao + p->n)
+    {
+        fazer_pendente(A);
+        p->tipo = INSERCAO;
+        p->posicao = posicao;
+        p->n = 0;
+    }
+
+    if (p->n + n > p->capacidade)
+    {
+        size_t capacidade = 2 * p->capacidade;
+        if (capacidade < p->n + n)
+            capacidade = p->n + n;
+        char *novo = realloc(p->texto, capacidade);
+        if (novo == NULL)
+        {
+            fprintf(stderr, "Erro: impossível alocar a edição pendente.\n");
+            exit(1);
+        }
+        p->texto = novo;
+        p->capacidade = capacidade;
+    }
+
+    size_t k = posicao - p->posicao;
+    memmove(p->texto + k + n, p->texto + k, p->n - k);
+    memcpy(p->texto + k, texto, n);
+    p->n += n;
+    A->tamanho += n;
+}
+
+/**
+ * Procedimento: juntar_remocao
+ * Uso: juntar_remocao(a, posicao, n);
+ * -----------------------------------
+ * Se a remoção está inteira dentro do texto de uma inserção pendente, apaga
+ * esses caracteres do texto pendente. Se encosta em uma remoção pendente
+ * (cobrindo a posição dela), as duas viram uma só: em posições do buffer
+ * anterior à remoção pendente, o intervalo removido começa em "posicao" e tem
+ * o tamanho das duas somadas. Senão, faz a pendente e começa outra.
+ */
+
+static void juntar_remocao (aplicadorTAD A, size_t posicao, size_t n)
+{
+    pendenteT *p = &A->pendente;
+
+    if (posicao > A->tamanho)
+        posicao = A->tamanho;
+    if (n > A->tamanho - posicao)
+        n = A->tamanho - posicao;
+    if (n == 0)
+        return;
+
+    if (p->tipo == INSERCAO && posicao >= p->posicao &&
+        posicao + n <= p->posicao + p->n)
+    {
+        size_t k = posicao - p->posicao;
+        memmove(p->texto + k, p->texto + k + n, p->n - k - n);
+        p->n -= n;
+        if (p->n == 0)
+            p->tipo = NENHUMA;
+    }
+    else if (p->tipo == REMOCAO && posicao <= p->posicao &&
+             p->posicao <= posicao + n)
+    {
+        p->posicao = posicao;
+        p->n += n;
+    }
+    else
+    {
+        fazer_pendente(A);
+        p->tipo = REMOCAO;
+        p->posicao = posicao;
+        p->n = n;
+    }
+    A->tamanho -= n;
+}
+
+/**
+ * Procedimento: fazer_pendente
+ * Uso: fazer_pendente(a);
+ * -----------------------
+ * Faz a edição pendente no buffer, com uma única inserção ou remoção em bloco.
+ */
+
+static void fazer_pendente (aplicadorTAD A)
+{
+    pendenteT *p = &A->pendente;
+
+    if (p->tipo == NENHUMA)
+        return;
+
+    mover_cursor_para_posicao(A->buffer, p->posicao);
+    if (p->tipo == INSERCAO)
+        inserir_texto(A->buffer, p->texto, p->n);
+    else
+        apagar_texto(A->buffer, p->n);
+    atomic_fetch_add(&A->operacoes, 1);
+    p->tipo = NENHUMA;
+}
@@ -0,0 +1,155 @@
+/**
+ * Arquivo: aplicador.h
+ * Versão : 1.1
+ * Data   : 2026-10-18 22:20
+ * -------------------------
+ * Este arquivo define uma interface para que várias threads (produtoras)
+ * editem o mesmo buffer. O bufferTAD não tem nenhuma sincronização; por isso
+ * as produtoras não mexem no buffer: elas apenas enviam edições (inserções e
+ * remoções em uma posição) para uma fila, e uma única thread aplicadora retira
+ * as edições da fila em lotes e as aplica ao buffer, na ordem em que foram
+ * enviadas.
+ *
+ * A fila é circular, com capacidade fixa, e não usa travas: cada produtora
+ * reserva a sua posição com um incremento atômico e a publica com uma escrita
+ * atômica, de modo que várias produtoras nunca esperam umas pelas outras (a
+ * não ser quando a fila está cheia). O número da reserva é também o número de
+ * sequência da edição, retornado à produtora, que pode esperar até que a
+ * edição tenha sido aplicada.
+ *
+ * Antes de aplicar um lote, a aplicadora junta as edições adjacentes (texto
+ * digitado em sequência, apagamentos seguidos para frente ou para trás) em uma
+ * única chamada de "inserir_texto" ou "apagar_texto", de modo que uma rajada
+ * de edições pequenas custa uma única operação no buffer.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _APLICADOR_H
+#define _APLICADOR_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: aplicadorTAD
+ * ------------------
+ * Representa a fila de edições de um buffer e a sua thread aplicadora.
+ */
+
+typedef struct aplicadorTCD *aplicadorTAD;
+
+/**
+ * TIPO: metricas_aplicadorT
+ * -------------------------
+ * Métricas acumuladas pelo aplicador:
+ *
+ *     enviadas      edições enviadas pelas produtoras
+ *     aplicadas     edições já aplicadas ao buffer
+ *     lotes         lotes retirados da fila pela aplicadora
+ *     operacoes     operações feitas no buffer (depois de juntar as edições)
+ *     esperas       vezes em que uma produtora encontrou a fila cheia
+ */
+
+typedef struct
+{
+    unsigned long long enviadas;
+    unsigned long long aplicadas;
+    unsigned long long lotes;
+    unsigned long long operacoes;
+    unsigned long long esperas;
+} metricas_aplicadorT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: iniciar_aplicador
+ * Uso: a = iniciar_aplicador(buffer, capacidade);
+ * -----------------------------------------------
+ * Cria uma fila com espaço para pelo menos "capacidade" edições (arredondado
+ * para uma potência de 2) e inicia a thread aplicadora do buffer. Até o
+ * aplicador ser encerrado, nenhuma outra thread deve usar o buffer (a não ser
+ * pelas leituras concorrentes de arraybuff.h). Retorna NULL em caso de erro.
+ */
+
+aplicadorTAD iniciar_aplicador (bufferTAD buffer, int capacidade);
+
+/**
+ * FUNÇÕES: enviar_insercao, enviar_remocao
+ * Uso: seq = enviar_insercao(a, posicao, texto, n);
+ *      seq = enviar_remocao(a, posicao, n);
+ * -------------------------------------------------
+ * Enviam uma edição ao aplicador e retornam o seu número de sequência (1 para
+ * a primeira edição, 2 para a segunda etc.). Podem ser chamadas por várias
+ * threads ao mesmo tempo. A inserção copia os "n" caracteres de "texto", que
+ * pode ser reutilizado logo em seguida. As posições se referem ao buffer como
+ * ele estará quando a edição for aplicada (depois de todas as edições de
+ * sequência menor); uma posição além do final é tratada como o final. Só
+ * esperam se a fila estiver cheia. Retornam 0 se não houver memória para
+ * copiar o texto.
+ */
+
+unsigned long long enviar_insercao (aplicadorTAD aplicador, size_t posicao,
+                                    const char *texto, size_t n);
+unsigned long long enviar_remocao (aplicadorTAD aplicador, size_t posicao,
+                                   size_t n);
+
+/**
+ * PROCEDIMENTO: aguardar_edicao
+ * Uso: aguardar_edicao(a, seq);
+ * -----------------------------
+ * Espera até que a edição de número "seq" (e, portanto, todas as anteriores)
+ * tenha sido aplicada ao buffer.
+ */
+
+void aguardar_edicao (aplicadorTAD aplicador, unsigned long long sequencia);
+
+/**
+ * FUNÇÃO: edicoes_aplicadas
+ * Uso: n = edicoes_aplicadas(a);
+ * ------------------------------
+ * Retorna, sem esperar, quantas edições já foram aplicadas: a edição "seq"
+ * está aplicada se "seq <= edicoes_aplicadas(a)".
+ */
+
+unsigned long long edicoes_aplicadas (aplicadorTAD aplicador);
+
+/**
+ * PROCEDIMENTO: obter_metricas_aplicador
+ * Uso: obter_metricas_aplicador(a, &metricas);
+ * --------------------------------------------
+ * Copia as métricas atuais do aplicador para "metricas".
+ */
+
+void obter_metricas_aplicador (aplicadorTAD aplicador,
+                               metricas_aplicadorT *metricas);
+
+/**
+ * PROCEDIMENTO: encerrar_aplicador
+ * Uso: encerrar_aplicador(&a);
+ * ----------------------------
+ * Espera que todas as edições já enviadas sejam aplicadas, encerra a thread
+ * aplicadora e libera o aplicador (o buffer não é liberado e volta a poder
+ * ser usado diretamente). Nenhuma edição pode ser enviada durante ou depois
+ * do encerramento. Note que o argumento é um PONTEIRO.
+ */
+
+void encerrar_aplicador (aplicadorTAD *aplicador);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
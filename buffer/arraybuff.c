@@ -1,11 +1,49 @@
 /**
  * Arquivo: arraybuf.c
- * Versão : 1.0
- * Data   : 2024-10-19 07:13
+ * Versão : 1.12
+ * Data   : 2026-10-19 04:40
  * -------------------------
  * Este arquivo implementa a interface buffer.h utilizando como estrutura de
- * dados principal um array. Nesta implementação o buffer terá tamanho limitado
- * por uma constante simbólica.
+ * dados principal um array. Nesta implementação o array começa com o tamanho
+ * dado por uma constante simbólica e é realocado (dobrando de tamanho) sempre
+ * que uma inserção precisar de mais espaço.
+ *
+ * No modo de leitura concorrente (veja arraybuff.h), toda operação que altera
+ * o buffer é feita entre "iniciar_escrita" e "terminar_escrita", que tornam o
+ * contador de sequência ímpar e par, e os arrays substituídos são aposentados
+ * em vez de liberados. As épocas anunciadas pelas leitoras ficam em uma tabela
+ * global, com uma posição (em uma linha de cache própria) para cada thread
+ * leitora; a posição é pega na primeira leitura da thread e devolvida quando a
+ * thread termina. Os campos do buffer continuam sendo campos comuns, lidos
+ * pelas leitoras sem sincronização: é o contador de sequência, conferido antes
+ * de usar os valores lidos e de novo depois da cópia, que descarta qualquer
+ * leitura feita durante uma escrita.
+ *
+ * Um buffer compartilhado (veja visor.h) tem o array dentro da região de
+ * memória compartilhada, logo após o cabeçalho. A região é mapeada com o seu
+ * limite desde o início, e crescer o array é apenas aumentar o tamanho da
+ * região (ftruncate), sem copiar nem mudar o endereço do texto. As mesmas
+ * funções "iniciar_escrita" e "terminar_escrita" mantêm o contador de
+ * sequência do cabeçalho e, ao terminar, copiam para o cabeçalho o tamanho, o
+ * cursor e a versão.
+ *
+ * Os tamanhos e posições são size_t, e o texto pode passar de 4 GB. Os arrays
+ * a partir de TEXTO_GRANDE bytes não vêm de malloc, mas de um mapeamento
+ * anônimo (mmap) do tamanho arredondado para páginas enormes: primeiro com
+ * páginas enormes reservadas (MAP_HUGETLB) e, se não houver, com páginas
+ * comuns marcadas para as páginas enormes transparentes (MADV_HUGEPAGE). Com
+ * isso uma varredura do texto inteiro sofre muito menos faltas na TLB. Fora do
+ * modo concorrente, um array mapeado cresce com mremap, sem cópia. O tipo de
+ * cada array é deduzido da sua capacidade.
+ *
+ * Um buffer criado com criar_buffer_com_alocador obtém do alocador apenas a
+ * sua estrutura: o array de texto continua sendo alocado por alocar_texto,
+ * pois pode ser aposentado ou trocado pela região compartilhada.
+ *
+ * As edições de uma transação (veja transacao.h) são aplicadas ao array de
+ * uma só vez, na confirmação ou na primeira leitura do texto: cada parte não
+ * alterada do texto é movida uma única vez para a sua posição final, em vez de
+ * a cauda do array ser deslocada a cada edição.
  *
  * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
  *             Capítulo 9: Efficiency and ATDs (pg. 381-386).
@@ -22,40 +60,218 @@
 
 /*** Includes ***/
 
+#define _GNU_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#define IMPLEMENTANDO_BUFFER
+
+#include "alocador.h"
+#include "arraybuff.h"
 #include "buffer.h"
+#include <fcntl.h>
 #include "genlib.h"
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "simpio.h"
 #include "strlib.h"
+#include <sys/mman.h>
+#include "transacao.h"
+#include <unistd.h>
+#include "visor.h"
 
 /*** Constantes Simbólicas ***/
 
 #define TAMBUFFER 100
 
+/**
+ * CONSTANTES: TEXTO_GRANDE, PAGINA_ENORME
+ * ---------------------------------------
+ * A capacidade a partir da qual o array do texto é mapeado com mmap, em vez
+ * de alocado com malloc, e o tamanho de uma página enorme, múltiplo do qual
+ * são os mapeamentos.
+ */
+
+#define TEXTO_GRANDE ((size_t) 2 << 20)
+#define PAGINA_ENORME ((size_t) 2 << 20)
+
+/**
+ * CONSTANTE: MAXLEITORAS
+ * ----------------------
+ * Quantidade máxima de threads lendo buffers no modo concorrente ao mesmo
+ * tempo (uma thread que termina devolve a sua posição na tabela de épocas).
+ */
+
+#define MAXLEITORAS 64
+
 /*** Tipos de Dados ***/
 
 /**
  * Tipo: struct bufferTCD
  * ----------------------
  * Nesta representação interna do buffer os caracteres estão armazenados em um
- * array. Também existirão variáveis para armazenar o tamanho da string do
- * buffer (o que nos permite ignorar o '\0' como marcador de final) e a posição
- * do cursor no buffer. A posição do cursor indicará o índice da posição no
- * array onde o próximo caractere será inserido.
+ * array alocado dinamicamente. Também existirão variáveis para armazenar a
+ * capacidade do array, o tamanho da string do buffer (o que nos permite ignorar
+ * o '\0' como marcador de final) e a posição do cursor no buffer. A posição do
+ * cursor indicará o índice da posição no array onde o próximo caractere será
+ * inserido.
  *
- *     texto      array com tamanho TAMBUFFER para os caracteres
- *     tamanho    quantidade de caracteres no buffer
- *     cursor     posição atual do cursor de edição
+ *     texto       array para os caracteres (inicialmente com TAMBUFFER posições)
+ *     capacidade  quantidade de posições alocadas em "texto"
+ *     tamanho     quantidade de caracteres no buffer
+ *     cursor      posição atual do cursor de edição
+ *     versao      contador de alterações do conteúdo
+ *     concorrente TRUE se o modo de leitura concorrente foi ativado
+ *     sequencia   contador de sequência (ímpar durante uma escrita)
+ *     aposentados arrays substituídos (com as suas capacidades) que ainda não
+ *                 podem ser liberados
+ *     releituras, naposentados, liberados   métricas da leitura concorrente
+ *     regiao      cabeçalho da região compartilhada (NULL se não compartilhado)
+ *     nome_regiao nome da região compartilhada
+ *     descritor   descritor da região compartilhada
+ *     alocador    alocador da estrutura do buffer
+ *     transacao   transação aberta (NULL se não houver)
+ *     desfazer    última transação confirmada, para desfazer_transacao
+ *     versao_desfazer   versão do buffer logo após aquela confirmação
  */
 
+typedef struct aposentadoTCD
+{
+    char *texto;
+    size_t capacidade;
+    unsigned long long epoca;
+    struct aposentadoTCD *proximo;
+} aposentadoT;
+
 struct bufferTCD
 {
-    char texto[TAMBUFFER];
-    int tamanho;
-    int cursor;
+    char *texto;
+    size_t capacidade;
+    size_t tamanho;
+    size_t cursor;
+    unsigned long versao;
+    bool concorrente;
+    atomic_uint sequencia;
+    aposentadoT *aposentados;
+    atomic_ullong releituras;
+    unsigned long long naposentados;
+    atomic_ullong liberados;
+    cabecalho_visorT *regiao;
+    char *nome_regiao;
+    int descritor;
+    alocadorT alocador;
+    transacaoTAD transacao;
+    transacaoTAD desfazer;
+    unsigned long versao_desfazer;
 };
 
+/**
+ * Tipo: leitoraT
+ * --------------
+ * Uma posição da tabela de épocas: a época anunciada pela thread leitora dona
+ * da posição (0 fora de uma leitura) e se a posição tem dona. Cada posição
+ * ocupa uma linha de cache, para que as leitoras não disputem a mesma linha.
+ */
+
+typedef struct
+{
+    _Alignas(64) atomic_ullong epoca;
+    atomic_int ocupada;
+} leitoraT;
+
+/**
+ * Tipo: leituraT
+ * --------------
+ * O que uma leitura concorrente obteve, todos da mesma versão do buffer.
+ */
+
+typedef struct
+{
+    size_t tamanho;
+    size_t cursor;
+    unsigned long versao;
+    size_t copiados;
+} leituraT;
+
+/**
+ * Tipo: saidaT
+ * ------------
+ * O array em que "substituir_tudo" monta o novo texto. Se "texto" for NULL,
+ * os caracteres são apenas contados.
+ */
+
+typedef struct
+{
+    char *texto;
+    size_t capacidade;
+    size_t tamanho;
+} saidaT;
+
+/**
+ * Tipo: classeT
+ * -------------
+ * As classes de caracteres procuradas pelos movimentos de palavra, linha e
+ * parágrafo: o '\n' (QUEBRA), qualquer outro caractere (TEXTO), os
+ * caracteres de palavra (PALAVRA) e os demais (SEPARADOR).
+ */
+
+typedef enum
+{
+    QUEBRA,
+    TEXTO,
+    PALAVRA,
+    SEPARADOR
+} classeT;
+
+/*** Variáveis Globais ***/
+
+/**
+ * VARIÁVEIS: epoca_global, leitoras, leitora_da_thread
+ * ----------------------------------------------------
+ * A época atual (avançada a cada array aposentado), a tabela de épocas
+ * anunciadas e a posição da tabela que pertence à thread (-1 se ainda não
+ * pegou uma). A chave "chave_leitora" faz com que a posição seja devolvida
+ * quando a thread termina.
+ */
+
+static atomic_ullong epoca_global = 1;
+static leitoraT leitoras[MAXLEITORAS];
+static _Thread_local int leitora_da_thread = -1;
+static pthread_key_t chave_leitora;
+static pthread_once_t chave_criada = PTHREAD_ONCE_INIT;
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void garantir_capacidade (bufferTAD buffer, size_t n);
+static void iniciar_escrita (bufferTAD buffer);
+static void terminar_escrita (bufferTAD buffer);
+static void aposentar (bufferTAD buffer, char *texto, size_t capacidade);
+static void recolher (bufferTAD buffer);
+static void ler (bufferTAD buffer, size_t inicio, size_t n, char destino[],
+                 leituraT *leitura);
+static void entrar_na_epoca (void);
+static void sair_da_epoca (void);
+static void criar_chave_leitora (void);
+static void devolver_leitora (void *posicao);
+static size_t *tabela_falhas (const char *padrao, size_t n);
+static void anexar (saidaT *saida, const char *texto, size_t n);
+static char *alocar_texto (size_t capacidade);
+static char *realocar_texto (char *texto, size_t capacidade, size_t usados,
+                             size_t nova);
+static void liberar_texto (char *texto, size_t capacidade);
+static size_t tamanho_mapeado (size_t capacidade);
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static bool pertence (char c, classeT classe);
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar);
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao);
+static void aplicar_pendentes (bufferTAD buffer);
+
 /*** Definições de Subprogramas Exportados ***/
 
 /**
@@ -68,15 +284,55 @@ struct bufferTCD
 
 bufferTAD criar_buffer (void)
 {
-    bufferTAD B = malloc(sizeof(struct bufferTCD));
+    return criar_buffer_com_alocador(NULL);
+}
+
+/**
+ * Função: criar_buffer_com_alocador
+ * Uso: buffer = criar_buffer_com_alocador(&alocador);
+ * ---------------------------------------------------
+ * Cria o buffer com a estrutura obtida do alocador (ou de malloc, se o
+ * alocador for NULL). Em caso de erro, libera o alocador, se for o dono da
+ * sua memória, e retorna NULL.
+ */
+
+bufferTAD criar_buffer_com_alocador (const alocadorT *alocador)
+{
+    alocadorT a = (alocador != NULL) ? *alocador : alocador_padrao();
+    bufferTAD B = alocar(&a, sizeof(struct bufferTCD));
     if (B == NULL)
     {
         fprintf(stderr, "Erro: impossível alocar buffer.\n");
+        liberar_alocador(&a);
+        return NULL;
+    }
+
+    B->texto = alocar_texto(TAMBUFFER);
+    if (B->texto == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar texto do buffer.\n");
+        desalocar(&a, B, sizeof(struct bufferTCD));
+        liberar_alocador(&a);
         return NULL;
     }
     
+    B->alocador = a;
+    B->capacidade = TAMBUFFER;
     B->tamanho = 0;
     B->cursor = 0;
+    B->versao = 0;
+    B->concorrente = FALSE;
+    atomic_init(&B->sequencia, 0);
+    B->aposentados = NULL;
+    atomic_init(&B->releituras, 0);
+    B->naposentados = 0;
+    atomic_init(&B->liberados, 0);
+    B->regiao = NULL;
+    B->nome_regiao = NULL;
+    B->descritor = -1;
+    B->transacao = NULL;
+    B->desfazer = NULL;
+    B->versao_desfazer = 0;
 
     return B;
 }
@@ -93,7 +349,28 @@ void liberar_buffer (bufferTAD *buffer)
 {
     if (*buffer != NULL)
     {
-        free(*buffer);
+        while ((*buffer)->aposentados != NULL)
+        {
+            aposentadoT *a = (*buffer)->aposentados;
+            (*buffer)->aposentados = a->proximo;
+            liberar_texto(a->texto, a->capacidade);
+            free(a);
+        }
+        if ((*buffer)->regiao != NULL)
+        {
+            munmap((*buffer)->regiao,
+                   CABECALHO_VISOR + (*buffer)->regiao->limite);
+            close((*buffer)->descritor);
+            shm_unlink((*buffer)->nome_regiao);
+            free((*buffer)->nome_regiao);
+        }
+        else
+            liberar_texto((*buffer)->texto, (*buffer)->capacidade);
+        liberar_transacao(&(*buffer)->transacao);
+        liberar_transacao(&(*buffer)->desfazer);
+        alocadorT alocador = (*buffer)->alocador;
+        desalocar(&alocador, *buffer, sizeof(struct bufferTCD));
+        liberar_alocador(&alocador);
         *buffer = NULL;
     }
 }
@@ -114,9 +391,16 @@ void mover_cursor_para_frente (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
+
+    if (mover_na_transacao(buffer, posicao_cursor(buffer) + 1))
+        return;
     
     if (buffer->cursor < buffer->tamanho)
+    {
+        iniciar_escrita(buffer);
         buffer->cursor++;
+        terminar_escrita(buffer);
+    }
 }
 
 void mover_cursor_para_tras (bufferTAD buffer)
@@ -126,9 +410,17 @@ void mover_cursor_para_tras (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
+
+    size_t atual = posicao_cursor(buffer);
+    if (mover_na_transacao(buffer, atual > 0 ? atual - 1 : 0))
+        return;
     
     if (buffer->cursor > 0)
+    {
+        iniciar_escrita(buffer);
         buffer->cursor--;
+        terminar_escrita(buffer);
+    }
 }
 
 /**
@@ -148,7 +440,12 @@ void mover_cursor_para_final (bufferTAD buffer)
         exit(1);
     }
 
+    if (mover_na_transacao(buffer, SIZE_MAX))
+        return;
+
+    iniciar_escrita(buffer);
     buffer->cursor = buffer->tamanho;
+    terminar_escrita(buffer);
 }
 
 void mover_cursor_para_inicio (bufferTAD buffer)
@@ -159,7 +456,259 @@ void mover_cursor_para_inicio (bufferTAD buffer)
         exit(1);
     }
 
+    if (mover_na_transacao(buffer, 0))
+        return;
+
+    iniciar_escrita(buffer);
     buffer->cursor = 0;
+    terminar_escrita(buffer);
+}
+
+/**
+ * Procedimento: mover_cursor_para_posicao
+ * Uso: mover_cursor_para_posicao(buffer, posicao);
+ * ------------------------------------------------
+ * Como o cursor é um índice do array, basta atribuir a nova posição.
+ */
+
+void mover_cursor_para_posicao (bufferTAD buffer, size_t posicao)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, posicao))
+        return;
+
+    if (posicao > buffer->tamanho)
+        posicao = buffer->tamanho;
+    iniciar_escrita(buffer);
+    buffer->cursor = posicao;
+    terminar_escrita(buffer);
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proxima_palavra
+ *                mover_cursor_para_palavra_anterior
+ * Uso: mover_cursor_para_proxima_palavra(buffer);
+ *      mover_cursor_para_palavra_anterior(buffer);
+ * -------------------------------------------------
+ * Os movimentos procuram no array a partir do cursor (o '\n' com memchr, as
+ * classes de caracteres com um laço simples) e terminam com um único salto do
+ * cursor, em vez de um movimento por caractere.
+ */
+
+void mover_cursor_para_proxima_palavra (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = avancar_ate(buffer, posicao_cursor(buffer), SEPARADOR);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, p, PALAVRA));
+}
+
+void mover_cursor_para_palavra_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), PALAVRA);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, p, SEPARADOR));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_inicio_da_linha
+ *                mover_cursor_para_final_da_linha
+ * Uso: mover_cursor_para_inicio_da_linha(buffer);
+ *      mover_cursor_para_final_da_linha(buffer);
+ * -----------------------------------------------
+ * Uma única busca pelo '\n' anterior ou seguinte ao cursor.
+ */
+
+void mover_cursor_para_inicio_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, posicao_cursor(buffer),
+                                                 QUEBRA));
+}
+
+void mover_cursor_para_final_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, posicao_cursor(buffer),
+                                                  QUEBRA));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proximo_paragrafo
+ *                mover_cursor_para_paragrafo_anterior
+ * Uso: mover_cursor_para_proximo_paragrafo(buffer);
+ *      mover_cursor_para_paragrafo_anterior(buffer);
+ * ---------------------------------------------------
+ * Para frente, o texto é percorrido de uma sequência de '\n' a outra; a
+ * primeira sequência com dois ou mais '\n' que vem depois de um caractere de
+ * texto termina o parágrafo, e a linha em branco começa logo após o primeiro
+ * '\n'. Para trás, o texto é percorrido de um início de linha com texto ao
+ * anterior; o primeiro que é precedido por dois ou mais '\n' (ou apenas por
+ * '\n' desde o início do buffer) começa um parágrafo, e a linha em branco
+ * começa logo antes dele. Se o cursor está em uma linha em branco, as linhas em
+ * branco vizinhas são puladas antes.
+ */
+
+void mover_cursor_para_proximo_paragrafo (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer), p = posicao_cursor(buffer);
+    bool apos_texto = (p > 0 && recuar_ate(buffer, p, TEXTO) == p);
+
+    while (p < n)
+    {
+        size_t q = avancar_ate(buffer, p, QUEBRA);
+        size_t r = (q < n) ? avancar_ate(buffer, q, TEXTO) : n;
+        if ((q > p || apos_texto) && r - q >= 2)
+        {
+            p = q + 1;
+            break;
+        }
+        p = r;
+        apos_texto = TRUE;
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+void mover_cursor_para_paragrafo_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), QUEBRA);
+
+    if (p == n || avancar_ate(buffer, p, TEXTO) != p)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        p = (t > 0) ? recuar_ate(buffer, t, QUEBRA) : 0;
+    }
+    while (p > 0)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        if (t == 0 || p - t >= 2)
+        {
+            p--;
+            break;
+        }
+        p = recuar_ate(buffer, t, QUEBRA);
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+/**
+ * Funções: tamanho_buffer, posicao_cursor
+ * Uso: n = tamanho_buffer(buffer);
+ *      p = posicao_cursor(buffer);
+ * ---------------------------------------
+ * Retornam o tamanho do buffer e a posição do cursor.
+ */
+
+size_t tamanho_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return tamanho_da_transacao(buffer->transacao);
+
+    return buffer->tamanho;
+}
+
+size_t posicao_cursor (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cursor de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return cursor_da_transacao(buffer->transacao);
+
+    return buffer->cursor;
+}
+
+/**
+ * Função: versao_buffer
+ * Uso: v = versao_buffer(buffer);
+ * -------------------------------
+ * Retorna o contador de alterações, incrementado pelas inserções e remoções.
+ */
+
+unsigned long versao_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: versão de buffer null.\n");
+        exit(1);
+    }
+
+    return buffer->versao;
+}
+
+/**
+ * Função: copiar_texto
+ * Uso: n = copiar_texto(buffer, inicio, n, destino);
+ * --------------------------------------------------
+ * Copia um trecho do array com uma única chamada a memcpy.
+ */
+
+size_t copiar_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[])
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cópia de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (inicio >= buffer->tamanho)
+        return 0;
+    if (n > buffer->tamanho - inicio)
+        n = buffer->tamanho - inicio;
+    memcpy(destino, buffer->texto + inicio, n);
+
+    return n;
 }
 
 /**
@@ -168,7 +717,7 @@ void mover_cursor_para_inicio (bufferTAD buffer)
  * ----------------------------------
  * Insere o caractere "c" no buffer "buffer", na posição atual do cursor,
  * deslocando os caracteres após a posição de inserção 1 posição para a
- * direita. Se ocorrer buffer overflow, ocorrerá um erro.
+ * direita. Se o array estiver cheio ele é realocado antes da inserção.
  */
 
 void inserir_caractere (bufferTAD buffer, char c)
@@ -178,18 +727,52 @@ void inserir_caractere (bufferTAD buffer, char c)
         fprintf(stderr, "Erro: inserção em buffer null.\n");
         exit(1);
     }
-    else if (buffer->cursor == TAMBUFFER)
-    {
-        fprintf(stderr, "Erro: buffer overflow.\n");
-        exit(1);
-    }
 
-    for (int i = buffer->tamanho; i > buffer->cursor; i--)
+    if (registrar(buffer, &c, 1, 0))
+        return;
+
+    iniciar_escrita(buffer);
+    garantir_capacidade(buffer, 1);
+
+    for (size_t i = buffer->tamanho; i > buffer->cursor; i--)
         buffer->texto[i] = buffer->texto[i - 1];
 
     buffer->texto[buffer->cursor] = c;
     buffer->tamanho++;
     buffer->cursor++;
+    buffer->versao++;
+    terminar_escrita(buffer);
+}
+
+/**
+ * Procedimento: inserir_texto
+ * Uso: inserir_texto(buffer, texto, n);
+ * -------------------------------------
+ * Insere "n" caracteres na posição do cursor deslocando a cauda do array uma
+ * única vez (com memmove) e copiando o texto de uma só vez (com memcpy), em vez
+ * de deslocar a cauda uma vez para cada caractere.
+ */
+
+void inserir_texto (bufferTAD buffer, const char *texto, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: inserção em buffer null.\n");
+        exit(1);
+    }
+    else if (n == 0 || registrar(buffer, texto, n, 0))
+        return;
+
+    iniciar_escrita(buffer);
+    garantir_capacidade(buffer, n);
+
+    memmove(buffer->texto + buffer->cursor + n, buffer->texto + buffer->cursor,
+            buffer->tamanho - buffer->cursor);
+    memcpy(buffer->texto + buffer->cursor, texto, n);
+    buffer->tamanho += n;
+    buffer->cursor += n;
+    buffer->versao++;
+    terminar_escrita(buffer);
 }
 
 /**
@@ -207,12 +790,166 @@ void apagar_caractere (bufferTAD buffer)
         exit(1);
     }
 
+    if (registrar(buffer, NULL, 0, 1))
+        return;
+
     if (buffer->cursor < buffer->tamanho)
     {
-        for (int i = buffer->cursor + 1; i < buffer->tamanho; i++)
+        iniciar_escrita(buffer);
+        for (size_t i = buffer->cursor + 1; i < buffer->tamanho; i++)
             buffer->texto[i - 1] = buffer->texto[i];
         buffer->tamanho--;
+        buffer->versao++;
+        terminar_escrita(buffer);
+    }
+}
+
+/**
+ * Procedimento: apagar_texto
+ * Uso: apagar_texto(buffer, n);
+ * -----------------------------
+ * Apaga até "n" caracteres após o cursor deslocando a cauda do array uma única
+ * vez (com memmove).
+ */
+
+void apagar_texto (bufferTAD buffer, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: remoção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, NULL, 0, n))
+        return;
+
+    size_t resta = buffer->tamanho - buffer->cursor;
+    if (n > resta)
+        n = resta;
+    if (n == 0)
+        return;
+
+    iniciar_escrita(buffer);
+    memmove(buffer->texto + buffer->cursor, buffer->texto + buffer->cursor + n,
+            resta - n);
+    buffer->tamanho -= n;
+    buffer->versao++;
+    terminar_escrita(buffer);
+}
+
+/**
+ * Função: substituir_tudo
+ * Uso: n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+ * ----------------------------------------------------------------
+ * Percorre o array uma única vez com o algoritmo de Knuth-Morris-Pratt,
+ * copiando para um novo array os trechos sem ocorrências (localizados com
+ * memchr e copiados com memcpy) e o texto novo no lugar de cada ocorrência; no
+ * final, o novo array substitui o antigo. O custo é O(n + np), qualquer que
+ * seja a quantidade de ocorrências, enquanto apagar e inserir cada ocorrência
+ * deslocaria a cauda do array uma vez por ocorrência.
+ */
+
+size_t substituir_tudo (bufferTAD buffer, const char *padrao, size_t np,
+                        const char *novo, size_t nn, bool simular)
+{
+    if (buffer == NULL || (np > 0 && padrao == NULL) ||
+        (nn > 0 && novo == NULL))
+    {
+        fprintf(stderr, "Erro: substituição em buffer null.\n");
+        exit(1);
+    }
+    else if (np == 0)
+        return 0;
+
+    aplicar_pendentes(buffer);
+    if (!simular)
+        guardar_texto_para_desfazer(buffer->transacao, buffer);
+    saidaT saida = {NULL, 0, 0};
+    if (!simular)
+    {
+        saida.capacidade = buffer->capacidade;
+        saida.texto = alocar_texto(saida.capacidade);
+        if (saida.texto == NULL)
+        {
+            fprintf(stderr, "Erro: buffer overflow.\n");
+            exit(1);
+        }
+    }
+
+    size_t *falhas = tabela_falhas(padrao, np);
+    const char *texto = buffer->texto;
+    size_t tamanho = buffer->tamanho, cursor = buffer->cursor;
+    size_t quantidade = 0, j = 0, ganho = 0, perda = 0, novo_cursor = 0;
+    bool dentro = FALSE;
+
+    for (size_t i = 0; i < tamanho; )
+    {
+        if (j == 0)
+        {
+            const char *p = memchr(texto + i, padrao[0], tamanho - i);
+            size_t fim = (p == NULL) ? tamanho : (size_t) (p - texto);
+            anexar(&saida, texto + i, fim - i);
+            i = fim;
+            if (i == tamanho)
+                break;
+        }
+
+        char c = texto[i++];
+        while (j > 0 && c != padrao[j])
+        {
+            anexar(&saida, padrao, j - falhas[j - 1]);
+            j = falhas[j - 1];
+        }
+        if (c == padrao[j])
+            j++;
+        else
+            anexar(&saida, &c, 1);
+
+        if (j == np)
+        {
+            if (i <= cursor)
+            {
+                ganho += nn;
+                perda += np;
+            }
+            else if (i - np < cursor)
+            {
+                novo_cursor = saida.tamanho + nn;
+                dentro = TRUE;
+            }
+            anexar(&saida, novo, nn);
+            quantidade++;
+            j = 0;
+        }
+    }
+    anexar(&saida, padrao, j);
+    free(falhas);
+
+    if (simular || quantidade == 0)
+    {
+        liberar_texto(saida.texto, saida.capacidade);
+        return quantidade;
+    }
+
+    iniciar_escrita(buffer);
+    if (buffer->regiao != NULL)
+    {
+        if (saida.tamanho > buffer->tamanho)
+            garantir_capacidade(buffer, saida.tamanho - buffer->tamanho);
+        memcpy(buffer->texto, saida.texto, saida.tamanho);
+        liberar_texto(saida.texto, saida.capacidade);
+    }
+    else
+    {
+        aposentar(buffer, buffer->texto, buffer->capacidade);
+        buffer->texto = saida.texto;
+        buffer->capacidade = saida.capacidade;
     }
+    buffer->tamanho = saida.tamanho;
+    buffer->cursor = dentro ? novo_cursor : cursor + ganho - perda;
+    buffer->versao++;
+    terminar_escrita(buffer);
+
+    return quantidade;
 }
 
 /**
@@ -224,12 +961,905 @@ void apagar_caractere (bufferTAD buffer)
 
 void exibir_buffer (bufferTAD buffer)
 {
-    for (int i = 0; i < buffer->tamanho; i++)
+    aplicar_pendentes(buffer);
+    for (size_t i = 0; i < buffer->tamanho; i++)
         printf(" %c", buffer->texto[i]);
 
     printf("\n");
 
-    for (int i = 0; i < buffer->cursor; i++)
+    for (size_t i = 0; i < buffer->cursor; i++)
         printf("  ");
     printf("^\n");
 }
+
+/**
+ * Procedimentos: iniciar_transacao, confirmar_transacao
+ * Uso: iniciar_transacao(buffer);
+ *      . . .
+ *      confirmar_transacao(buffer);
+ * -----------------------------------------------------
+ * A transação aberta fica em "transacao". Na confirmação, as edições
+ * pendentes são aplicadas por "aplicar_pendentes", e a transação passa a ser
+ * o registro para desfazer, junto com a versão do buffer naquele momento.
+ */
+
+void iniciar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+
+    if (buffer->transacao != NULL)
+        aninhar_transacao(buffer->transacao);
+    else
+        buffer->transacao = criar_transacao();
+}
+
+void confirmar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao == NULL)
+    {
+        fprintf(stderr, "Erro: nenhuma transação aberta.\n");
+        return;
+    }
+    else if (desaninhar_transacao(buffer->transacao))
+        return;
+
+    aplicar_pendentes(buffer);
+    liberar_transacao(&buffer->desfazer);
+    buffer->desfazer = buffer->transacao;
+    buffer->transacao = NULL;
+    buffer->versao_desfazer = buffer->versao;
+}
+
+/**
+ * Predicado: desfazer_transacao
+ * Uso: if (desfazer_transacao(buffer)) . . .
+ * ------------------------------------------
+ * A versão guardada na confirmação diz se o buffer foi alterado depois dela.
+ * As edições inversas são feitas com as operações comuns do buffer.
+ */
+
+bool desfazer_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: desfazer em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao != NULL || buffer->desfazer == NULL ||
+             buffer->versao != buffer->versao_desfazer)
+        return FALSE;
+
+    transacaoTAD desfazer = buffer->desfazer;
+    buffer->desfazer = NULL;
+    bool desfeita = reverter_transacao(desfazer, buffer);
+    liberar_transacao(&desfazer);
+    return desfeita;
+}
+
+/**
+ * Procedimento: ativar_leitura_concorrente
+ * Uso: ativar_leitura_concorrente(buffer);
+ * ----------------------------------------
+ * Apenas liga o modo: a partir daí as alterações passam pelo contador de
+ * sequência e os arrays substituídos são aposentados.
+ */
+
+void ativar_leitura_concorrente (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: leitura concorrente em buffer null.\n");
+        exit(1);
+    }
+
+    buffer->concorrente = TRUE;
+}
+
+/**
+ * Funções: ler_tamanho, ler_cursor, ler_versao, ler_texto
+ * Uso: n = ler_tamanho(buffer);
+ *      p = ler_cursor(buffer);
+ *      v = ler_versao(buffer);
+ *      n = ler_texto(buffer, inicio, n, destino, &versao);
+ * --------------------------------------------------------
+ * Fazem uma leitura concorrente com "ler" e retornam o que foi pedido.
+ */
+
+size_t ler_tamanho (bufferTAD buffer)
+{
+    leituraT leitura;
+    ler(buffer, 0, 0, NULL, &leitura);
+    return leitura.tamanho;
+}
+
+size_t ler_cursor (bufferTAD buffer)
+{
+    leituraT leitura;
+    ler(buffer, 0, 0, NULL, &leitura);
+    return leitura.cursor;
+}
+
+unsigned long ler_versao (bufferTAD buffer)
+{
+    leituraT leitura;
+    ler(buffer, 0, 0, NULL, &leitura);
+    return leitura.versao;
+}
+
+size_t ler_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[],
+                  unsigned long *versao)
+{
+    leituraT leitura;
+    ler(buffer, inicio, n, destino, &leitura);
+    if (versao != NULL)
+        *versao = leitura.versao;
+    return leitura.copiados;
+}
+
+/**
+ * Procedimento: obter_metricas_leitura
+ * Uso: obter_metricas_leitura(buffer, &metricas);
+ * -----------------------------------------------
+ * Copia os contadores; "naposentados" só é alterado pela escritora, e deve
+ * ser consultado por ela.
+ */
+
+void obter_metricas_leitura (bufferTAD buffer, metricas_leituraT *metricas)
+{
+    if (buffer == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: métricas de buffer null.\n");
+        exit(1);
+    }
+
+    metricas->releituras = atomic_load(&buffer->releituras);
+    metricas->aposentados = buffer->naposentados;
+    metricas->liberados = atomic_load(&buffer->liberados);
+}
+
+/**
+ * Função: compartilhar_buffer
+ * Uso: if (compartilhar_buffer(buffer, nome, limite)) . . .
+ * ---------------------------------------------------------
+ * Cria a região (substituindo uma região antiga com o mesmo nome, que pode
+ * ter sobrado de um editor encerrado sem liberar o buffer), com espaço para o
+ * texto atual, mapeia a região inteira e preenche o cabeçalho. O texto é
+ * copiado para a região uma única vez; o array antigo é aposentado. O contador
+ * do cabeçalho nasce ímpar e fica par no "terminar_escrita" que encerra a
+ * troca do array.
+ */
+
+bool compartilhar_buffer (bufferTAD buffer, string nome, size_t limite)
+{
+    if (buffer == NULL || nome == NULL)
+    {
+        fprintf(stderr, "Erro: compartilhamento de buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->regiao != NULL)
+    {
+        fprintf(stderr, "Erro: o buffer já está compartilhado.\n");
+        return FALSE;
+    }
+
+    aplicar_pendentes(buffer);
+    size_t capacidade = buffer->capacidade;
+    if (capacidade > limite)
+        capacidade = limite;
+    if (limite == 0 || buffer->tamanho > limite)
+    {
+        fprintf(stderr, "Erro: o buffer não cabe no limite da região.\n");
+        return FALSE;
+    }
+
+    char *copia_nome = malloc(strlen(nome) + 1);
+    shm_unlink(nome);
+    int fd = shm_open(nome, O_CREAT | O_EXCL | O_RDWR, 0644);
+    void *mapa = MAP_FAILED;
+    if (copia_nome != NULL && fd >= 0 &&
+        ftruncate(fd, CABECALHO_VISOR + capacidade) == 0)
+        mapa = mmap(NULL, CABECALHO_VISOR + limite, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+    if (mapa == MAP_FAILED)
+    {
+        fprintf(stderr, "Erro: impossível criar a região %s.\n", nome);
+        if (fd >= 0)
+        {
+            close(fd);
+            shm_unlink(nome);
+        }
+        free(copia_nome);
+        return FALSE;
+    }
+    strcpy(copia_nome, nome);
+
+    cabecalho_visorT *c = mapa;
+    c->magico = MAGICO_VISOR;
+    c->formato = FORMATO_VISOR;
+    atomic_init(&c->sequencia, 1);
+    c->limite = limite;
+    c->capacidade = capacidade;
+    memcpy((char *) mapa + CABECALHO_VISOR, buffer->texto, buffer->tamanho);
+
+    iniciar_escrita(buffer);
+    aposentar(buffer, buffer->texto, buffer->capacidade);
+    buffer->texto = (char *) mapa + CABECALHO_VISOR;
+    buffer->capacidade = capacidade;
+    buffer->regiao = c;
+    buffer->nome_regiao = copia_nome;
+    buffer->descritor = fd;
+    terminar_escrita(buffer);
+
+    return TRUE;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Procedimento: garantir_capacidade
+ * Uso: garantir_capacidade(buffer, n);
+ * ------------------------------------
+ * Garante que o array do buffer tem espaço para mais "n" caracteres, dobrando a
+ * capacidade (quantas vezes for necessário) e realocando o array. No modo de
+ * leitura concorrente o array não pode ser realocado (uma leitora pode estar
+ * lendo o antigo): o texto é copiado para um novo array e o antigo é
+ * aposentado. Em um buffer compartilhado, apenas a região cresce, até o seu
+ * limite. Se o buffer não puder crescer, termina o programa com um erro de
+ * buffer overflow.
+ */
+
+static void garantir_capacidade (bufferTAD buffer, size_t n)
+{
+    if (n > SIZE_MAX / 2 - buffer->tamanho)
+    {
+        fprintf(stderr, "Erro: buffer overflow.\n");
+        exit(1);
+    }
+    else if (buffer->tamanho + n <= buffer->capacidade)
+        return;
+
+    size_t nova = buffer->capacidade;
+    while (nova < buffer->tamanho + n)
+        nova *= 2;
+
+    if (buffer->regiao != NULL)
+    {
+        if (nova > buffer->regiao->limite)
+            nova = buffer->regiao->limite;
+        if (nova < buffer->tamanho + n ||
+            ftruncate(buffer->descritor, CABECALHO_VISOR + nova) != 0)
+        {
+            fprintf(stderr, "Erro: buffer overflow.\n");
+            exit(1);
+        }
+        buffer->capacidade = nova;
+        buffer->regiao->capacidade = nova;
+        return;
+    }
+
+    char *texto = buffer->concorrente ?
+                  alocar_texto(nova) :
+                  realocar_texto(buffer->texto, buffer->capacidade,
+                                 buffer->tamanho, nova);
+    if (texto == NULL)
+    {
+        fprintf(stderr, "Erro: buffer overflow.\n");
+        exit(1);
+    }
+
+    if (buffer->concorrente)
+    {
+        memcpy(texto, buffer->texto, buffer->tamanho);
+        aposentar(buffer, buffer->texto, buffer->capacidade);
+    }
+    buffer->texto = texto;
+    buffer->capacidade = nova;
+}
+
+/**
+ * Procedimentos: iniciar_escrita, terminar_escrita
+ * Uso: iniciar_escrita(buffer);
+ *      . . .
+ *      terminar_escrita(buffer);
+ * ------------------------------------------------
+ * No modo de leitura concorrente, tornam o contador de sequência ímpar antes
+ * de uma alteração e par depois dela (e o mesmo com o contador do cabeçalho,
+ * se o buffer for compartilhado). A barreira após o contador ímpar impede
+ * que as escritas da alteração sejam vistas antes dele, e a escrita com
+ * "release" do contador par impede que sejam vistas depois. Ao terminar, a
+ * escritora aproveita para liberar os arrays aposentados que ninguém mais lê.
+ */
+
+static void iniciar_escrita (bufferTAD buffer)
+{
+    if (buffer->regiao != NULL)
+    {
+        cabecalho_visorT *c = buffer->regiao;
+        unsigned s = atomic_load_explicit(&c->sequencia, memory_order_relaxed);
+        atomic_store_explicit(&c->sequencia, s + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+    if (buffer->concorrente)
+    {
+        unsigned s = atomic_load_explicit(&buffer->sequencia,
+                                          memory_order_relaxed);
+        atomic_store_explicit(&buffer->sequencia, s + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+    }
+}
+
+static void terminar_escrita (bufferTAD buffer)
+{
+    if (buffer->regiao != NULL)
+    {
+        cabecalho_visorT *c = buffer->regiao;
+        c->tamanho = buffer->tamanho;
+        c->cursor = buffer->cursor;
+        c->versao = buffer->versao;
+        unsigned s = atomic_load_explicit(&c->sequencia, memory_order_relaxed);
+        atomic_store_explicit(&c->sequencia, s + 1, memory_order_release);
+    }
+    if (buffer->concorrente)
+    {
+        unsigned s = atomic_load_explicit(&buffer->sequencia,
+                                          memory_order_relaxed);
+        atomic_store_explicit(&buffer->sequencia, s + 1, memory_order_release);
+        if (buffer->aposentados != NULL)
+            recolher(buffer);
+    }
+}
+
+/**
+ * Procedimento: aposentar
+ * Uso: aposentar(buffer, texto, capacidade);
+ * ------------------------------
+ * Fora do modo concorrente, libera o array. No modo concorrente, guarda o
+ * array na lista de aposentados com o número da época atual e avança a época:
+ * uma leitora que anunciar a nova época (ou uma posterior) já começou depois
+ * da troca do array e não pode estar lendo o antigo.
+ */
+
+static void aposentar (bufferTAD buffer, char *texto, size_t capacidade)
+{
+    if (!buffer->concorrente)
+    {
+        liberar_texto(texto, capacidade);
+        return;
+    }
+
+    aposentadoT *a = malloc(sizeof(aposentadoT));
+    if (a == NULL)
+    {
+        fprintf(stderr, "Erro: impossível aposentar o array do buffer.\n");
+        exit(1);
+    }
+    a->texto = texto;
+    a->capacidade = capacidade;
+    a->epoca = atomic_fetch_add(&epoca_global, 1);
+    a->proximo = buffer->aposentados;
+    buffer->aposentados = a;
+    buffer->naposentados++;
+}
+
+/**
+ * Procedimento: recolher
+ * Uso: recolher(buffer);
+ * ----------------------
+ * Procura a menor época anunciada pelas leitoras que estão lendo e libera os
+ * arrays aposentados em uma época anterior a ela. A barreira completa garante
+ * que a troca do array seja vista pelas leitoras que ainda não anunciaram a
+ * sua época, ou que a escritora veja o anúncio delas.
+ */
+
+static void recolher (bufferTAD buffer)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    unsigned long long minima = ULLONG_MAX;
+    for (int i = 0; i < MAXLEITORAS; i++)
+    {
+        unsigned long long e = atomic_load(&leitoras[i].epoca);
+        if (e != 0 && e < minima)
+            minima = e;
+    }
+
+    aposentadoT **a = &buffer->aposentados;
+    while (*a != NULL)
+    {
+        if ((*a)->epoca < minima)
+        {
+            aposentadoT *livre = *a;
+            *a = livre->proximo;
+            liberar_texto(livre->texto, livre->capacidade);
+            free(livre);
+            atomic_fetch_add_explicit(&buffer->liberados, 1,
+                                      memory_order_relaxed);
+        }
+        else
+            a = &(*a)->proximo;
+    }
+}
+
+/**
+ * Procedimento: ler
+ * Uso: ler(buffer, inicio, n, destino, &leitura);
+ * -----------------------------------------------
+ * Faz uma leitura concorrente: dentro da sua época, anota o contador de
+ * sequência (esperando enquanto for ímpar), lê os campos do buffer e confere
+ * o contador antes de usá-los (para não copiar de um array com um tamanho de
+ * outra versão); depois copia o trecho e confere o contador de novo. Se o
+ * contador mudou, tudo é refeito. Durante uma escrita a leitora cede o
+ * processador, para não disputá-lo com a escritora.
+ */
+
+static void ler (bufferTAD buffer, size_t inicio, size_t n, char destino[],
+                 leituraT *leitura)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: leitura de buffer null.\n");
+        exit(1);
+    }
+    else if (!buffer->concorrente)
+    {
+        fprintf(stderr, "Erro: leitura concorrente não ativada.\n");
+        exit(1);
+    }
+
+    entrar_na_epoca();
+    while (TRUE)
+    {
+        unsigned s = atomic_load_explicit(&buffer->sequencia,
+                                          memory_order_acquire);
+        if (s % 2 == 1)
+        {
+            sched_yield();
+            continue;
+        }
+
+        const char *texto = buffer->texto;
+        leitura->tamanho = buffer->tamanho;
+        leitura->cursor = buffer->cursor;
+        leitura->versao = buffer->versao;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&buffer->sequencia, memory_order_relaxed) != s)
+        {
+            atomic_fetch_add_explicit(&buffer->releituras, 1,
+                                      memory_order_relaxed);
+            continue;
+        }
+
+        leitura->copiados = 0;
+        if (n > 0 && inicio < leitura->tamanho)
+        {
+            leitura->copiados = leitura->tamanho - inicio;
+            if (leitura->copiados > n)
+                leitura->copiados = n;
+            memcpy(destino, texto + inicio, leitura->copiados);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&buffer->sequencia, memory_order_relaxed) == s)
+            break;
+        atomic_fetch_add_explicit(&buffer->releituras, 1, memory_order_relaxed);
+    }
+    sair_da_epoca();
+}
+
+/**
+ * Procedimentos: entrar_na_epoca, sair_da_epoca
+ * Uso: entrar_na_epoca( );
+ *      . . .
+ *      sair_da_epoca( );
+ * ----------------------------------------------
+ * Anunciam e retiram a época da thread leitora. Na primeira leitura, a thread
+ * pega uma posição livre da tabela de épocas (com uma troca atômica) e a
+ * registra na chave "chave_leitora", para que seja devolvida quando a thread
+ * terminar. O anúncio é seguido de uma barreira completa, que faz par com a
+ * de "recolher".
+ */
+
+static void entrar_na_epoca (void)
+{
+    if (leitora_da_thread < 0)
+    {
+        pthread_once(&chave_criada, criar_chave_leitora);
+        for (int i = 0; i < MAXLEITORAS && leitora_da_thread < 0; i++)
+        {
+            int livre = 0;
+            if (atomic_compare_exchange_strong(&leitoras[i].ocupada, &livre, 1))
+                leitora_da_thread = i;
+        }
+        if (leitora_da_thread < 0)
+        {
+            fprintf(stderr, "Erro: mais de %d threads leitoras.\n",
+                    MAXLEITORAS);
+            exit(1);
+        }
+        pthread_setspecific(chave_leitora,
+                            (void *) (intptr_t) (leitora_da_thread + 1));
+    }
+
+    atomic_store(&leitoras[leitora_da_thread].epoca,
+                 atomic_load(&epoca_global));
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static void sair_da_epoca (void)
+{
+    atomic_store_explicit(&leitoras[leitora_da_thread].epoca, 0,
+                          memory_order_release);
+}
+
+/**
+ * Procedimentos: criar_chave_leitora, devolver_leitora
+ * Uso: pthread_once(&chave_criada, criar_chave_leitora);
+ * ------------------------------------------------------
+ * Criam a chave das threads leitoras e devolvem a posição da tabela de épocas
+ * quando uma thread leitora termina.
+ */
+
+static void criar_chave_leitora (void)
+{
+    pthread_key_create(&chave_leitora, devolver_leitora);
+}
+
+static void devolver_leitora (void *posicao)
+{
+    int i = (int) (intptr_t) posicao - 1;
+    atomic_store(&leitoras[i].epoca, 0);
+    atomic_store(&leitoras[i].ocupada, 0);
+}
+
+/**
+ * Função: tabela_falhas
+ * Uso: falhas = tabela_falhas(padrao, n);
+ * ---------------------------------------
+ * Retorna a tabela de falhas de Knuth-Morris-Pratt do padrão: falhas[k] é o
+ * tamanho do maior prefixo de padrao[0..k] que também é sufixo de
+ * padrao[1..k]. Termina o programa se não houver memória.
+ */
+
+static size_t *tabela_falhas (const char *padrao, size_t n)
+{
+    size_t *falhas = malloc(n * sizeof(size_t));
+    if (falhas == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar tabela de busca.\n");
+        exit(1);
+    }
+
+    falhas[0] = 0;
+    for (size_t k = 1, j = 0; k < n; k++)
+    {
+        while (j > 0 && padrao[k] != padrao[j])
+            j = falhas[j - 1];
+        if (padrao[k] == padrao[j])
+            j++;
+        falhas[k] = j;
+    }
+
+    return falhas;
+}
+
+/**
+ * Procedimento: anexar
+ * Uso: anexar(&saida, texto, n);
+ * ------------------------------
+ * Acrescenta "n" caracteres ao final da saída, dobrando a capacidade do array
+ * quando necessário. Termina o programa com um erro de buffer overflow se o
+ * array não puder crescer.
+ */
+
+static void anexar (saidaT *saida, const char *texto, size_t n)
+{
+    if (saida->texto != NULL && n > 0)
+    {
+        if (n > SIZE_MAX / 2 - saida->tamanho)
+        {
+            fprintf(stderr, "Erro: buffer overflow.\n");
+            exit(1);
+        }
+        if (saida->tamanho + n > saida->capacidade)
+        {
+            size_t nova = saida->capacidade;
+            while (nova < saida->tamanho + n)
+                nova *= 2;
+
+            char *maior = realocar_texto(saida->texto, saida->capacidade,
+                                         saida->tamanho, nova);
+            if (maior == NULL)
+            {
+                fprintf(stderr, "Erro: buffer overflow.\n");
+                exit(1);
+            }
+            saida->texto = maior;
+            saida->capacidade = nova;
+        }
+        memcpy(saida->texto + saida->tamanho, texto, n);
+    }
+    saida->tamanho += n;
+}
+
+/**
+ * Função: alocar_texto
+ * Uso: texto = alocar_texto(capacidade);
+ * --------------------------------------
+ * Aloca um array de texto: com malloc, se a capacidade for menor do que
+ * TEXTO_GRANDE, ou com um mapeamento anônimo, de preferência de páginas
+ * enormes. Retorna NULL se não houver memória.
+ */
+
+static char *alocar_texto (size_t capacidade)
+{
+    if (capacidade < TEXTO_GRANDE)
+        return malloc(capacidade);
+
+    size_t n = tamanho_mapeado(capacidade);
+    void *mapa = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    mapa = mmap(NULL, n, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (mapa == MAP_FAILED)
+    {
+        mapa = mmap(NULL, n, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapa == MAP_FAILED)
+            return NULL;
+#ifdef MADV_HUGEPAGE
+        madvise(mapa, n, MADV_HUGEPAGE);
+#endif
+    }
+    return mapa;
+}
+
+/**
+ * Função: realocar_texto
+ * Uso: texto = realocar_texto(texto, capacidade, usados, nova);
+ * -------------------------------------------------------------
+ * Aumenta um array de texto para a capacidade "nova", preservando os "usados"
+ * primeiros caracteres: com realloc, entre arrays pequenos; com mremap, entre
+ * arrays mapeados; ou alocando o novo array e copiando. Retorna NULL, sem
+ * alterar o array antigo, se não houver memória.
+ */
+
+static char *realocar_texto (char *texto, size_t capacidade, size_t usados,
+                             size_t nova)
+{
+    if (nova < TEXTO_GRANDE)
+        return realloc(texto, nova);
+
+#ifdef MREMAP_MAYMOVE
+    if (capacidade >= TEXTO_GRANDE)
+    {
+        void *mapa = mremap(texto, tamanho_mapeado(capacidade),
+                            tamanho_mapeado(nova), MREMAP_MAYMOVE);
+        if (mapa != MAP_FAILED)
+            return mapa;
+    }
+#endif
+
+    char *novo = alocar_texto(nova);
+    if (novo == NULL)
+        return NULL;
+    memcpy(novo, texto, usados);
+    liberar_texto(texto, capacidade);
+    return novo;
+}
+
+/**
+ * Procedimento: liberar_texto
+ * Uso: liberar_texto(texto, capacidade);
+ * --------------------------------------
+ * Libera um array obtido de alocar_texto ou realocar_texto com a capacidade
+ * informada.
+ */
+
+static void liberar_texto (char *texto, size_t capacidade)
+{
+    if (texto == NULL)
+        return;
+    if (capacidade < TEXTO_GRANDE)
+        free(texto);
+    else
+        munmap(texto, tamanho_mapeado(capacidade));
+}
+
+/**
+ * Função: tamanho_mapeado
+ * Uso: n = tamanho_mapeado(capacidade);
+ * -------------------------------------
+ * Retorna a capacidade arredondada para um múltiplo de PAGINA_ENORME.
+ */
+
+static size_t tamanho_mapeado (size_t capacidade)
+{
+    return (capacidade + PAGINA_ENORME - 1) / PAGINA_ENORME * PAGINA_ENORME;
+}
+
+/**
+ * Funções: avancar_ate, recuar_ate
+ * Uso: p = avancar_ate(buffer, posicao, classe);
+ *      p = recuar_ate(buffer, posicao, classe);
+ * ----------------------------------------------
+ * "avancar_ate" retorna a posição do primeiro caractere da classe a partir de
+ * "posicao" (ou o tamanho do buffer, se não houver um); "recuar_ate" retorna a
+ * posição logo após o último caractere da classe antes de "posicao" (ou 0). O
+ * '\n' seguinte é procurado com memchr; os demais casos percorrem o array.
+ */
+
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    const char *texto = buffer->texto;
+    size_t n = buffer->tamanho;
+
+    if (classe == QUEBRA && posicao < n)
+    {
+        const char *q = memchr(texto + posicao, '\n', n - posicao);
+        return (q != NULL) ? (size_t) (q - texto) : n;
+    }
+    while (posicao < n && !pertence(texto[posicao], classe))
+        posicao++;
+    return posicao;
+}
+
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    const char *texto = buffer->texto;
+
+    while (posicao > 0 && !pertence(texto[posicao - 1], classe))
+        posicao--;
+    return posicao;
+}
+
+/**
+ * Predicado: pertence
+ * Uso: if (pertence(c, classe)) . . .
+ * -----------------------------------
+ * Retorna TRUE se o caractere "c" é da classe "classe". Os caracteres de
+ * palavra são testados por intervalos, sem consultar a localidade, para que os
+ * laços de busca fiquem simples o bastante para serem vetorizados.
+ */
+
+static bool pertence (char c, classeT classe)
+{
+    unsigned char u = (unsigned char) c;
+    bool palavra = (unsigned) ((u | 0x20) - 'a') < 26 ||
+                   (unsigned) (u - '0') < 10 || u == '_' || u >= 0x80;
+
+    switch (classe)
+    {
+    case QUEBRA: return c == '\n';
+    case TEXTO: return c != '\n';
+    case PALAVRA: return palavra;
+    default: return !palavra;
+    }
+}
+
+/**
+ * Predicado: registrar
+ * Uso: if (registrar(buffer, texto, n, apagar)) return;
+ * -----------------------------------------------------
+ * Se há uma transação aberta, registra nela a inserção dos "n" caracteres de
+ * "texto" ou a remoção de "apagar" caracteres após o cursor e retorna TRUE;
+ * senão, retorna FALSE, e a edição deve ser feita no buffer.
+ */
+
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar)
+{
+    if (buffer->transacao == NULL)
+        return FALSE;
+
+    sincronizar_transacao(buffer->transacao, tamanho_buffer(buffer),
+                          posicao_cursor(buffer));
+    if (n > 0 ? !registrar_insercao(buffer->transacao, texto, n)
+              : !registrar_remocao(buffer->transacao, apagar))
+        fprintf(stderr, "Erro: impossível registrar a edição.\n");
+    return TRUE;
+}
+
+/**
+ * Predicado: mover_na_transacao
+ * Uso: if (mover_na_transacao(buffer, posicao)) return;
+ * -----------------------------------------------------
+ * Se há edições pendentes, move o cursor da transação e retorna TRUE; senão,
+ * retorna FALSE, e o cursor do buffer deve ser movido.
+ */
+
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao)
+{
+    if (!transacao_pendente(buffer->transacao))
+        return FALSE;
+
+    mover_cursor_da_transacao(buffer->transacao, posicao);
+    return TRUE;
+}
+
+/**
+ * Procedimento: aplicar_pendentes
+ * Uso: aplicar_pendentes(buffer);
+ * -------------------------------
+ * Aplica as edições pendentes da transação, se houver, em uma única passagem
+ * pelo array. Depois de guardar o texto que cada trecho remove (para desfazer),
+ * as partes não alteradas que vão para a esquerda são movidas da esquerda para
+ * a direita, e as que vão para a direita, da direita para a esquerda, de modo
+ * que nenhuma sobrescreve outra ainda não movida; por último, os textos
+ * inseridos são copiados para os seus lugares. Cada caractere é movido no
+ * máximo uma vez, quaisquer que sejam as edições.
+ */
+
+static void aplicar_pendentes (bufferTAD buffer)
+{
+    transacaoTAD T = buffer->transacao;
+    if (!transacao_pendente(T))
+        return;
+
+    size_t n = quantidade_de_trechos(T), tamanho = tamanho_da_transacao(T);
+    size_t inseridos = 0, removidos = 0, de, ate;
+    trechoT t;
+
+    iniciar_escrita(buffer);
+    if (tamanho > buffer->tamanho)
+        garantir_capacidade(buffer, tamanho - buffer->tamanho);
+    char *texto = buffer->texto;
+
+    for (size_t k = 0; k < n; k++)
+    {
+        t = trecho_da_transacao(T, k);
+        guardar_para_desfazer(T, t.inicio + inseridos - removidos, t.inseridos,
+                              texto + t.inicio, t.removidos);
+        inseridos += t.inseridos;
+        removidos += t.removidos;
+    }
+
+    inseridos = removidos = 0;
+    for (size_t k = 0; k < n; k++)
+    {
+        t = trecho_da_transacao(T, k);
+        inseridos += t.inseridos;
+        removidos += t.removidos;
+        de = t.inicio + t.removidos;
+        ate = (k + 1 < n) ? trecho_da_transacao(T, k + 1).inicio
+                          : buffer->tamanho;
+        if (removidos > inseridos)
+            memmove(texto + de - (removidos - inseridos), texto + de, ate - de);
+    }
+
+    ate = buffer->tamanho;
+    for (size_t k = n; k-- > 0; )
+    {
+        t = trecho_da_transacao(T, k);
+        de = t.inicio + t.removidos;
+        if (inseridos > removidos)
+            memmove(texto + de + (inseridos - removidos), texto + de, ate - de);
+        inseridos -= t.inseridos;
+        removidos -= t.removidos;
+        ate = t.inicio;
+    }
+
+    for (size_t k = 0; k < n; k++)
+    {
+        t = trecho_da_transacao(T, k);
+        if (t.inseridos > 0)
+            memcpy(texto + t.inicio + inseridos - removidos, t.texto,
+                   t.inseridos);
+        inseridos += t.inseridos;
+        removidos += t.removidos;
+    }
+
+    buffer->tamanho = tamanho;
+    buffer->cursor = cursor_da_transacao(T);
+    buffer->versao++;
+    terminar_escrita(buffer);
+    concluir_aplicacao(T);
+}
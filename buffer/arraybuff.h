@@ -0,0 +1,137 @@
+/**
+ * Arquivo: arraybuff.h
+ * Versão : 1.1
+ * Data   : 2026-10-18 22:50
+ * -------------------------
+ * Este arquivo define as extensões da interface buffer.h que só existem na
+ * implementação arraybuff.c, na qual o texto é armazenado em um único array.
+ *
+ * A extensão é um modo de leitura concorrente: depois de ativado, uma thread
+ * (a escritora, por exemplo a aplicadora de aplicador.h) continua usando as
+ * operações de buffer.h normalmente, e qualquer quantidade de outras threads
+ * (as leitoras) pode consultar o tamanho, o cursor, a versão e trechos do
+ * texto ao mesmo tempo, sem nenhuma trava.
+ *
+ * Cada alteração do buffer é envolvida por um contador de sequência (um
+ * "seqlock"): a escritora o torna ímpar antes de alterar e par depois. A
+ * leitora anota o contador, lê o que precisa e confere o contador de novo; se
+ * ele mudou (ou era ímpar), a leitura é descartada e refeita. As leituras
+ * nunca atrasam a escritora.
+ *
+ * Uma leitora pode estar lendo o array antigo no momento em que a escritora o
+ * troca por um maior. Por isso, no modo concorrente, a escritora não libera o
+ * array antigo: ele é "aposentado" com o número da época atual, e a época é
+ * avançada. Cada leitora anuncia a época em que começou a ler, e um array
+ * aposentado só é liberado quando nenhuma leitora anunciou uma época igual ou
+ * anterior à da sua aposentadoria (reclamação baseada em épocas).
+ *
+ * O buffer também pode ser publicado em memória compartilhada, para que
+ * outros processos o leiam sem cópias, com a interface visor.h.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _ARRAYBUFF_H
+#define _ARRAYBUFF_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: metricas_leituraT
+ * -----------------------
+ * Métricas do modo de leitura concorrente:
+ *
+ *     releituras    leituras descartadas e refeitas por causa de uma escrita
+ *     aposentados   arrays aposentados pela escritora
+ *     liberados     arrays aposentados que já foram liberados
+ */
+
+typedef struct
+{
+    unsigned long long releituras;
+    unsigned long long aposentados;
+    unsigned long long liberados;
+} metricas_leituraT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * PROCEDIMENTO: ativar_leitura_concorrente
+ * Uso: ativar_leitura_concorrente(buffer);
+ * ----------------------------------------
+ * Liga o modo de leitura concorrente do buffer, que fica ligado até o buffer
+ * ser liberado. Deve ser chamado antes de as leitoras começarem a ler; a
+ * partir daí, apenas uma thread pode alterar o buffer, e o buffer só pode ser
+ * liberado depois que as leitoras terminarem.
+ */
+
+void ativar_leitura_concorrente (bufferTAD buffer);
+
+/**
+ * FUNÇÕES: ler_tamanho, ler_cursor, ler_versao
+ * Uso: n = ler_tamanho(buffer);
+ *      p = ler_cursor(buffer);
+ *      v = ler_versao(buffer);
+ * ---------------------------------------------
+ * Equivalentes a tamanho_buffer, posicao_cursor e versao_buffer, mas podem ser
+ * chamadas por qualquer thread enquanto a escritora altera o buffer.
+ */
+
+size_t ler_tamanho (bufferTAD buffer);
+size_t ler_cursor (bufferTAD buffer);
+unsigned long ler_versao (bufferTAD buffer);
+
+/**
+ * FUNÇÃO: ler_texto
+ * Uso: n = ler_texto(buffer, inicio, n, destino, &versao);
+ * --------------------------------------------------------
+ * Equivalente a copiar_texto, mas pode ser chamada por qualquer thread
+ * enquanto a escritora altera o buffer. O trecho copiado é sempre o de uma
+ * única versão do buffer, cujo número é guardado em "versao" (se não for
+ * NULL). Retorna a quantidade de caracteres copiados.
+ */
+
+size_t ler_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[],
+                  unsigned long *versao);
+
+/**
+ * PROCEDIMENTO: obter_metricas_leitura
+ * Uso: obter_metricas_leitura(buffer, &metricas);
+ * -----------------------------------------------
+ * Copia para "metricas" as métricas do modo de leitura concorrente.
+ */
+
+void obter_metricas_leitura (bufferTAD buffer, metricas_leituraT *metricas);
+
+/**
+ * FUNÇÃO: compartilhar_buffer
+ * Uso: if (compartilhar_buffer(buffer, nome, limite)) . . .
+ * ---------------------------------------------------------
+ * Passa o texto do buffer para uma região de memória compartilhada com o nome
+ * "nome" (por exemplo "/meu_buffer"), que pode ser lida por outros processos
+ * com a interface visor.h. O texto nunca poderá ter mais do que "limite"
+ * caracteres; a região só ocupa memória para o texto que de fato existe. A
+ * região é removida quando o buffer é liberado. Retorna FALSE em caso de erro
+ * (o buffer continua como estava).
+ */
+
+bool compartilhar_buffer (bufferTAD buffer, string nome, size_t limite);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
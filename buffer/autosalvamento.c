@@ -0,0 +1,332 @@
+/**
+ * Arquivo: autosalvamento.c
+ * Versão : 1.0
+ * Data   : 2026-10-18 15:20
+ * -------------------------
+ * Este arquivo implementa a interface autosalvamento.h. A captura é uma cópia
+ * do texto do buffer, feita com "copiar_texto" no laço principal; a gravação
+ * (a parte lenta, que depende do disco) fica inteiramente com a thread
+ * gravadora. O array da captura é reaproveitado entre os salvamentos, e só é
+ * reescrito quando a gravadora está parada, de modo que as duas threads nunca
+ * usam a captura ao mesmo tempo. Para saber se o buffer mudou é usada a versão
+ * do buffer ("versao_buffer"), sem comparar o texto.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "autosalvamento.h"
+#include "buffer.h"
+#include "genlib.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: autosalvamentoTCD
+ * -----------------------
+ * Representação concreta do salvamento automático:
+ *
+ *     arquivo, temporario  nomes do arquivo de destino e do temporário
+ *     intervalo            intervalo mínimo entre salvamentos (ms)
+ *     captura              texto capturado, com "tamcaptura" caracteres em
+ *                          um array com capacidade "capcaptura"
+ *     versao_gravando      versão do buffer que está na captura
+ *     versao_salva         versão do buffer do último salvamento concluído
+ *     salvo                TRUE se já houve algum salvamento concluído
+ *     ultimo               instante da última verificação, em ms
+ *     inicio               instante do início da captura em gravação
+ *     ocupada              TRUE enquanto a gravadora trabalha na captura
+ *     encerrar             TRUE se a gravadora deve terminar
+ *     metricas             métricas acumuladas
+ *     trava, pedido        sincronização com a gravadora
+ */
+
+struct autosalvamentoTCD
+{
+    char *arquivo;
+    char *temporario;
+    int intervalo;
+    char *captura;
+    size_t tamcaptura;
+    size_t capcaptura;
+    unsigned long versao_gravando;
+    unsigned long versao_salva;
+    bool salvo;
+    double ultimo;
+    double inicio;
+    bool ocupada;
+    bool encerrar;
+    metricas_autosalvamentoT metricas;
+    pthread_mutex_t trava;
+    pthread_cond_t pedido;
+    pthread_t gravadora;
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void *gravar_capturas (void *arg);
+static bool gravar_captura (autosalvamentoTAD a);
+static double agora (void);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: iniciar_autosalvamento
+ * Uso: a = iniciar_autosalvamento(arquivo, intervalo);
+ * ----------------------------------------------------
+ * Aloca a estrutura, monta o nome do arquivo temporário ("<arquivo>.tmp") e
+ * cria a thread gravadora.
+ */
+
+autosalvamentoTAD iniciar_autosalvamento (string arquivo, int intervalo)
+{
+    autosalvamentoTAD A = calloc(1, sizeof(struct autosalvamentoTCD));
+    if (A == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar autosalvamento.\n");
+        return NULL;
+    }
+
+    A->arquivo = malloc(strlen(arquivo) + 1);
+    A->temporario = malloc(strlen(arquivo) + 5);
+    if (A->arquivo == NULL || A->temporario == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar autosalvamento.\n");
+        free(A->arquivo);
+        free(A->temporario);
+        free(A);
+        return NULL;
+    }
+    strcpy(A->arquivo, arquivo);
+    sprintf(A->temporario, "%s.tmp", arquivo);
+    A->intervalo = intervalo;
+    A->ultimo = agora();
+
+    pthread_mutex_init(&A->trava, NULL);
+    pthread_cond_init(&A->pedido, NULL);
+    pthread_create(&A->gravadora, NULL, gravar_capturas, A);
+
+    return A;
+}
+
+/**
+ * Função: autosalvar
+ * Uso: if (autosalvar(a, buffer)) . . .
+ * -------------------------------------
+ * Faz as verificações baratas primeiro (intervalo, versão, gravadora ocupada)
+ * e só então copia o texto do buffer para a captura.
+ */
+
+bool autosalvar (autosalvamentoTAD autosalvamento, bufferTAD buffer)
+{
+    if (autosalvamento == NULL || buffer == NULL)
+    {
+        fprintf(stderr, "Erro: autosalvamento ou buffer null.\n");
+        exit(1);
+    }
+
+    autosalvamentoTAD A = autosalvamento;
+    double t0 = agora();
+    if (t0 - A->ultimo < A->intervalo)
+        return FALSE;
+    A->ultimo = t0;
+
+    unsigned long versao = versao_buffer(buffer);
+    pthread_mutex_lock(&A->trava);
+    if (A->salvo && versao == A->versao_salva)
+    {
+        A->metricas.ignorados++;
+        pthread_mutex_unlock(&A->trava);
+        return FALSE;
+    }
+    else if (A->ocupada)
+    {
+        A->metricas.adiados++;
+        pthread_mutex_unlock(&A->trava);
+        return FALSE;
+    }
+    pthread_mutex_unlock(&A->trava);
+
+    size_t n = tamanho_buffer(buffer);
+    if (n > A->capcaptura)
+    {
+        char *captura = realloc(A->captura, n);
+        if (captura == NULL)
+        {
+            fprintf(stderr, "Erro: impossível alocar a captura.\n");
+            return FALSE;
+        }
+        A->captura = captura;
+        A->capcaptura = n;
+    }
+    A->tamcaptura = copiar_texto(buffer, 0, n, A->captura);
+
+    pthread_mutex_lock(&A->trava);
+    A->versao_gravando = versao;
+    A->inicio = t0;
+    A->metricas.captura_ultima = agora() - t0;
+    A->ocupada = TRUE;
+    pthread_cond_broadcast(&A->pedido);
+    pthread_mutex_unlock(&A->trava);
+
+    return TRUE;
+}
+
+/**
+ * Procedimento: obter_metricas_autosalvamento
+ * Uso: obter_metricas_autosalvamento(a, &metricas);
+ * -------------------------------------------------
+ * Copia as métricas sob a trava, pois a gravadora as atualiza.
+ */
+
+void obter_metricas_autosalvamento (autosalvamentoTAD autosalvamento,
+                                    metricas_autosalvamentoT *metricas)
+{
+    if (autosalvamento == NULL)
+    {
+        fprintf(stderr, "Erro: métricas de autosalvamento null.\n");
+        exit(1);
+    }
+
+    pthread_mutex_lock(&autosalvamento->trava);
+    *metricas = autosalvamento->metricas;
+    pthread_mutex_unlock(&autosalvamento->trava);
+}
+
+/**
+ * Procedimento: encerrar_autosalvamento
+ * Uso: encerrar_autosalvamento(&a);
+ * ---------------------------------
+ * Sinaliza o encerramento, espera a gravadora terminar e libera a memória.
+ */
+
+void encerrar_autosalvamento (autosalvamentoTAD *autosalvamento)
+{
+    if (autosalvamento == NULL || *autosalvamento == NULL)
+        return;
+
+    autosalvamentoTAD A = *autosalvamento;
+    pthread_mutex_lock(&A->trava);
+    A->encerrar = TRUE;
+    pthread_cond_broadcast(&A->pedido);
+    pthread_mutex_unlock(&A->trava);
+    pthread_join(A->gravadora, NULL);
+
+    pthread_mutex_destroy(&A->trava);
+    pthread_cond_destroy(&A->pedido);
+    free(A->captura);
+    free(A->arquivo);
+    free(A->temporario);
+    free(A);
+    *autosalvamento = NULL;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: gravar_capturas
+ * Uso: pthread_create(&gravadora, NULL, gravar_capturas, a);
+ * ----------------------------------------------------------
+ * Corpo da thread gravadora: espera uma captura, grava essa captura e
+ * registra as métricas. Uma captura entregue antes do encerramento é gravada
+ * antes de a thread terminar.
+ */
+
+static void *gravar_capturas (void *arg)
+{
+    autosalvamentoTAD A = arg;
+
+    pthread_mutex_lock(&A->trava);
+    while (TRUE)
+    {
+        while (!A->ocupada && !A->encerrar)
+            pthread_cond_wait(&A->pedido, &A->trava);
+        if (!A->ocupada)
+            break;
+        pthread_mutex_unlock(&A->trava);
+
+        bool ok = gravar_captura(A);
+        double latencia = agora() - A->inicio;
+
+        pthread_mutex_lock(&A->trava);
+        if (ok)
+        {
+            A->salvo = TRUE;
+            A->versao_salva = A->versao_gravando;
+            A->metricas.salvamentos++;
+            A->metricas.bytes += A->tamcaptura;
+            A->metricas.latencia_ultima = latencia;
+            A->metricas.latencia_total += latencia;
+            if (latencia > A->metricas.latencia_maxima)
+                A->metricas.latencia_maxima = latencia;
+        }
+        else
+            A->metricas.falhas++;
+        A->ocupada = FALSE;
+    }
+    pthread_mutex_unlock(&A->trava);
+
+    return NULL;
+}
+
+/**
+ * Função: gravar_captura
+ * Uso: if (gravar_captura(a)) . . .
+ * ---------------------------------
+ * Grava a captura no arquivo temporário, sincroniza o arquivo com o disco e o
+ * renomeia sobre o arquivo de destino, que assim nunca fica incompleto.
+ */
+
+static bool gravar_captura (autosalvamentoTAD A)
+{
+    FILE *arq = fopen(A->temporario, "wb");
+    if (arq == NULL)
+    {
+        fprintf(stderr, "Erro: impossível criar \"%s\".\n", A->temporario);
+        return FALSE;
+    }
+
+    bool ok = (fwrite(A->captura, 1, A->tamcaptura, arq) == A->tamcaptura);
+    ok = (fflush(arq) == 0) && ok;
+    ok = (fsync(fileno(arq)) == 0) && ok;
+    ok = (fclose(arq) == 0) && ok;
+    ok = ok && (rename(A->temporario, A->arquivo) == 0);
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: impossível salvar \"%s\".\n", A->arquivo);
+        remove(A->temporario);
+    }
+
+    return ok;
+}
+
+/**
+ * Função: agora
+ * Uso: t = agora( );
+ * ------------------
+ * Retorna o instante atual de um relógio monotônico, em milissegundos.
+ */
+
+static double agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
@@ -0,0 +1,121 @@
+/**
+ * Arquivo: autosalvamento.h
+ * Versão : 1.0
+ * Data   : 2026-10-18 15:20
+ * -------------------------
+ * Este arquivo define uma interface para o salvamento automático de um buffer
+ * em segundo plano. O laço principal do editor chama "autosalvar" depois de
+ * cada comando; quando o intervalo de salvamento passou e o buffer mudou desde
+ * o último salvamento, é feita uma captura (uma cópia instantânea do texto) e
+ * uma thread gravadora grava essa captura em um arquivo temporário, que depois
+ * é renomeado sobre o arquivo de destino. Enquanto isso o editor continua
+ * processando comandos normalmente.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _AUTOSALVAMENTO_H
+#define _AUTOSALVAMENTO_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: autosalvamentoTAD
+ * -----------------------
+ * Representa o salvamento automático de um buffer em um arquivo.
+ */
+
+typedef struct autosalvamentoTCD *autosalvamentoTAD;
+
+/**
+ * TIPO: metricas_autosalvamentoT
+ * ------------------------------
+ * Métricas acumuladas pelo salvamento automático (tempos em milissegundos):
+ *
+ *     salvamentos       quantidade de salvamentos concluídos
+ *     ignorados         pedidos ignorados porque o buffer não mudou
+ *     adiados           pedidos adiados porque ainda havia uma gravação
+ *     falhas            salvamentos que falharam
+ *     bytes             total de bytes gravados
+ *     captura_ultima    tempo da última captura (no laço principal)
+ *     latencia_ultima   tempo do último salvamento, da captura ao rename
+ *     latencia_maxima   maior tempo de salvamento observado
+ *     latencia_total    soma dos tempos de todos os salvamentos
+ */
+
+typedef struct
+{
+    unsigned long salvamentos;
+    unsigned long ignorados;
+    unsigned long adiados;
+    unsigned long falhas;
+    unsigned long long bytes;
+    double captura_ultima;
+    double latencia_ultima;
+    double latencia_maxima;
+    double latencia_total;
+} metricas_autosalvamentoT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: iniciar_autosalvamento
+ * Uso: a = iniciar_autosalvamento(arquivo, intervalo);
+ * ----------------------------------------------------
+ * Cria um salvamento automático para o arquivo "arquivo", com no mínimo
+ * "intervalo" milissegundos entre dois salvamentos, e inicia a thread
+ * gravadora. Retorna NULL em caso de erro.
+ */
+
+autosalvamentoTAD iniciar_autosalvamento (string arquivo, int intervalo);
+
+/**
+ * FUNÇÃO: autosalvar
+ * Uso: if (autosalvar(a, buffer)) . . .
+ * -------------------------------------
+ * Verifica se é hora de salvar o buffer e, se for, faz a captura e a entrega à
+ * thread gravadora, retornando TRUE. Nunca espera pela gravação: se o buffer
+ * não mudou, se o intervalo ainda não passou ou se a gravação anterior ainda
+ * não terminou, apenas retorna FALSE.
+ */
+
+bool autosalvar (autosalvamentoTAD autosalvamento, bufferTAD buffer);
+
+/**
+ * PROCEDIMENTO: obter_metricas_autosalvamento
+ * Uso: obter_metricas_autosalvamento(a, &metricas);
+ * -------------------------------------------------
+ * Copia as métricas atuais do salvamento automático para "metricas".
+ */
+
+void obter_metricas_autosalvamento (autosalvamentoTAD autosalvamento,
+                                    metricas_autosalvamentoT *metricas);
+
+/**
+ * PROCEDIMENTO: encerrar_autosalvamento
+ * Uso: encerrar_autosalvamento(&a);
+ * ---------------------------------
+ * Espera a gravação em andamento (se houver), encerra a thread gravadora e
+ * libera o salvamento automático. Note que o argumento é um PONTEIRO.
+ */
+
+void encerrar_autosalvamento (autosalvamentoTAD *autosalvamento);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -0,0 +1,4307 @@
+/**
+ * Arquivo: blocobuff.c
+ * Versão : 1.16
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo implementa as interfaces buffer.h e blocobuff.h utilizando uma
+ * lista duplamente encadeada de blocos, na qual cada bloco armazena até
+ * TAMBLOCO caracteres consecutivos do buffer. É um meio termo entre o array
+ * (arraybuff.c), que desloca o texto inteiro a cada inserção, e a lista
+ * encadeada de caracteres (lsebuff.c), que gasta uma célula por caractere: as
+ * inserções e remoções deslocam no máximo um bloco, e cada bloco é um trecho
+ * contíguo de memória.
+ *
+ * Os blocos ficam também em uma fila de acesso, do mais recente para o mais
+ * antigo. Quando a compressão está ligada, a cada operação os blocos do final
+ * da fila que ficaram fora da janela são comprimidos; um bloco comprimido sai
+ * da fila e volta para o início dela quando é descomprimido. A cópia e a
+ * exibição do texto leem um bloco comprimido sem descomprimi-lo de vez.
+ *
+ * Um arquivo aberto com "mapear_arquivo" é representado por blocos mapeados,
+ * de até TAMMAPA caracteres, cujos dados apontam diretamente para o
+ * mapeamento do arquivo. Antes de uma edição em um bloco mapeado, apenas o
+ * trecho em volta do cursor é copiado para um bloco comum ("materializar").
+ *
+ * O mapeamento é um caso de "armazém": uma área somente leitura, com contador
+ * de referências, compartilhada por blocos e por trechos copiados. Ao copiar
+ * um trecho, os blocos comuns envolvidos passam a ser compartilhados (o array
+ * do bloco vira um armazém, sem cópia), e colar um trecho apenas liga à lista
+ * novos blocos que apontam para os mesmos armazéns. Como os blocos
+ * compartilhados são tratados exatamente como os mapeados, a primeira edição
+ * em um deles copia só o trecho em volta do cursor (cópia na escrita).
+ *
+ * Um instantâneo ("gravar_instantaneo") grava a lista de blocos como ela está:
+ * um cabeçalho, o texto dos blocos em sequência e, no final, uma tabela com o
+ * tamanho, a quantidade de quebras de linha, o hash e a potência de cada
+ * bloco. A tabela fica no final porque as quebras de linha são contadas
+ * enquanto o texto é gravado; o cabeçalho é regravado por último, com o total
+ * de linhas. Para abrir o instantâneo, o arquivo é mapeado como em
+ * "mapear_arquivo" e cada entrada da tabela vira um bloco mapeado que já tem o
+ * seu hash: nada do texto é lido. O formato usa a ordem de bytes da máquina.
+ *
+ * Com um limite de memória (do buffer ou do processo), os blocos comuns do
+ * final da fila de acesso são despejados em um arquivo temporário quando o
+ * limite é ultrapassado: o bloco fica sem dados, como um bloco comprimido, e
+ * é recarregado do arquivo quando for acessado ("tocar"), ou apenas lido para
+ * o rascunho ("ler_bloco"). O arquivo é dividido em vagas de TAMBLOCO bytes,
+ * reaproveitadas quando os blocos voltam para a memória. Cada bloco conhece o
+ * buffer ao qual pertence, para que a memória seja contada sempre que um
+ * array de bloco é alocado ou liberado.
+ *
+ * Um buffer criado com criar_buffer_com_alocador obtém do alocador apenas a
+ * sua estrutura. Os blocos continuam usando malloc e free, pois carregam
+ * referências a armazéns e vagas de despejo e entram na contagem de memória
+ * do processo; liberar_buffer precisa visitá-los de qualquer forma.
+ *
+ * A comparação de dois buffers ("comparar_buffers") casa os blocos do buffer
+ * novo com blocos iguais do antigo por meio de uma tabela de hash dos blocos
+ * antigos, sempre em ordem crescente de posição; "regioes_alteradas" casa da
+ * mesma forma os blocos do buffer com os blocos guardados na assinatura. Os trechos entre os blocos
+ * casados (as "janelas") são lidos, divididos em linhas e comparados com a
+ * versão de espaço linear do algoritmo de Myers, que bissecta o problema pelo
+ * "meio" do caminho de edição. As janelas começam e terminam em fronteiras de
+ * blocos, de modo que a primeira e a última linha de uma janela podem ser
+ * pedaços de linha; isso só afeta a forma das edições, não o resultado.
+ *
+ * A busca de uma posição ("localizar") guarda o último bloco encontrado, de
+ * modo que leituras em sequência (como uma varredura do buffer inteiro com
+ * copiar_texto, em janelas) não percorram a lista desde o início a cada
+ * chamada. O bloco guardado só vale enquanto a versão do buffer e a lista de
+ * blocos não mudarem.
+ *
+ * As edições de uma transação (veja transacao.h) são aplicadas em ordem de
+ * posição, de uma só vez: cada bloco é materializado e dividido no máximo uma
+ * vez por trecho, e o cursor só anda para frente.
+ *
+ * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
+ *             Capítulo 9: Efficiency and ADTs.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+#define IMPLEMENTANDO_BUFFER
+
+#include "alocador.h"
+#include "blocobuff.h"
+#include "buffer.h"
+#include <errno.h>
+#include "genlib.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <time.h>
+#include "transacao.h"
+#include <unistd.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: TAMBLOCO, BASEHASH
+ * ------------------------------
+ * TAMBLOCO é a capacidade, em caracteres, de cada bloco, e BASEHASH é a base
+ * do hash polinomial dos blocos (um número ímpar, com aritmética módulo 2^64).
+ */
+
+#define TAMBLOCO 4096
+#define BASEHASH 0x100000001B3ULL
+
+/**
+ * CONSTANTE: MAXMYERS
+ * -------------------
+ * A maior quantidade de edições procurada em cada bissecção do algoritmo de
+ * Myers. Um trecho que precisa de mais edições do que isso é tratado como
+ * substituído por inteiro, o que limita o tempo gasto com janelas que não têm
+ * quase nada em comum.
+ */
+
+#define MAXMYERS 4096
+
+/**
+ * CONSTANTE: TAMMAPA
+ * ------------------
+ * Quantidade máxima de caracteres de um bloco mapeado. Blocos mapeados
+ * grandes mantêm a lista curta mesmo para arquivos enormes (cerca de mil
+ * blocos por gigabyte).
+ */
+
+#define TAMMAPA (1 << 20)
+
+/**
+ * CONSTANTES: MINIMOLZ, MAXIMOLZ, BITSLZ, MENORBLOCO
+ * --------------------------------------------------
+ * Parâmetros do compressor LZ dos blocos frios. O texto comprimido é uma
+ * sequência de comandos de um byte "c": se c < 0x80, seguem c + 1 caracteres
+ * literais; caso contrário, repetem-se (c & 0x7F) + MINIMOLZ caracteres que
+ * estão a uma distância dada pelos 2 bytes seguintes. MAXIMOLZ é a maior
+ * repetição possível, BITSLZ é o tamanho (em bits) da tabela de hash usada para
+ * encontrar repetições, e blocos com menos de MENORBLOCO caracteres não são
+ * comprimidos.
+ */
+
+#define MINIMOLZ 4
+#define MAXIMOLZ (MINIMOLZ + 127)
+#define BITSLZ 12
+#define MENORBLOCO 64
+
+/**
+ * CONSTANTES: MAGICO_INSTANTANEO, FORMATO_INSTANTANEO
+ * ---------------------------------------------------
+ * Os 8 bytes que identificam um instantâneo de blocobuff e a versão do
+ * formato do instantâneo.
+ */
+
+#define MAGICO_INSTANTANEO "BLOCOINS"
+#define FORMATO_INSTANTANEO 1u
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: armazemTCD, armazemTAD
+ * ----------------------------
+ * Uma área de memória somente leitura compartilhada por blocos (de um ou mais
+ * buffers) e por trechos copiados. A área é liberada, ou desmapeada se for o
+ * mapeamento de um arquivo, quando a última referência é devolvida.
+ *
+ *     dados        início da área
+ *     tamanho      tamanho da área, em bytes
+ *     mapeado      TRUE se a área é o mapeamento de um arquivo
+ *     referencias  quantidade de blocos e trechos que usam a área
+ */
+
+typedef struct armazemTCD
+{
+    char *dados;
+    size_t tamanho;
+    bool mapeado;
+    int referencias;
+} armazemTCD;
+
+typedef struct armazemTCD *armazemTAD;
+
+/**
+ * Tipo: blocoTCD, blocoTAD
+ * ------------------------
+ * Um bloco da lista. Além dos caracteres, cada bloco guarda o hash do seu
+ * conteúdo e a potência BASEHASH^tamanho, que permitem combinar os hashes dos
+ * blocos no hash do texto inteiro sem percorrer o texto. O campo "sujo" indica
+ * que o conteúdo mudou e que o hash precisa ser recalculado.
+ *
+ *     dados           array com TAMBLOCO posições para os caracteres, NULL
+ *                     se o bloco está comprimido, ou um ponteiro para dentro
+ *                     do armazém se o bloco é compartilhado
+ *     tamanho         quantidade de caracteres no bloco
+ *     hash            hash polinomial do conteúdo do bloco
+ *     potencia        BASEHASH elevado a "tamanho" (módulo 2^64)
+ *     sujo            TRUE se "hash" e "potencia" estão desatualizados
+ *     compactado      o conteúdo comprimido, com "tamcompactado" bytes
+ *     acesso          valor do relógio do buffer no último acesso ao bloco
+ *     na_fila         TRUE se o bloco está na fila de acesso
+ *     incompressivel  TRUE se a compressão não reduziu o bloco
+ *     armazem         o armazém dos dados de um bloco compartilhado (os
+ *                     blocos mapeados também são compartilhados), ou NULL
+ *     dono            o buffer ao qual o bloco pertence
+ *     despejado       TRUE se o conteúdo está na vaga "vaga" do arquivo de
+ *                     despejo
+ *     mais_recente,
+ *     mais_antigo     vizinhos do bloco na fila de acesso
+ */
+
+typedef struct blocoTCD
+{
+    char *dados;
+    int tamanho;
+    uint64_t hash;
+    uint64_t potencia;
+    bool sujo;
+    unsigned char *compactado;
+    int tamcompactado;
+    unsigned long acesso;
+    bool na_fila;
+    bool incompressivel;
+    armazemTAD armazem;
+    struct bufferTCD *dono;
+    bool despejado;
+    size_t vaga;
+    struct blocoTCD *anterior;
+    struct blocoTCD *proximo;
+    struct blocoTCD *mais_recente;
+    struct blocoTCD *mais_antigo;
+} blocoTCD;
+
+typedef struct blocoTCD *blocoTAD;
+
+/**
+ * Tipo: bufferTCD
+ * ---------------
+ * A representação concreta do buffer mantém a lista de blocos e a posição do
+ * cursor, dada pelo bloco atual e pelo deslocamento dentro desse bloco. O
+ * buffer sempre tem pelo menos um bloco; blocos vazios só existem quando o
+ * buffer inteiro está vazio.
+ *
+ *     primeiro      primeiro bloco da lista
+ *     ultimo        último bloco da lista
+ *     atual         bloco onde está o cursor
+ *     deslocamento  posição do cursor dentro de "atual" (0 a atual->tamanho)
+ *     cursor        posição absoluta do cursor no buffer
+ *     tamanho       quantidade total de caracteres no buffer
+ *     nblocos       quantidade de blocos na lista
+ *     raiz          hash do buffer inteiro, válido se "alteracoes" for 0
+ *     alteracoes    quantidade de alterações desde o cálculo de "raiz"
+ *     versao        contador de alterações do conteúdo (nunca é zerado)
+ *     visto         último bloco encontrado por "localizar" (ou NULL), que
+ *                   começa na posição "inicio_visto" e só vale enquanto a
+ *                   versão for "versao_vista"
+ *     recente       bloco acessado mais recentemente (início da fila)
+ *     antigo        bloco acessado há mais tempo (final da fila)
+ *     relogio       quantidade de operações feitas no buffer
+ *     janela        janela da compressão dos blocos frios (0 se desligada)
+ *     rascunho      área para a leitura de blocos comprimidos
+ *     compressao    métricas da compressão
+ *     mapa          armazém do mapeamento do arquivo, ou NULL
+ *     residentes    blocos comuns cujo array está na memória
+ *     limite        limite de memória do buffer, em bytes (0: sem limite)
+ *     despejo       descritor do arquivo de despejo (-1 se ainda não criado)
+ *     livres        pilha das vagas livres do arquivo de despejo, com
+ *                   "nlivres" vagas e espaço para "caplivres"
+ *     vagas         quantidade de vagas já usadas no arquivo de despejo
+ *     metricas      métricas do despejo
+ *     alocador      alocador da estrutura do buffer
+ *     transacao     transação aberta (NULL se não houver)
+ *     desfazer      última transação confirmada, para desfazer_transacao
+ *     versao_desfazer   versão do buffer logo após aquela confirmação
+ */
+
+struct bufferTCD
+{
+    blocoTAD primeiro;
+    blocoTAD ultimo;
+    blocoTAD atual;
+    int deslocamento;
+    size_t cursor;
+    size_t tamanho;
+    size_t nblocos;
+    uint64_t raiz;
+    unsigned long alteracoes;
+    unsigned long versao;
+    blocoTAD visto;
+    size_t inicio_visto;
+    unsigned long versao_vista;
+    blocoTAD recente;
+    blocoTAD antigo;
+    unsigned long relogio;
+    unsigned long janela;
+    char *rascunho;
+    metricas_compressaoT compressao;
+    armazemTAD mapa;
+    size_t residentes;
+    size_t limite;
+    int despejo;
+    size_t *livres;
+    size_t nlivres;
+    size_t caplivres;
+    size_t vagas;
+    metricas_despejoT metricas;
+    alocadorT alocador;
+    transacaoTAD transacao;
+    transacaoTAD desfazer;
+    unsigned long versao_desfazer;
+};
+
+/**
+ * Tipo: assinaturaTCD
+ * -------------------
+ * Guarda, para cada bloco do buffer no momento da assinatura, o hash e o
+ * tamanho do bloco, além do hash do buffer inteiro.
+ */
+
+struct assinaturaTCD
+{
+    size_t nblocos;
+    uint64_t *hashes;
+    int *tamanhos;
+    uint64_t raiz;
+};
+
+/**
+ * Tipo: parteT, trechoTCD
+ * -----------------------
+ * Um trecho copiado é uma sequência de partes, cada uma com "tamanho"
+ * caracteres que começam em "dados", dentro de um armazém do qual o trecho
+ * detém uma referência.
+ */
+
+typedef struct
+{
+    armazemTAD armazem;
+    char *dados;
+    int tamanho;
+} parteT;
+
+struct trechoTCD
+{
+    size_t tamanho;
+    size_t npartes;
+    parteT *partes;
+};
+
+/**
+ * Tipo: anelTCD
+ * -------------
+ * Os trechos do anel ficam em um array circular com "capacidade" posições;
+ * "inicio" é a posição do trecho mais recente, e os demais seguem em ordem.
+ */
+
+struct anelTCD
+{
+    trechoTAD *trechos;
+    int capacidade;
+    int quantidade;
+    int inicio;
+};
+
+/**
+ * Tipo: cadeiaT
+ * -------------
+ * A lista de blocos montada por "substituir_tudo", ainda desligada do buffer.
+ * Novos caracteres só são acrescentados ao último bloco se ele for um bloco
+ * novo ("aberto"); os blocos reaproveitados da lista antiga não mudam. Na
+ * simulação nenhum bloco é criado e apenas "tamanho" é contado.
+ */
+
+typedef struct
+{
+    blocoTAD primeiro;
+    blocoTAD ultimo;
+    size_t nblocos;
+    size_t tamanho;
+    bool aberto;
+    bool simular;
+} cadeiaT;
+
+/**
+ * Tipo: alteracaoT, diferencaTCD
+ * ------------------------------
+ * Uma diferença guarda as suas edições (como em edicaoT, mas com o texto dado
+ * pela posição em "textos", que pode mudar de lugar ao crescer) e o texto
+ * inserido por todas elas, em sequência:
+ *
+ *     antigo, novo    tamanhos dos dois textos comparados
+ *     edicoes         as "nedicoes" edições, com espaço para "capedicoes"
+ *     textos          os "ntextos" caracteres inseridos, com espaço para
+ *                     "captextos"
+ *     metricas        o trabalho feito pela comparação
+ */
+
+typedef struct
+{
+    size_t antiga;
+    size_t removidos;
+    size_t nova;
+    size_t inseridos;
+    size_t texto;
+} alteracaoT;
+
+struct diferencaTCD
+{
+    size_t antigo;
+    size_t novo;
+    alteracaoT *edicoes;
+    size_t nedicoes;
+    size_t capedicoes;
+    char *textos;
+    size_t ntextos;
+    size_t captextos;
+    metricas_diferencaT metricas;
+};
+
+/**
+ * Tipo: tabela_blocosT
+ * --------------------
+ * Tabela de hash (de endereçamento aberto) de uma sequência de blocos, dados
+ * pelos arrays paralelos "hashes" e "tamanhos". "posicoes" tem "mascara" + 1
+ * posições e leva cada par (hash, tamanho) a um bloco com esse par;
+ * "proximos" liga cada bloco ao seguinte com o mesmo par (SIZE_MAX no
+ * último).
+ */
+
+typedef struct
+{
+    const uint64_t *hashes;
+    const int *tamanhos;
+    size_t *posicoes;
+    size_t *proximos;
+    size_t mascara;
+} tabela_blocosT;
+
+/**
+ * Tipo: linhaT, comparacaoT
+ * -------------------------
+ * Uma linha de uma janela (a posição do seu início na janela, o tamanho,
+ * '\n' incluído, e o hash) e o estado da comparação de uma janela: o texto,
+ * as linhas e a posição, no buffer, de cada lado ("a" é o antigo, "b" o novo),
+ * e a diferença que recebe as edições. Depois da última linha de cada lado há
+ * uma linha vazia que marca o final da janela.
+ */
+
+typedef struct
+{
+    size_t inicio;
+    size_t tamanho;
+    uint64_t hash;
+} linhaT;
+
+typedef struct
+{
+    const char *texto_a;
+    const char *texto_b;
+    linhaT *linhas_a;
+    linhaT *linhas_b;
+    size_t inicio_a;
+    size_t inicio_b;
+    diferencaTAD diferenca;
+} comparacaoT;
+
+/**
+ * Tipo: cabecalho_instantaneoT
+ * ----------------------------
+ * O início de um instantâneo. O texto começa em "texto" (logo após o
+ * cabeçalho) e a tabela de blocos em "tabela" (após o texto, alinhada a 8
+ * bytes); o arquivo termina com a tabela.
+ *
+ *     magico     MAGICO_INSTANTANEO
+ *     formato    FORMATO_INSTANTANEO
+ *     nblocos    quantidade de entradas da tabela
+ *     tamanho    quantidade de caracteres do buffer
+ *     cursor     posição do cursor
+ *     linhas     total de quebras de linha
+ *     raiz       hash do buffer inteiro
+ */
+
+typedef struct
+{
+    char magico[8];
+    uint32_t formato;
+    uint32_t reservado;
+    uint64_t texto;
+    uint64_t tabela;
+    uint64_t nblocos;
+    uint64_t tamanho;
+    uint64_t cursor;
+    uint64_t linhas;
+    uint64_t raiz;
+} cabecalho_instantaneoT;
+
+/**
+ * Tipo: entrada_instantaneoT
+ * --------------------------
+ * Uma entrada da tabela de blocos de um instantâneo.
+ */
+
+typedef struct
+{
+    uint32_t tamanho;
+    uint32_t linhas;
+    uint64_t hash;
+    uint64_t potencia;
+} entrada_instantaneoT;
+
+/**
+ * Tipo: classeT
+ * -------------
+ * As classes de caracteres procuradas pelos movimentos de palavra, linha e
+ * parágrafo: o '\n' (QUEBRA), qualquer outro caractere (TEXTO), os
+ * caracteres de palavra (PALAVRA) e os demais (SEPARADOR).
+ */
+
+typedef enum
+{
+    QUEBRA,
+    TEXTO,
+    PALAVRA,
+    SEPARADOR
+} classeT;
+
+/*** Variáveis Globais ***/
+
+/**
+ * VARIÁVEIS: memoria_processo, limite_processo
+ * --------------------------------------------
+ * A memória ocupada pelos blocos comuns de todos os buffers e o limite dessa
+ * memória (0: sem limite). São atômicas porque cada buffer pode ser usado por
+ * uma thread diferente.
+ */
+
+static atomic_size_t memoria_processo = 0;
+static atomic_size_t limite_processo = 0;
+
+/*** Declarações de Subprogramas Privados ***/
+
+static blocoTAD criar_bloco (bufferTAD buffer);
+static blocoTAD criar_bloco_compartilhado (armazemTAD armazem, char *dados,
+                                           int tamanho);
+static armazemTAD criar_armazem (char *dados, size_t tamanho, bool mapeado);
+static armazemTAD reter_armazem (armazemTAD armazem);
+static void soltar_armazem (armazemTAD *armazem);
+static void compartilhar (bufferTAD buffer, blocoTAD bloco);
+static blocoTAD separar (bufferTAD buffer, size_t posicao);
+static void remover_intervalo (bufferTAD buffer, size_t n);
+static void reposicionar (bufferTAD buffer, size_t posicao);
+static void materializar (bufferTAD buffer);
+static void remover_bloco (blocoTAD *bloco);
+static void ligar_bloco_depois (bufferTAD buffer, blocoTAD bloco,
+                                blocoTAD novo);
+static void desligar_bloco (bufferTAD buffer, blocoTAD bloco);
+static blocoTAD dividir_bloco (bufferTAD buffer, blocoTAD bloco, int posicao);
+static void marcar_alteracao (bufferTAD buffer, blocoTAD bloco);
+static void atualizar_hash (blocoTAD bloco);
+static blocoTAD localizar (bufferTAD buffer, size_t posicao, int *deslocamento);
+static size_t distancia (size_t a, size_t b);
+static void tocar (bufferTAD buffer, blocoTAD bloco);
+static void retirar_da_fila (bufferTAD buffer, blocoTAD bloco);
+static void avancar_relogio (bufferTAD buffer);
+static void comprimir_bloco (bufferTAD buffer, blocoTAD bloco);
+static const char *ler_bloco (bufferTAD buffer, blocoTAD bloco);
+static int comprimir_lz (const char *origem, int n, unsigned char *destino,
+                         int capacidade);
+static int emitir_literais (const char *origem, int n, unsigned char *destino,
+                            int o, int capacidade);
+static void descomprimir_lz (const unsigned char *origem, int n,
+                             char *destino);
+static double agora (void);
+static size_t *tabela_falhas (const char *padrao, size_t n);
+static void encadear (cadeiaT *cadeia, blocoTAD bloco);
+static void anexar_texto (bufferTAD buffer, cadeiaT *cadeia, const char *texto,
+                          size_t n);
+static void descartar_bloco (bufferTAD buffer, blocoTAD bloco);
+static bool conferir_instantaneo (const char *dados, size_t tamanho);
+static void contar_residente (blocoTAD bloco, int delta);
+static bool excede_limite (bufferTAD buffer);
+static void despejar_frios (bufferTAD buffer, blocoTAD protegido);
+static bool despejar_bloco (bufferTAD buffer, blocoTAD bloco);
+static void recarregar_bloco (bufferTAD buffer, blocoTAD bloco,
+                              char *destino);
+static void devolver_vaga (bufferTAD buffer, blocoTAD bloco);
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static bool pertence (char c, classeT classe);
+static bool tabelar_blocos (tabela_blocosT *tabela, const uint64_t hashes[],
+                            const int tamanhos[], size_t n);
+static size_t procurar_bloco (tabela_blocosT *tabela, uint64_t hash,
+                              int tamanho, size_t minimo);
+static void liberar_tabela (tabela_blocosT *tabela);
+static bool comparar_janela (diferencaTAD diferenca, bufferTAD antigo,
+                             size_t a0, size_t a1, bufferTAD novo, size_t b0,
+                             size_t b1);
+static linhaT *dividir_linhas (const char *texto, size_t n, size_t *nlinhas);
+static bool comparar_linhas (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                             size_t b1);
+static int bissectar (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                      size_t b1, size_t *x, size_t *y);
+static bool linhas_iguais (comparacaoT *c, size_t i, size_t j);
+static bool registrar_edicao (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                              size_t b1);
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar);
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao);
+static void aplicar_pendentes (bufferTAD buffer);
+static void guardar_recorte (bufferTAD buffer, size_t n);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: criar_buffer
+ * Uso: buffer = criar_buffer( );
+ * ------------------------------
+ * Cria um buffer vazio, representado por uma lista com um único bloco vazio.
+ * Retorna NULL se não houver memória.
+ */
+
+bufferTAD criar_buffer (void)
+{
+    return criar_buffer_com_alocador(NULL);
+}
+
+/**
+ * Função: criar_buffer_com_alocador
+ * Uso: buffer = criar_buffer_com_alocador(&alocador);
+ * ---------------------------------------------------
+ * Igual a criar_buffer, com a estrutura do buffer obtida do alocador (ou de
+ * malloc, se o alocador for NULL). Em caso de erro, libera o alocador, se for
+ * o dono da sua memória.
+ */
+
+bufferTAD criar_buffer_com_alocador (const alocadorT *alocador)
+{
+    alocadorT a = (alocador != NULL) ? *alocador : alocador_padrao();
+    bufferTAD B = alocar(&a, sizeof(struct bufferTCD));
+    if (B == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar buffer.\n");
+        liberar_alocador(&a);
+        return NULL;
+    }
+
+    memset(B, 0, sizeof(struct bufferTCD));
+    B->alocador = a;
+    B->despejo = -1;
+    blocoTAD bloco = criar_bloco(B);
+    if (bloco == NULL)
+    {
+        desalocar(&a, B, sizeof(struct bufferTCD));
+        liberar_alocador(&a);
+        return NULL;
+    }
+
+    B->primeiro = B->ultimo = B->atual = bloco;
+    B->nblocos = 1;
+    B->alteracoes = 1;
+    tocar(B, bloco);
+
+    return B;
+}
+
+/**
+ * Procedimento: liberar_buffer
+ * Uso: liberar_buffer(&buffer);
+ * -----------------------------
+ * Libera todos os blocos do buffer e o buffer em si, copiando o ponteiro para
+ * o próximo bloco antes de liberar cada bloco.
+ */
+
+void liberar_buffer (bufferTAD *buffer)
+{
+    if (buffer == NULL || *buffer == NULL)
+        return;
+
+    blocoTAD atual = (*buffer)->primeiro, proximo;
+    while (atual != NULL)
+    {
+        proximo = atual->proximo;
+        remover_bloco(&atual);
+        atual = proximo;
+    }
+    free((*buffer)->rascunho);
+    if ((*buffer)->mapa != NULL)
+        soltar_armazem(&(*buffer)->mapa);
+    if ((*buffer)->despejo >= 0)
+        close((*buffer)->despejo);
+    free((*buffer)->livres);
+    liberar_transacao(&(*buffer)->transacao);
+    liberar_transacao(&(*buffer)->desfazer);
+    alocadorT alocador = (*buffer)->alocador;
+    desalocar(&alocador, *buffer, sizeof(struct bufferTCD));
+    liberar_alocador(&alocador);
+    *buffer = NULL;
+}
+
+/**
+ * Procedimentos: mover_cursor_para_frente
+ *                mover_cursor_para_tras
+ * Uso: mover_cursor_para_frente(buffer);
+ *      mover_cursor_para_tras(buffer);
+ * ---------------------------------------
+ * Movem o cursor um caractere. Se o cursor estiver em uma das pontas do bloco
+ * atual, ele passa antes para o bloco vizinho (que é descomprimido, se for o
+ * caso).
+ */
+
+void mover_cursor_para_frente (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, posicao_cursor(buffer) + 1))
+        return;
+
+    if (buffer->deslocamento == buffer->atual->tamanho &&
+        buffer->atual->proximo != NULL)
+    {
+        buffer->atual = buffer->atual->proximo;
+        buffer->deslocamento = 0;
+        tocar(buffer, buffer->atual);
+    }
+    if (buffer->deslocamento < buffer->atual->tamanho)
+    {
+        buffer->deslocamento++;
+        buffer->cursor++;
+    }
+    avancar_relogio(buffer);
+}
+
+void mover_cursor_para_tras (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    size_t atual = posicao_cursor(buffer);
+    if (mover_na_transacao(buffer, atual > 0 ? atual - 1 : 0))
+        return;
+
+    if (buffer->deslocamento == 0 && buffer->atual->anterior != NULL)
+    {
+        buffer->atual = buffer->atual->anterior;
+        buffer->deslocamento = buffer->atual->tamanho;
+        tocar(buffer, buffer->atual);
+    }
+    if (buffer->deslocamento > 0)
+    {
+        buffer->deslocamento--;
+        buffer->cursor--;
+    }
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimentos: mover_cursor_para_final
+ *                mover_cursor_para_inicio
+ * Uso: mover_cursor_para_final(buffer);
+ *      mover_cursor_para_inicio(buffer);
+ * ---------------------------------------
+ * Como a lista guarda ponteiros para o primeiro e o último bloco, os dois
+ * movimentos têm custo constante.
+ */
+
+void mover_cursor_para_final (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, SIZE_MAX))
+        return;
+
+    buffer->atual = buffer->ultimo;
+    buffer->deslocamento = buffer->ultimo->tamanho;
+    buffer->cursor = buffer->tamanho;
+    tocar(buffer, buffer->atual);
+    avancar_relogio(buffer);
+}
+
+void mover_cursor_para_inicio (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, 0))
+        return;
+
+    buffer->atual = buffer->primeiro;
+    buffer->deslocamento = 0;
+    buffer->cursor = 0;
+    tocar(buffer, buffer->atual);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimento: mover_cursor_para_posicao
+ * Uso: mover_cursor_para_posicao(buffer, posicao);
+ * ------------------------------------------------
+ * Localiza o bloco que contém a posição e posiciona o cursor nele. A busca
+ * salta bloco a bloco, e não caractere a caractere.
+ */
+
+void mover_cursor_para_posicao (bufferTAD buffer, size_t posicao)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, posicao))
+        return;
+
+    if (posicao > buffer->tamanho)
+        posicao = buffer->tamanho;
+    buffer->atual = localizar(buffer, posicao, &buffer->deslocamento);
+    buffer->cursor = posicao;
+    tocar(buffer, buffer->atual);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proxima_palavra
+ *                mover_cursor_para_palavra_anterior
+ * Uso: mover_cursor_para_proxima_palavra(buffer);
+ *      mover_cursor_para_palavra_anterior(buffer);
+ * -------------------------------------------------
+ * As buscas percorrem os blocos a partir do bloco do cursor (o '\n' com
+ * memchr), lendo os blocos comprimidos ou despejados sem alterá-los, e o
+ * cursor salta uma única vez, direto para o bloco encontrado.
+ */
+
+void mover_cursor_para_proxima_palavra (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = avancar_ate(buffer, posicao_cursor(buffer), SEPARADOR);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, p, PALAVRA));
+}
+
+void mover_cursor_para_palavra_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), PALAVRA);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, p, SEPARADOR));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_inicio_da_linha
+ *                mover_cursor_para_final_da_linha
+ * Uso: mover_cursor_para_inicio_da_linha(buffer);
+ *      mover_cursor_para_final_da_linha(buffer);
+ * -----------------------------------------------
+ * Uma única busca pelo '\n' anterior ou seguinte ao cursor.
+ */
+
+void mover_cursor_para_inicio_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, posicao_cursor(buffer),
+                                                 QUEBRA));
+}
+
+void mover_cursor_para_final_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, posicao_cursor(buffer),
+                                                  QUEBRA));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proximo_paragrafo
+ *                mover_cursor_para_paragrafo_anterior
+ * Uso: mover_cursor_para_proximo_paragrafo(buffer);
+ *      mover_cursor_para_paragrafo_anterior(buffer);
+ * ---------------------------------------------------
+ * Para frente, o texto é percorrido de uma sequência de '\n' a outra; a
+ * primeira sequência com dois ou mais '\n' que vem depois de um caractere de
+ * texto termina o parágrafo, e a linha em branco começa logo após o primeiro
+ * '\n'. Para trás, o texto é percorrido de um início de linha com texto ao
+ * anterior; o primeiro que é precedido por dois ou mais '\n' (ou apenas por
+ * '\n' desde o início do buffer) começa um parágrafo, e a linha em branco
+ * começa logo antes dele. Se o cursor está em uma linha em branco, as linhas em
+ * branco vizinhas são puladas antes.
+ */
+
+void mover_cursor_para_proximo_paragrafo (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer), p = posicao_cursor(buffer);
+    bool apos_texto = (p > 0 && recuar_ate(buffer, p, TEXTO) == p);
+
+    while (p < n)
+    {
+        size_t q = avancar_ate(buffer, p, QUEBRA);
+        size_t r = (q < n) ? avancar_ate(buffer, q, TEXTO) : n;
+        if ((q > p || apos_texto) && r - q >= 2)
+        {
+            p = q + 1;
+            break;
+        }
+        p = r;
+        apos_texto = TRUE;
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+void mover_cursor_para_paragrafo_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), QUEBRA);
+
+    if (p == n || avancar_ate(buffer, p, TEXTO) != p)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        p = (t > 0) ? recuar_ate(buffer, t, QUEBRA) : 0;
+    }
+    while (p > 0)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        if (t == 0 || p - t >= 2)
+        {
+            p--;
+            break;
+        }
+        p = recuar_ate(buffer, t, QUEBRA);
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+/**
+ * Funções: tamanho_buffer, posicao_cursor
+ * Uso: n = tamanho_buffer(buffer);
+ *      p = posicao_cursor(buffer);
+ * ---------------------------------------
+ * Retornam o tamanho do buffer e a posição absoluta do cursor.
+ */
+
+size_t tamanho_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return tamanho_da_transacao(buffer->transacao);
+
+    return buffer->tamanho;
+}
+
+size_t posicao_cursor (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cursor de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return cursor_da_transacao(buffer->transacao);
+
+    return buffer->cursor;
+}
+
+/**
+ * Função: versao_buffer
+ * Uso: v = versao_buffer(buffer);
+ * -------------------------------
+ * Retorna o contador de alterações, incrementado a cada bloco alterado.
+ */
+
+unsigned long versao_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: versão de buffer null.\n");
+        exit(1);
+    }
+
+    return buffer->versao;
+}
+
+/**
+ * Função: copiar_texto
+ * Uso: n = copiar_texto(buffer, inicio, n, destino);
+ * --------------------------------------------------
+ * Localiza o bloco onde o trecho começa e copia, com memcpy, a parte do trecho
+ * que está em cada bloco. Os blocos comprimidos continuam comprimidos.
+ */
+
+size_t copiar_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[])
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cópia de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (inicio >= buffer->tamanho)
+        return 0;
+
+    int desl;
+    size_t copiados = 0;
+    for (blocoTAD b = localizar(buffer, inicio, &desl); b != NULL &&
+         copiados < n; b = b->proximo, desl = 0)
+    {
+        size_t k = b->tamanho - desl;
+        if (k > n - copiados)
+            k = n - copiados;
+        memcpy(destino + copiados, ler_bloco(buffer, b) + desl, k);
+        copiados += k;
+    }
+
+    return copiados;
+}
+
+/**
+ * Procedimento: inserir_caractere
+ * Uso: inserir_caractere(buffer, c);
+ * ----------------------------------
+ * Insere o caractere "c" na posição do cursor. Se o bloco atual está cheio, ele
+ * é dividido na posição do cursor (ou, se o cursor está no final do bloco, um
+ * bloco vazio é criado depois dele) antes da inserção.
+ */
+
+void inserir_caractere (bufferTAD buffer, char c)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: inserção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, &c, 1, 0))
+        return;
+
+    materializar(buffer);
+    blocoTAD bloco = buffer->atual;
+    if (bloco->tamanho == TAMBLOCO)
+    {
+        blocoTAD novo = dividir_bloco(buffer, bloco, buffer->deslocamento);
+        if (buffer->deslocamento == TAMBLOCO)
+        {
+            bloco = buffer->atual = novo;
+            buffer->deslocamento = 0;
+        }
+    }
+
+    memmove(bloco->dados + buffer->deslocamento + 1,
+            bloco->dados + buffer->deslocamento,
+            bloco->tamanho - buffer->deslocamento);
+    bloco->dados[buffer->deslocamento++] = c;
+    bloco->tamanho++;
+    buffer->tamanho++;
+    buffer->cursor++;
+    marcar_alteracao(buffer, bloco);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimento: inserir_texto
+ * Uso: inserir_texto(buffer, texto, n);
+ * -------------------------------------
+ * Insere "n" caracteres na posição do cursor. O bloco atual é dividido no
+ * cursor uma única vez; o texto é copiado para o espaço livre do bloco atual e,
+ * depois, para novos blocos cheios. Se o trecho que estava após o cursor couber
+ * no último bloco preenchido, ele é juntado a esse bloco.
+ */
+
+void inserir_texto (bufferTAD buffer, const char *texto, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: inserção em buffer null.\n");
+        exit(1);
+    }
+    else if (n == 0 || registrar(buffer, texto, n, 0))
+        return;
+
+    materializar(buffer);
+    blocoTAD bloco = buffer->atual;
+    blocoTAD resto = NULL;
+    if (buffer->deslocamento < bloco->tamanho)
+        resto = dividir_bloco(buffer, bloco, buffer->deslocamento);
+
+    while (n > 0)
+    {
+        if (bloco->tamanho == TAMBLOCO)
+        {
+            blocoTAD novo = criar_bloco(buffer);
+            if (novo == NULL)
+            {
+                fprintf(stderr, "Erro: impossível alocar bloco.\n");
+                exit(1);
+            }
+            ligar_bloco_depois(buffer, bloco, novo);
+            bloco = novo;
+        }
+        size_t k = TAMBLOCO - bloco->tamanho;
+        if (k > n)
+            k = n;
+        memcpy(bloco->dados + bloco->tamanho, texto, k);
+        bloco->tamanho += k;
+        marcar_alteracao(buffer, bloco);
+        if (excede_limite(buffer))
+            despejar_frios(buffer, bloco);
+        texto += k;
+        n -= k;
+        buffer->tamanho += k;
+        buffer->cursor += k;
+    }
+
+    buffer->atual = bloco;
+    buffer->deslocamento = bloco->tamanho;
+
+    if (resto != NULL && bloco->tamanho + resto->tamanho <= TAMBLOCO)
+    {
+        tocar(buffer, resto);
+        memcpy(bloco->dados + bloco->tamanho, resto->dados, resto->tamanho);
+        bloco->tamanho += resto->tamanho;
+        desligar_bloco(buffer, resto);
+        remover_bloco(&resto);
+    }
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimento: apagar_caractere
+ * Uso: apagar_caractere(buffer);
+ * ------------------------------
+ * Apaga o caractere imediatamente posterior ao cursor. Um bloco que fica vazio
+ * é removido da lista (a não ser que seja o único), e um bloco que fica com
+ * menos de um quarto da capacidade é juntado ao bloco seguinte, se couber, para
+ * que a lista não se encha de blocos pequenos.
+ */
+
+void apagar_caractere (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: remoção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, NULL, 0, 1))
+        return;
+
+    blocoTAD bloco = buffer->atual;
+    if (buffer->deslocamento == bloco->tamanho)
+    {
+        if (bloco->proximo == NULL)
+            return;
+        buffer->atual = bloco->proximo;
+        buffer->deslocamento = 0;
+        tocar(buffer, buffer->atual);
+    }
+    materializar(buffer);
+    bloco = buffer->atual;
+
+    memmove(bloco->dados + buffer->deslocamento,
+            bloco->dados + buffer->deslocamento + 1,
+            bloco->tamanho - buffer->deslocamento - 1);
+    bloco->tamanho--;
+    buffer->tamanho--;
+    marcar_alteracao(buffer, bloco);
+
+    if (bloco->tamanho == 0 && buffer->nblocos > 1)
+    {
+        if (bloco->anterior != NULL)
+        {
+            buffer->atual = bloco->anterior;
+            buffer->deslocamento = bloco->anterior->tamanho;
+        }
+        else
+        {
+            buffer->atual = bloco->proximo;
+            buffer->deslocamento = 0;
+        }
+        desligar_bloco(buffer, bloco);
+        remover_bloco(&bloco);
+        tocar(buffer, buffer->atual);
+    }
+    else if (bloco->tamanho < TAMBLOCO / 4 && bloco->proximo != NULL &&
+             bloco->tamanho + bloco->proximo->tamanho <= TAMBLOCO)
+    {
+        blocoTAD proximo = bloco->proximo;
+        memcpy(bloco->dados + bloco->tamanho, ler_bloco(buffer, proximo),
+               proximo->tamanho);
+        bloco->tamanho += proximo->tamanho;
+        desligar_bloco(buffer, proximo);
+        remover_bloco(&proximo);
+    }
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimento: apagar_texto
+ * Uso: apagar_texto(buffer, n);
+ * -----------------------------
+ * Apaga até "n" caracteres após o cursor. Se todos estão no bloco do cursor
+ * (e ele não fica vazio), a cauda do bloco é deslocada uma única vez; senão,
+ * os blocos nas duas pontas do intervalo são separados e os blocos entre elas
+ * são desligados inteiros, sem que o texto apagado seja lido.
+ */
+
+void apagar_texto (bufferTAD buffer, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: remoção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, NULL, 0, n))
+        return;
+
+    size_t resta = buffer->tamanho - buffer->cursor;
+    if (n > resta)
+        n = resta;
+    if (n == 0)
+        return;
+
+    materializar(buffer);
+    if (buffer->deslocamento + n >= (size_t) buffer->atual->tamanho)
+    {
+        remover_intervalo(buffer, n);
+        return;
+    }
+
+    blocoTAD bloco = buffer->atual;
+    memmove(bloco->dados + buffer->deslocamento,
+            bloco->dados + buffer->deslocamento + n,
+            bloco->tamanho - buffer->deslocamento - n);
+    bloco->tamanho -= (int) n;
+    buffer->tamanho -= n;
+    marcar_alteracao(buffer, bloco);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Função: substituir_tudo
+ * Uso: n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+ * ----------------------------------------------------------------
+ * Percorre os blocos uma única vez, procurando o padrão com o algoritmo de
+ * Knuth-Morris-Pratt (que encontra também as ocorrências divididas entre dois
+ * blocos), e monta uma nova lista de blocos cheios com o texto resultante. Um
+ * bloco em que o primeiro caractere do padrão não aparece, e que não continua
+ * uma ocorrência iniciada no bloco anterior, não tem nada a substituir: ele
+ * passa inteiro para a nova lista, sem ser copiado, continuando comprimido ou
+ * compartilhado. Os demais blocos antigos são liberados à medida que são lidos. Ao
+ * final a nova lista substitui a antiga e o cursor é localizado nela.
+ */
+
+size_t substituir_tudo (bufferTAD buffer, const char *padrao, size_t np,
+                        const char *novo, size_t nn, bool simular)
+{
+    if (buffer == NULL || (np > 0 && padrao == NULL) ||
+        (nn > 0 && novo == NULL))
+    {
+        fprintf(stderr, "Erro: substituição em buffer null.\n");
+        exit(1);
+    }
+    else if (np == 0)
+        return 0;
+
+    aplicar_pendentes(buffer);
+    if (!simular)
+        guardar_texto_para_desfazer(buffer->transacao, buffer);
+    size_t *falhas = tabela_falhas(padrao, np);
+    cadeiaT cadeia = {NULL, NULL, 0, 0, FALSE, simular};
+    size_t cursor = buffer->cursor, i = 0;
+    size_t quantidade = 0, j = 0, ganho = 0, perda = 0, novo_cursor = 0;
+    bool dentro = FALSE;
+
+    blocoTAD bloco = buffer->primeiro, proximo;
+    for (; bloco != NULL; bloco = proximo)
+    {
+        proximo = bloco->proximo;
+        const char *dados = ler_bloco(buffer, bloco);
+        int n = bloco->tamanho;
+
+        if (j == 0 && n > 0 && memchr(dados, padrao[0], n) == NULL)
+        {
+            i += n;
+            cadeia.tamanho += n;
+            if (!simular)
+                encadear(&cadeia, bloco);
+            continue;
+        }
+
+        for (int x = 0; x < n; )
+        {
+            if (j == 0)
+            {
+                const char *p = memchr(dados + x, padrao[0], n - x);
+                int fim = (p == NULL) ? n : (int) (p - dados);
+                anexar_texto(buffer, &cadeia, dados + x, fim - x);
+                i += fim - x;
+                x = fim;
+                if (x == n)
+                    break;
+            }
+
+            char c = dados[x++];
+            i++;
+            while (j > 0 && c != padrao[j])
+            {
+                anexar_texto(buffer, &cadeia, padrao, j - falhas[j - 1]);
+                j = falhas[j - 1];
+            }
+            if (c == padrao[j])
+                j++;
+            else
+                anexar_texto(buffer, &cadeia, &c, 1);
+
+            if (j == np)
+            {
+                if (i <= cursor)
+                {
+                    ganho += nn;
+                    perda += np;
+                }
+                else if (i - np < cursor)
+                {
+                    novo_cursor = cadeia.tamanho + nn;
+                    dentro = TRUE;
+                }
+                anexar_texto(buffer, &cadeia, novo, nn);
+                quantidade++;
+                j = 0;
+            }
+        }
+        if (!simular)
+            descartar_bloco(buffer, bloco);
+    }
+    anexar_texto(buffer, &cadeia, padrao, j);
+    free(falhas);
+
+    if (simular)
+        return quantidade;
+
+    if (cadeia.primeiro == NULL)
+    {
+        blocoTAD vazio = criar_bloco(buffer);
+        if (vazio == NULL)
+            exit(1);
+        encadear(&cadeia, vazio);
+        tocar(buffer, vazio);
+    }
+    buffer->primeiro = cadeia.primeiro;
+    buffer->ultimo = cadeia.ultimo;
+    buffer->nblocos = cadeia.nblocos;
+    buffer->tamanho = cadeia.tamanho;
+    buffer->alteracoes++;
+    buffer->visto = NULL;
+    if (quantidade > 0)
+        buffer->versao++;
+
+    if (!dentro)
+        novo_cursor = cursor + ganho - perda;
+    reposicionar(buffer, novo_cursor);
+    avancar_relogio(buffer);
+
+    return quantidade;
+}
+
+/**
+ * Procedimento: exibir_buffer
+ * Uso: exibir_buffer(buffer);
+ * ---------------------------
+ * Exibe o conteúdo atual do buffer no terminal, bloco por bloco. Os blocos
+ * comprimidos continuam comprimidos.
+ */
+
+void exibir_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: impressão de buffer null.\n");
+        return;
+    }
+
+    aplicar_pendentes(buffer);
+    for (blocoTAD b = buffer->primeiro; b != NULL; b = b->proximo)
+    {
+        const char *dados = ler_bloco(buffer, b);
+        for (int i = 0; i < b->tamanho; i++)
+            printf(" %c", dados[i]);
+    }
+    printf("\n");
+
+    for (size_t i = 0; i < buffer->cursor; i++)
+        printf("  ");
+    printf("^\n");
+}
+
+/**
+ * Procedimentos: iniciar_transacao, confirmar_transacao
+ * Uso: iniciar_transacao(buffer);
+ *      . . .
+ *      confirmar_transacao(buffer);
+ * -----------------------------------------------------
+ * A transação aberta fica em "transacao". Na confirmação, as edições
+ * pendentes são aplicadas por "aplicar_pendentes", e a transação passa a ser
+ * o registro para desfazer, junto com a versão do buffer naquele momento.
+ */
+
+void iniciar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+
+    if (buffer->transacao != NULL)
+        aninhar_transacao(buffer->transacao);
+    else
+        buffer->transacao = criar_transacao();
+}
+
+void confirmar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao == NULL)
+    {
+        fprintf(stderr, "Erro: nenhuma transação aberta.\n");
+        return;
+    }
+    else if (desaninhar_transacao(buffer->transacao))
+        return;
+
+    aplicar_pendentes(buffer);
+    liberar_transacao(&buffer->desfazer);
+    buffer->desfazer = buffer->transacao;
+    buffer->transacao = NULL;
+    buffer->versao_desfazer = buffer->versao;
+}
+
+/**
+ * Predicado: desfazer_transacao
+ * Uso: if (desfazer_transacao(buffer)) . . .
+ * ------------------------------------------
+ * A versão guardada na confirmação diz se o buffer foi alterado depois dela.
+ * As edições inversas são feitas com as operações comuns do buffer.
+ */
+
+bool desfazer_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: desfazer em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao != NULL || buffer->desfazer == NULL ||
+             buffer->versao != buffer->versao_desfazer)
+        return FALSE;
+
+    transacaoTAD desfazer = buffer->desfazer;
+    buffer->desfazer = NULL;
+    bool desfeita = reverter_transacao(desfazer, buffer);
+    liberar_transacao(&desfazer);
+    return desfeita;
+}
+
+/**
+ * Função: hash_buffer
+ * Uso: h = hash_buffer(buffer);
+ * -----------------------------
+ * O hash de um texto t[0..n-1] é a soma de (t[i] + 1) * BASEHASH^(n-1-i),
+ * módulo 2^64. Com essa definição, o hash da concatenação de dois trechos A e B
+ * é hash(A) * BASEHASH^|B| + hash(B); assim o hash do buffer é obtido combinando
+ * os hashes dos blocos, e não depende de onde estão as fronteiras entre os
+ * blocos. Os blocos "sujos" são recalculados; os demais não são percorridos.
+ * Um bloco comprimido nunca está sujo: o hash é atualizado antes da compressão.
+ */
+
+uint64_t hash_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: hash de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (buffer->alteracoes > 0)
+    {
+        uint64_t raiz = 0;
+        for (blocoTAD b = buffer->primeiro; b != NULL; b = b->proximo)
+        {
+            if (b->sujo)
+                atualizar_hash(b);
+            raiz = raiz * b->potencia + b->hash;
+        }
+        buffer->raiz = raiz;
+        buffer->alteracoes = 0;
+    }
+
+    return buffer->raiz;
+}
+
+/**
+ * Função: assinar_buffer
+ * Uso: assinatura = assinar_buffer(buffer);
+ * -----------------------------------------
+ * Copia o hash e o tamanho de cada bloco para uma nova assinatura.
+ */
+
+assinaturaTAD assinar_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: assinatura de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    assinaturaTAD A = malloc(sizeof(struct assinaturaTCD));
+    if (A == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar assinatura.\n");
+        return NULL;
+    }
+    A->hashes = malloc(buffer->nblocos * sizeof(uint64_t));
+    A->tamanhos = malloc(buffer->nblocos * sizeof(int));
+    if (A->hashes == NULL || A->tamanhos == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar assinatura.\n");
+        free(A->hashes);
+        free(A->tamanhos);
+        free(A);
+        return NULL;
+    }
+
+    A->raiz = hash_buffer(buffer);
+    A->nblocos = buffer->nblocos;
+    size_t i = 0;
+    for (blocoTAD b = buffer->primeiro; b != NULL; b = b->proximo, i++)
+    {
+        A->hashes[i] = b->hash;
+        A->tamanhos[i] = b->tamanho;
+    }
+
+    return A;
+}
+
+/**
+ * Procedimento: liberar_assinatura
+ * Uso: liberar_assinatura(&assinatura);
+ * -------------------------------------
+ * Libera a memória de uma assinatura e atribui NULL ao ponteiro original.
+ */
+
+void liberar_assinatura (assinaturaTAD *assinatura)
+{
+    if (assinatura != NULL && *assinatura != NULL)
+    {
+        free((*assinatura)->hashes);
+        free((*assinatura)->tamanhos);
+        free(*assinatura);
+        *assinatura = NULL;
+    }
+}
+
+/**
+ * Predicado: buffer_alterado
+ * Uso: if (buffer_alterado(buffer, assinatura)) . . .
+ * ---------------------------------------------------
+ * Compara o hash atual do buffer com o hash guardado na assinatura.
+ */
+
+bool buffer_alterado (bufferTAD buffer, assinaturaTAD assinatura)
+{
+    if (assinatura == NULL)
+        return TRUE;
+
+    return hash_buffer(buffer) != assinatura->raiz;
+}
+
+/**
+ * Função: regioes_alteradas
+ * Uso: n = regioes_alteradas(buffer, assinatura, regioes, max);
+ * -------------------------------------------------------------
+ * Monta uma tabela com os blocos da assinatura e percorre os blocos do buffer
+ * procurando, para cada um, o primeiro bloco igual (mesmo hash e mesmo
+ * tamanho) da assinatura que vem depois do último bloco casado. Os blocos sem
+ * correspondente formam as regiões alteradas; blocos da assinatura que foram
+ * pulados sem correspondente no buffer indicam uma remoção, registrada como
+ * uma região de tamanho 0. Sem memória para a tabela, o buffer inteiro é
+ * informado como uma única região alterada.
+ */
+
+size_t regioes_alteradas (bufferTAD buffer, assinaturaTAD assinatura,
+                          regiaoT regioes[], size_t max)
+{
+    if (buffer == NULL || assinatura == NULL)
+    {
+        fprintf(stderr, "Erro: comparação com buffer ou assinatura null.\n");
+        exit(1);
+    }
+
+    (void) hash_buffer(buffer);
+
+    tabela_blocosT tabela;
+    if (!tabelar_blocos(&tabela, assinatura->hashes, assinatura->tamanhos,
+                        assinatura->nblocos))
+    {
+        fprintf(stderr, "Erro: impossível alocar a comparação.\n");
+        if (max > 0)
+            regioes[0] = (regiaoT) { 0, buffer->tamanho };
+        return 1;
+    }
+
+    size_t j = 0, posicao = 0, n = 0, inicio = 0;
+    bool aberta = FALSE;
+    for (blocoTAD b = buffer->primeiro; b != NULL; b = b->proximo)
+    {
+        size_t k = procurar_bloco(&tabela, b->hash, b->tamanho, j);
+        if (k != SIZE_MAX)
+        {
+            if (k > j && !aberta)
+            {
+                aberta = TRUE;
+                inicio = posicao;
+            }
+            if (aberta)
+            {
+                if (n < max)
+                    regioes[n] = (regiaoT) { inicio, posicao - inicio };
+                n++;
+                aberta = FALSE;
+            }
+            j = k + 1;
+        }
+        else if (!aberta)
+        {
+            aberta = TRUE;
+            inicio = posicao;
+        }
+        posicao += b->tamanho;
+    }
+
+    if (aberta || j < assinatura->nblocos)
+    {
+        if (!aberta)
+            inicio = posicao;
+        if (n < max)
+            regioes[n] = (regiaoT) { inicio, posicao - inicio };
+        n++;
+    }
+
+    liberar_tabela(&tabela);
+    return n;
+}
+
+/**
+ * Função: comparar_buffers
+ * Uso: diferenca = comparar_buffers(antigo, novo);
+ * ------------------------------------------------
+ * Atualiza os hashes dos dois buffers e monta uma tabela com os blocos do
+ * antigo. Cada bloco do novo é procurado na tabela entre os blocos antigos
+ * que vêm depois do último bloco casado; se houver um, a janela entre este e o
+ * casamento anterior é comparada e o bloco é pulado. O que sobra depois do
+ * último casamento forma a última janela.
+ */
+
+diferencaTAD comparar_buffers (bufferTAD antigo, bufferTAD novo)
+{
+    if (antigo == NULL || novo == NULL)
+    {
+        fprintf(stderr, "Erro: comparação de buffer null.\n");
+        exit(1);
+    }
+
+    (void) hash_buffer(antigo);
+    (void) hash_buffer(novo);
+
+    diferencaTAD D = calloc(1, sizeof(struct diferencaTCD));
+    uint64_t *hashes = malloc(antigo->nblocos * sizeof(uint64_t));
+    int *tamanhos = malloc(antigo->nblocos * sizeof(int));
+    size_t *inicios = malloc(antigo->nblocos * sizeof(size_t));
+    tabela_blocosT tabela;
+    bool ok = (D != NULL && hashes != NULL && tamanhos != NULL &&
+               inicios != NULL);
+    if (ok)
+    {
+        size_t k = 0, posicao = 0;
+        for (blocoTAD b = antigo->primeiro; b != NULL; b = b->proximo, k++)
+        {
+            hashes[k] = b->hash;
+            tamanhos[k] = b->tamanho;
+            inicios[k] = posicao;
+            posicao += b->tamanho;
+        }
+        ok = tabelar_blocos(&tabela, hashes, tamanhos, antigo->nblocos);
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: impossível alocar a comparação.\n");
+        free(D);
+        free(hashes);
+        free(tamanhos);
+        free(inicios);
+        return NULL;
+    }
+
+    D->antigo = antigo->tamanho;
+    D->novo = novo->tamanho;
+    size_t minimo = 0, fim_a = 0, fim_b = 0, posicao = 0;
+    for (blocoTAD b = novo->primeiro; b != NULL && ok; b = b->proximo)
+    {
+        size_t k = SIZE_MAX;
+        if (b->tamanho > 0)
+            k = procurar_bloco(&tabela, b->hash, b->tamanho, minimo);
+        if (k != SIZE_MAX)
+        {
+            if (inicios[k] > fim_a || posicao > fim_b)
+                ok = comparar_janela(D, antigo, fim_a, inicios[k], novo,
+                                     fim_b, posicao);
+            D->metricas.iguais++;
+            minimo = k + 1;
+            fim_a = inicios[k] + b->tamanho;
+            fim_b = posicao + b->tamanho;
+        }
+        posicao += b->tamanho;
+    }
+    if (ok && (fim_a < antigo->tamanho || fim_b < novo->tamanho))
+        ok = comparar_janela(D, antigo, fim_a, antigo->tamanho, novo, fim_b,
+                             novo->tamanho);
+
+    liberar_tabela(&tabela);
+    free(hashes);
+    free(tamanhos);
+    free(inicios);
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: impossível alocar a comparação.\n");
+        liberar_diferenca(&D);
+    }
+    return D;
+}
+
+/**
+ * Funções: quantidade_de_edicoes, edicao_da_diferenca
+ * Uso: n = quantidade_de_edicoes(diferenca);
+ *      edicao = edicao_da_diferenca(diferenca, k);
+ * -------------------------------------------------
+ * O texto da edição é obtido somando a sua posição ao início de "textos".
+ */
+
+size_t quantidade_de_edicoes (diferencaTAD diferenca)
+{
+    if (diferenca == NULL)
+    {
+        fprintf(stderr, "Erro: diferença null.\n");
+        exit(1);
+    }
+    return diferenca->nedicoes;
+}
+
+edicaoT edicao_da_diferenca (diferencaTAD diferenca, size_t k)
+{
+    if (diferenca == NULL || k >= diferenca->nedicoes)
+    {
+        fprintf(stderr, "Erro: edição inexistente.\n");
+        exit(1);
+    }
+
+    alteracaoT *a = &diferenca->edicoes[k];
+    edicaoT edicao = {a->antiga, a->removidos, a->nova, a->inseridos,
+                      diferenca->textos + a->texto};
+    return edicao;
+}
+
+/**
+ * Predicado: aplicar_diferenca
+ * Uso: if (aplicar_diferenca(buffer, diferenca)) . . .
+ * ----------------------------------------------------
+ * Como as edições estão em ordem crescente de posição, aplicá-las da última
+ * para a primeira mantém válidas as posições das que ainda faltam.
+ */
+
+bool aplicar_diferenca (bufferTAD buffer, diferencaTAD diferenca)
+{
+    if (buffer == NULL || diferenca == NULL)
+    {
+        fprintf(stderr, "Erro: aplicação de diferença em buffer null.\n");
+        exit(1);
+    }
+    else if (tamanho_buffer(buffer) != diferenca->antigo)
+    {
+        fprintf(stderr, "Erro: o buffer não tem o texto antigo.\n");
+        return FALSE;
+    }
+
+    for (size_t k = diferenca->nedicoes; k-- > 0; )
+    {
+        alteracaoT *a = &diferenca->edicoes[k];
+        mover_cursor_para_posicao(buffer, a->antiga);
+        apagar_texto(buffer, a->removidos);
+        inserir_texto(buffer, diferenca->textos + a->texto, a->inseridos);
+    }
+    return TRUE;
+}
+
+/**
+ * Procedimento: obter_metricas_diferenca
+ * Uso: obter_metricas_diferenca(diferenca, &metricas);
+ * ----------------------------------------------------
+ * Copia as métricas guardadas na diferença.
+ */
+
+void obter_metricas_diferenca (diferencaTAD diferenca,
+                               metricas_diferencaT *metricas)
+{
+    if (diferenca == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: métricas de diferença null.\n");
+        exit(1);
+    }
+    *metricas = diferenca->metricas;
+}
+
+/**
+ * Procedimento: liberar_diferenca
+ * Uso: liberar_diferenca(&diferenca);
+ * -----------------------------------
+ * Libera as edições, o texto inserido e a própria diferença.
+ */
+
+void liberar_diferenca (diferencaTAD *diferenca)
+{
+    if (diferenca != NULL && *diferenca != NULL)
+    {
+        free((*diferenca)->edicoes);
+        free((*diferenca)->textos);
+        free(*diferenca);
+        *diferenca = NULL;
+    }
+}
+
+/**
+ * Função: mapear_arquivo
+ * Uso: if (mapear_arquivo(buffer, nome)) . . .
+ * --------------------------------------------
+ * Mapeia o arquivo inteiro (somente leitura, MAP_PRIVATE) e substitui o bloco
+ * vazio do buffer por uma lista de blocos mapeados de TAMMAPA caracteres. O
+ * descritor do arquivo pode ser fechado logo depois do mmap.
+ */
+
+bool mapear_arquivo (bufferTAD buffer, string nome)
+{
+    if (buffer == NULL || nome == NULL)
+    {
+        fprintf(stderr, "Erro: mapeamento em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (buffer->tamanho > 0 || buffer->mapa != NULL)
+    {
+        fprintf(stderr, "Erro: o buffer precisa estar vazio.\n");
+        return FALSE;
+    }
+
+    int fd = open(nome, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        fprintf(stderr, "Erro: impossível abrir \"%s\".\n", nome);
+        if (fd >= 0)
+            close(fd);
+        return FALSE;
+    }
+
+    size_t tamanho = (size_t) info.st_size;
+    if (tamanho == 0)
+    {
+        close(fd);
+        return TRUE;
+    }
+    void *dados = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dados == MAP_FAILED)
+    {
+        fprintf(stderr, "Erro: impossível mapear \"%s\".\n", nome);
+        return FALSE;
+    }
+    armazemTAD mapa = criar_armazem(dados, tamanho, TRUE);
+    if (mapa == NULL)
+    {
+        munmap(dados, tamanho);
+        return FALSE;
+    }
+
+    blocoTAD vazio = buffer->primeiro, ultimo = vazio;
+    for (size_t i = 0; i < tamanho; i += TAMMAPA)
+    {
+        int k = (tamanho - i < TAMMAPA) ? (int) (tamanho - i) : TAMMAPA;
+        blocoTAD bloco = criar_bloco_compartilhado(mapa, mapa->dados + i, k);
+        if (bloco == NULL)
+        {
+            while (vazio->proximo != NULL)
+            {
+                blocoTAD b = vazio->proximo;
+                desligar_bloco(buffer, b);
+                remover_bloco(&b);
+            }
+            soltar_armazem(&mapa);
+            return FALSE;
+        }
+        ligar_bloco_depois(buffer, ultimo, bloco);
+        ultimo = bloco;
+    }
+
+    desligar_bloco(buffer, vazio);
+    remover_bloco(&vazio);
+    buffer->mapa = mapa;
+    buffer->tamanho = tamanho;
+    buffer->atual = buffer->primeiro;
+    buffer->deslocamento = 0;
+    buffer->cursor = 0;
+    buffer->versao++;
+    if (buffer->transacao != NULL)
+        guardar_para_desfazer(buffer->transacao, 0, tamanho, NULL, 0);
+
+    return TRUE;
+}
+
+/**
+ * Função: gravar_instantaneo
+ * Uso: if (gravar_instantaneo(buffer, nome, &resumo)) . . .
+ * ---------------------------------------------------------
+ * Grava "<nome>.tmp" com escritas sequenciais (o cabeçalho provisório, o texto
+ * de cada bloco, lido sem descomprimir de vez, e a tabela), regrava o
+ * cabeçalho, sincroniza o arquivo com o disco e o renomeia para "nome". Um
+ * buffer aberto a partir de "nome" continua válido, pois o arquivo antigo só
+ * deixa de existir quando o seu mapeamento é desfeito.
+ */
+
+bool gravar_instantaneo (bufferTAD buffer, string nome,
+                         resumo_instantaneoT *resumo)
+{
+    if (buffer == NULL || nome == NULL)
+    {
+        fprintf(stderr, "Erro: instantâneo de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    char *temporario = malloc(strlen(nome) + 5);
+    entrada_instantaneoT *tabela = malloc(buffer->nblocos *
+                                          sizeof(entrada_instantaneoT));
+    if (temporario == NULL || tabela == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar o instantâneo.\n");
+        free(temporario);
+        free(tabela);
+        return FALSE;
+    }
+    sprintf(temporario, "%s.tmp", nome);
+
+    cabecalho_instantaneoT c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magico, MAGICO_INSTANTANEO, sizeof(c.magico));
+    c.formato = FORMATO_INSTANTANEO;
+    c.texto = sizeof(c);
+    c.tabela = (c.texto + buffer->tamanho + 7) / 8 * 8;
+    c.nblocos = buffer->nblocos;
+    c.tamanho = buffer->tamanho;
+    c.cursor = buffer->cursor;
+    c.raiz = hash_buffer(buffer);
+
+    FILE *arq = fopen(temporario, "wb");
+    bool ok = (arq != NULL && fwrite(&c, sizeof(c), 1, arq) == 1);
+    size_t i = 0;
+    for (blocoTAD b = buffer->primeiro; ok && b != NULL; b = b->proximo, i++)
+    {
+        const char *dados = ler_bloco(buffer, b);
+        const char *p = dados, *fim = dados + b->tamanho;
+        uint32_t linhas = 0;
+        while ((p = memchr(p, '\n', fim - p)) != NULL)
+        {
+            linhas++;
+            p++;
+        }
+        tabela[i] = (entrada_instantaneoT) { b->tamanho, linhas, b->hash,
+                                             b->potencia };
+        c.linhas += linhas;
+        ok = (fwrite(dados, 1, b->tamanho, arq) == (size_t) b->tamanho);
+    }
+    if (ok)
+    {
+        static const char zeros[8];
+        size_t alinhamento = c.tabela - c.texto - c.tamanho;
+        ok = fwrite(zeros, 1, alinhamento, arq) == alinhamento &&
+             fwrite(tabela, sizeof(entrada_instantaneoT), c.nblocos, arq) ==
+             c.nblocos &&
+             fseek(arq, 0, SEEK_SET) == 0 &&
+             fwrite(&c, sizeof(c), 1, arq) == 1 &&
+             fflush(arq) == 0 && fsync(fileno(arq)) == 0;
+    }
+    if (arq != NULL)
+        ok = (fclose(arq) == 0) && ok;
+    ok = ok && (rename(temporario, nome) == 0);
+
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: impossível gravar o instantâneo \"%s\": %s.\n",
+                nome, strerror(errno));
+        remove(temporario);
+    }
+    else if (resumo != NULL)
+    {
+        resumo->blocos = c.nblocos;
+        resumo->linhas = c.linhas;
+        resumo->hash = c.raiz;
+    }
+    free(temporario);
+    free(tabela);
+
+    return ok;
+}
+
+/**
+ * Função: abrir_instantaneo
+ * Uso: if (abrir_instantaneo(buffer, nome, &resumo)) . . .
+ * --------------------------------------------------------
+ * Mapeia o arquivo inteiro, confere o cabeçalho e a tabela (percorrendo só a
+ * tabela) e substitui o bloco vazio do buffer por um bloco mapeado para cada
+ * entrada, com o hash e a potência da entrada. O hash do buffer também vem do
+ * cabeçalho, e o cursor volta para onde estava.
+ */
+
+bool abrir_instantaneo (bufferTAD buffer, string nome,
+                        resumo_instantaneoT *resumo)
+{
+    if (buffer == NULL || nome == NULL)
+    {
+        fprintf(stderr, "Erro: instantâneo em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (buffer->tamanho > 0 || buffer->mapa != NULL)
+    {
+        fprintf(stderr, "Erro: o buffer precisa estar vazio.\n");
+        return FALSE;
+    }
+
+    int fd = open(nome, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0)
+    {
+        fprintf(stderr, "Erro: impossível abrir \"%s\".\n", nome);
+        if (fd >= 0)
+            close(fd);
+        return FALSE;
+    }
+
+    size_t tamanho = (size_t) info.st_size;
+    void *dados = MAP_FAILED;
+    if (tamanho >= sizeof(cabecalho_instantaneoT))
+        dados = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dados == MAP_FAILED || !conferir_instantaneo(dados, tamanho))
+    {
+        fprintf(stderr, "Erro: \"%s\" não é um instantâneo válido.\n", nome);
+        if (dados != MAP_FAILED)
+            munmap(dados, tamanho);
+        return FALSE;
+    }
+
+    const cabecalho_instantaneoT *c = dados;
+    const entrada_instantaneoT *tabela = (const entrada_instantaneoT *)
+                                         ((char *) dados + c->tabela);
+    if (resumo != NULL)
+    {
+        resumo->blocos = c->nblocos;
+        resumo->linhas = c->linhas;
+        resumo->hash = c->raiz;
+    }
+    if (c->tamanho == 0)
+    {
+        munmap(dados, tamanho);
+        return TRUE;
+    }
+    armazemTAD mapa = criar_armazem(dados, tamanho, TRUE);
+    if (mapa == NULL)
+    {
+        munmap(dados, tamanho);
+        return FALSE;
+    }
+
+    blocoTAD vazio = buffer->primeiro, ultimo = vazio;
+    char *texto = mapa->dados + c->texto;
+    for (size_t i = 0; i < c->nblocos; i++)
+    {
+        if (tabela[i].tamanho == 0)
+            continue;
+        blocoTAD bloco = criar_bloco_compartilhado(mapa, texto,
+                                                   (int) tabela[i].tamanho);
+        if (bloco == NULL)
+        {
+            while (vazio->proximo != NULL)
+            {
+                blocoTAD b = vazio->proximo;
+                desligar_bloco(buffer, b);
+                remover_bloco(&b);
+            }
+            soltar_armazem(&mapa);
+            return FALSE;
+        }
+        bloco->hash = tabela[i].hash;
+        bloco->potencia = tabela[i].potencia;
+        bloco->sujo = FALSE;
+        ligar_bloco_depois(buffer, ultimo, bloco);
+        ultimo = bloco;
+        texto += tabela[i].tamanho;
+    }
+
+    desligar_bloco(buffer, vazio);
+    remover_bloco(&vazio);
+    buffer->mapa = mapa;
+    buffer->tamanho = c->tamanho;
+    buffer->raiz = c->raiz;
+    buffer->alteracoes = 0;
+    buffer->versao++;
+    if (buffer->transacao != NULL)
+        guardar_para_desfazer(buffer->transacao, 0, c->tamanho, NULL, 0);
+    reposicionar(buffer, c->cursor);
+
+    return TRUE;
+}
+
+/**
+ * Procedimento: configurar_compressao
+ * Uso: configurar_compressao(buffer, janela);
+ * -------------------------------------------
+ * Apenas registra a janela: os blocos frios são comprimidos ao longo das
+ * próximas operações, por "avancar_relogio".
+ */
+
+void configurar_compressao (bufferTAD buffer, unsigned long janela)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: compressão de buffer null.\n");
+        exit(1);
+    }
+
+    buffer->janela = janela;
+}
+
+/**
+ * Procedimento: obter_metricas_compressao
+ * Uso: obter_metricas_compressao(buffer, &metricas);
+ * --------------------------------------------------
+ * Copia as métricas mantidas no próprio buffer.
+ */
+
+void obter_metricas_compressao (bufferTAD buffer,
+                                metricas_compressaoT *metricas)
+{
+    if (buffer == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: métricas de buffer null.\n");
+        exit(1);
+    }
+
+    *metricas = buffer->compressao;
+}
+
+/**
+ * Procedimentos: limitar_memoria, limitar_memoria_processo
+ * Uso: limitar_memoria(buffer, limite);
+ *      limitar_memoria_processo(limite);
+ * -----------------------------------------------------
+ * Registram o limite e, no caso do buffer, já despejam o que for preciso; os
+ * outros buffers se ajustam ao limite do processo na próxima operação.
+ */
+
+void limitar_memoria (bufferTAD buffer, size_t limite)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: limite de memória em buffer null.\n");
+        exit(1);
+    }
+
+    buffer->limite = limite;
+    if (excede_limite(buffer))
+        despejar_frios(buffer, NULL);
+}
+
+void limitar_memoria_processo (size_t limite)
+{
+    atomic_store(&limite_processo, limite);
+}
+
+/**
+ * Procedimento: obter_metricas_despejo
+ * Uso: obter_metricas_despejo(buffer, &metricas);
+ * -----------------------------------------------
+ * Copia as métricas mantidas no buffer e completa as que são calculadas.
+ */
+
+void obter_metricas_despejo (bufferTAD buffer, metricas_despejoT *metricas)
+{
+    if (buffer == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: métricas de buffer null.\n");
+        exit(1);
+    }
+
+    *metricas = buffer->metricas;
+    metricas->residentes = buffer->residentes * TAMBLOCO;
+    metricas->processo = atomic_load(&memoria_processo);
+    metricas->despejados = buffer->vagas - buffer->nlivres;
+}
+
+/**
+ * Funções: copiar_trecho, recortar_trecho
+ * Uso: trecho = copiar_trecho(buffer, n);
+ *      trecho = recortar_trecho(buffer, n);
+ * -----------------------------------------
+ * Os blocos comuns alcançados pelo trecho passam a ser compartilhados (o array
+ * de cada um vira um armazém, sem cópia) e o trecho guarda uma parte, com uma
+ * referência para o armazém, por bloco. Para recortar, o trecho é copiado e
+ * os blocos do intervalo são separados nas pontas e desligados da lista.
+ */
+
+trechoTAD copiar_trecho (bufferTAD buffer, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cópia de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (n > buffer->tamanho - buffer->cursor)
+        n = buffer->tamanho - buffer->cursor;
+
+    int inicio;
+    blocoTAD primeiro = localizar(buffer, buffer->cursor, &inicio);
+    size_t npartes = 0;
+    blocoTAD b = primeiro;
+    for (size_t resta = n, d = inicio; resta > 0; b = b->proximo, d = 0)
+    {
+        if (d < (size_t) b->tamanho)
+        {
+            size_t k = b->tamanho - d;
+            resta -= (k < resta) ? k : resta;
+            npartes++;
+        }
+    }
+
+    trechoTAD trecho = calloc(1, sizeof(struct trechoTCD));
+    parteT *partes = (npartes > 0) ? malloc(npartes * sizeof(parteT)) : NULL;
+    if (trecho == NULL || (npartes > 0 && partes == NULL))
+    {
+        fprintf(stderr, "Erro: impossível alocar trecho.\n");
+        free(trecho);
+        free(partes);
+        return NULL;
+    }
+
+    size_t i = 0;
+    b = primeiro;
+    for (size_t resta = n, d = inicio; resta > 0; b = b->proximo, d = 0)
+    {
+        if (d < (size_t) b->tamanho)
+        {
+            size_t k = b->tamanho - d;
+            if (k > resta)
+                k = resta;
+            compartilhar(buffer, b);
+            partes[i].armazem = reter_armazem(b->armazem);
+            partes[i].dados = b->dados + d;
+            partes[i].tamanho = (int) k;
+            i++;
+            resta -= k;
+        }
+    }
+    trecho->tamanho = n;
+    trecho->npartes = npartes;
+    trecho->partes = partes;
+
+    return trecho;
+}
+
+trechoTAD recortar_trecho (bufferTAD buffer, size_t n)
+{
+    trechoTAD trecho = copiar_trecho(buffer, n);
+    if (trecho != NULL)
+    {
+        if (buffer->transacao != NULL)
+            guardar_recorte(buffer, trecho->tamanho);
+        remover_intervalo(buffer, trecho->tamanho);
+    }
+
+    return trecho;
+}
+
+/**
+ * Procedimento: colar_trecho
+ * Uso: colar_trecho(buffer, trecho);
+ * ----------------------------------
+ * Separa o bloco do cursor na posição do cursor e liga, nesse ponto, um novo
+ * bloco compartilhado para cada parte do trecho. Nenhum caractere é copiado.
+ */
+
+void colar_trecho (bufferTAD buffer, trechoTAD trecho)
+{
+    if (buffer == NULL || trecho == NULL)
+    {
+        fprintf(stderr, "Erro: colagem em buffer null.\n");
+        exit(1);
+    }
+    else if (trecho->tamanho == 0)
+        return;
+
+    aplicar_pendentes(buffer);
+    size_t cursor = buffer->cursor;
+    blocoTAD vazio = (buffer->tamanho == 0) ? buffer->primeiro : NULL;
+    blocoTAD depois = separar(buffer, cursor);
+    blocoTAD antes = (depois != NULL) ? depois->anterior : buffer->ultimo;
+
+    for (size_t i = 0; i < trecho->npartes; i++)
+    {
+        parteT *parte = &trecho->partes[i];
+        blocoTAD novo = criar_bloco_compartilhado(parte->armazem, parte->dados,
+                                                  parte->tamanho);
+        if (novo == NULL)
+            exit(1);
+        ligar_bloco_depois(buffer, antes, novo);
+        antes = novo;
+    }
+    if (vazio != NULL)
+    {
+        desligar_bloco(buffer, vazio);
+        remover_bloco(&vazio);
+    }
+
+    buffer->tamanho += trecho->tamanho;
+    buffer->versao++;
+    if (buffer->transacao != NULL)
+        guardar_para_desfazer(buffer->transacao, cursor, trecho->tamanho, NULL,
+                              0);
+    reposicionar(buffer, cursor + trecho->tamanho);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Função: tamanho_trecho
+ * Uso: n = tamanho_trecho(trecho);
+ * --------------------------------
+ * Retorna a quantidade de caracteres guardada no trecho.
+ */
+
+size_t tamanho_trecho (trechoTAD trecho)
+{
+    if (trecho == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de trecho null.\n");
+        exit(1);
+    }
+
+    return trecho->tamanho;
+}
+
+/**
+ * Procedimento: liberar_trecho
+ * Uso: liberar_trecho(&trecho);
+ * -----------------------------
+ * Devolve as referências das partes e libera o trecho.
+ */
+
+void liberar_trecho (trechoTAD *trecho)
+{
+    if (trecho == NULL || *trecho == NULL)
+        return;
+
+    for (size_t i = 0; i < (*trecho)->npartes; i++)
+        soltar_armazem(&(*trecho)->partes[i].armazem);
+    free((*trecho)->partes);
+    free(*trecho);
+    *trecho = NULL;
+}
+
+/**
+ * Função: criar_anel
+ * Uso: anel = criar_anel(capacidade);
+ * -----------------------------------
+ * Aloca o anel com o array circular vazio.
+ */
+
+anelTAD criar_anel (int capacidade)
+{
+    if (capacidade < 1)
+        capacidade = 1;
+
+    anelTAD A = calloc(1, sizeof(struct anelTCD));
+    if (A == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar anel.\n");
+        return NULL;
+    }
+
+    A->trechos = calloc(capacidade, sizeof(trechoTAD));
+    if (A->trechos == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar anel.\n");
+        free(A);
+        return NULL;
+    }
+    A->capacidade = capacidade;
+
+    return A;
+}
+
+/**
+ * Procedimento: liberar_anel
+ * Uso: liberar_anel(&anel);
+ * -------------------------
+ * Libera os trechos guardados e o anel.
+ */
+
+void liberar_anel (anelTAD *anel)
+{
+    if (anel == NULL || *anel == NULL)
+        return;
+
+    for (int k = 0; k < (*anel)->quantidade; k++)
+        liberar_trecho(&(*anel)->trechos[((*anel)->inicio + k) %
+                                         (*anel)->capacidade]);
+    free((*anel)->trechos);
+    free(*anel);
+    *anel = NULL;
+}
+
+/**
+ * Procedimento: guardar_no_anel
+ * Uso: guardar_no_anel(anel, trecho);
+ * -----------------------------------
+ * O novo trecho ocupa a posição anterior à do mais recente; com o anel cheio,
+ * essa posição é a do trecho mais antigo, que é liberado antes.
+ */
+
+void guardar_no_anel (anelTAD anel, trechoTAD trecho)
+{
+    if (anel == NULL || trecho == NULL)
+    {
+        fprintf(stderr, "Erro: anel ou trecho null.\n");
+        exit(1);
+    }
+
+    anel->inicio = (anel->inicio + anel->capacidade - 1) % anel->capacidade;
+    if (anel->quantidade == anel->capacidade)
+        liberar_trecho(&anel->trechos[anel->inicio]);
+    else
+        anel->quantidade++;
+    anel->trechos[anel->inicio] = trecho;
+}
+
+/**
+ * Funções: trecho_do_anel, quantidade_no_anel
+ * Uso: trecho = trecho_do_anel(anel, k);
+ *      n = quantidade_no_anel(anel);
+ * ---------------------------------------
+ * Retornam o k-ésimo trecho mais recente (ou NULL) e a quantidade de trechos.
+ */
+
+trechoTAD trecho_do_anel (anelTAD anel, int k)
+{
+    if (anel == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a anel null.\n");
+        exit(1);
+    }
+    else if (k < 0 || k >= anel->quantidade)
+        return NULL;
+
+    return anel->trechos[(anel->inicio + k) % anel->capacidade];
+}
+
+int quantidade_no_anel (anelTAD anel)
+{
+    if (anel == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a anel null.\n");
+        exit(1);
+    }
+
+    return anel->quantidade;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: criar_bloco
+ * Uso: bloco = criar_bloco(buffer);
+ * ---------------------------------
+ * Cria um bloco vazio do buffer, desligado de qualquer lista. Retorna NULL se
+ * não houver memória.
+ */
+
+static blocoTAD criar_bloco (bufferTAD buffer)
+{
+    blocoTAD bloco = calloc(1, sizeof(struct blocoTCD));
+    if (bloco == NULL)
+    {
+        fprintf(stderr, "Erro: impossível criar bloco.\n");
+        return NULL;
+    }
+
+    bloco->dados = malloc(TAMBLOCO);
+    if (bloco->dados == NULL)
+    {
+        fprintf(stderr, "Erro: impossível criar bloco.\n");
+        free(bloco);
+        return NULL;
+    }
+    bloco->sujo = TRUE;
+    bloco->dono = buffer;
+    contar_residente(bloco, 1);
+
+    return bloco;
+}
+
+/**
+ * Função: criar_bloco_compartilhado
+ * Uso: bloco = criar_bloco_compartilhado(armazem, dados, tamanho);
+ * ----------------------------------------------------------------
+ * Cria um bloco, desligado de qualquer lista, cujos "tamanho" caracteres
+ * estão em "dados", dentro de "armazem", e que passa a deter uma referência
+ * para o armazém. Retorna NULL se não houver memória.
+ */
+
+static blocoTAD criar_bloco_compartilhado (armazemTAD armazem, char *dados,
+                                           int tamanho)
+{
+    blocoTAD bloco = calloc(1, sizeof(struct blocoTCD));
+    if (bloco == NULL)
+    {
+        fprintf(stderr, "Erro: impossível criar bloco.\n");
+        return NULL;
+    }
+
+    bloco->dados = dados;
+    bloco->tamanho = tamanho;
+    bloco->armazem = reter_armazem(armazem);
+    bloco->sujo = TRUE;
+
+    return bloco;
+}
+
+/**
+ * Procedimento: materializar
+ * Uso: materializar(buffer);
+ * --------------------------
+ * Se o bloco do cursor é compartilhado (ou mapeado), copia para um bloco comum
+ * um trecho de até TAMBLOCO / 2 caracteres em volta do cursor (deixando espaço
+ * para inserções), e divide o bloco compartilhado em um bloco antes e outro
+ * depois desse trecho. O cursor passa para o bloco comum. O conteúdo do buffer
+ * não muda.
+ */
+
+static void materializar (bufferTAD buffer)
+{
+    blocoTAD bloco = buffer->atual;
+    if (bloco->armazem == NULL)
+        return;
+
+    int k = TAMBLOCO / 2;
+    int inicio = buffer->deslocamento > k / 2 ? buffer->deslocamento - k / 2 : 0;
+    int fim = inicio + k < bloco->tamanho ? inicio + k : bloco->tamanho;
+    char *origem = bloco->dados;
+
+    if (fim < bloco->tamanho)
+    {
+        blocoTAD sufixo = criar_bloco_compartilhado(bloco->armazem,
+                                                    origem + fim,
+                                                    bloco->tamanho - fim);
+        if (sufixo == NULL)
+            exit(1);
+        ligar_bloco_depois(buffer, bloco, sufixo);
+    }
+
+    blocoTAD comum = criar_bloco(buffer);
+    if (comum == NULL)
+        exit(1);
+    memcpy(comum->dados, origem + inicio, fim - inicio);
+    comum->tamanho = fim - inicio;
+    ligar_bloco_depois(buffer, bloco, comum);
+
+    buffer->atual = comum;
+    buffer->deslocamento -= inicio;
+    if (inicio > 0)
+    {
+        bloco->tamanho = inicio;
+        bloco->sujo = TRUE;
+    }
+    else
+    {
+        desligar_bloco(buffer, bloco);
+        remover_bloco(&bloco);
+    }
+}
+
+/**
+ * Procedimento: remover_bloco
+ * Uso: remover_bloco(&bloco);
+ * ---------------------------
+ * Libera a memória de um bloco (já desligado da lista) e atribui NULL ao
+ * ponteiro original. Os dados de um bloco compartilhado pertencem ao armazém,
+ * do qual o bloco apenas devolve a sua referência; a vaga de um bloco
+ * despejado volta a ficar livre.
+ */
+
+static void remover_bloco (blocoTAD *bloco)
+{
+    if (bloco == NULL || *bloco == NULL)
+    {
+        fprintf(stderr, "Erro: não há bloco para liberar.\n");
+        return;
+    }
+
+    if ((*bloco)->armazem != NULL)
+        soltar_armazem(&(*bloco)->armazem);
+    else if ((*bloco)->dados != NULL)
+    {
+        contar_residente(*bloco, -1);
+        free((*bloco)->dados);
+    }
+    if ((*bloco)->despejado)
+        devolver_vaga((*bloco)->dono, *bloco);
+    free((*bloco)->compactado);
+    free(*bloco);
+    *bloco = NULL;
+}
+
+/**
+ * Procedimentos: ligar_bloco_depois, desligar_bloco
+ * Uso: ligar_bloco_depois(buffer, bloco, novo);
+ *      desligar_bloco(buffer, bloco);
+ * -------------------------------------------------
+ * Ligam o bloco "novo" à lista logo após "bloco" (ou no início da lista, se
+ * "bloco" for NULL), ou retiram "bloco" da lista, mantendo atualizados os
+ * ponteiros para o primeiro e o último bloco, a quantidade de blocos e a fila
+ * de acesso (e esquecendo o bloco guardado por "localizar"). "desligar_bloco"
+ * não libera a memória do bloco.
+ */
+
+static void ligar_bloco_depois (bufferTAD buffer, blocoTAD bloco,
+                                blocoTAD novo)
+{
+    blocoTAD proximo = (bloco != NULL) ? bloco->proximo : buffer->primeiro;
+
+    novo->anterior = bloco;
+    novo->proximo = proximo;
+    if (proximo != NULL)
+        proximo->anterior = novo;
+    else
+        buffer->ultimo = novo;
+    if (bloco != NULL)
+        bloco->proximo = novo;
+    else
+        buffer->primeiro = novo;
+    buffer->nblocos++;
+    buffer->alteracoes++;
+    buffer->visto = NULL;
+    tocar(buffer, novo);
+}
+
+static void desligar_bloco (bufferTAD buffer, blocoTAD bloco)
+{
+    if (bloco->anterior != NULL)
+        bloco->anterior->proximo = bloco->proximo;
+    else
+        buffer->primeiro = bloco->proximo;
+    if (bloco->proximo != NULL)
+        bloco->proximo->anterior = bloco->anterior;
+    else
+        buffer->ultimo = bloco->anterior;
+    bloco->anterior = bloco->proximo = NULL;
+    buffer->nblocos--;
+    buffer->alteracoes++;
+    buffer->visto = NULL;
+    if (bloco->na_fila)
+        retirar_da_fila(buffer, bloco);
+}
+
+/**
+ * Função: dividir_bloco
+ * Uso: novo = dividir_bloco(buffer, bloco, posicao);
+ * --------------------------------------------------
+ * Move os caracteres de "bloco" a partir de "posicao" para um novo bloco, que é
+ * ligado à lista logo após "bloco", e retorna o novo bloco. Termina o programa
+ * se não houver memória.
+ */
+
+static blocoTAD dividir_bloco (bufferTAD buffer, blocoTAD bloco, int posicao)
+{
+    blocoTAD novo = criar_bloco(buffer);
+    if (novo == NULL)
+    {
+        fprintf(stderr, "Erro: impossível dividir bloco.\n");
+        exit(1);
+    }
+
+    novo->tamanho = bloco->tamanho - posicao;
+    memcpy(novo->dados, bloco->dados + posicao, novo->tamanho);
+    bloco->tamanho = posicao;
+    ligar_bloco_depois(buffer, bloco, novo);
+    marcar_alteracao(buffer, bloco);
+
+    return novo;
+}
+
+/**
+ * Procedimento: marcar_alteracao
+ * Uso: marcar_alteracao(buffer, bloco);
+ * -------------------------------------
+ * Registra que o conteúdo de "bloco" mudou: o hash do bloco e o hash do buffer
+ * precisam ser recalculados, e o bloco (que pode ter passado a ser
+ * compressível) volta para o início da fila de acesso.
+ */
+
+static void marcar_alteracao (bufferTAD buffer, blocoTAD bloco)
+{
+    bloco->sujo = TRUE;
+    bloco->incompressivel = FALSE;
+    buffer->alteracoes++;
+    buffer->versao++;
+    tocar(buffer, bloco);
+}
+
+/**
+ * Procedimento: atualizar_hash
+ * Uso: atualizar_hash(bloco);
+ * ---------------------------
+ * Recalcula o hash e a potência de um bloco pelo método de Horner.
+ */
+
+static void atualizar_hash (blocoTAD bloco)
+{
+    uint64_t hash = 0, potencia = 1;
+
+    for (int i = 0; i < bloco->tamanho; i++)
+    {
+        hash = hash * BASEHASH + (unsigned char) bloco->dados[i] + 1;
+        potencia *= BASEHASH;
+    }
+    bloco->hash = hash;
+    bloco->potencia = potencia;
+    bloco->sujo = FALSE;
+}
+
+/**
+ * Função: localizar
+ * Uso: bloco = localizar(buffer, posicao, &deslocamento);
+ * -------------------------------------------------------
+ * Retorna o bloco que contém a posição absoluta "posicao" (que não pode ser
+ * maior do que o tamanho do buffer) e armazena em "deslocamento" a posição
+ * dentro desse bloco. A busca começa pelo ponto conhecido mais próximo: o
+ * início do buffer, o bloco do cursor, o último bloco ou o bloco encontrado
+ * na busca anterior.
+ */
+
+static blocoTAD localizar (bufferTAD buffer, size_t posicao, int *deslocamento)
+{
+    blocoTAD b = buffer->atual;
+    size_t inicio = buffer->cursor - buffer->deslocamento;
+
+    if (posicao < inicio / 2)
+    {
+        b = buffer->primeiro;
+        inicio = 0;
+    }
+    else if (posicao > inicio &&
+             posicao - inicio > (buffer->tamanho - inicio) / 2)
+    {
+        b = buffer->ultimo;
+        inicio = buffer->tamanho - b->tamanho;
+    }
+    if (buffer->visto != NULL && buffer->versao_vista == buffer->versao &&
+        distancia(posicao, buffer->inicio_visto) < distancia(posicao, inicio))
+    {
+        b = buffer->visto;
+        inicio = buffer->inicio_visto;
+    }
+
+    while (posicao < inicio)
+    {
+        b = b->anterior;
+        inicio -= b->tamanho;
+    }
+    while (posicao > inicio + b->tamanho)
+    {
+        inicio += b->tamanho;
+        b = b->proximo;
+    }
+
+    buffer->visto = b;
+    buffer->inicio_visto = inicio;
+    buffer->versao_vista = buffer->versao;
+    *deslocamento = (int) (posicao - inicio);
+    return b;
+}
+
+/**
+ * Função: distancia
+ * Uso: d = distancia(a, b);
+ * -------------------------
+ * Retorna a distância entre duas posições do buffer.
+ */
+
+static size_t distancia (size_t a, size_t b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+/**
+ * Procedimento: tocar
+ * Uso: tocar(buffer, bloco);
+ * --------------------------
+ * Registra um acesso a "bloco": recarrega o bloco do arquivo de despejo ou o
+ * descomprime (medindo o tempo gasto), se necessário, e o coloca no início da
+ * fila de acesso. Blocos compartilhados
+ * não entram na fila: não são comprimidos, e o sistema operacional já descarta
+ * as páginas frias dos blocos mapeados.
+ */
+
+static void tocar (bufferTAD buffer, blocoTAD bloco)
+{
+    if (bloco->despejado)
+    {
+        bloco->dados = malloc(TAMBLOCO);
+        if (bloco->dados == NULL)
+        {
+            fprintf(stderr, "Erro: impossível recarregar bloco.\n");
+            exit(1);
+        }
+        recarregar_bloco(buffer, bloco, bloco->dados);
+        devolver_vaga(buffer, bloco);
+        contar_residente(bloco, 1);
+        buffer->metricas.recargas++;
+    }
+    else if (bloco->dados == NULL)
+    {
+        double t0 = agora();
+        bloco->dados = malloc(TAMBLOCO);
+        if (bloco->dados == NULL)
+        {
+            fprintf(stderr, "Erro: impossível descomprimir bloco.\n");
+            exit(1);
+        }
+        descomprimir_lz(bloco->compactado, bloco->tamcompactado, bloco->dados);
+        contar_residente(bloco, 1);
+
+        metricas_compressaoT *m = &buffer->compressao;
+        m->comprimidos--;
+        m->bytes_originais -= bloco->tamanho;
+        m->bytes_comprimidos -= bloco->tamcompactado;
+        free(bloco->compactado);
+        bloco->compactado = NULL;
+        bloco->tamcompactado = 0;
+
+        double latencia = agora() - t0;
+        m->descompressoes++;
+        m->latencia_total += latencia;
+        if (latencia > m->latencia_maxima)
+            m->latencia_maxima = latencia;
+    }
+
+    bloco->acesso = buffer->relogio;
+    if (bloco->na_fila)
+        retirar_da_fila(buffer, bloco);
+    if (bloco->incompressivel || bloco->armazem != NULL)
+        return;
+
+    bloco->mais_antigo = buffer->recente;
+    bloco->mais_recente = NULL;
+    if (buffer->recente != NULL)
+        buffer->recente->mais_recente = bloco;
+    else
+        buffer->antigo = bloco;
+    buffer->recente = bloco;
+    bloco->na_fila = TRUE;
+}
+
+/**
+ * Procedimento: retirar_da_fila
+ * Uso: retirar_da_fila(buffer, bloco);
+ * ------------------------------------
+ * Retira "bloco" da fila de acesso.
+ */
+
+static void retirar_da_fila (bufferTAD buffer, blocoTAD bloco)
+{
+    if (bloco->mais_recente != NULL)
+        bloco->mais_recente->mais_antigo = bloco->mais_antigo;
+    else
+        buffer->recente = bloco->mais_antigo;
+    if (bloco->mais_antigo != NULL)
+        bloco->mais_antigo->mais_recente = bloco->mais_recente;
+    else
+        buffer->antigo = bloco->mais_recente;
+    bloco->mais_recente = bloco->mais_antigo = NULL;
+    bloco->na_fila = FALSE;
+}
+
+/**
+ * Procedimento: avancar_relogio
+ * Uso: avancar_relogio(buffer);
+ * -----------------------------
+ * Conta mais uma operação no buffer e, se a compressão estiver ligada,
+ * comprime os blocos do final da fila de acesso que ficaram fora da janela. O
+ * bloco do cursor nunca é comprimido: se ele chega ao final da fila, é apenas
+ * colocado de volta no início. Por fim, se o limite de memória estiver
+ * ultrapassado, despeja os blocos mais frios.
+ */
+
+static void avancar_relogio (bufferTAD buffer)
+{
+    buffer->relogio++;
+    while (buffer->janela > 0 && buffer->antigo != NULL &&
+           buffer->relogio - buffer->antigo->acesso > buffer->janela)
+    {
+        if (buffer->antigo == buffer->atual)
+            tocar(buffer, buffer->atual);
+        else
+            comprimir_bloco(buffer, buffer->antigo);
+    }
+    if (excede_limite(buffer))
+        despejar_frios(buffer, NULL);
+}
+
+/**
+ * Procedimento: comprimir_bloco
+ * Uso: comprimir_bloco(buffer, bloco);
+ * ------------------------------------
+ * Atualiza o hash do bloco (que não poderá ser recalculado enquanto o bloco
+ * estiver comprimido), retira o bloco da fila e o comprime. Se a compressão
+ * não economizar pelo menos 1/8 do bloco, o bloco fica como está e é marcado
+ * como incompressível até ser alterado novamente; mas, se o limite de memória
+ * estiver ultrapassado, o bloco é despejado (fora da fila ele não seria mais
+ * encontrado por "despejar_frios").
+ */
+
+static void comprimir_bloco (bufferTAD buffer, blocoTAD bloco)
+{
+    unsigned char saida[TAMBLOCO];
+    int n = -1;
+
+    if (bloco->sujo)
+        atualizar_hash(bloco);
+    retirar_da_fila(buffer, bloco);
+    if (bloco->tamanho >= MENORBLOCO)
+        n = comprimir_lz(bloco->dados, bloco->tamanho, saida,
+                         bloco->tamanho - bloco->tamanho / 8);
+
+    unsigned char *compactado = (n > 0) ? malloc(n) : NULL;
+    if (compactado == NULL)
+    {
+        if (!excede_limite(buffer) || !despejar_bloco(buffer, bloco))
+            bloco->incompressivel = TRUE;
+        return;
+    }
+
+    memcpy(compactado, saida, n);
+    contar_residente(bloco, -1);
+    free(bloco->dados);
+    bloco->dados = NULL;
+    bloco->compactado = compactado;
+    bloco->tamcompactado = n;
+
+    metricas_compressaoT *m = &buffer->compressao;
+    m->comprimidos++;
+    m->bytes_originais += bloco->tamanho;
+    m->bytes_comprimidos += n;
+    m->compressoes++;
+}
+
+/**
+ * Função: ler_bloco
+ * Uso: dados = ler_bloco(buffer, bloco);
+ * --------------------------------------
+ * Retorna os caracteres de "bloco" apenas para leitura. Se o bloco está
+ * comprimido (ou despejado), ele é descomprimido (ou lido do arquivo) no
+ * rascunho do buffer, que só é válido até a próxima chamada, e continua
+ * comprimido (ou despejado).
+ */
+
+static const char *ler_bloco (bufferTAD buffer, blocoTAD bloco)
+{
+    if (bloco->dados != NULL)
+        return bloco->dados;
+
+    if (buffer->rascunho == NULL)
+    {
+        buffer->rascunho = malloc(TAMBLOCO);
+        if (buffer->rascunho == NULL)
+        {
+            fprintf(stderr, "Erro: impossível ler bloco comprimido.\n");
+            exit(1);
+        }
+    }
+    if (bloco->despejado)
+    {
+        recarregar_bloco(buffer, bloco, buffer->rascunho);
+        buffer->metricas.leituras++;
+    }
+    else
+    {
+        descomprimir_lz(bloco->compactado, bloco->tamcompactado,
+                        buffer->rascunho);
+        buffer->compressao.leituras++;
+    }
+
+    return buffer->rascunho;
+}
+
+/**
+ * Função: comprimir_lz
+ * Uso: n = comprimir_lz(origem, n, destino, capacidade);
+ * ------------------------------------------------------
+ * Comprime os "n" caracteres de "origem" em "destino" e retorna o tamanho do
+ * resultado, ou -1 se ele não couber em "capacidade" bytes. As repetições são
+ * procuradas com uma tabela de hash que guarda, para cada sequência de
+ * MINIMOLZ caracteres, a última posição em que ela apareceu; a repetição é
+ * então estendida enquanto os caracteres forem iguais.
+ */
+
+static int comprimir_lz (const char *origem, int n, unsigned char *destino,
+                         int capacidade)
+{
+    int tabela[1 << BITSLZ];
+    int i = 0, literais = 0, o = 0;
+
+    for (int k = 0; k < (1 << BITSLZ); k++)
+        tabela[k] = -1;
+
+    while (i + MINIMOLZ <= n)
+    {
+        uint32_t sequencia;
+        memcpy(&sequencia, origem + i, MINIMOLZ);
+        uint32_t h = (uint32_t) (sequencia * 2654435761u) >> (32 - BITSLZ);
+        int candidato = tabela[h];
+        tabela[h] = i;
+        if (candidato < 0 ||
+            memcmp(origem + candidato, origem + i, MINIMOLZ) != 0)
+        {
+            i++;
+            continue;
+        }
+
+        int k = MINIMOLZ;
+        while (i + k < n && k < MAXIMOLZ &&
+               origem[candidato + k] == origem[i + k])
+            k++;
+
+        o = emitir_literais(origem + literais, i - literais, destino, o,
+                            capacidade);
+        if (o < 0 || o + 3 > capacidade)
+            return -1;
+        destino[o++] = 0x80 | (k - MINIMOLZ);
+        destino[o++] = (i - candidato) & 0xFF;
+        destino[o++] = (i - candidato) >> 8;
+        i += k;
+        literais = i;
+    }
+
+    return emitir_literais(origem + literais, n - literais, destino, o,
+                           capacidade);
+}
+
+/**
+ * Função: emitir_literais
+ * Uso: o = emitir_literais(origem, n, destino, o, capacidade);
+ * ------------------------------------------------------------
+ * Acrescenta a "destino", a partir da posição "o", comandos com os "n"
+ * caracteres literais de "origem" (até 128 por comando). Retorna a nova
+ * posição em "destino", ou -1 se os comandos não couberem.
+ */
+
+static int emitir_literais (const char *origem, int n, unsigned char *destino,
+                            int o, int capacidade)
+{
+    while (n > 0)
+    {
+        int k = n > 128 ? 128 : n;
+        if (o + 1 + k > capacidade)
+            return -1;
+        destino[o++] = k - 1;
+        memcpy(destino + o, origem, k);
+        o += k;
+        origem += k;
+        n -= k;
+    }
+
+    return o;
+}
+
+/**
+ * Procedimento: descomprimir_lz
+ * Uso: descomprimir_lz(origem, n, destino);
+ * -----------------------------------------
+ * Descomprime os "n" bytes de "origem" em "destino". As repetições são
+ * copiadas caractere a caractere, pois podem se sobrepor ao próprio trecho
+ * que está sendo produzido.
+ */
+
+static void descomprimir_lz (const unsigned char *origem, int n,
+                             char *destino)
+{
+    int i = 0, o = 0;
+
+    while (i < n)
+    {
+        int c = origem[i++];
+        if (c < 0x80)
+        {
+            memcpy(destino + o, origem + i, c + 1);
+            i += c + 1;
+            o += c + 1;
+        }
+        else
+        {
+            int k = (c & 0x7F) + MINIMOLZ;
+            int distancia = origem[i] | origem[i + 1] << 8;
+            i += 2;
+            for (int j = 0; j < k; j++, o++)
+                destino[o] = destino[o - distancia];
+        }
+    }
+}
+
+/**
+ * Função: agora
+ * Uso: t = agora( );
+ * ------------------
+ * Retorna o instante atual de um relógio monotônico, em milissegundos.
+ */
+
+static double agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000.0 + t.tv_nsec / 1000000.0;
+}
+
+/**
+ * Função: tabela_falhas
+ * Uso: falhas = tabela_falhas(padrao, n);
+ * ---------------------------------------
+ * Retorna a tabela de falhas de Knuth-Morris-Pratt do padrão: falhas[k] é o
+ * tamanho do maior prefixo de padrao[0..k] que também é sufixo de
+ * padrao[1..k]. Termina o programa se não houver memória.
+ */
+
+static size_t *tabela_falhas (const char *padrao, size_t n)
+{
+    size_t *falhas = malloc(n * sizeof(size_t));
+    if (falhas == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar tabela de busca.\n");
+        exit(1);
+    }
+
+    falhas[0] = 0;
+    for (size_t k = 1, j = 0; k < n; k++)
+    {
+        while (j > 0 && padrao[k] != padrao[j])
+            j = falhas[j - 1];
+        if (padrao[k] == padrao[j])
+            j++;
+        falhas[k] = j;
+    }
+
+    return falhas;
+}
+
+/**
+ * Procedimento: encadear
+ * Uso: encadear(&cadeia, bloco);
+ * ------------------------------
+ * Liga "bloco" ao final da cadeia. O bloco fica fechado: novos caracteres irão
+ * para um bloco novo.
+ */
+
+static void encadear (cadeiaT *cadeia, blocoTAD bloco)
+{
+    bloco->anterior = cadeia->ultimo;
+    bloco->proximo = NULL;
+    if (cadeia->ultimo != NULL)
+        cadeia->ultimo->proximo = bloco;
+    else
+        cadeia->primeiro = bloco;
+    cadeia->ultimo = bloco;
+    cadeia->nblocos++;
+    cadeia->aberto = FALSE;
+}
+
+/**
+ * Procedimento: anexar_texto
+ * Uso: anexar_texto(buffer, &cadeia, texto, n);
+ * ---------------------------------------------
+ * Acrescenta "n" caracteres ao final da cadeia, completando o último bloco, se
+ * estiver aberto, e criando blocos novos (que entram na fila de acesso do
+ * buffer) para o restante. Termina o programa se não houver memória.
+ */
+
+static void anexar_texto (bufferTAD buffer, cadeiaT *cadeia, const char *texto,
+                          size_t n)
+{
+    cadeia->tamanho += n;
+    if (cadeia->simular)
+        return;
+
+    while (n > 0)
+    {
+        blocoTAD bloco = cadeia->ultimo;
+        if (!cadeia->aberto || bloco->tamanho == TAMBLOCO)
+        {
+            bloco = criar_bloco(buffer);
+            if (bloco == NULL)
+            {
+                fprintf(stderr, "Erro: impossível alocar bloco.\n");
+                exit(1);
+            }
+            encadear(cadeia, bloco);
+            cadeia->aberto = TRUE;
+            tocar(buffer, bloco);
+        }
+        size_t k = TAMBLOCO - bloco->tamanho;
+        if (k > n)
+            k = n;
+        memcpy(bloco->dados + bloco->tamanho, texto, k);
+        bloco->tamanho += k;
+        texto += k;
+        n -= k;
+    }
+}
+
+/**
+ * Procedimento: descartar_bloco
+ * Uso: descartar_bloco(buffer, bloco);
+ * ------------------------------------
+ * Libera um bloco da lista antiga de "substituir_tudo", retirando-o da fila de
+ * acesso e, se estiver comprimido, das métricas da compressão. Como o bloco
+ * não passa por "desligar_bloco", o último bloco visto por "localizar" é
+ * esquecido aqui.
+ */
+
+static void descartar_bloco (bufferTAD buffer, blocoTAD bloco)
+{
+    buffer->visto = NULL;
+    if (bloco->na_fila)
+        retirar_da_fila(buffer, bloco);
+    if (bloco->compactado != NULL)
+    {
+        metricas_compressaoT *m = &buffer->compressao;
+        m->comprimidos--;
+        m->bytes_originais -= bloco->tamanho;
+        m->bytes_comprimidos -= bloco->tamcompactado;
+    }
+    remover_bloco(&bloco);
+}
+
+/**
+ * Funções: criar_armazem, reter_armazem
+ * Uso: armazem = criar_armazem(dados, tamanho, mapeado);
+ *      bloco->armazem = reter_armazem(armazem);
+ * -----------------------------------------------------
+ * "criar_armazem" cria um armazém para a área "dados" (que passa a pertencer
+ * ao armazém) com uma referência, ou retorna NULL se não houver memória;
+ * "reter_armazem" conta mais uma referência e retorna o próprio armazém.
+ */
+
+static armazemTAD criar_armazem (char *dados, size_t tamanho, bool mapeado)
+{
+    armazemTAD armazem = malloc(sizeof(struct armazemTCD));
+    if (armazem == NULL)
+    {
+        fprintf(stderr, "Erro: impossível criar armazém.\n");
+        return NULL;
+    }
+
+    armazem->dados = dados;
+    armazem->tamanho = tamanho;
+    armazem->mapeado = mapeado;
+    armazem->referencias = 1;
+
+    return armazem;
+}
+
+static armazemTAD reter_armazem (armazemTAD armazem)
+{
+    armazem->referencias++;
+    return armazem;
+}
+
+/**
+ * Procedimento: soltar_armazem
+ * Uso: soltar_armazem(&armazem);
+ * ------------------------------
+ * Devolve uma referência ao armazém e atribui NULL ao ponteiro original. Com a
+ * última referência, a área é desmapeada ou liberada, junto com o armazém.
+ */
+
+static void soltar_armazem (armazemTAD *armazem)
+{
+    if (--(*armazem)->referencias == 0)
+    {
+        if ((*armazem)->mapeado)
+            munmap((*armazem)->dados, (*armazem)->tamanho);
+        else
+            free((*armazem)->dados);
+        free(*armazem);
+    }
+    *armazem = NULL;
+}
+
+/**
+ * Procedimento: compartilhar
+ * Uso: compartilhar(buffer, bloco);
+ * ---------------------------------
+ * Transforma um bloco comum em compartilhado: o bloco é descomprimido, se for
+ * o caso, sai da fila de acesso e o seu array passa a pertencer a um novo
+ * armazém. Nenhum caractere é copiado. Termina o programa se não houver
+ * memória.
+ */
+
+static void compartilhar (bufferTAD buffer, blocoTAD bloco)
+{
+    if (bloco->armazem != NULL)
+        return;
+
+    tocar(buffer, bloco);
+    bloco->armazem = criar_armazem(bloco->dados, TAMBLOCO, FALSE);
+    if (bloco->armazem == NULL)
+        exit(1);
+    contar_residente(bloco, -1);
+    if (bloco->na_fila)
+        retirar_da_fila(buffer, bloco);
+}
+
+/**
+ * Função: separar
+ * Uso: bloco = separar(buffer, posicao);
+ * --------------------------------------
+ * Garante que um bloco começa na posição "posicao" e retorna esse bloco (NULL
+ * se a posição é o final do buffer). Um bloco compartilhado é dividido em dois
+ * blocos que apontam para o mesmo armazém; um bloco comum é dividido por
+ * "dividir_bloco". O cursor continua na mesma posição.
+ */
+
+static blocoTAD separar (bufferTAD buffer, size_t posicao)
+{
+    int d;
+    blocoTAD bloco = localizar(buffer, posicao, &d);
+    if (d == bloco->tamanho)
+        return bloco->proximo;
+    else if (d == 0)
+        return bloco;
+
+    blocoTAD novo;
+    if (bloco->armazem != NULL)
+    {
+        novo = criar_bloco_compartilhado(bloco->armazem, bloco->dados + d,
+                                         bloco->tamanho - d);
+        if (novo == NULL)
+            exit(1);
+        bloco->tamanho = d;
+        bloco->sujo = TRUE;
+        ligar_bloco_depois(buffer, bloco, novo);
+    }
+    else
+    {
+        tocar(buffer, bloco);
+        novo = dividir_bloco(buffer, bloco, d);
+    }
+
+    if (bloco == buffer->atual && buffer->deslocamento > d)
+    {
+        buffer->atual = novo;
+        buffer->deslocamento -= d;
+    }
+
+    return novo;
+}
+
+/**
+ * Procedimento: remover_intervalo
+ * Uso: remover_intervalo(buffer, n);
+ * ----------------------------------
+ * Remove os "n" caracteres seguintes ao cursor (que devem existir) separando
+ * os blocos nas duas pontas do intervalo e desligando os blocos entre elas.
+ */
+
+static void remover_intervalo (bufferTAD buffer, size_t n)
+{
+    if (n == 0)
+        return;
+
+    size_t cursor = buffer->cursor;
+    blocoTAD bloco = separar(buffer, cursor);
+    blocoTAD fim = separar(buffer, cursor + n);
+
+    while (bloco != fim)
+    {
+        blocoTAD proximo = bloco->proximo;
+        desligar_bloco(buffer, bloco);
+        descartar_bloco(buffer, bloco);
+        bloco = proximo;
+    }
+    if (buffer->primeiro == NULL)
+    {
+        blocoTAD vazio = criar_bloco(buffer);
+        if (vazio == NULL)
+            exit(1);
+        ligar_bloco_depois(buffer, NULL, vazio);
+    }
+
+    buffer->tamanho -= n;
+    buffer->versao++;
+    reposicionar(buffer, cursor);
+    avancar_relogio(buffer);
+}
+
+/**
+ * Procedimento: reposicionar
+ * Uso: reposicionar(buffer, posicao);
+ * -----------------------------------
+ * Coloca o cursor na posição "posicao" depois de uma mudança na lista de
+ * blocos que pode ter invalidado o bloco atual, localizando a posição a partir
+ * do primeiro bloco.
+ */
+
+static void reposicionar (bufferTAD buffer, size_t posicao)
+{
+    buffer->atual = buffer->primeiro;
+    buffer->deslocamento = 0;
+    buffer->cursor = 0;
+    buffer->atual = localizar(buffer, posicao, &buffer->deslocamento);
+    buffer->cursor = posicao;
+    tocar(buffer, buffer->atual);
+}
+
+/**
+ * Predicado: conferir_instantaneo
+ * Uso: if (conferir_instantaneo(dados, tamanho)) . . .
+ * ----------------------------------------------------
+ * Retorna TRUE se os "tamanho" bytes de "dados" têm o formato de um
+ * instantâneo: cabeçalho conhecido, texto e tabela dentro do arquivo, a
+ * tabela terminando no final do arquivo, blocos que cabem em um int e cuja
+ * soma é o tamanho do buffer, e o cursor dentro do buffer. O texto não é lido.
+ */
+
+static bool conferir_instantaneo (const char *dados, size_t tamanho)
+{
+    const cabecalho_instantaneoT *c = (const cabecalho_instantaneoT *) dados;
+
+    if (memcmp(c->magico, MAGICO_INSTANTANEO, sizeof(c->magico)) != 0 ||
+        c->formato != FORMATO_INSTANTANEO ||
+        c->texto != sizeof(cabecalho_instantaneoT) ||
+        c->tamanho > tamanho || c->cursor > c->tamanho ||
+        c->tabela != (c->texto + c->tamanho + 7) / 8 * 8 ||
+        c->tabela > tamanho ||
+        c->nblocos != (tamanho - c->tabela) / sizeof(entrada_instantaneoT) ||
+        c->tabela + c->nblocos * sizeof(entrada_instantaneoT) != tamanho)
+        return FALSE;
+
+    const entrada_instantaneoT *tabela = (const entrada_instantaneoT *)
+                                         (dados + c->tabela);
+    uint64_t soma = 0;
+    for (size_t i = 0; i < c->nblocos; i++)
+    {
+        if (tabela[i].tamanho > INT_MAX)
+            return FALSE;
+        soma += tabela[i].tamanho;
+    }
+
+    return soma == c->tamanho;
+}
+
+/**
+ * Procedimento: contar_residente
+ * Uso: contar_residente(bloco, delta);
+ * ------------------------------------
+ * Soma "delta" (1 ou -1) à quantidade de arrays de blocos comuns na memória
+ * do dono do bloco e TAMBLOCO * delta à memória do processo.
+ */
+
+static void contar_residente (blocoTAD bloco, int delta)
+{
+    if (delta > 0)
+    {
+        bloco->dono->residentes++;
+        atomic_fetch_add(&memoria_processo, TAMBLOCO);
+    }
+    else
+    {
+        bloco->dono->residentes--;
+        atomic_fetch_sub(&memoria_processo, TAMBLOCO);
+    }
+}
+
+/**
+ * Predicado: excede_limite
+ * Uso: if (excede_limite(buffer)) . . .
+ * -------------------------------------
+ * Retorna TRUE se a memória do buffer ou a do processo ultrapassou o seu
+ * limite.
+ */
+
+static bool excede_limite (bufferTAD buffer)
+{
+    size_t limite = atomic_load_explicit(&limite_processo,
+                                         memory_order_relaxed);
+
+    return (buffer->limite > 0 && buffer->residentes * TAMBLOCO > buffer->limite)
+           || (limite > 0 && atomic_load_explicit(&memoria_processo,
+                                                  memory_order_relaxed) > limite);
+}
+
+/**
+ * Procedimento: despejar_frios
+ * Uso: despejar_frios(buffer, protegido);
+ * ---------------------------------------
+ * Despeja os blocos do final da fila de acesso até que a memória volte para
+ * dentro do limite. O bloco do cursor e o bloco "protegido" (o que está sendo
+ * preenchido por "inserir_texto", ou NULL) não são despejados: ao chegarem ao
+ * final da fila, voltam para o início; quando isso acontece pela segunda vez,
+ * não há mais o que despejar. Para também se o arquivo de despejo falhar.
+ */
+
+static void despejar_frios (bufferTAD buffer, blocoTAD protegido)
+{
+    int poupados = 0;
+
+    while (poupados < 2 && buffer->antigo != NULL && excede_limite(buffer))
+    {
+        blocoTAD bloco = buffer->antigo;
+        if (bloco == buffer->atual || bloco == protegido)
+        {
+            tocar(buffer, bloco);
+            poupados++;
+        }
+        else if (!despejar_bloco(buffer, bloco))
+            return;
+    }
+}
+
+/**
+ * Função: despejar_bloco
+ * Uso: if (despejar_bloco(buffer, bloco)) . . .
+ * ---------------------------------------------
+ * Grava o conteúdo do bloco (um bloco comum, com o array na memória) em uma
+ * vaga do arquivo de despejo, criando o arquivo na primeira vez (em $TMPDIR ou
+ * /tmp, e já removido do diretório, para que desapareça com o processo), e
+ * libera o array. O hash é atualizado antes, pois não poderá ser recalculado
+ * com o bloco fora da memória. Retorna FALSE, com o bloco inalterado, se a
+ * gravação falhar.
+ */
+
+static bool despejar_bloco (bufferTAD buffer, blocoTAD bloco)
+{
+    if (buffer->despejo < 0)
+    {
+        const char *diretorio = getenv("TMPDIR");
+        if (diretorio == NULL || diretorio[0] == '\0')
+            diretorio = "/tmp";
+        char *modelo = malloc(strlen(diretorio) + 20);
+        if (modelo == NULL)
+            return FALSE;
+        sprintf(modelo, "%s/blocobuff.XXXXXX", diretorio);
+        buffer->despejo = mkstemp(modelo);
+        if (buffer->despejo >= 0)
+            unlink(modelo);
+        else
+            fprintf(stderr, "Erro: impossível criar o arquivo de despejo "
+                    "\"%s\": %s.\n", modelo, strerror(errno));
+        free(modelo);
+        if (buffer->despejo < 0)
+            return FALSE;
+    }
+
+    bool nova = (buffer->nlivres == 0);
+    size_t vaga = nova ? buffer->vagas : buffer->livres[buffer->nlivres - 1];
+    if (bloco->sujo)
+        atualizar_hash(bloco);
+    if (pwrite(buffer->despejo, bloco->dados, bloco->tamanho,
+               (off_t) vaga * TAMBLOCO) != (ssize_t) bloco->tamanho)
+    {
+        fprintf(stderr, "Erro: impossível despejar bloco: %s.\n",
+                strerror(errno));
+        return FALSE;
+    }
+    if (nova)
+        buffer->vagas++;
+    else
+        buffer->nlivres--;
+
+    if (bloco->na_fila)
+        retirar_da_fila(buffer, bloco);
+    contar_residente(bloco, -1);
+    free(bloco->dados);
+    bloco->dados = NULL;
+    bloco->despejado = TRUE;
+    bloco->vaga = vaga;
+    buffer->metricas.despejos++;
+
+    return TRUE;
+}
+
+/**
+ * Procedimento: recarregar_bloco
+ * Uso: recarregar_bloco(buffer, bloco, destino);
+ * ----------------------------------------------
+ * Lê da vaga do bloco despejado os seus caracteres para "destino". Termina o
+ * programa se a leitura falhar, pois o conteúdo do buffer estaria perdido.
+ */
+
+static void recarregar_bloco (bufferTAD buffer, blocoTAD bloco,
+                              char *destino)
+{
+    if (pread(buffer->despejo, destino, bloco->tamanho,
+              (off_t) bloco->vaga * TAMBLOCO) != (ssize_t) bloco->tamanho)
+    {
+        fprintf(stderr, "Erro: impossível recarregar bloco: %s.\n",
+                strerror(errno));
+        exit(1);
+    }
+}
+
+/**
+ * Procedimento: devolver_vaga
+ * Uso: devolver_vaga(buffer, bloco);
+ * ----------------------------------
+ * Coloca a vaga de um bloco despejado na pilha de vagas livres (que cresce
+ * quando necessário) e marca o bloco como não despejado.
+ */
+
+static void devolver_vaga (bufferTAD buffer, blocoTAD bloco)
+{
+    if (buffer->nlivres == buffer->caplivres)
+    {
+        size_t capacidade = buffer->caplivres > 0 ? 2 * buffer->caplivres : 64;
+        size_t *livres = realloc(buffer->livres, capacidade * sizeof(size_t));
+        if (livres == NULL)
+        {
+            fprintf(stderr, "Erro: impossível devolver vaga de despejo.\n");
+            exit(1);
+        }
+        buffer->livres = livres;
+        buffer->caplivres = capacidade;
+    }
+    buffer->livres[buffer->nlivres++] = bloco->vaga;
+    bloco->despejado = FALSE;
+}
+
+/**
+ * Funções: avancar_ate, recuar_ate
+ * Uso: p = avancar_ate(buffer, posicao, classe);
+ *      p = recuar_ate(buffer, posicao, classe);
+ * ----------------------------------------------
+ * "avancar_ate" retorna a posição do primeiro caractere da classe a partir de
+ * "posicao" (ou o tamanho do buffer, se não houver um); "recuar_ate" retorna a
+ * posição logo após o último caractere da classe antes de "posicao" (ou 0). As
+ * buscas saltam de bloco em bloco, e o '\n' seguinte é procurado em cada bloco
+ * com memchr.
+ */
+
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    if (posicao >= buffer->tamanho)
+        return buffer->tamanho;
+
+    int desl;
+    blocoTAD b = localizar(buffer, posicao, &desl);
+    size_t inicio = posicao - desl;
+    for (; b != NULL; inicio += b->tamanho, b = b->proximo, desl = 0)
+    {
+        if (desl == b->tamanho)
+            continue;
+
+        const char *dados = ler_bloco(buffer, b);
+        if (classe == QUEBRA)
+        {
+            const char *q = memchr(dados + desl, '\n', b->tamanho - desl);
+            if (q != NULL)
+                return inicio + (size_t) (q - dados);
+        }
+        else
+        {
+            for (int i = desl; i < b->tamanho; i++)
+                if (pertence(dados[i], classe))
+                    return inicio + i;
+        }
+    }
+
+    return buffer->tamanho;
+}
+
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    if (posicao == 0)
+        return 0;
+
+    int desl;
+    blocoTAD b = localizar(buffer, posicao, &desl);
+    size_t inicio = posicao - desl;
+    while (b != NULL)
+    {
+        if (desl > 0)
+        {
+            const char *dados = ler_bloco(buffer, b);
+            for (int i = desl; i > 0; i--)
+                if (pertence(dados[i - 1], classe))
+                    return inicio + i;
+        }
+        b = b->anterior;
+        if (b != NULL)
+        {
+            desl = b->tamanho;
+            inicio -= b->tamanho;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Predicado: pertence
+ * Uso: if (pertence(c, classe)) . . .
+ * -----------------------------------
+ * Retorna TRUE se o caractere "c" é da classe "classe". Os caracteres de
+ * palavra são testados por intervalos, sem consultar a localidade, para que os
+ * laços de busca fiquem simples o bastante para serem vetorizados.
+ */
+
+static bool pertence (char c, classeT classe)
+{
+    unsigned char u = (unsigned char) c;
+    bool palavra = (unsigned) ((u | 0x20) - 'a') < 26 ||
+                   (unsigned) (u - '0') < 10 || u == '_' || u >= 0x80;
+
+    switch (classe)
+    {
+    case QUEBRA: return c == '\n';
+    case TEXTO: return c != '\n';
+    case PALAVRA: return palavra;
+    default: return !palavra;
+    }
+}
+
+/**
+ * Função: tabelar_blocos
+ * Uso: if (tabelar_blocos(&tabela, hashes, tamanhos, n)) . . .
+ * ------------------------------------------------------------
+ * Monta a tabela dos "n" blocos dados por "hashes" e "tamanhos" (que a tabela
+ * apenas referencia), com pelo menos o dobro de posições. Os blocos são
+ * inseridos do último para o primeiro, de modo que cada posição fica com o
+ * primeiro bloco de cada par. Retorna FALSE se não houver memória.
+ */
+
+static bool tabelar_blocos (tabela_blocosT *tabela, const uint64_t hashes[],
+                            const int tamanhos[], size_t n)
+{
+    size_t capacidade = 16;
+    while (capacidade < 2 * n)
+        capacidade *= 2;
+
+    tabela->hashes = hashes;
+    tabela->tamanhos = tamanhos;
+    tabela->posicoes = malloc(capacidade * sizeof(size_t));
+    tabela->proximos = malloc((n > 0 ? n : 1) * sizeof(size_t));
+    tabela->mascara = capacidade - 1;
+    if (tabela->posicoes == NULL || tabela->proximos == NULL)
+    {
+        liberar_tabela(tabela);
+        return FALSE;
+    }
+    for (size_t h = 0; h < capacidade; h++)
+        tabela->posicoes[h] = SIZE_MAX;
+
+    for (size_t k = n; k-- > 0; )
+    {
+        size_t h = (size_t) (hashes[k] ^ hashes[k] >> 29) & tabela->mascara;
+        while (tabela->posicoes[h] != SIZE_MAX &&
+               (hashes[tabela->posicoes[h]] != hashes[k] ||
+                tamanhos[tabela->posicoes[h]] != tamanhos[k]))
+            h = (h + 1) & tabela->mascara;
+        tabela->proximos[k] = tabela->posicoes[h];
+        tabela->posicoes[h] = k;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Função: procurar_bloco
+ * Uso: k = procurar_bloco(&tabela, hash, tamanho, minimo);
+ * --------------------------------------------------------
+ * Retorna o índice do primeiro bloco da tabela com o par (hash, tamanho) que
+ * não vem antes de "minimo", ou SIZE_MAX se não houver. Como "minimo" só
+ * cresce, a posição da tabela passa a apontar para esse bloco, e os
+ * anteriores nunca mais são visitados (o último bloco de cada par fica na
+ * tabela, para não interromper a sondagem).
+ */
+
+static size_t procurar_bloco (tabela_blocosT *tabela, uint64_t hash,
+                              int tamanho, size_t minimo)
+{
+    size_t h = (size_t) (hash ^ hash >> 29) & tabela->mascara;
+    while (tabela->posicoes[h] != SIZE_MAX)
+    {
+        size_t k = tabela->posicoes[h];
+        if (tabela->hashes[k] == hash && tabela->tamanhos[k] == tamanho)
+        {
+            while (k < minimo && tabela->proximos[k] != SIZE_MAX)
+                k = tabela->proximos[k];
+            tabela->posicoes[h] = k;
+            return (k >= minimo) ? k : SIZE_MAX;
+        }
+        h = (h + 1) & tabela->mascara;
+    }
+    return SIZE_MAX;
+}
+
+/**
+ * Procedimento: liberar_tabela
+ * Uso: liberar_tabela(&tabela);
+ * -----------------------------
+ * Libera os arrays alocados por "tabelar_blocos".
+ */
+
+static void liberar_tabela (tabela_blocosT *tabela)
+{
+    free(tabela->posicoes);
+    free(tabela->proximos);
+    tabela->posicoes = tabela->proximos = NULL;
+}
+
+/**
+ * Predicado: comparar_janela
+ * Uso: if (comparar_janela(diferenca, antigo, a0, a1, novo, b0, b1)) . . .
+ * ------------------------------------------------------------------------
+ * Lê os caracteres [a0, a1) do buffer antigo e [b0, b1) do novo, divide os
+ * dois textos em linhas e acrescenta à diferença as edições entre eles.
+ * Retorna FALSE se não houver memória.
+ */
+
+static bool comparar_janela (diferencaTAD diferenca, bufferTAD antigo,
+                             size_t a0, size_t a1, bufferTAD novo, size_t b0,
+                             size_t b1)
+{
+    size_t na = a1 - a0, nb = b1 - b0, la = 0, lb = 0;
+    char *texto_a = malloc(na > 0 ? na : 1);
+    char *texto_b = malloc(nb > 0 ? nb : 1);
+    linhaT *linhas_a = NULL, *linhas_b = NULL;
+
+    bool ok = (texto_a != NULL && texto_b != NULL);
+    if (ok)
+    {
+        copiar_texto(antigo, a0, na, texto_a);
+        copiar_texto(novo, b0, nb, texto_b);
+        linhas_a = dividir_linhas(texto_a, na, &la);
+        linhas_b = dividir_linhas(texto_b, nb, &lb);
+        ok = (linhas_a != NULL && linhas_b != NULL);
+    }
+    if (ok)
+    {
+        comparacaoT c = {texto_a, texto_b, linhas_a, linhas_b, a0, b0,
+                         diferenca};
+        diferenca->metricas.janelas++;
+        diferenca->metricas.lidos += na + nb;
+        ok = comparar_linhas(&c, 0, la, 0, lb);
+    }
+
+    free(texto_a);
+    free(texto_b);
+    free(linhas_a);
+    free(linhas_b);
+    return ok;
+}
+
+/**
+ * Função: dividir_linhas
+ * Uso: linhas = dividir_linhas(texto, n, &nlinhas);
+ * -------------------------------------------------
+ * Divide os "n" caracteres de "texto" em linhas terminadas por '\n' (a
+ * última pode não ter o '\n'), calcula o hash de cada uma e armazena em
+ * "nlinhas" quantas são. Retorna o array das linhas, com a linha vazia final,
+ * ou NULL se não houver memória.
+ */
+
+static linhaT *dividir_linhas (const char *texto, size_t n, size_t *nlinhas)
+{
+    size_t quantidade = 0;
+    for (size_t i = 0; i < n; quantidade++)
+    {
+        const char *q = memchr(texto + i, '\n', n - i);
+        i = (q != NULL) ? (size_t) (q - texto) + 1 : n;
+    }
+
+    linhaT *linhas = malloc((quantidade + 1) * sizeof(linhaT));
+    if (linhas == NULL)
+        return NULL;
+
+    size_t inicio = 0;
+    for (size_t k = 0; k < quantidade; k++)
+    {
+        const char *q = memchr(texto + inicio, '\n', n - inicio);
+        size_t fim = (q != NULL) ? (size_t) (q - texto) + 1 : n;
+        uint64_t hash = 0;
+        for (size_t i = inicio; i < fim; i++)
+            hash = hash * BASEHASH + (unsigned char) texto[i] + 1;
+        linhas[k] = (linhaT) { inicio, fim - inicio, hash };
+        inicio = fim;
+    }
+    linhas[quantidade] = (linhaT) { n, 0, 0 };
+
+    *nlinhas = quantidade;
+    return linhas;
+}
+
+/**
+ * Predicado: comparar_linhas
+ * Uso: if (comparar_linhas(&comparacao, a0, a1, b0, b1)) . . .
+ * ------------------------------------------------------------
+ * Acrescenta à diferença as edições que transformam as linhas [a0, a1) do
+ * lado antigo nas linhas [b0, b1) do lado novo: descarta as linhas iguais do
+ * início e do final e, se ainda sobrarem linhas dos dois lados, divide o
+ * problema no ponto encontrado por "bissectar" e resolve as duas metades.
+ * Retorna FALSE se não houver memória.
+ */
+
+static bool comparar_linhas (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                             size_t b1)
+{
+    while (a0 < a1 && b0 < b1 && linhas_iguais(c, a0, b0))
+    {
+        a0++;
+        b0++;
+    }
+    while (a1 > a0 && b1 > b0 && linhas_iguais(c, a1 - 1, b1 - 1))
+    {
+        a1--;
+        b1--;
+    }
+    if (a0 == a1 || b0 == b1)
+        return registrar_edicao(c, a0, a1, b0, b1);
+
+    size_t x = a0, y = b0;
+    int r = bissectar(c, a0, a1, b0, b1, &x, &y);
+    if (r < 0)
+        return FALSE;
+    else if (r == 0)
+        return registrar_edicao(c, a0, a1, b0, b1);
+
+    return comparar_linhas(c, a0, x, b0, y) &&
+           comparar_linhas(c, x, a1, y, b1);
+}
+
+/**
+ * Função: bissectar
+ * Uso: r = bissectar(&comparacao, a0, a1, b0, b1, &x, &y);
+ * --------------------------------------------------------
+ * Procura o "meio" do caminho de edição mais curto entre as linhas [a0, a1) e
+ * [b0, b1), avançando ao mesmo tempo um caminho a partir do início e outro a
+ * partir do final, em diagonais k = x - y, até que se sobreponham (Myers,
+ * "An O(ND) Difference Algorithm and Its Variations", 1986). Os vetores "v1"
+ * e "v2" guardam, para cada diagonal, o x mais distante alcançado por cada
+ * caminho. Retorna 1 e armazena o ponto de divisão em "x" e "y", 0 se os
+ * caminhos não se encontrarem em MAXMYERS passos, ou -1 se não houver
+ * memória.
+ */
+
+static int bissectar (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                      size_t b1, size_t *x, size_t *y)
+{
+    long n = (long) (a1 - a0), m = (long) (b1 - b0);
+    long maximo = (n + m + 1) / 2;
+    if (maximo > MAXMYERS)
+        maximo = MAXMYERS;
+    long desl = maximo, tamanho = 2 * maximo + 2;
+
+    long *v1 = malloc(2 * (size_t) tamanho * sizeof(long));
+    if (v1 == NULL)
+        return -1;
+    long *v2 = v1 + tamanho;
+    for (long i = 0; i < 2 * tamanho; i++)
+        v1[i] = -1;
+    v1[desl + 1] = 0;
+    v2[desl + 1] = 0;
+
+    long delta = n - m;
+    bool frente = (delta % 2 != 0);
+    long k1ini = 0, k1fim = 0, k2ini = 0, k2fim = 0;
+    int resultado = 0;
+
+    for (long d = 0; d < maximo && resultado == 0; d++)
+    {
+        for (long k1 = -d + k1ini; k1 <= d - k1fim && resultado == 0; k1 += 2)
+        {
+            long i1 = desl + k1, x1;
+            if (k1 == -d || (k1 != d && v1[i1 - 1] < v1[i1 + 1]))
+                x1 = v1[i1 + 1];
+            else
+                x1 = v1[i1 - 1] + 1;
+            long y1 = x1 - k1;
+            while (x1 < n && y1 < m && linhas_iguais(c, a0 + x1, b0 + y1))
+            {
+                x1++;
+                y1++;
+            }
+            v1[i1] = x1;
+
+            if (x1 > n)
+                k1fim += 2;
+            else if (y1 > m)
+                k1ini += 2;
+            else if (frente)
+            {
+                long i2 = desl + delta - k1;
+                if (i2 >= 0 && i2 < tamanho && v2[i2] != -1 &&
+                    x1 >= n - v2[i2])
+                {
+                    *x = a0 + (size_t) x1;
+                    *y = b0 + (size_t) y1;
+                    resultado = 1;
+                }
+            }
+        }
+
+        for (long k2 = -d + k2ini; k2 <= d - k2fim && resultado == 0; k2 += 2)
+        {
+            long i2 = desl + k2, x2;
+            if (k2 == -d || (k2 != d && v2[i2 - 1] < v2[i2 + 1]))
+                x2 = v2[i2 + 1];
+            else
+                x2 = v2[i2 - 1] + 1;
+            long y2 = x2 - k2;
+            while (x2 < n && y2 < m &&
+                   linhas_iguais(c, a1 - 1 - (size_t) x2, b1 - 1 - (size_t) y2))
+            {
+                x2++;
+                y2++;
+            }
+            v2[i2] = x2;
+
+            if (x2 > n)
+                k2fim += 2;
+            else if (y2 > m)
+                k2ini += 2;
+            else if (!frente)
+            {
+                long i1 = desl + delta - k2;
+                if (i1 >= 0 && i1 < tamanho && v1[i1] != -1 &&
+                    v1[i1] >= n - x2)
+                {
+                    *x = a0 + (size_t) v1[i1];
+                    *y = b0 + (size_t) (v1[i1] - (i1 - desl));
+                    resultado = 1;
+                }
+            }
+        }
+    }
+
+    free(v1);
+    return resultado;
+}
+
+/**
+ * Predicado: linhas_iguais
+ * Uso: if (linhas_iguais(&comparacao, i, j)) . . .
+ * ------------------------------------------------
+ * Retorna TRUE se a linha "i" do lado antigo é igual à linha "j" do lado novo.
+ * O hash e o tamanho descartam quase todas as linhas diferentes sem comparar
+ * os caracteres.
+ */
+
+static bool linhas_iguais (comparacaoT *c, size_t i, size_t j)
+{
+    linhaT *a = &c->linhas_a[i], *b = &c->linhas_b[j];
+
+    return a->hash == b->hash && a->tamanho == b->tamanho &&
+           memcmp(c->texto_a + a->inicio, c->texto_b + b->inicio,
+                  a->tamanho) == 0;
+}
+
+/**
+ * Predicado: registrar_edicao
+ * Uso: if (registrar_edicao(&comparacao, a0, a1, b0, b1)) . . .
+ * -------------------------------------------------------------
+ * Acrescenta à diferença a edição que substitui as linhas [a0, a1) do lado
+ * antigo pelas linhas [b0, b1) do lado novo, convertendo as linhas em
+ * posições dos buffers e copiando o texto inserido. Uma edição que começa
+ * onde a anterior termina é juntada a ela. Retorna FALSE se não houver
+ * memória.
+ */
+
+static bool registrar_edicao (comparacaoT *c, size_t a0, size_t a1, size_t b0,
+                              size_t b1)
+{
+    if (a0 == a1 && b0 == b1)
+        return TRUE;
+
+    diferencaTAD D = c->diferenca;
+    size_t antiga = c->inicio_a + c->linhas_a[a0].inicio;
+    size_t removidos = c->linhas_a[a1].inicio - c->linhas_a[a0].inicio;
+    size_t nova = c->inicio_b + c->linhas_b[b0].inicio;
+    size_t inseridos = c->linhas_b[b1].inicio - c->linhas_b[b0].inicio;
+
+    if (inseridos > D->captextos - D->ntextos)
+    {
+        size_t capacidade = (D->captextos > 0) ? D->captextos : TAMBLOCO;
+        while (capacidade - D->ntextos < inseridos)
+            capacidade *= 2;
+        char *textos = realloc(D->textos, capacidade);
+        if (textos == NULL)
+            return FALSE;
+        D->textos = textos;
+        D->captextos = capacidade;
+    }
+
+    alteracaoT *ultima = (D->nedicoes > 0) ? &D->edicoes[D->nedicoes - 1]
+                                           : NULL;
+    if (ultima != NULL && ultima->antiga + ultima->removidos == antiga &&
+        ultima->nova + ultima->inseridos == nova)
+    {
+        ultima->removidos += removidos;
+        ultima->inseridos += inseridos;
+    }
+    else
+    {
+        if (D->nedicoes == D->capedicoes)
+        {
+            size_t capacidade = (D->capedicoes > 0) ? 2 * D->capedicoes : 16;
+            alteracaoT *edicoes = realloc(D->edicoes,
+                                          capacidade * sizeof(alteracaoT));
+            if (edicoes == NULL)
+                return FALSE;
+            D->edicoes = edicoes;
+            D->capedicoes = capacidade;
+        }
+        D->edicoes[D->nedicoes++] = (alteracaoT) { antiga, removidos, nova,
+                                                   inseridos, D->ntextos };
+    }
+
+    if (inseridos > 0)
+        memcpy(D->textos + D->ntextos, c->texto_b + c->linhas_b[b0].inicio,
+               inseridos);
+    D->ntextos += inseridos;
+    return TRUE;
+}
+
+/**
+ * Predicado: registrar
+ * Uso: if (registrar(buffer, texto, n, apagar)) return;
+ * -----------------------------------------------------
+ * Se há uma transação aberta, registra nela a inserção dos "n" caracteres de
+ * "texto" ou a remoção de "apagar" caracteres após o cursor e retorna TRUE;
+ * senão, retorna FALSE, e a edição deve ser feita no buffer.
+ */
+
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar)
+{
+    if (buffer->transacao == NULL)
+        return FALSE;
+
+    sincronizar_transacao(buffer->transacao, tamanho_buffer(buffer),
+                          posicao_cursor(buffer));
+    if (n > 0 ? !registrar_insercao(buffer->transacao, texto, n)
+              : !registrar_remocao(buffer->transacao, apagar))
+        fprintf(stderr, "Erro: impossível registrar a edição.\n");
+    return TRUE;
+}
+
+/**
+ * Predicado: mover_na_transacao
+ * Uso: if (mover_na_transacao(buffer, posicao)) return;
+ * -----------------------------------------------------
+ * Se há edições pendentes, move o cursor da transação e retorna TRUE; senão,
+ * retorna FALSE, e o cursor do buffer deve ser movido.
+ */
+
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao)
+{
+    if (!transacao_pendente(buffer->transacao))
+        return FALSE;
+
+    mover_cursor_da_transacao(buffer->transacao, posicao);
+    return TRUE;
+}
+
+/**
+ * Procedimento: aplicar_pendentes
+ * Uso: aplicar_pendentes(buffer);
+ * -------------------------------
+ * Aplica as edições pendentes da transação, se houver, com aplicar_trechos:
+ * um trecho por vez, em ordem de posição. A transação é desligada do buffer
+ * durante a aplicação, para que as operações não sejam registradas de novo.
+ */
+
+static void aplicar_pendentes (bufferTAD buffer)
+{
+    transacaoTAD transacao = buffer->transacao;
+    if (!transacao_pendente(transacao))
+        return;
+
+    buffer->transacao = NULL;
+    aplicar_trechos(transacao, buffer);
+    buffer->transacao = transacao;
+}
+
+/**
+ * Procedimento: guardar_recorte
+ * Uso: guardar_recorte(buffer, n);
+ * --------------------------------
+ * Guarda no registro para desfazer da transação aberta os "n" caracteres que
+ * recortar_trecho vai remover no cursor. Como o trecho recortado não é
+ * contíguo, o texto é copiado para um array temporário; sem memória para ele,
+ * a transação deixa de poder ser desfeita.
+ */
+
+static void guardar_recorte (bufferTAD buffer, size_t n)
+{
+    char *removido = malloc(n > 0 ? n : 1);
+    if (removido != NULL)
+        copiar_texto(buffer, buffer->cursor, n, removido);
+    guardar_para_desfazer(buffer->transacao, buffer->cursor, 0, removido, n);
+    free(removido);
+}
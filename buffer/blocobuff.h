@@ -0,0 +1,527 @@
+/**
+ * Arquivo: blocobuff.h
+ * Versão : 1.7
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo define as extensões da interface buffer.h que só existem na
+ * implementação blocobuff.c, na qual o texto é armazenado em blocos de tamanho
+ * limitado. Como cada bloco é uma unidade independente de armazenamento, é
+ * possível manter informações por bloco que são atualizadas apenas quando o
+ * bloco é alterado.
+ *
+ * A primeira dessas informações é um hash do conteúdo de cada bloco. Os hashes
+ * dos blocos são combinados em um hash do buffer inteiro (uma árvore de Merkle
+ * de dois níveis: blocos e raiz). Uma "assinatura" guarda os hashes dos blocos
+ * em um determinado momento e permite responder, depois, se o buffer mudou e
+ * quais regiões mudaram, relendo apenas o texto dos blocos alterados; a raiz
+ * é recombinada a partir dos hashes de todos os blocos, sem ler o texto.
+ *
+ * Os mesmos hashes permitem comparar dois buffers (por exemplo, a versão salva
+ * em um instantâneo e o buffer atual, ou dois instantâneos) sem ler o texto
+ * que não mudou: cada bloco de um buffer que tem um bloco igual (mesmo hash e
+ * mesmo tamanho) no outro é pulado em O(1), e só as janelas entre esses blocos
+ * são lidas e comparadas linha a linha. O resultado é uma "diferença": uma
+ * lista compacta de edições que transforma o texto antigo no novo e que pode
+ * ser aplicada a um buffer com o texto antigo.
+ *
+ * A segunda é a compressão dos blocos frios: quando configurada, os blocos que
+ * o cursor não visita há mais de uma "janela" de operações são comprimidos em
+ * memória (com um compressor simples da família LZ77, embutido em blocobuff.c)
+ * e descomprimidos no primeiro acesso, de modo que um buffer grande e parado
+ * ocupa bem menos memória.
+ *
+ * Para que um buffer enorme (um texto de vários gigabytes colado de uma vez,
+ * por exemplo) não esgote a memória do processo, é possível limitar a memória
+ * ocupada pelos blocos de cada buffer e de todos os buffers juntos. Acima do
+ * limite, os blocos mais frios são despejados em um arquivo temporário e
+ * trazidos de volta quando acessados; a interface buffer.h continua
+ * funcionando normalmente.
+ *
+ * Por fim, um arquivo pode ser aberto em modo mapeado ("mapear_arquivo"): o
+ * arquivo é mapeado na memória (mmap) e os blocos apenas apontam para trechos
+ * do mapeamento, sem que o arquivo seja lido. O sistema operacional só traz
+ * para a memória as páginas que forem de fato acessadas, e só os trechos
+ * editados são copiados para blocos comuns.
+ *
+ * Da mesma forma, o buffer pode ser gravado em um "instantâneo": um arquivo
+ * binário que guarda, além do texto, as fronteiras dos blocos, a quantidade de
+ * linhas de cada bloco e os hashes. Abrir um instantâneo mapeia o arquivo e
+ * refaz a lista de blocos a partir dessa tabela, sem ler nem recalcular nada
+ * do texto; o custo depende da quantidade de blocos, e não do tamanho do
+ * texto.
+ *
+ * Os blocos também permitem copiar, recortar e colar sem copiar o texto: um
+ * trecho copiado apenas compartilha, com contagem de referências, a memória
+ * dos blocos de onde saiu, e colar o trecho liga ao buffer novos blocos que
+ * apontam para essa mesma memória. Colar 100 MB várias vezes custa apenas
+ * alguns blocos por colagem; o texto só é copiado, em pedaços de alguns
+ * kilobytes, quando um bloco compartilhado é editado. Os trechos podem ser
+ * guardados em um anel ("kill ring") com os últimos trechos copiados ou
+ * recortados.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _BLOCOBUFF_H
+#define _BLOCOBUFF_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: assinaturaTAD
+ * -------------------
+ * Representa os hashes de todos os blocos de um buffer em um determinado
+ * momento, para comparação posterior com o mesmo buffer.
+ */
+
+typedef struct assinaturaTCD *assinaturaTAD;
+
+/**
+ * TIPO: regiaoT
+ * -------------
+ * Uma região do buffer, dada pela posição do primeiro caractere e pela
+ * quantidade de caracteres. Uma região com tamanho 0 indica que algo foi
+ * apagado naquela posição.
+ */
+
+typedef struct
+{
+    size_t inicio;
+    size_t tamanho;
+} regiaoT;
+
+/**
+ * TIPO: diferencaTAD
+ * ------------------
+ * O resultado da comparação de dois buffers: a lista de edições que
+ * transforma o texto do buffer antigo no texto do buffer novo.
+ */
+
+typedef struct diferencaTCD *diferencaTAD;
+
+/**
+ * TIPO: edicaoT
+ * -------------
+ * Uma edição de uma diferença: os "removidos" caracteres que começam na
+ * posição "antiga" do texto antigo são substituídos pelos "inseridos"
+ * caracteres de "texto", que começam na posição "nova" do texto novo. Uma das
+ * duas quantidades pode ser 0 (uma remoção ou uma inserção pura). O "texto"
+ * pertence à diferença e não termina com '\0'.
+ */
+
+typedef struct
+{
+    size_t antiga;
+    size_t removidos;
+    size_t nova;
+    size_t inseridos;
+    const char *texto;
+} edicaoT;
+
+/**
+ * TIPO: metricas_diferencaT
+ * -------------------------
+ * O trabalho feito por uma comparação:
+ *
+ *     iguais    blocos do buffer novo pulados por terem um bloco igual no
+ *               antigo
+ *     janelas   trechos entre os blocos iguais comparados linha a linha
+ *     lidos     caracteres lidos dos dois buffers para essas comparações
+ */
+
+typedef struct
+{
+    size_t iguais;
+    size_t janelas;
+    size_t lidos;
+} metricas_diferencaT;
+
+/**
+ * TIPO: metricas_compressaoT
+ * --------------------------
+ * Métricas da compressão dos blocos frios (tempos em milissegundos):
+ *
+ *     comprimidos        blocos que estão comprimidos agora
+ *     bytes_originais    caracteres contidos nesses blocos
+ *     bytes_comprimidos  memória ocupada por esses blocos, comprimidos
+ *     compressoes        blocos comprimidos desde a criação do buffer
+ *     descompressoes     blocos descomprimidos por causa de um acesso
+ *     leituras           descompressões temporárias, apenas para leitura
+ *     latencia_total     tempo gasto nas descompressões (sem as leituras)
+ *     latencia_maxima    maior tempo de uma descompressão
+ *
+ * A taxa de compressão é bytes_originais / bytes_comprimidos.
+ */
+
+typedef struct
+{
+    size_t comprimidos;
+    size_t bytes_originais;
+    size_t bytes_comprimidos;
+    unsigned long compressoes;
+    unsigned long descompressoes;
+    unsigned long leituras;
+    double latencia_total;
+    double latencia_maxima;
+} metricas_compressaoT;
+
+/**
+ * TIPO: metricas_despejoT
+ * -----------------------
+ * Métricas do despejo dos blocos frios para o disco:
+ *
+ *     residentes   memória ocupada agora pelos blocos do buffer, em bytes
+ *     processo     memória ocupada pelos blocos de todos os buffers, em bytes
+ *     despejados   blocos do buffer que estão agora no arquivo de despejo
+ *     despejos     blocos despejados desde a criação do buffer
+ *     recargas     blocos trazidos de volta para a memória por um acesso
+ *     leituras     blocos lidos do arquivo sem voltar para a memória
+ *
+ * Só os blocos comuns contam: a memória dos blocos mapeados é administrada
+ * pelo sistema operacional, e a dos trechos compartilhados não pertence a um
+ * único buffer.
+ */
+
+typedef struct
+{
+    size_t residentes;
+    size_t processo;
+    size_t despejados;
+    unsigned long despejos;
+    unsigned long recargas;
+    unsigned long leituras;
+} metricas_despejoT;
+
+/**
+ * TIPO: trechoTAD
+ * ---------------
+ * Um trecho de texto copiado ou recortado de um buffer. O trecho não muda
+ * depois de criado, mesmo que o buffer de onde ele saiu seja alterado ou
+ * liberado, e pode ser colado em qualquer buffer.
+ */
+
+typedef struct trechoTCD *trechoTAD;
+
+/**
+ * TIPO: anelTAD
+ * -------------
+ * Um anel de trechos com capacidade fixa, do mais recente (a área de
+ * transferência) para o mais antigo.
+ */
+
+typedef struct anelTCD *anelTAD;
+
+/**
+ * TIPO: resumo_instantaneoT
+ * -------------------------
+ * O que se sabe de um instantâneo sem ler o seu texto:
+ *
+ *     blocos   quantidade de blocos gravados
+ *     linhas   quantidade de quebras de linha ('\n') do texto
+ *     hash     hash do buffer (o mesmo de "hash_buffer")
+ */
+
+typedef struct
+{
+    size_t blocos;
+    size_t linhas;
+    uint64_t hash;
+} resumo_instantaneoT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: hash_buffer
+ * Uso: h = hash_buffer(buffer);
+ * -----------------------------
+ * Retorna o hash do conteúdo do buffer. Apenas os blocos alterados desde o
+ * último cálculo têm o seu texto percorrido novamente; para os demais é usado
+ * o hash guardado no próprio bloco.
+ */
+
+uint64_t hash_buffer (bufferTAD buffer);
+
+/**
+ * FUNÇÕES: assinar_buffer, liberar_assinatura
+ * Uso: assinatura = assinar_buffer(buffer);
+ *      liberar_assinatura(&assinatura);
+ * -------------------------------------------
+ * "assinar_buffer" cria uma assinatura com o estado atual do buffer (ou NULL se
+ * não houver memória), e "liberar_assinatura" libera uma assinatura. Note que o
+ * argumento de "liberar_assinatura" é um PONTEIRO para a assinatura.
+ */
+
+assinaturaTAD assinar_buffer (bufferTAD buffer);
+void liberar_assinatura (assinaturaTAD *assinatura);
+
+/**
+ * PREDICADO: buffer_alterado
+ * Uso: if (buffer_alterado(buffer, assinatura)) . . .
+ * ---------------------------------------------------
+ * Retorna TRUE se o conteúdo do buffer é diferente do conteúdo que ele tinha
+ * quando a assinatura foi criada.
+ */
+
+bool buffer_alterado (bufferTAD buffer, assinaturaTAD assinatura);
+
+/**
+ * FUNÇÃO: regioes_alteradas
+ * Uso: n = regioes_alteradas(buffer, assinatura, regioes, max);
+ * -------------------------------------------------------------
+ * Armazena no array "regioes" (com espaço para "max" elementos) as regiões do
+ * buffer atual cujo conteúdo não existia, na mesma ordem, quando a assinatura
+ * foi criada, e retorna a quantidade de regiões encontradas (que pode ser
+ * maior do que "max"; nesse caso apenas as "max" primeiras são armazenadas).
+ */
+
+size_t regioes_alteradas (bufferTAD buffer, assinaturaTAD assinatura,
+                          regiaoT regioes[], size_t max);
+
+/**
+ * FUNÇÃO: comparar_buffers
+ * Uso: diferenca = comparar_buffers(antigo, novo);
+ * ------------------------------------------------
+ * Compara o texto do buffer "antigo" com o do buffer "novo" e retorna a
+ * diferença entre eles (ou NULL se não houver memória). Os blocos iguais nos
+ * dois buffers são pulados sem que o seu texto seja lido; só os trechos entre
+ * eles são comparados, linha a linha, com o algoritmo de Myers. Os cursores
+ * não se movem.
+ */
+
+diferencaTAD comparar_buffers (bufferTAD antigo, bufferTAD novo);
+
+/**
+ * FUNÇÕES: quantidade_de_edicoes, edicao_da_diferenca
+ * Uso: n = quantidade_de_edicoes(diferenca);
+ *      edicao = edicao_da_diferenca(diferenca, k);
+ * -------------------------------------------------
+ * "quantidade_de_edicoes" retorna quantas edições a diferença tem (0 se os
+ * textos são iguais), e "edicao_da_diferenca" retorna a k-ésima edição (0 é a
+ * primeira). As edições estão em ordem crescente de posição e não se tocam.
+ */
+
+size_t quantidade_de_edicoes (diferencaTAD diferenca);
+edicaoT edicao_da_diferenca (diferencaTAD diferenca, size_t k);
+
+/**
+ * PREDICADO: aplicar_diferenca
+ * Uso: if (aplicar_diferenca(buffer, diferenca)) . . .
+ * ----------------------------------------------------
+ * Aplica ao buffer, que deve ter o texto do buffer antigo da comparação, as
+ * edições da diferença, da última para a primeira, de modo que o buffer passa
+ * a ter o texto do buffer novo. O cursor fica no final da primeira edição.
+ * Retorna FALSE, sem alterar o buffer, se o tamanho do buffer não for o do
+ * texto antigo.
+ */
+
+bool aplicar_diferenca (bufferTAD buffer, diferencaTAD diferenca);
+
+/**
+ * PROCEDIMENTO: obter_metricas_diferenca
+ * Uso: obter_metricas_diferenca(diferenca, &metricas);
+ * ----------------------------------------------------
+ * Copia para "metricas" o trabalho feito pela comparação que criou a
+ * diferença.
+ */
+
+void obter_metricas_diferenca (diferencaTAD diferenca,
+                               metricas_diferencaT *metricas);
+
+/**
+ * PROCEDIMENTO: liberar_diferenca
+ * Uso: liberar_diferenca(&diferenca);
+ * -----------------------------------
+ * Libera a diferença (inclusive o texto das edições) e atribui NULL ao
+ * ponteiro original.
+ */
+
+void liberar_diferenca (diferencaTAD *diferenca);
+
+/**
+ * FUNÇÃO: mapear_arquivo
+ * Uso: if (mapear_arquivo(buffer, nome)) . . .
+ * --------------------------------------------
+ * Abre o arquivo "nome" no buffer, que deve estar vazio, em modo mapeado: o
+ * custo não depende do tamanho do arquivo, que só é lido à medida que o cursor,
+ * a exibição ou a cópia de texto alcançam cada trecho. O cursor fica no início
+ * do buffer. O arquivo não pode ser alterado por outro programa enquanto o
+ * buffer existir. Retorna FALSE (com o buffer inalterado) em caso de erro.
+ */
+
+bool mapear_arquivo (bufferTAD buffer, string nome);
+
+/**
+ * FUNÇÃO: gravar_instantaneo
+ * Uso: if (gravar_instantaneo(buffer, nome, &resumo)) . . .
+ * ---------------------------------------------------------
+ * Grava no arquivo "nome" um instantâneo do buffer (texto, blocos, linhas,
+ * hashes e posição do cursor). O arquivo anterior só é substituído depois que
+ * o novo estiver completo no disco. Se "resumo" não for NULL, o resumo do
+ * instantâneo é armazenado nele. Retorna FALSE em caso de erro.
+ */
+
+bool gravar_instantaneo (bufferTAD buffer, string nome,
+                         resumo_instantaneoT *resumo);
+
+/**
+ * FUNÇÃO: abrir_instantaneo
+ * Uso: if (abrir_instantaneo(buffer, nome, &resumo)) . . .
+ * --------------------------------------------------------
+ * Abre no buffer, que deve estar vazio, o instantâneo gravado no arquivo
+ * "nome", em modo mapeado (como "mapear_arquivo"): os blocos, os hashes e o
+ * cursor voltam a ser o que eram, e o texto só é lido quando for acessado. O
+ * texto não é conferido com os hashes gravados. Se "resumo" não for NULL, o
+ * resumo do instantâneo é armazenado nele. Retorna FALSE (com o buffer
+ * inalterado) se o arquivo não puder ser aberto ou não for um instantâneo.
+ */
+
+bool abrir_instantaneo (bufferTAD buffer, string nome,
+                        resumo_instantaneoT *resumo);
+
+/**
+ * PROCEDIMENTO: configurar_compressao
+ * Uso: configurar_compressao(buffer, janela);
+ * -------------------------------------------
+ * Passa a comprimir os blocos que não são acessados (pelo cursor ou por uma
+ * edição) há mais de "janela" operações de movimentação ou de edição. Uma
+ * janela 0 (o padrão) desliga a compressão; os blocos que já estavam
+ * comprimidos são descomprimidos quando forem acessados.
+ */
+
+void configurar_compressao (bufferTAD buffer, unsigned long janela);
+
+/**
+ * PROCEDIMENTO: obter_metricas_compressao
+ * Uso: obter_metricas_compressao(buffer, &metricas);
+ * --------------------------------------------------
+ * Copia as métricas atuais da compressão dos blocos frios para "metricas".
+ */
+
+void obter_metricas_compressao (bufferTAD buffer,
+                                metricas_compressaoT *metricas);
+
+/**
+ * PROCEDIMENTOS: limitar_memoria, limitar_memoria_processo
+ * Uso: limitar_memoria(buffer, limite);
+ *      limitar_memoria_processo(limite);
+ * -----------------------------------------------------
+ * Limitam a "limite" bytes a memória ocupada pelos blocos do buffer, ou pelos
+ * blocos de todos os buffers do processo. Um limite 0 (o padrão) significa
+ * sem limite. Acima do limite, a cada operação os blocos acessados há mais
+ * tempo são gravados em um arquivo temporário e liberados da memória; o bloco
+ * do cursor nunca é despejado.
+ */
+
+void limitar_memoria (bufferTAD buffer, size_t limite);
+void limitar_memoria_processo (size_t limite);
+
+/**
+ * PROCEDIMENTO: obter_metricas_despejo
+ * Uso: obter_metricas_despejo(buffer, &metricas);
+ * -----------------------------------------------
+ * Copia as métricas atuais do despejo de blocos para "metricas".
+ */
+
+void obter_metricas_despejo (bufferTAD buffer, metricas_despejoT *metricas);
+
+/**
+ * FUNÇÕES: copiar_trecho, recortar_trecho
+ * Uso: trecho = copiar_trecho(buffer, n);
+ *      trecho = recortar_trecho(buffer, n);
+ * -----------------------------------------
+ * Criam um trecho com os "n" caracteres seguintes ao cursor (ou menos, se o
+ * final do buffer for alcançado). "recortar_trecho" também remove esses
+ * caracteres do buffer. O cursor não se move, e nenhum caractere é copiado: o
+ * custo depende da quantidade de blocos envolvidos, não do tamanho do trecho.
+ * Retornam NULL se não houver memória.
+ */
+
+trechoTAD copiar_trecho (bufferTAD buffer, size_t n);
+trechoTAD recortar_trecho (bufferTAD buffer, size_t n);
+
+/**
+ * PROCEDIMENTO: colar_trecho
+ * Uso: colar_trecho(buffer, trecho);
+ * ----------------------------------
+ * Insere o texto do trecho na posição do cursor, que fica após o texto
+ * inserido, sem copiar o texto. O trecho continua válido e pode ser colado
+ * outras vezes.
+ */
+
+void colar_trecho (bufferTAD buffer, trechoTAD trecho);
+
+/**
+ * FUNÇÃO: tamanho_trecho
+ * Uso: n = tamanho_trecho(trecho);
+ * --------------------------------
+ * Retorna a quantidade de caracteres do trecho.
+ */
+
+size_t tamanho_trecho (trechoTAD trecho);
+
+/**
+ * PROCEDIMENTO: liberar_trecho
+ * Uso: liberar_trecho(&trecho);
+ * -----------------------------
+ * Libera o trecho e atribui NULL ao ponteiro original. A memória compartilhada
+ * com os blocos só é liberada quando nenhum bloco ou trecho a usa mais.
+ */
+
+void liberar_trecho (trechoTAD *trecho);
+
+/**
+ * FUNÇÕES: criar_anel, liberar_anel
+ * Uso: anel = criar_anel(capacidade);
+ *      liberar_anel(&anel);
+ * -----------------------------------
+ * "criar_anel" cria um anel vazio para até "capacidade" trechos (ou NULL se
+ * não houver memória), e "liberar_anel" libera o anel e os trechos guardados
+ * nele, atribuindo NULL ao ponteiro original.
+ */
+
+anelTAD criar_anel (int capacidade);
+void liberar_anel (anelTAD *anel);
+
+/**
+ * PROCEDIMENTO: guardar_no_anel
+ * Uso: guardar_no_anel(anel, trecho);
+ * -----------------------------------
+ * Guarda o trecho como o mais recente do anel, que passa a ser o seu dono (o
+ * trecho não deve ser liberado pelo chamador). Se o anel estiver cheio, o
+ * trecho mais antigo é liberado.
+ */
+
+void guardar_no_anel (anelTAD anel, trechoTAD trecho);
+
+/**
+ * FUNÇÕES: trecho_do_anel, quantidade_no_anel
+ * Uso: trecho = trecho_do_anel(anel, k);
+ *      n = quantidade_no_anel(anel);
+ * ---------------------------------------
+ * "trecho_do_anel" retorna o k-ésimo trecho mais recente do anel (0 é o mais
+ * recente), ou NULL se não houver, e "quantidade_no_anel" retorna quantos
+ * trechos o anel guarda.
+ */
+
+trechoTAD trecho_do_anel (anelTAD anel, int k);
+int quantidade_no_anel (anelTAD anel);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -1,7 +1,7 @@
 /**
  * Arquivo: buffer.h
- * Versão : 1.0
- * Data   : 2024-10-18 22:51
+ * Versão : 1.11
+ * Data   : 2026-10-19 04:40
  * -------------------------
  * Este arquivo define uma interface para a abstração de um editor de buffer,
  * implementado como um TAD.
@@ -26,7 +26,9 @@
 
 /*** Includes ***/
 
+#include "alocador.h"
 #include "genlib.h"
+#include <stddef.h>
 
 /*** Tipos de Dados ***/
 
@@ -51,6 +53,19 @@ typedef struct bufferTCD *bufferTAD;
 
 bufferTAD criar_buffer (void);
 
+/**
+ * FUNÇÃO: criar_buffer_com_alocador
+ * Uso: buffer = criar_buffer_com_alocador(&alocador);
+ * ---------------------------------------------------
+ * Igual a criar_buffer, mas a memória do buffer é obtida e devolvida pelo
+ * alocador informado (veja alocador.h); com NULL, usa malloc e free. O buffer
+ * guarda uma cópia do alocador. Se o alocador tiver "liberar_tudo" (uma
+ * arena), o buffer passa a ser o seu dono: liberar_buffer, ou a própria
+ * criação, se falhar, libera toda a memória da arena.
+ */
+
+bufferTAD criar_buffer_com_alocador (const alocadorT *alocador);
+
 /**
  * PROCEDIMENTO: liberar_buffer
  * Uso: liberar_buffer(buffer);
@@ -90,6 +105,97 @@ void mover_cursor_para_tras (bufferTAD buffer);
 void mover_cursor_para_final (bufferTAD buffer);
 void mover_cursor_para_inicio (bufferTAD buffer);
 
+/**
+ * PROCEDIMENTO: mover_cursor_para_posicao
+ * Uso: mover_cursor_para_posicao(buffer, posicao);
+ * ------------------------------------------------
+ * Move o cursor para a posição absoluta "posicao" (0 é o início do buffer). Se
+ * "posicao" for maior do que o tamanho do buffer, o cursor vai para o final.
+ */
+
+void mover_cursor_para_posicao (bufferTAD buffer, size_t posicao);
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_proxima_palavra
+ *                mover_cursor_para_palavra_anterior
+ * Uso: mover_cursor_para_proxima_palavra(buffer);
+ *      mover_cursor_para_palavra_anterior(buffer);
+ * -------------------------------------------------
+ * Uma palavra é uma sequência de letras, dígitos, '_' ou bytes acima de 127
+ * (os bytes de um caractere UTF-8 acentuado). O primeiro procedimento leva o
+ * cursor para o início da próxima palavra depois do cursor (ou para o final do
+ * buffer); o segundo leva o cursor para o início da palavra anterior ao cursor
+ * (a palavra em que ele está, se estiver no meio de uma), ou para o início do
+ * buffer, como os comandos 'w' e 'b' do vi.
+ */
+
+void mover_cursor_para_proxima_palavra (bufferTAD buffer);
+void mover_cursor_para_palavra_anterior (bufferTAD buffer);
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_inicio_da_linha
+ *                mover_cursor_para_final_da_linha
+ * Uso: mover_cursor_para_inicio_da_linha(buffer);
+ *      mover_cursor_para_final_da_linha(buffer);
+ * -----------------------------------------------
+ * Levam o cursor para logo depois do '\n' anterior ao cursor (ou para o início
+ * do buffer) e para o próximo '\n' (ou para o final do buffer),
+ * respectivamente.
+ */
+
+void mover_cursor_para_inicio_da_linha (bufferTAD buffer);
+void mover_cursor_para_final_da_linha (bufferTAD buffer);
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_proximo_paragrafo
+ *                mover_cursor_para_paragrafo_anterior
+ * Uso: mover_cursor_para_proximo_paragrafo(buffer);
+ *      mover_cursor_para_paragrafo_anterior(buffer);
+ * ---------------------------------------------------
+ * Os parágrafos são separados por linhas em branco. Estes procedimentos levam
+ * o cursor para o início da primeira linha em branco depois do parágrafo
+ * seguinte ou antes do parágrafo anterior ao cursor, como os comandos '}' e
+ * '{' do vi, ou para o final ou o início do buffer, se não houver uma.
+ */
+
+void mover_cursor_para_proximo_paragrafo (bufferTAD buffer);
+void mover_cursor_para_paragrafo_anterior (bufferTAD buffer);
+
+/**
+ * FUNÇÕES: tamanho_buffer, posicao_cursor
+ * Uso: n = tamanho_buffer(buffer);
+ *      p = posicao_cursor(buffer);
+ * ---------------------------------------
+ * Retornam a quantidade de caracteres no buffer e a posição absoluta do cursor
+ * (a quantidade de caracteres antes do cursor), respectivamente.
+ */
+
+size_t tamanho_buffer (bufferTAD buffer);
+size_t posicao_cursor (bufferTAD buffer);
+
+/**
+ * FUNÇÃO: versao_buffer
+ * Uso: v = versao_buffer(buffer);
+ * -------------------------------
+ * Retorna um número que muda sempre que o conteúdo do buffer é alterado (mas
+ * não quando apenas o cursor se move). Comparando versões é possível saber, em
+ * tempo constante, se o buffer mudou desde um momento anterior.
+ */
+
+unsigned long versao_buffer (bufferTAD buffer);
+
+/**
+ * FUNÇÃO: copiar_texto
+ * Uso: n = copiar_texto(buffer, inicio, n, destino);
+ * --------------------------------------------------
+ * Copia para o array "destino" até "n" caracteres do buffer, a partir da
+ * posição "inicio", sem mover o cursor, e retorna quantos caracteres foram
+ * copiados (menos do que "n" se o final do buffer for alcançado). Nenhum '\0'
+ * é acrescentado ao final de "destino".
+ */
+
+size_t copiar_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[]);
+
 /**
  * PROCEDIMENTO: inserir_caractere
  * Uso: inserir_caractere(buffer, c);
@@ -101,6 +207,18 @@ void mover_cursor_para_inicio (bufferTAD buffer);
 
 void inserir_caractere (bufferTAD buffer, char c);
 
+/**
+ * PROCEDIMENTO: inserir_texto
+ * Uso: inserir_texto(buffer, texto, n);
+ * -------------------------------------
+ * Insere os "n" primeiros caracteres de "texto" no buffer, na posição atual do
+ * cursor. O efeito é o mesmo de chamar "inserir_caractere" para cada um dos
+ * caracteres, mas cada implementação faz a inserção em bloco, de uma só vez.
+ * Após a inserção o cursor é posicionado após o último caractere inserido.
+ */
+
+void inserir_texto (bufferTAD buffer, const char *texto, size_t n);
+
 /**
  * PROCEDIMENTO: apagar_caractere
  * Uso: apagar_caractere(buffer);
@@ -111,6 +229,34 @@ void inserir_caractere (bufferTAD buffer, char c);
 
 void apagar_caractere (bufferTAD buffer);
 
+/**
+ * PROCEDIMENTO: apagar_texto
+ * Uso: apagar_texto(buffer, n);
+ * -----------------------------
+ * Apaga os "n" caracteres imediatamente posteriores ao cursor (ou todos até o
+ * final do buffer, se houver menos do que "n"). O efeito é o mesmo de chamar
+ * "apagar_caractere" "n" vezes, mas cada implementação faz a remoção em bloco.
+ */
+
+void apagar_texto (bufferTAD buffer, size_t n);
+
+/**
+ * FUNÇÃO: substituir_tudo
+ * Uso: n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+ * ----------------------------------------------------------------
+ * Substitui cada ocorrência dos "np" caracteres de "padrao" pelos "nn"
+ * caracteres de "novo" e retorna a quantidade de substituições. As ocorrências
+ * são procuradas da esquerda para a direita, sem sobreposição, e o texto
+ * resultante é montado em uma única passagem pelo buffer, em vez de uma
+ * remoção e uma inserção por ocorrência. O cursor continua junto do mesmo
+ * caractere; se estava dentro de uma ocorrência, passa para o final do texto
+ * que a substituiu. Se "simular" for TRUE, o buffer não é alterado e apenas a
+ * quantidade de ocorrências é retornada. Um padrão vazio não tem ocorrências.
+ */
+
+size_t substituir_tudo (bufferTAD buffer, const char *padrao, size_t np,
+                        const char *novo, size_t nn, bool simular);
+
 /**
  * PROCEDIMENTO: exibir_buffer
  * Uso: exibir_buffer(buffer);
@@ -120,6 +266,60 @@ void apagar_caractere (bufferTAD buffer);
 
 void exibir_buffer (bufferTAD buffer);
 
+/**
+ * PROCEDIMENTOS: iniciar_transacao, confirmar_transacao
+ * Uso: iniciar_transacao(buffer);
+ *      . . .
+ *      confirmar_transacao(buffer);
+ * -----------------------------------------------------
+ * Agrupam uma sequência de edições em uma transação. Entre as duas chamadas,
+ * as inserções, as remoções e os movimentos simples do cursor (para frente,
+ * para trás, para o início, para o final e para uma posição) não alteram o
+ * armazenamento do buffer: são apenas registrados, e as edições que se tocam
+ * são juntadas em uma só. tamanho_buffer e posicao_cursor já refletem as
+ * edições registradas, mas versao_buffer só muda quando elas são aplicadas.
+ * Na confirmação, todas as edições registradas são aplicadas de uma só vez,
+ * em ordem de posição, pela passagem própria de cada implementação.
+ *
+ * As demais operações (copiar_texto, exibir_buffer, substituir_tudo e os
+ * movimentos por palavra, linha e parágrafo) aplicam antes as edições
+ * registradas, sem encerrar a transação, e o mesmo vale para as extensões de
+ * cada implementação (como arraybuff.h e blocobuff.h) que leem ou alteram o
+ * texto; só as leituras concorrentes de arraybuff.h veem o texto sem as
+ * edições pendentes. Uma transação iniciada dentro de outra faz parte da
+ * externa, e só a confirmação da externa aplica as edições.
+ */
+
+void iniciar_transacao (bufferTAD buffer);
+void confirmar_transacao (bufferTAD buffer);
+
+/**
+ * PREDICADO: desfazer_transacao
+ * Uso: if (desfazer_transacao(buffer)) . . .
+ * ------------------------------------------
+ * Desfaz, de uma só vez, todas as edições da última transação confirmada
+ * (inclusive as feitas por substituir_tudo e pelas extensões enquanto ela
+ * estava aberta) e retorna TRUE. Se não houver transação confirmada, se o
+ * buffer foi alterado depois dela, se houver uma transação aberta ou se
+ * faltou memória para guardar o texto que ela removeu, não faz nada e
+ * retorna FALSE. Apenas a última transação pode ser desfeita.
+ */
+
+bool desfazer_transacao (bufferTAD buffer);
+
+/*** Rastreamento ***/
+
+/**
+ * Nos programas compilados com -Drastreamento, as chamadas às operações acima
+ * passam pelo rastreador de eventos definido em rastreador.h. As
+ * implementações desta interface definem IMPLEMENTANDO_BUFFER antes de incluir
+ * este arquivo, para que as suas próprias definições não sejam redirecionadas.
+ */
+
+#if defined(rastreamento) && !defined(IMPLEMENTANDO_BUFFER)
+#include "rastreador.h"
+#endif
+
 /*** Finaliza Boilerplate da Interface ***/
 
 #endif
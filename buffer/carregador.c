@@ -0,0 +1,472 @@
+/**
+ * Arquivo: carregador.c
+ * Versão : 1.1
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo implementa a interface carregador.h. A carga é organizada como
+ * uma linha de montagem com três etapas, ligadas por uma janela circular de
+ * blocos:
+ *
+ *     leitora  --->  [ janela de JANELA blocos ]  --->  montadora
+ *                        ^                 |
+ *                        |   analisadoras  |
+ *                        +-----------------+
+ *
+ * A thread leitora preenche a janela com blocos lidos do arquivo; as threads
+ * analisadoras pegam o próximo bloco lido e calculam seus metadados; a thread
+ * montadora (a que chamou "carregar_arquivo") insere os blocos no buffer, na
+ * ordem do arquivo, e libera a posição da janela. Como a leitora nunca fica
+ * mais do que JANELA blocos à frente da montadora, a memória extra usada pela
+ * carga é limitada a JANELA * TAMBLOCO bytes, qualquer que seja o tamanho do
+ * arquivo. A sincronização é feita com um único mutex e uma única variável de
+ * condição, pois ela ocorre apenas uma vez por bloco (e não por caractere).
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "buffer.h"
+#include "carregador.h"
+#include "genlib.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: TAMBLOCO, JANELA, MAXTRABALHADORES
+ * ----------------------------------------------
+ * TAMBLOCO é o tamanho, em bytes, de cada bloco lido do arquivo; JANELA é a
+ * quantidade máxima de blocos em trânsito entre a leitura e a montagem; e
+ * MAXTRABALHADORES limita a quantidade de threads analisadoras.
+ */
+
+#define TAMBLOCO (1 << 20)
+#define JANELA 32
+#define MAXTRABALHADORES 64
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: estadoT
+ * -------------
+ * Indica em que etapa da linha de montagem está uma posição da janela.
+ */
+
+typedef enum { LIVRE, LIDO, ANALISADO } estadoT;
+
+/**
+ * Tipo: blocoT
+ * ------------
+ * Representa um bloco do arquivo em trânsito pela linha de montagem:
+ *
+ *     dados         bytes lidos do arquivo
+ *     tamanho       quantidade de bytes em "dados"
+ *     quebras       quantidade de '\n' no bloco
+ *     continuacoes  bytes de continuação UTF-8 no início do bloco (terminam
+ *                   uma sequência que começou no bloco anterior)
+ *     pendentes     bytes de continuação que faltam para completar a última
+ *                   sequência UTF-8 do bloco (estão no bloco seguinte)
+ *     tamcauda      bytes já presentes dessa última sequência incompleta
+ *     utf8_valido   TRUE se o bloco (sem as pontas) é UTF-8 válido
+ *     estado        etapa atual do bloco
+ */
+
+typedef struct
+{
+    char *dados;
+    size_t tamanho;
+    size_t quebras;
+    int continuacoes;
+    int pendentes;
+    int tamcauda;
+    bool utf8_valido;
+    estadoT estado;
+} blocoT;
+
+/**
+ * Tipo: cargaT
+ * ------------
+ * Estado compartilhado entre as threads de uma carga. Os contadores "lidos",
+ * "distribuidos" e "montados" são números de blocos (e não posições da janela):
+ * o bloco "i" ocupa sempre a posição "i % JANELA".
+ */
+
+typedef struct
+{
+    FILE *arquivo;
+    blocoT janela[JANELA];
+    size_t lidos;
+    size_t distribuidos;
+    size_t montados;
+    bool fim;
+    bool erro;
+    pthread_mutex_t trava;
+    pthread_cond_t mudou;
+} cargaT;
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void *ler_blocos (void *arg);
+static void *analisar_blocos (void *arg);
+static void analisar_bloco (blocoT *bloco);
+static bool validar_utf8 (const unsigned char *s, size_t n, int *pendentes);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: carregar_arquivo
+ * Uso: if (carregar_arquivo(buffer, nome, trabalhadores, &resumo)) . . .
+ * ----------------------------------------------------------------------
+ * Cria as threads leitora e analisadoras e executa, na thread atual, a etapa
+ * de montagem. Se nem todas as analisadoras puderem ser criadas, a carga
+ * continua com as que foram; sem a leitora ou sem nenhuma analisadora (caso
+ * em que a leitora é encerrada com "fim" e os blocos que ela já leu são
+ * liberados), nada é carregado e a função retorna FALSE. A validade UTF-8
+ * nas fronteiras entre blocos é verificada aqui, guardando em "cauda" o
+ * início da sequência incompleta do bloco anterior.
+ */
+
+bool carregar_arquivo (bufferTAD buffer, string nome, int trabalhadores,
+                       resumo_cargaT *resumo)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: carga em buffer null.\n");
+        exit(1);
+    }
+
+    cargaT *carga = calloc(1, sizeof(cargaT));
+    if (carga == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar a carga.\n");
+        return FALSE;
+    }
+
+    carga->arquivo = fopen(nome, "rb");
+    if (carga->arquivo == NULL)
+    {
+        fprintf(stderr, "Erro: impossível abrir \"%s\".\n", nome);
+        free(carga);
+        return FALSE;
+    }
+    pthread_mutex_init(&carga->trava, NULL);
+    pthread_cond_init(&carga->mudou, NULL);
+
+    if (trabalhadores <= 0)
+        trabalhadores = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (trabalhadores <= 0)
+        trabalhadores = 1;
+    else if (trabalhadores > MAXTRABALHADORES)
+        trabalhadores = MAXTRABALHADORES;
+
+    pthread_t leitora, analisadoras[MAXTRABALHADORES];
+    bool leitora_criada = (pthread_create(&leitora, NULL, ler_blocos,
+                                          carga) == 0);
+    int criadas = 0;
+    while (leitora_criada && criadas < trabalhadores &&
+           pthread_create(&analisadoras[criadas], NULL, analisar_blocos,
+                          carga) == 0)
+        criadas++;
+    trabalhadores = criadas;
+    if (trabalhadores == 0)
+    {
+        fprintf(stderr, "Erro: impossível criar as threads da carga.\n");
+        if (leitora_criada)
+        {
+            pthread_mutex_lock(&carga->trava);
+            carga->fim = TRUE;
+            pthread_cond_broadcast(&carga->mudou);
+            pthread_mutex_unlock(&carga->trava);
+            pthread_join(leitora, NULL);
+            for (int k = 0; k < JANELA; k++)
+                free(carga->janela[k].dados);
+        }
+        fclose(carga->arquivo);
+        pthread_mutex_destroy(&carga->trava);
+        pthread_cond_destroy(&carga->mudou);
+        free(carga);
+        return FALSE;
+    }
+
+    resumo_cargaT total = { 0, 0, 0, TRUE };
+    unsigned char cauda[8];
+    int tamcauda = 0, pendentes = 0;
+
+    for (size_t i = 0; ; i++)
+    {
+        blocoT *bloco = &carga->janela[i % JANELA];
+
+        pthread_mutex_lock(&carga->trava);
+        while (!(i < carga->lidos && bloco->estado == ANALISADO) &&
+               !(carga->fim && i >= carga->lidos))
+            pthread_cond_wait(&carga->mudou, &carga->trava);
+        bool acabou = (i >= carga->lidos);
+        pthread_mutex_unlock(&carga->trava);
+        if (acabou)
+            break;
+
+        inserir_texto(buffer, bloco->dados, bloco->tamanho);
+
+        total.bytes += bloco->tamanho;
+        total.linhas += bloco->quebras;
+        total.blocos++;
+        if (!bloco->utf8_valido || bloco->continuacoes != pendentes)
+            total.utf8_valido = FALSE;
+        else if (pendentes > 0)
+        {
+            int p;
+            memcpy(cauda + tamcauda, bloco->dados, bloco->continuacoes);
+            if (!validar_utf8(cauda, tamcauda + bloco->continuacoes, &p) || p)
+                total.utf8_valido = FALSE;
+        }
+        pendentes = bloco->pendentes;
+        tamcauda = bloco->tamcauda;
+        memcpy(cauda, bloco->dados + bloco->tamanho - tamcauda, tamcauda);
+
+        free(bloco->dados);
+        bloco->dados = NULL;
+
+        pthread_mutex_lock(&carga->trava);
+        bloco->estado = LIVRE;
+        carga->montados++;
+        pthread_cond_broadcast(&carga->mudou);
+        pthread_mutex_unlock(&carga->trava);
+    }
+    if (pendentes > 0)
+        total.utf8_valido = FALSE;
+
+    pthread_join(leitora, NULL);
+    for (int t = 0; t < trabalhadores; t++)
+        pthread_join(analisadoras[t], NULL);
+
+    bool ok = !carga->erro;
+    if (!ok)
+        fprintf(stderr, "Erro: falha na leitura de \"%s\".\n", nome);
+
+    fclose(carga->arquivo);
+    pthread_mutex_destroy(&carga->trava);
+    pthread_cond_destroy(&carga->mudou);
+    free(carga);
+
+    if (resumo != NULL)
+        *resumo = total;
+    return ok;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: ler_blocos
+ * Uso: pthread_create(&leitora, NULL, ler_blocos, carga);
+ * -------------------------------------------------------
+ * Corpo da thread leitora: lê o arquivo em blocos de TAMBLOCO bytes enquanto
+ * houver espaço na janela, até o final do arquivo, um erro de leitura ou o
+ * pedido de parada (feito com "fim" quando a carga é abandonada).
+ */
+
+static void *ler_blocos (void *arg)
+{
+    cargaT *carga = arg;
+
+    while (TRUE)
+    {
+        pthread_mutex_lock(&carga->trava);
+        while (carga->lidos >= carga->montados + JANELA && !carga->fim)
+            pthread_cond_wait(&carga->mudou, &carga->trava);
+        blocoT *bloco = &carga->janela[carga->lidos % JANELA];
+        bool parar = carga->fim;
+        pthread_mutex_unlock(&carga->trava);
+        if (parar)
+            return NULL;
+
+        char *dados = malloc(TAMBLOCO);
+        size_t n = 0;
+        if (dados != NULL)
+            n = fread(dados, 1, TAMBLOCO, carga->arquivo);
+
+        pthread_mutex_lock(&carga->trava);
+        if (dados == NULL || ferror(carga->arquivo))
+            carga->erro = TRUE;
+        if (n > 0 && !carga->erro)
+        {
+            bloco->dados = dados;
+            bloco->tamanho = n;
+            bloco->estado = LIDO;
+            carga->lidos++;
+        }
+        else
+            free(dados);
+        if (n < TAMBLOCO || carga->erro)
+            carga->fim = TRUE;
+        bool fim = carga->fim;
+        pthread_cond_broadcast(&carga->mudou);
+        pthread_mutex_unlock(&carga->trava);
+
+        if (fim)
+            return NULL;
+    }
+}
+
+/**
+ * Função: analisar_blocos
+ * Uso: pthread_create(&analisadora, NULL, analisar_blocos, carga);
+ * ----------------------------------------------------------------
+ * Corpo de uma thread analisadora: pega o próximo bloco lido que ainda não foi
+ * distribuído, analisa esse bloco fora da região crítica e o marca como
+ * analisado. Termina quando a leitura acabou e não há mais blocos a analisar.
+ */
+
+static void *analisar_blocos (void *arg)
+{
+    cargaT *carga = arg;
+
+    pthread_mutex_lock(&carga->trava);
+    while (TRUE)
+    {
+        while (carga->distribuidos >= carga->lidos && !carga->fim)
+            pthread_cond_wait(&carga->mudou, &carga->trava);
+        if (carga->distribuidos >= carga->lidos)
+            break;
+
+        blocoT *bloco = &carga->janela[carga->distribuidos++ % JANELA];
+        pthread_mutex_unlock(&carga->trava);
+
+        analisar_bloco(bloco);
+
+        pthread_mutex_lock(&carga->trava);
+        bloco->estado = ANALISADO;
+        pthread_cond_broadcast(&carga->mudou);
+    }
+    pthread_mutex_unlock(&carga->trava);
+
+    return NULL;
+}
+
+/**
+ * Procedimento: analisar_bloco
+ * Uso: analisar_bloco(bloco);
+ * ---------------------------
+ * Calcula os metadados de um bloco: conta as quebras de linha com memchr e
+ * valida o UTF-8 do bloco, separando os bytes de continuação do início (que
+ * pertencem a uma sequência do bloco anterior) e os que faltam no final.
+ */
+
+static void analisar_bloco (blocoT *bloco)
+{
+    const char *p = bloco->dados, *fim = bloco->dados + bloco->tamanho;
+    size_t quebras = 0;
+    while ((p = memchr(p, '\n', fim - p)) != NULL)
+    {
+        quebras++;
+        p++;
+    }
+    bloco->quebras = quebras;
+
+    const unsigned char *s = (const unsigned char *) bloco->dados;
+    int c = 0;
+    while (c < 3 && (size_t) c < bloco->tamanho && (s[c] & 0xC0) == 0x80)
+        c++;
+    bloco->continuacoes = c;
+    bloco->utf8_valido = validar_utf8(s + c, bloco->tamanho - c,
+                                      &bloco->pendentes);
+
+    int t = 0;
+    if (bloco->utf8_valido && bloco->pendentes > 0)
+    {
+        while ((s[bloco->tamanho - 1 - t] & 0xC0) == 0x80)
+            t++;
+        t++;
+    }
+    bloco->tamcauda = t;
+}
+
+/**
+ * Função: validar_utf8
+ * Uso: if (validar_utf8(s, n, &pendentes)) . . .
+ * ----------------------------------------------
+ * Retorna TRUE se os "n" bytes de "s" formam UTF-8 válido (sem sequências
+ * longas demais, surrogates ou valores acima de U+10FFFF). Uma sequência
+ * incompleta no final não é considerada erro: a quantidade de bytes que falta
+ * é armazenada em "pendentes" (0 se a última sequência está completa). Trechos
+ * ASCII são verificados 8 bytes por vez.
+ */
+
+static bool validar_utf8 (const unsigned char *s, size_t n, int *pendentes)
+{
+    size_t i = 0;
+
+    *pendentes = 0;
+    while (i < n)
+    {
+        if (i + 8 <= n)
+        {
+            uint64_t palavra;
+            memcpy(&palavra, s + i, 8);
+            if ((palavra & 0x8080808080808080ULL) == 0)
+            {
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned char c = s[i];
+        unsigned char min = 0x80, max = 0xBF;
+        size_t k;
+        if (c < 0x80)
+        {
+            i++;
+            continue;
+        }
+        else if (c >= 0xC2 && c <= 0xDF)
+            k = 1;
+        else if (c >= 0xE0 && c <= 0xEF)
+        {
+            k = 2;
+            if (c == 0xE0)
+                min = 0xA0;
+            else if (c == 0xED)
+                max = 0x9F;
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            k = 3;
+            if (c == 0xF0)
+                min = 0x90;
+            else if (c == 0xF4)
+                max = 0x8F;
+        }
+        else
+            return FALSE;
+
+        for (size_t j = 1; j <= k; j++)
+        {
+            if (i + j >= n)
+            {
+                *pendentes = (int) (k - j + 1);
+                return TRUE;
+            }
+            if (j == 1 && (s[i + 1] < min || s[i + 1] > max))
+                return FALSE;
+            if ((s[i + j] & 0xC0) != 0x80)
+                return FALSE;
+        }
+        i += k + 1;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,82 @@
+/**
+ * Arquivo: carregador.h
+ * Versão : 1.0
+ * Data   : 2026-10-18 10:20
+ * -------------------------
+ * Este arquivo define uma interface para a carga de arquivos (potencialmente
+ * muito grandes) em um bufferTAD. Em vez de chamar "inserir_caractere" uma vez
+ * para cada caractere do arquivo, o carregador trabalha como uma linha de
+ * montagem (pipeline) com três etapas que executam ao mesmo tempo:
+ *
+ *     1) leitura : uma thread lê o arquivo em blocos grandes;
+ *     2) análise : threads trabalhadoras calculam, em paralelo, os metadados
+ *                  de cada bloco (tamanho, quebras de linha, validade UTF-8);
+ *     3) montagem: a thread que chamou o carregador insere cada bloco, em
+ *                  ordem, no buffer, com uma única chamada a "inserir_texto".
+ *
+ * Dessa forma o tempo de carga fica limitado pela leitura do disco, e não pelo
+ * laço de inserção caractere a caractere.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _CARREGADOR_H
+#define _CARREGADOR_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: resumo_cargaT
+ * -------------------
+ * Este tipo concreto reúne os metadados calculados durante a carga de um
+ * arquivo:
+ *
+ *     bytes        quantidade de caracteres (bytes) inseridos no buffer
+ *     linhas       quantidade de quebras de linha ('\n') encontradas
+ *     blocos       quantidade de blocos em que o arquivo foi dividido
+ *     utf8_valido  TRUE se todo o arquivo é UTF-8 válido
+ */
+
+typedef struct
+{
+    size_t bytes;
+    size_t linhas;
+    size_t blocos;
+    bool utf8_valido;
+} resumo_cargaT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: carregar_arquivo
+ * Uso: if (carregar_arquivo(buffer, nome, trabalhadores, &resumo)) . . .
+ * ----------------------------------------------------------------------
+ * Carrega o conteúdo do arquivo "nome" no buffer, na posição atual do cursor
+ * (o cursor fica após o último caractere carregado). A análise dos blocos é
+ * feita por "trabalhadores" threads; se esse argumento for menor ou igual a 0,
+ * é usada uma thread por processador disponível. Se "resumo" não for NULL, os
+ * metadados da carga são armazenados nele. Retorna FALSE se o arquivo não
+ * puder ser aberto ou lido (o que já tiver sido carregado permanece no buffer).
+ */
+
+bool carregar_arquivo (bufferTAD buffer, string nome, int trabalhadores,
+                       resumo_cargaT *resumo);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
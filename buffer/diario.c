@@ -0,0 +1,679 @@
+/**
+ * Arquivo: diario.c
+ * Versão : 1.2
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo implementa a interface diario.h. Os arquivos têm o seguinte
+ * formato (texto, com uma linha de cabeçalho):
+ *
+ *     checkpoint: "checkpoint <geração> <cursor> <tamanho>\n" <texto do buffer>
+ *     diário    : "diario <geração>\n" <registro>\n <registro>\n . . .
+ *
+ * A geração liga o diário ao checkpoint do qual ele parte: ao salvar um novo
+ * checkpoint a geração é incrementada e o diário é reiniciado. Se o programa
+ * falhar depois de renomear o novo checkpoint mas antes de reiniciar o diário,
+ * o diário antigo (de geração menor) é ignorado na recuperação, em vez de ser
+ * reaplicado em duplicidade. Antes de reiniciar o diário, o diretório do
+ * checkpoint também é sincronizado com o disco: sem isso, uma queda logo
+ * depois poderia perder a renomeação e deixar o checkpoint antigo ao lado de
+ * um diário já esvaziado.
+ *
+ * O lote de registros é trocado por um segundo lote (double buffering) no
+ * momento da gravação, para que os registros feitos durante a gravação não
+ * fiquem esperando pelo disco.
+ *
+ * Uma falha de gravação ou de sincronização é permanente: depois dela não se
+ * sabe o que chegou ao disco (o arquivo pode terminar no meio de um registro,
+ * e o Linux pode já ter descartado as páginas não gravadas), então os lotes
+ * seguintes são descartados em vez de gravados depois de um registro talvez
+ * incompleto. O próximo checkpoint, que contém todo o buffer, reinicia o
+ * diário e encerra o estado de falha.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "buffer.h"
+#include "diario.h"
+#include "genlib.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: TAMLOTE, TAMCOPIA
+ * -----------------------------
+ * TAMLOTE é a capacidade inicial, em bytes, de cada lote de registros; quando
+ * um lote atinge esse tamanho a gravadora é acordada antes do fim do
+ * intervalo. TAMCOPIA é o tamanho dos trechos copiados do buffer para o
+ * checkpoint (e lidos do checkpoint para o buffer).
+ */
+
+#define TAMLOTE (64 * 1024)
+#define TAMCOPIA (1 << 20)
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: diarioTCD
+ * ---------------
+ * Representação concreta do diário:
+ *
+ *     fd             descritor do arquivo, aberto com O_APPEND
+ *     geracao        geração do checkpoint do qual o diário parte
+ *     intervalo      intervalo entre sincronizações, em milissegundos
+ *     lote           registros ainda não entregues à gravadora
+ *     registrados    total de bytes registrados desde a abertura
+ *     sincronizados  total de bytes já gravados e sincronizados
+ *     urgente        TRUE se alguém espera pela sincronização
+ *     encerrar       TRUE se a gravadora deve terminar
+ *     falhou         TRUE depois de uma falha de gravação
+ *     trava          protege o lote, os contadores e os indicadores
+ *     gravacao       serializa as escritas no arquivo
+ *     pedido         acorda a gravadora
+ *     gravado        avisa que uma sincronização terminou
+ */
+
+struct diarioTCD
+{
+    int fd;
+    unsigned long geracao;
+    int intervalo;
+    char *lote;
+    size_t tamlote;
+    size_t caplote;
+    unsigned long long registrados;
+    unsigned long long sincronizados;
+    bool urgente;
+    bool encerrar;
+    bool falhou;
+    pthread_mutex_t trava;
+    pthread_mutex_t gravacao;
+    pthread_cond_t pedido;
+    pthread_cond_t gravado;
+    pthread_t gravadora;
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void *gravar_lotes (void *arg);
+static bool gravar_tudo (int fd, const char *dados, size_t n);
+static bool cortar_registro_incompleto (diarioTAD diario);
+static bool reiniciar_arquivo (diarioTAD diario, unsigned long geracao);
+static bool sincronizar_diretorio (string arquivo);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: recuperar_sessao
+ * Uso: if (recuperar_sessao(buffer, checkpoint, diario, aplicar, &geracao))
+ * -------------------------------------------------------------------------
+ * Lê o checkpoint em trechos de TAMCOPIA bytes e depois reaplica os registros
+ * do diário. Uma última linha sem '\n' é um registro que não chegou a ser
+ * gravado por inteiro, e é descartada. Um checkpoint com cabeçalho inválido
+ * não é tratado como ausente: a geração 0 faria "abrir_diario" reiniciar o
+ * diário da geração verdadeira.
+ */
+
+bool recuperar_sessao (bufferTAD buffer, string checkpoint, string diario,
+                       aplicadorT aplicar, unsigned long *geracao_recuperada)
+{
+    unsigned long geracao = 0;
+    size_t cursor = 0, tamanho = 0;
+
+    FILE *arq = fopen(checkpoint, "rb");
+    if (arq != NULL)
+    {
+        if (fscanf(arq, "checkpoint %lu %zu %zu", &geracao, &cursor,
+                   &tamanho) != 3 || fgetc(arq) != '\n')
+        {
+            fprintf(stderr, "Erro: checkpoint \"%s\" inválido.\n", checkpoint);
+            fclose(arq);
+            return FALSE;
+        }
+
+        char *trecho = malloc(TAMCOPIA);
+        if (trecho == NULL)
+        {
+            fprintf(stderr, "Erro: impossível ler o checkpoint.\n");
+            exit(1);
+        }
+        size_t n;
+        while ((n = fread(trecho, 1, TAMCOPIA, arq)) > 0)
+            inserir_texto(buffer, trecho, n);
+        free(trecho);
+        fclose(arq);
+
+        if (tamanho_buffer(buffer) != tamanho)
+            fprintf(stderr, "Aviso: checkpoint \"%s\" incompleto.\n",
+                    checkpoint);
+        mover_cursor_para_posicao(buffer, cursor);
+    }
+
+    arq = fopen(diario, "rb");
+    if (arq != NULL)
+    {
+        unsigned long g;
+        if (fscanf(arq, "diario %lu", &g) == 1 && fgetc(arq) == '\n' &&
+            g == geracao)
+        {
+            char *linha = NULL;
+            size_t cap = 0;
+            ssize_t n;
+            while ((n = getline(&linha, &cap, arq)) > 0 && linha[n - 1] == '\n')
+            {
+                linha[n - 1] = '\0';
+                aplicar(buffer, linha);
+            }
+            free(linha);
+        }
+        fclose(arq);
+    }
+
+    *geracao_recuperada = geracao;
+    return TRUE;
+}
+
+/**
+ * Função: abrir_diario
+ * Uso: diario = abrir_diario(nome, geracao, intervalo);
+ * -----------------------------------------------------
+ * Abre (ou cria) o arquivo, verifica a geração do cabeçalho e inicia a thread
+ * gravadora. Se o diário continua, um registro incompleto no final (que a
+ * recuperação descartou) é cortado antes que os novos registros sejam
+ * acrescentados depois dele. Se o arquivo não puder ser preparado, ou a
+ * gravadora não puder ser criada, o diário não é aberto.
+ */
+
+diarioTAD abrir_diario (string nome, unsigned long geracao, int intervalo)
+{
+    diarioTAD D = calloc(1, sizeof(struct diarioTCD));
+    if (D == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar diário.\n");
+        return NULL;
+    }
+
+    D->lote = malloc(TAMLOTE);
+    D->fd = open(nome, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (D->lote == NULL || D->fd < 0)
+    {
+        fprintf(stderr, "Erro: impossível abrir o diário \"%s\".\n", nome);
+        if (D->fd >= 0)
+            close(D->fd);
+        free(D->lote);
+        free(D);
+        return NULL;
+    }
+    D->caplote = TAMLOTE;
+    D->intervalo = intervalo;
+    D->geracao = geracao;
+
+    char cabecalho[64];
+    ssize_t lidos = pread(D->fd, cabecalho, sizeof(cabecalho) - 1, 0);
+    unsigned long g;
+    int fim = 0;
+    cabecalho[lidos > 0 ? lidos : 0] = '\0';
+    bool ok;
+    if (sscanf(cabecalho, "diario %lu%n", &g, &fim) != 1 ||
+        cabecalho[fim] != '\n' || g != geracao)
+        ok = reiniciar_arquivo(D, geracao);
+    else
+        ok = cortar_registro_incompleto(D);
+
+    pthread_mutex_init(&D->trava, NULL);
+    pthread_mutex_init(&D->gravacao, NULL);
+    pthread_cond_init(&D->pedido, NULL);
+    pthread_cond_init(&D->gravado, NULL);
+    if (ok && pthread_create(&D->gravadora, NULL, gravar_lotes, D) != 0)
+    {
+        fprintf(stderr, "Erro: impossível criar a gravadora do diário.\n");
+        ok = FALSE;
+    }
+    if (!ok)
+    {
+        close(D->fd);
+        pthread_mutex_destroy(&D->trava);
+        pthread_mutex_destroy(&D->gravacao);
+        pthread_cond_destroy(&D->pedido);
+        pthread_cond_destroy(&D->gravado);
+        free(D->lote);
+        free(D);
+        return NULL;
+    }
+
+    return D;
+}
+
+/**
+ * Procedimento: registrar_no_diario
+ * Uso: registrar_no_diario(diario, registro);
+ * -------------------------------------------
+ * Copia o registro e uma quebra de linha para o lote atual. A gravadora só é
+ * acordada se o lote ficou grande, ou se o diário sincroniza a cada registro
+ * (intervalo menor ou igual a 0).
+ */
+
+void registrar_no_diario (diarioTAD diario, string registro)
+{
+    if (diario == NULL)
+    {
+        fprintf(stderr, "Erro: registro em diário null.\n");
+        exit(1);
+    }
+
+    size_t n = strlen(registro);
+
+    pthread_mutex_lock(&diario->trava);
+    if (diario->tamlote + n + 1 > diario->caplote)
+    {
+        size_t cap = diario->caplote;
+        while (cap < diario->tamlote + n + 1)
+            cap *= 2;
+        char *lote = realloc(diario->lote, cap);
+        if (lote == NULL)
+        {
+            fprintf(stderr, "Erro: impossível aumentar o lote do diário.\n");
+            exit(1);
+        }
+        diario->lote = lote;
+        diario->caplote = cap;
+    }
+    memcpy(diario->lote + diario->tamlote, registro, n);
+    diario->lote[diario->tamlote + n] = '\n';
+    diario->tamlote += n + 1;
+    diario->registrados += n + 1;
+    if (diario->intervalo <= 0 || diario->tamlote >= TAMLOTE)
+        pthread_cond_signal(&diario->pedido);
+    pthread_mutex_unlock(&diario->trava);
+}
+
+/**
+ * Função: sincronizar_diario
+ * Uso: if (sincronizar_diario(diario)) . . .
+ * ------------------------------------------
+ * Pede uma gravação imediata e espera até que todos os bytes registrados até
+ * agora estejam sincronizados, ou até que a gravadora registre uma falha.
+ */
+
+bool sincronizar_diario (diarioTAD diario)
+{
+    if (diario == NULL)
+        return TRUE;
+
+    pthread_mutex_lock(&diario->trava);
+    unsigned long long alvo = diario->registrados;
+    while (diario->sincronizados < alvo && !diario->falhou)
+    {
+        diario->urgente = TRUE;
+        pthread_cond_signal(&diario->pedido);
+        pthread_cond_wait(&diario->gravado, &diario->trava);
+    }
+    bool ok = !diario->falhou;
+    pthread_mutex_unlock(&diario->trava);
+
+    return ok;
+}
+
+/**
+ * Função: salvar_checkpoint
+ * Uso: if (salvar_checkpoint(buffer, diario, checkpoint)) . . .
+ * -------------------------------------------------------------
+ * Grava "<checkpoint>.tmp", sincroniza esse arquivo com o disco, renomeia o
+ * arquivo para "checkpoint", sincroniza o diretório (para que a renomeação
+ * chegue ao disco) e só então reinicia o diário na nova geração. Se o diário
+ * estava em falha, o checkpoint é gravado mesmo assim (é a única cópia dos
+ * registros perdidos) e, com o diário reiniciado, os registros pendentes, já
+ * contidos no checkpoint, são descartados e a falha é encerrada.
+ */
+
+bool salvar_checkpoint (bufferTAD buffer, diarioTAD diario, string checkpoint)
+{
+    if (buffer == NULL || diario == NULL)
+    {
+        fprintf(stderr, "Erro: checkpoint de buffer ou diário null.\n");
+        exit(1);
+    }
+
+    if (!sincronizar_diario(diario))
+        fprintf(stderr, "Aviso: o diário falhou; o checkpoint será a única "
+                "cópia dos últimos registros.\n");
+
+    unsigned long geracao = diario->geracao + 1;
+    size_t tamanho = tamanho_buffer(buffer);
+    char *temporario = malloc(strlen(checkpoint) + 5);
+    char *trecho = malloc(TAMCOPIA);
+    if (temporario == NULL || trecho == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar o checkpoint.\n");
+        free(temporario);
+        free(trecho);
+        return FALSE;
+    }
+    sprintf(temporario, "%s.tmp", checkpoint);
+
+    FILE *arq = fopen(temporario, "wb");
+    bool ok = (arq != NULL);
+    if (ok)
+    {
+        fprintf(arq, "checkpoint %lu %zu %zu\n", geracao,
+                posicao_cursor(buffer), tamanho);
+        for (size_t i = 0; i < tamanho && ok; )
+        {
+            size_t n = copiar_texto(buffer, i, TAMCOPIA, trecho);
+            ok = (fwrite(trecho, 1, n, arq) == n);
+            i += n;
+        }
+        ok = (fflush(arq) == 0) && ok;
+        ok = (fsync(fileno(arq)) == 0) && ok;
+        ok = (fclose(arq) == 0) && ok;
+    }
+    free(trecho);
+
+    if (ok)
+        ok = (rename(temporario, checkpoint) == 0);
+    if (ok && !sincronizar_diretorio(checkpoint))
+    {
+        fprintf(stderr, "Erro: impossível sincronizar o diretório de \"%s\": "
+                "%s.\n", checkpoint, strerror(errno));
+        free(temporario);
+        return FALSE;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Erro: impossível gravar o checkpoint \"%s\": %s.\n",
+                checkpoint, strerror(errno));
+        remove(temporario);
+        free(temporario);
+        return FALSE;
+    }
+    free(temporario);
+
+    pthread_mutex_lock(&diario->gravacao);
+    ok = reiniciar_arquivo(diario, geracao);
+    pthread_mutex_unlock(&diario->gravacao);
+    if (ok)
+    {
+        pthread_mutex_lock(&diario->trava);
+        if (diario->falhou)
+        {
+            diario->tamlote = 0;
+            diario->sincronizados = diario->registrados;
+            diario->falhou = FALSE;
+        }
+        pthread_mutex_unlock(&diario->trava);
+    }
+
+    return ok;
+}
+
+/**
+ * Procedimento: fechar_diario
+ * Uso: fechar_diario(&diario);
+ * ----------------------------
+ * Pede à gravadora que grave o último lote e termine, espera por ela e libera
+ * os recursos do diário.
+ */
+
+void fechar_diario (diarioTAD *diario)
+{
+    if (diario == NULL || *diario == NULL)
+        return;
+
+    diarioTAD D = *diario;
+    pthread_mutex_lock(&D->trava);
+    D->encerrar = TRUE;
+    pthread_cond_signal(&D->pedido);
+    pthread_mutex_unlock(&D->trava);
+    pthread_join(D->gravadora, NULL);
+
+    close(D->fd);
+    pthread_mutex_destroy(&D->trava);
+    pthread_mutex_destroy(&D->gravacao);
+    pthread_cond_destroy(&D->pedido);
+    pthread_cond_destroy(&D->gravado);
+    free(D->lote);
+    free(D);
+    *diario = NULL;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: gravar_lotes
+ * Uso: pthread_create(&gravadora, NULL, gravar_lotes, diario);
+ * ------------------------------------------------------------
+ * Corpo da thread gravadora. A cada intervalo (ou quando acordada) troca o
+ * lote atual por um lote vazio, grava o lote cheio e sincroniza o arquivo fora
+ * da região crítica, e avisa quem estiver esperando pela sincronização. Em
+ * estado de falha os lotes são apenas descartados.
+ */
+
+static void *gravar_lotes (void *arg)
+{
+    diarioTAD D = arg;
+    char *gravando = NULL;
+    size_t capgravando = 0;
+
+    pthread_mutex_lock(&D->trava);
+    while (TRUE)
+    {
+        if (!D->urgente && !D->encerrar && D->tamlote < TAMLOTE)
+        {
+            if (D->intervalo > 0)
+            {
+                struct timespec limite;
+                clock_gettime(CLOCK_REALTIME, &limite);
+                limite.tv_sec += D->intervalo / 1000;
+                limite.tv_nsec += (D->intervalo % 1000) * 1000000L;
+                if (limite.tv_nsec >= 1000000000L)
+                {
+                    limite.tv_sec++;
+                    limite.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&D->pedido, &D->trava, &limite);
+            }
+            else if (D->tamlote == 0)
+                pthread_cond_wait(&D->pedido, &D->trava);
+        }
+        D->urgente = FALSE;
+
+        if (D->tamlote > 0 && D->falhou)
+            D->tamlote = 0;
+        else if (D->tamlote > 0)
+        {
+            char *lote = D->lote;
+            size_t n = D->tamlote, cap = D->caplote;
+            unsigned long long alvo = D->registrados;
+            if (gravando == NULL)
+            {
+                gravando = malloc(TAMLOTE);
+                capgravando = TAMLOTE;
+            }
+            if (gravando == NULL)
+            {
+                fprintf(stderr, "Erro: impossível alocar lote do diário.\n");
+                exit(1);
+            }
+            D->lote = gravando;
+            D->caplote = capgravando;
+            D->tamlote = 0;
+            gravando = lote;
+            capgravando = cap;
+            pthread_mutex_unlock(&D->trava);
+
+            pthread_mutex_lock(&D->gravacao);
+            bool ok = gravar_tudo(D->fd, gravando, n) && fdatasync(D->fd) == 0;
+            if (!ok)
+                fprintf(stderr, "Erro: falha na gravação do diário: %s.\n",
+                        strerror(errno));
+            pthread_mutex_unlock(&D->gravacao);
+
+            pthread_mutex_lock(&D->trava);
+            if (ok)
+                D->sincronizados = alvo;
+            else
+                D->falhou = TRUE;
+        }
+        pthread_cond_broadcast(&D->gravado);
+
+        if (D->encerrar && D->tamlote == 0)
+            break;
+    }
+    pthread_mutex_unlock(&D->trava);
+    free(gravando);
+
+    return NULL;
+}
+
+/**
+ * Função: gravar_tudo
+ * Uso: if (gravar_tudo(fd, dados, n)) . . .
+ * -----------------------------------------
+ * Chama "write" até que os "n" bytes tenham sido gravados, repetindo as
+ * escritas parciais e as interrompidas por sinais.
+ */
+
+static bool gravar_tudo (int fd, const char *dados, size_t n)
+{
+    while (n > 0)
+    {
+        ssize_t k = write(fd, dados, n);
+        if (k < 0 && errno == EINTR)
+            continue;
+        else if (k < 0)
+            return FALSE;
+        dados += k;
+        n -= k;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Função: cortar_registro_incompleto
+ * Uso: if (cortar_registro_incompleto(diario)) . . .
+ * --------------------------------------------------
+ * Procura, de trás para frente, a última quebra de linha do arquivo (a do
+ * cabeçalho, se não houver registros) e corta o que vier depois dela: um
+ * registro que não chegou a ser gravado por inteiro.
+ */
+
+static bool cortar_registro_incompleto (diarioTAD diario)
+{
+    struct stat info;
+    char trecho[512];
+
+    if (fstat(diario->fd, &info) != 0)
+    {
+        fprintf(stderr, "Erro: impossível ler o diário: %s.\n",
+                strerror(errno));
+        return FALSE;
+    }
+    off_t fim = info.st_size;
+    while (fim > 0)
+    {
+        size_t n = fim < (off_t) sizeof(trecho) ? (size_t) fim
+                                                 : sizeof(trecho);
+        if (pread(diario->fd, trecho, n, fim - n) != (ssize_t) n)
+        {
+            fprintf(stderr, "Erro: impossível ler o diário: %s.\n",
+                    strerror(errno));
+            return FALSE;
+        }
+        size_t k = n;
+        while (k > 0 && trecho[k - 1] != '\n')
+            k--;
+        fim -= n - k;
+        if (k > 0)
+            break;
+    }
+    if (fim == info.st_size)
+        return TRUE;
+
+    if (ftruncate(diario->fd, fim) != 0 || fdatasync(diario->fd) != 0)
+    {
+        fprintf(stderr, "Erro: impossível cortar o diário: %s.\n",
+                strerror(errno));
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Função: reiniciar_arquivo
+ * Uso: if (reiniciar_arquivo(diario, geracao)) . . .
+ * --------------------------------------------------
+ * Esvazia o arquivo do diário e grava o cabeçalho da geração informada.
+ */
+
+static bool reiniciar_arquivo (diarioTAD diario, unsigned long geracao)
+{
+    char cabecalho[64];
+    int n = sprintf(cabecalho, "diario %lu\n", geracao);
+
+    if (ftruncate(diario->fd, 0) != 0 ||
+        !gravar_tudo(diario->fd, cabecalho, n) || fdatasync(diario->fd) != 0)
+    {
+        fprintf(stderr, "Erro: impossível reiniciar o diário: %s.\n",
+                strerror(errno));
+        return FALSE;
+    }
+    diario->geracao = geracao;
+
+    return TRUE;
+}
+
+/**
+ * Função: sincronizar_diretorio
+ * Uso: if (sincronizar_diretorio(arquivo)) . . .
+ * ----------------------------------------------
+ * Abre o diretório que contém "arquivo" (o diretório atual, se o nome não
+ * tiver '/') e chama "fsync" nele, gravando no disco as entradas criadas ou
+ * renomeadas. Retorna FALSE em caso de erro, com errno indicando a causa.
+ */
+
+static bool sincronizar_diretorio (string arquivo)
+{
+    char *diretorio = malloc(strlen(arquivo) + 2);
+    if (diretorio == NULL)
+        return FALSE;
+    strcpy(diretorio, arquivo);
+    char *barra = strrchr(diretorio, '/');
+    if (barra == NULL)
+        strcpy(diretorio, ".");
+    else if (barra == diretorio)
+        diretorio[1] = '\0';
+    else
+        *barra = '\0';
+
+    int fd = open(diretorio, O_RDONLY);
+    free(diretorio);
+    if (fd < 0)
+        return FALSE;
+    bool ok = (fsync(fd) == 0);
+    int erro = errno;
+    close(fd);
+    errno = erro;
+
+    return ok;
+}
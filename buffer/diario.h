@@ -0,0 +1,139 @@
+/**
+ * Arquivo: diario.h
+ * Versão : 1.2
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo define uma interface para um diário (write-ahead log) das
+ * operações de edição de um buffer, utilizado para recuperar o buffer depois
+ * de uma falha do programa. A recuperação combina dois arquivos:
+ *
+ *     checkpoint: o conteúdo completo do buffer (e a posição do cursor) no
+ *                 momento em que ele foi salvo pela última vez;
+ *     diário    : os registros das operações feitas depois desse momento, um
+ *                 por linha, na ordem em que foram executadas.
+ *
+ * Os registros não são gravados no disco um a um: eles são acumulados em
+ * memória e uma thread gravadora escreve e sincroniza (fsync) o lote inteiro a
+ * cada intervalo configurável (commit em grupo). Registrar uma operação custa
+ * apenas uma cópia em memória; em caso de falha, perdem-se no máximo as
+ * operações do último intervalo.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _DIARIO_H
+#define _DIARIO_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: diarioTAD
+ * ---------------
+ * Representa um diário aberto para gravação.
+ */
+
+typedef struct diarioTCD *diarioTAD;
+
+/**
+ * TIPO: aplicadorT
+ * ----------------
+ * Tipo dos procedimentos que reaplicam um registro do diário a um buffer,
+ * durante a recuperação. O registro é a mesma string passada a
+ * "registrar_no_diario", sem a quebra de linha.
+ */
+
+typedef void (*aplicadorT) (bufferTAD buffer, string registro);
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: recuperar_sessao
+ * Uso: if (recuperar_sessao(buffer, checkpoint, diario, aplicar, &geracao))
+ * -------------------------------------------------------------------------
+ * Carrega no buffer (que deve estar vazio) o conteúdo do arquivo "checkpoint",
+ * posiciona o cursor onde ele estava e reaplica, com "aplicar", cada registro
+ * completo do arquivo "diario" que pertence a esse checkpoint. Os arquivos que
+ * não existem são ignorados. Armazena em "geracao" a geração do checkpoint (0
+ * se não houver checkpoint), que deve ser passada a "abrir_diario". Retorna
+ * FALSE, sem alterar o buffer nem os arquivos, se o checkpoint existe mas o
+ * seu cabeçalho é inválido; nesse caso a sessão não deve ser continuada.
+ */
+
+bool recuperar_sessao (bufferTAD buffer, string checkpoint, string diario,
+                       aplicadorT aplicar, unsigned long *geracao);
+
+/**
+ * FUNÇÃO: abrir_diario
+ * Uso: diario = abrir_diario(nome, geracao, intervalo);
+ * -----------------------------------------------------
+ * Abre o arquivo de diário "nome" para gravação e inicia a thread gravadora,
+ * que sincroniza o diário com o disco a cada "intervalo" milissegundos. Se o
+ * arquivo já contém registros da mesma geração, os novos registros são
+ * acrescentados a eles, depois de cortado um último registro incompleto;
+ * caso contrário o arquivo é reiniciado. Retorna NULL se o arquivo não puder
+ * ser aberto ou preparado, ou se a gravadora não puder ser criada.
+ */
+
+diarioTAD abrir_diario (string nome, unsigned long geracao, int intervalo);
+
+/**
+ * PROCEDIMENTO: registrar_no_diario
+ * Uso: registrar_no_diario(diario, registro);
+ * -------------------------------------------
+ * Acrescenta "registro" (uma string sem quebras de linha) ao lote de registros
+ * ainda não gravados. A gravação é feita depois, pela thread gravadora.
+ */
+
+void registrar_no_diario (diarioTAD diario, string registro);
+
+/**
+ * FUNÇÃO: sincronizar_diario
+ * Uso: if (sincronizar_diario(diario)) . . .
+ * ------------------------------------------
+ * Espera até que todos os registros feitos até agora estejam gravados e
+ * sincronizados com o disco. Retorna FALSE se uma gravação falhou: nesse caso
+ * os registros seguintes deixam de ser gravados até o próximo checkpoint.
+ */
+
+bool sincronizar_diario (diarioTAD diario);
+
+/**
+ * FUNÇÃO: salvar_checkpoint
+ * Uso: if (salvar_checkpoint(buffer, diario, checkpoint)) . . .
+ * -------------------------------------------------------------
+ * Grava o conteúdo do buffer no arquivo "checkpoint" (em um arquivo temporário
+ * que depois é renomeado, para que um checkpoint incompleto nunca substitua o
+ * anterior) e reinicia o diário em uma nova geração, já que os registros
+ * anteriores passam a estar contidos no checkpoint. Retorna FALSE em caso de
+ * erro, mantendo o checkpoint e o diário anteriores.
+ */
+
+bool salvar_checkpoint (bufferTAD buffer, diarioTAD diario, string checkpoint);
+
+/**
+ * PROCEDIMENTO: fechar_diario
+ * Uso: fechar_diario(&diario);
+ * ----------------------------
+ * Grava os registros pendentes, encerra a thread gravadora e libera o diário.
+ * Note que o argumento é um PONTEIRO para o diário.
+ */
+
+void fechar_diario (diarioTAD *diario);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
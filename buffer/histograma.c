@@ -0,0 +1,210 @@
+/**
+ * Arquivo: histograma.c
+ * Versão : 1.0
+ * Data   : 2026-10-18 19:00
+ * -------------------------
+ * Este arquivo implementa a interface histograma.h. Os valores de 0 a 15 têm
+ * uma faixa cada; a partir daí, um valor v com o bit mais alto na posição k
+ * cai na faixa 16 + (k - 4) * 8 + s, onde s são os 3 bits logo abaixo do bit
+ * mais alto.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#include "genlib.h"
+#include "histograma.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: SUBFAIXAS, FAIXAS
+ * -----------------------------
+ * SUBFAIXAS é em quantas faixas cada potência de 2 é dividida (2^3), e FAIXAS
+ * é a quantidade total de faixas, suficiente para valores de até 64 bits.
+ */
+
+#define SUBFAIXAS 8
+#define FAIXAS (2 * SUBFAIXAS + (64 - 4) * SUBFAIXAS)
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: histogramaTCD
+ * -------------------
+ * A quantidade de valores em cada faixa, o total de valores e o maior valor
+ * registrado.
+ */
+
+struct histogramaTCD
+{
+    uint64_t contagens[FAIXAS];
+    uint64_t total;
+    uint64_t maximo;
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static int faixa (uint64_t valor);
+static uint64_t limite_faixa (int faixa);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: criar_histograma
+ * Uso: h = criar_histograma( );
+ * -----------------------------
+ * Aloca o histograma com todos os contadores zerados.
+ */
+
+histogramaTAD criar_histograma (void)
+{
+    histogramaTAD H = calloc(1, sizeof(struct histogramaTCD));
+    if (H == NULL)
+        fprintf(stderr, "Erro: impossível alocar histograma.\n");
+
+    return H;
+}
+
+/**
+ * Procedimento: liberar_histograma
+ * Uso: liberar_histograma(&h);
+ * ----------------------------
+ * Libera a memória do histograma.
+ */
+
+void liberar_histograma (histogramaTAD *histograma)
+{
+    if (histograma != NULL && *histograma != NULL)
+    {
+        free(*histograma);
+        *histograma = NULL;
+    }
+}
+
+/**
+ * Procedimento: registrar_valor
+ * Uso: registrar_valor(h, valor);
+ * -------------------------------
+ * Incrementa o contador da faixa do valor.
+ */
+
+void registrar_valor (histogramaTAD histograma, uint64_t valor)
+{
+    if (histograma == NULL)
+    {
+        fprintf(stderr, "Erro: registro em histograma null.\n");
+        exit(1);
+    }
+
+    histograma->contagens[faixa(valor)]++;
+    histograma->total++;
+    if (valor > histograma->maximo)
+        histograma->maximo = valor;
+}
+
+/**
+ * Função: quantidade_valores
+ * Uso: n = quantidade_valores(h);
+ * -------------------------------
+ * Retorna o total mantido pelo histograma.
+ */
+
+uint64_t quantidade_valores (histogramaTAD histograma)
+{
+    if (histograma == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a histograma null.\n");
+        exit(1);
+    }
+
+    return histograma->total;
+}
+
+/**
+ * Função: percentil
+ * Uso: p99 = percentil(h, 99.0);
+ * ------------------------------
+ * Soma as faixas, da menor para a maior, até alcançar a posição do percentil
+ * entre os valores ordenados, e retorna o limite superior dessa faixa.
+ */
+
+uint64_t percentil (histogramaTAD histograma, double p)
+{
+    if (histograma == NULL)
+    {
+        fprintf(stderr, "Erro: consulta a histograma null.\n");
+        exit(1);
+    }
+    else if (histograma->total == 0)
+        return 0;
+
+    uint64_t posicao = (uint64_t) (p / 100.0 * histograma->total + 0.5);
+    if (posicao < 1)
+        posicao = 1;
+    if (posicao > histograma->total)
+        posicao = histograma->total;
+
+    uint64_t acumulado = 0;
+    for (int i = 0; i < FAIXAS; i++)
+    {
+        acumulado += histograma->contagens[i];
+        if (acumulado >= posicao)
+        {
+            uint64_t limite = limite_faixa(i);
+            return limite < histograma->maximo ? limite : histograma->maximo;
+        }
+    }
+
+    return histograma->maximo;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: faixa
+ * Uso: i = faixa(valor);
+ * ----------------------
+ * Retorna a faixa de um valor.
+ */
+
+static int faixa (uint64_t valor)
+{
+    if (valor < 2 * SUBFAIXAS)
+        return (int) valor;
+
+    int k = 63 - __builtin_clzll(valor);
+    int s = (int) (valor >> (k - 3)) & (SUBFAIXAS - 1);
+
+    return 2 * SUBFAIXAS + (k - 4) * SUBFAIXAS + s;
+}
+
+/**
+ * Função: limite_faixa
+ * Uso: v = limite_faixa(i);
+ * -------------------------
+ * Retorna o maior valor que cai na faixa "i".
+ */
+
+static uint64_t limite_faixa (int i)
+{
+    if (i < 2 * SUBFAIXAS)
+        return (uint64_t) i;
+
+    int k = (i - 2 * SUBFAIXAS) / SUBFAIXAS + 4;
+    uint64_t s = (uint64_t) ((i - 2 * SUBFAIXAS) % SUBFAIXAS);
+    uint64_t inicio = ((uint64_t) SUBFAIXAS + s) << (k - 3);
+
+    return inicio + ((uint64_t) 1 << (k - 3)) - 1;
+}
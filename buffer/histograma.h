@@ -0,0 +1,97 @@
+/**
+ * Arquivo: histograma.h
+ * Versão : 1.0
+ * Data   : 2026-10-18 19:00
+ * -------------------------
+ * Este arquivo define uma interface para histogramas de latência com faixas
+ * em escala logarítmica: cada potência de 2 é dividida em 8 faixas iguais, de
+ * modo que qualquer valor é registrado com erro relativo de no máximo 12,5%,
+ * usando uma quantidade fixa de memória (pouco mais de 500 contadores) para
+ * valores de 0 até 2^64 - 1. Registrar um valor custa algumas operações
+ * aritméticas e um incremento, sem alocação de memória.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _HISTOGRAMA_H
+#define _HISTOGRAMA_H
+
+/*** Includes ***/
+
+#include "genlib.h"
+#include <stdint.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: histogramaTAD
+ * -------------------
+ * Representa um histograma de valores (tipicamente latências em
+ * nanossegundos).
+ */
+
+typedef struct histogramaTCD *histogramaTAD;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: criar_histograma
+ * Uso: h = criar_histograma( );
+ * -----------------------------
+ * Cria um histograma vazio. Retorna NULL se não houver memória.
+ */
+
+histogramaTAD criar_histograma (void);
+
+/**
+ * PROCEDIMENTO: liberar_histograma
+ * Uso: liberar_histograma(&h);
+ * ----------------------------
+ * Libera o histograma e atribui NULL ao ponteiro original. Note que o
+ * argumento é um PONTEIRO para o histograma.
+ */
+
+void liberar_histograma (histogramaTAD *histograma);
+
+/**
+ * PROCEDIMENTO: registrar_valor
+ * Uso: registrar_valor(h, valor);
+ * -------------------------------
+ * Registra mais uma ocorrência de "valor" no histograma.
+ */
+
+void registrar_valor (histogramaTAD histograma, uint64_t valor);
+
+/**
+ * FUNÇÃO: quantidade_valores
+ * Uso: n = quantidade_valores(h);
+ * -------------------------------
+ * Retorna quantos valores foram registrados no histograma.
+ */
+
+uint64_t quantidade_valores (histogramaTAD histograma);
+
+/**
+ * FUNÇÃO: percentil
+ * Uso: p99 = percentil(h, 99.0);
+ * ------------------------------
+ * Retorna o percentil "p" (de 0 a 100) dos valores registrados: um valor
+ * maior ou igual a pelo menos p% dos valores, arredondado para o limite
+ * superior da sua faixa (mas nunca maior do que o maior valor registrado).
+ * Retorna 0 se o histograma estiver vazio.
+ */
+
+uint64_t percentil (histogramaTAD histograma, double p);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
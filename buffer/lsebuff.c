@@ -1,11 +1,28 @@
 /**
  * Arquivo: lsebuff.c
- * Versão : 1.0
- * Data   : 2024-10-27 16:55
+ * Versão : 1.10
+ * Data   : 2026-10-19 04:40
  * -------------------------
  * Este arquivo implementa a interface buffer.h, utilizando uma lista encadeada
  * simples para o armazenamento dos caracteres do buffer.
  *
+ * Sobre a lista é mantido um índice em vários níveis (uma skip list): algumas
+ * células, sorteadas, fazem parte também de listas "expressas", cada uma com
+ * cerca de 1/4 das células do nível abaixo, e cada ligação de um nível
+ * expresso guarda quantos caracteres ela salta. Com isso, localizar uma
+ * posição qualquer custa O(log n) em vez de O(n), e voltar um caractere não
+ * exige mais percorrer a lista desde o início. O índice pode ser desligado
+ * compilando com -Dsemindice; nesse caso a lista volta a ser percorrida
+ * caractere a caractere.
+ *
+ * A estrutura do buffer e as células são obtidas do alocador do buffer (veja
+ * alocador.h e criar_buffer_com_alocador). Com uma arena, liberar_buffer não
+ * percorre a lista: a arena inteira é liberada de uma só vez.
+ *
+ * As edições de uma transação (veja transacao.h) são aplicadas à lista de uma
+ * só vez, na confirmação ou na primeira leitura do texto, reaproveitando as
+ * células dos caracteres substituídos (veja aplicar_pendentes).
+ *
  * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
  *             Capítulo 9: Efficiency and ADTs (pg. 391-407).
  *
@@ -21,14 +38,39 @@
 
 /*** Includes ***/
 
+#define IMPLEMENTANDO_BUFFER
+
+#include "alocador.h"
 #include "buffer.h"
 #include "genlib.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "strlib.h"
+#include "transacao.h"
 
 /*** Constantes Simbólicas ***/
 
+/**
+ * CONSTANTE: NIVEIS
+ * -----------------
+ * Quantidade máxima de níveis expressos do índice. Como cada nível tem cerca
+ * de 1/4 das células do nível anterior, 16 níveis bastam para 4^16 (mais de
+ * 4 bilhões) de caracteres.
+ */
+
+#define NIVEIS 16
+
+/**
+ * CONSTANTE: JANELA
+ * -----------------
+ * Maior quantidade de caracteres copiada de uma vez para um array local pelas
+ * buscas para trás.
+ */
+
+#define JANELA 4096
+
 /*** Variáveis Globais ***/
 
 /*** Tipos de Dados ***/
@@ -42,12 +84,26 @@
  * ponteiro para uma celulaTCD, para facilitar algumas operações. As operações
  * de criar e remover células são privadas a este arquivo, e estão definidas
  * mais abaixo.
+ *
+ * Uma célula que faz parte de "altura" níveis expressos do índice tem, para
+ * cada nível k (de 0 a altura - 1), a próxima célula desse nível e a
+ * distância, em caracteres, até ela. Se não há próxima célula no nível, a
+ * distância é contada até uma posição fictícia logo após o final do buffer. A
+ * maioria das células tem altura 0 e ocupa o mesmo espaço de antes.
  */
 
+typedef struct nivelTCD
+{
+    struct celulaTCD *salto;
+    size_t distancia;
+} nivelTCD;
+
 typedef struct celulaTCD
 {
     char letra;
+    unsigned char altura;
     struct celulaTCD *proximo;
+    nivelTCD niveis[];
 } celulaTCD;
 
 typedef struct celulaTCD *celulaTAD;
@@ -61,6 +117,18 @@ typedef struct celulaTCD *celulaTAD;
  *
  *     inicio    : ponteiro para o início da lista
  *     cursor    : ponteiro para a posição atual do cursor
+ *     tamanho   : quantidade de caracteres na lista
+ *     posicao   : quantidade de caracteres antes do cursor
+ *     versao    : contador de alterações do conteúdo
+ *     topo      : quantidade de níveis expressos em uso
+ *     dedo      : para cada nível expresso k, a última célula desse nível que
+ *                 está no cursor ou antes dele (a "dummy cell", se não houver)
+ *     posdedo   : a posição de cada célula de "dedo" (0 para a dummy cell)
+ *     sorteio   : estado do gerador de números usado para sortear as alturas
+ *     alocador  : alocador da estrutura do buffer e das células
+ *     transacao : transação aberta (NULL se não houver)
+ *     desfazer  : última transação confirmada, para desfazer_transacao
+ *     versao_desfazer : versão do buffer logo após aquela confirmação
  *
  * Para simplificar as operações na lista esta imiplementação adota a estratégia
  * de manter uma "dummy cell" no início de cada lista, de forma que o buffer
@@ -71,18 +139,63 @@ typedef struct celulaTCD *celulaTAD;
  *     +-------+    /     +------+
  *     | C o---+---/      | NULL |      C: ponteiro cursor
  *     +-------+          +------+
+ *
+ * A dummy cell tem a altura máxima, NIVEIS. O "dedo" é o que permite inserir e
+ * apagar no cursor sem buscar nada no índice: as células que precisam ser
+ * religadas são exatamente as do dedo.
  */
 
 struct bufferTCD
 {
     celulaTAD inicio;
     celulaTAD cursor;
+    size_t tamanho;
+    size_t posicao;
+    unsigned long versao;
+    int topo;
+    celulaTAD dedo[NIVEIS];
+    size_t posdedo[NIVEIS];
+    uint32_t sorteio;
+    alocadorT alocador;
+    transacaoTAD transacao;
+    transacaoTAD desfazer;
+    unsigned long versao_desfazer;
 };
 
+/**
+ * Tipo: classeT
+ * -------------
+ * As classes de caracteres procuradas pelos movimentos de palavra, linha e
+ * parágrafo: o '\n' (QUEBRA), qualquer outro caractere (TEXTO), os
+ * caracteres de palavra (PALAVRA) e os demais (SEPARADOR).
+ */
+
+typedef enum
+{
+    QUEBRA,
+    TEXTO,
+    PALAVRA,
+    SEPARADOR
+} classeT;
+
 /*** Declarações de Suprogramas Privados ***/
 
-static celulaTAD criar_celula (void);
-static void remover_celula (celulaTAD *celula);
+static celulaTAD criar_celula (bufferTAD buffer, int altura);
+static void remover_celula (bufferTAD buffer, celulaTAD *celula);
+static void ligar_celula (bufferTAD buffer, char c);
+static void desligar_celula (bufferTAD buffer);
+static celulaTAD localizar (bufferTAD buffer, size_t posicao, bool dedo);
+static int sortear_altura (bufferTAD buffer);
+static size_t *tabela_falhas (const char *padrao, size_t n);
+static void anexar (bufferTAD buffer, bool simular, const char *texto,
+                    size_t n);
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static bool pertence (char c, classeT classe);
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar);
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao);
+static void aplicar_pendentes (bufferTAD buffer);
 
 /*** Definições de Subprogramas Exportados ***/
 
@@ -97,24 +210,45 @@ static void remover_celula (celulaTAD *celula);
 bufferTAD
 criar_buffer (void)
 {
-    bufferTAD B = calloc(1, sizeof(struct bufferTCD));
+    return criar_buffer_com_alocador(NULL);
+}
+
+/**
+ * Função: criar_buffer_com_alocador
+ * Uso: buffer = criar_buffer_com_alocador(&alocador);
+ * ---------------------------------------------------
+ * Igual a criar_buffer, mas a estrutura do buffer e todas as células serão
+ * obtidas do alocador (ou de malloc, se o alocador for NULL). Em caso de erro,
+ * libera o alocador, se for o dono da sua memória, e retorna NULL.
+ */
+
+bufferTAD
+criar_buffer_com_alocador (const alocadorT *alocador)
+{
+    alocadorT a = (alocador != NULL) ? *alocador : alocador_padrao();
+    bufferTAD B = alocar(&a, sizeof(struct bufferTCD));
     if (B == NULL)
     {
         fprintf(stderr, "Erro: impossível alocar buffer.\n");
+        liberar_alocador(&a);
         return NULL;
     }
+    memset(B, 0, sizeof(struct bufferTCD));
+    B->alocador = a;
 
-    celulaTAD temp = criar_celula();
+    celulaTAD temp = criar_celula(B, NIVEIS);
     if (temp == NULL)
     {
         fprintf(stderr, "Erro: a célula não foi criada.\n");
-        free(B);
+        desalocar(&a, B, sizeof(struct bufferTCD));
+        liberar_alocador(&a);
         B = NULL;
         return NULL;
     }
 
     B->inicio = B->cursor = temp;
     B->inicio->proximo = NULL;
+    B->sorteio = 2463534242u;
 
     temp = NULL;
     
@@ -131,6 +265,10 @@ criar_buffer (void)
  * depois, verificar seu ponteiro "próximo". Para evitar visitar campos em uma
  * estrutura depois que ela foi liberada, temos que copiar o ponteiro antes de
  * liberar essa estrutura da memória.
+ *
+ * Se o alocador do buffer for uma arena, as células não são visitadas: a
+ * arena, que contém as células e a própria estrutura do buffer, é liberada de
+ * uma só vez.
  */
 
 void
@@ -142,15 +280,22 @@ liberar_buffer (bufferTAD *buffer)
     }
     else
     {
-        celulaTAD atual, proxima;
-        atual = (*buffer)->inicio;
-        while (atual != NULL)
+        alocadorT alocador = (*buffer)->alocador;
+        liberar_transacao(&(*buffer)->transacao);
+        liberar_transacao(&(*buffer)->desfazer);
+        if (alocador.liberar_tudo == NULL)
         {
-            proxima = atual->proximo;
-            remover_celula(&atual);
-            atual = proxima;
+            celulaTAD atual, proxima;
+            atual = (*buffer)->inicio;
+            while (atual != NULL)
+            {
+                proxima = atual->proximo;
+                remover_celula(*buffer, &atual);
+                atual = proxima;
+            }
+            desalocar(&alocador, *buffer, sizeof(struct bufferTCD));
         }
-        free(*buffer);
+        liberar_alocador(&alocador);
         *buffer = NULL;
     }
 }
@@ -161,7 +306,8 @@ liberar_buffer (bufferTAD *buffer)
  * ----------------------------------
  * Insere o caractere 'c' no buffer "buffer", na posição indicada pelo cursor (o
  * cursor aponta para a CÉLULA IMEDIATAMENTE ANTES DA POSIÇÃO DO CURSOR). Após a
- * inserção do caractere os ponteiros são ajustados.
+ * inserção do caractere os ponteiros (e o índice) são ajustados por
+ * "ligar_celula".
  */
 
 void
@@ -172,29 +318,40 @@ inserir_caractere (bufferTAD buffer, char c)
         fprintf(stderr, "Erro: inserção em buffer null.");
         exit(1);
     }
-
-    // 1: cria nova célula na memória e retorna um ponteiro para a essa célula:
-    celulaTAD pc = criar_celula();
-    if (pc == NULL)
+    else if (registrar(buffer, &c, 1, 0))
     {
-        fprintf(stderr, "Erro: impossível alocar célula.\n");
-        exit(1);
+        return;
     }
 
-    // 2: copia o caractere para a nova célula:
-    pc->letra = c;
-
-    // 3: copia o "próximo" do cursor para o ponteiro "próximo" da nova célula:
-    pc->proximo = buffer->cursor->proximo;
+    ligar_celula(buffer, c);
+    buffer->versao++;
+}
 
-    // 4: altera o "próximo" do cursor para que apontar para o nova célula:
-    buffer->cursor->proximo = pc;
+/**
+ * Procedimento: inserir_texto
+ * Uso: inserir_texto(buffer, texto, n);
+ * -------------------------------------
+ * Insere "n" caracteres na posição do cursor, uma célula de cada vez (cada
+ * célula nova precisa ser ligada aos níveis do índice para os quais foi
+ * sorteada). Ao final o cursor aponta para a última célula inserida.
+ */
 
-    // 5: faz o cursor para apontar para a nova célula:
-    buffer->cursor = pc;
+void
+inserir_texto (bufferTAD buffer, const char *texto, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: inserção em buffer null.\n");
+        exit(1);
+    }
+    else if (n == 0 || registrar(buffer, texto, n, 0))
+    {
+        return;
+    }
 
-    // 6: remove o ponteiro temporário (não estritamente necessário):
-    pc = NULL;
+    for (size_t i = 0; i < n; i++)
+        ligar_celula(buffer, texto[i]);
+    buffer->versao++;
 }
 
 /**
@@ -203,22 +360,57 @@ inserir_caractere (bufferTAD buffer, char c)
  * ------------------------------
  * Recebe o buffer como argumento e remove o caractere apontado pelo cursor. A
  * operação é facilitada pelo uso da "dummy cell", que faz para o cursor apontar
- * para a célula imediatamente anterior à posição do cursor.
+ * para a célula imediatamente anterior à posição do cursor; a célula é
+ * desligada da lista e do índice por "desligar_celula".
  */
 
 void
 apagar_caractere (bufferTAD buffer)
 {
-    celulaTAD temp;
+    if (registrar(buffer, NULL, 0, 1))
+    {
+        return;
+    }
 
     if (buffer->cursor->proximo != NULL)
     {
-        temp = buffer->cursor->proximo;
-        buffer->cursor->proximo = temp->proximo;
-        remover_celula(&temp);
+        desligar_celula(buffer);
+        buffer->versao++;
     }
+}
 
-    temp = NULL;
+/**
+ * Procedimento: apagar_texto
+ * Uso: apagar_texto(buffer, n);
+ * -----------------------------
+ * Apaga até "n" caracteres após o cursor. Como as células apagadas são sempre
+ * as seguintes ao cursor, as células a religar são sempre as do dedo, e cada
+ * célula custa uma atualização por nível em uso, sem nenhuma busca.
+ */
+
+void
+apagar_texto (bufferTAD buffer, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: remoção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, NULL, 0, n))
+    {
+        return;
+    }
+
+    size_t removidos = 0;
+    while (removidos < n && buffer->cursor->proximo != NULL)
+    {
+        desligar_celula(buffer);
+        removidos++;
+    }
+    if (removidos > 0)
+    {
+        buffer->versao++;
+    }
 }
 
 /**
@@ -227,6 +419,10 @@ apagar_caractere (bufferTAD buffer)
  * Uso: mover_cursor_para_frente(buffer);
  *      mover_cursor_para_tras(buffer);
  * ---------------------------------------
+ * Para frente, a célula seguinte passa a ser o dedo dos níveis de que faz
+ * parte. Para trás, é preciso encontrar a célula anterior ao cursor, o que é
+ * feito descendo pelo índice a partir do dedo do primeiro nível que está acima
+ * da célula do cursor; em média são visitadas poucas células.
  */
 
 void
@@ -237,10 +433,20 @@ mover_cursor_para_frente (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
+    else if (mover_na_transacao(buffer, posicao_cursor(buffer) + 1))
+    {
+        return;
+    }
 
     if (buffer->cursor->proximo != NULL)
     {
         buffer->cursor = buffer->cursor->proximo;
+        buffer->posicao++;
+        for (int k = 0; k < buffer->cursor->altura; k++)
+        {
+            buffer->dedo[k] = buffer->cursor;
+            buffer->posdedo[k] = buffer->posicao;
+        }
     }
 }
 
@@ -252,17 +458,41 @@ mover_cursor_para_tras (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
-
-    celulaTAD temp;
+    else if (mover_na_transacao(buffer, (posicao_cursor(buffer) > 0)
+                                        ? posicao_cursor(buffer) - 1 : 0))
+    {
+        return;
+    }
 
     if (buffer->cursor != buffer->inicio)
     {
-        temp = buffer->inicio;
-        while (temp->proximo != buffer->cursor)
+        int h = buffer->cursor->altura;
+        size_t alvo = buffer->posicao - 1, pos = 0;
+        celulaTAD temp = buffer->inicio;
+        if (h < buffer->topo)
+        {
+            temp = buffer->dedo[h];
+            pos = buffer->posdedo[h];
+        }
+
+        for (int k = h - 1; k >= 0; k--)
+        {
+            while (temp->niveis[k].salto != NULL &&
+                   pos + temp->niveis[k].distancia <= alvo)
+            {
+                pos += temp->niveis[k].distancia;
+                temp = temp->niveis[k].salto;
+            }
+            buffer->dedo[k] = temp;
+            buffer->posdedo[k] = pos;
+        }
+        while (pos < alvo)
         {
             temp = temp->proximo;
+            pos++;
         }
         buffer->cursor = temp;
+        buffer->posicao = alvo;
     }
 }
 
@@ -272,6 +502,8 @@ mover_cursor_para_tras (bufferTAD buffer)
  * Uso: mover_cursor_para_inicio(buffer);
  *      mover_cursor_para_final(buffer);
  * ---------------------------------------
+ * O início é a dummy cell, que também é o dedo de todos os níveis. O final é
+ * localizado pelo índice, em O(log n).
  */
 
 void
@@ -282,8 +514,18 @@ mover_cursor_para_inicio (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
+    else if (mover_na_transacao(buffer, 0))
+    {
+        return;
+    }
 
     buffer->cursor = buffer->inicio;
+    buffer->posicao = 0;
+    for (int k = 0; k < buffer->topo; k++)
+    {
+        buffer->dedo[k] = buffer->inicio;
+        buffer->posdedo[k] = 0;
+    }
 }
 
 void
@@ -294,11 +536,397 @@ mover_cursor_para_final (bufferTAD buffer)
         fprintf(stderr, "Erro: movimentação em buffer null.\n");
         exit(1);
     }
+    else if (mover_na_transacao(buffer, SIZE_MAX))
+    {
+        return;
+    }
+
+    buffer->cursor = localizar(buffer, buffer->tamanho, TRUE);
+    buffer->posicao = buffer->tamanho;
+}
+
+/**
+ * Procedimento: mover_cursor_para_posicao
+ * Uso: mover_cursor_para_posicao(buffer, posicao);
+ * ------------------------------------------------
+ * A posição é localizada pelo índice, descendo do nível mais alto até a lista
+ * de caracteres, em O(log n).
+ */
+
+void
+mover_cursor_para_posicao (bufferTAD buffer, size_t posicao)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+    else if (mover_na_transacao(buffer, posicao))
+    {
+        return;
+    }
 
-    while (buffer->cursor->proximo != NULL)
+    if (posicao > buffer->tamanho)
     {
-        mover_cursor_para_frente(buffer);
+        posicao = buffer->tamanho;
     }
+    buffer->cursor = localizar(buffer, posicao, TRUE);
+    buffer->posicao = posicao;
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proxima_palavra
+ *                mover_cursor_para_palavra_anterior
+ * Uso: mover_cursor_para_proxima_palavra(buffer);
+ *      mover_cursor_para_palavra_anterior(buffer);
+ * -------------------------------------------------
+ * Para frente, as buscas percorrem a lista a partir da célula do cursor; para
+ * trás, copiam janelas de células para um array local, pois a lista não tem
+ * ligações para trás. O cursor é localizado pelo índice uma única vez, ao
+ * final.
+ */
+
+void
+mover_cursor_para_proxima_palavra (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = avancar_ate(buffer, posicao_cursor(buffer), SEPARADOR);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, p, PALAVRA));
+}
+
+void
+mover_cursor_para_palavra_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), PALAVRA);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, p, SEPARADOR));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_inicio_da_linha
+ *                mover_cursor_para_final_da_linha
+ * Uso: mover_cursor_para_inicio_da_linha(buffer);
+ *      mover_cursor_para_final_da_linha(buffer);
+ * -----------------------------------------------
+ * Uma única busca pelo '\n' anterior ou seguinte ao cursor.
+ */
+
+void
+mover_cursor_para_inicio_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, posicao_cursor(buffer),
+                                                 QUEBRA));
+}
+
+void
+mover_cursor_para_final_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, posicao_cursor(buffer),
+                                                  QUEBRA));
+}
+
+/**
+ * Procedimentos: mover_cursor_para_proximo_paragrafo
+ *                mover_cursor_para_paragrafo_anterior
+ * Uso: mover_cursor_para_proximo_paragrafo(buffer);
+ *      mover_cursor_para_paragrafo_anterior(buffer);
+ * ---------------------------------------------------
+ * Para frente, o texto é percorrido de uma sequência de '\n' a outra; a
+ * primeira sequência com dois ou mais '\n' que vem depois de um caractere de
+ * texto termina o parágrafo, e a linha em branco começa logo após o primeiro
+ * '\n'. Para trás, o texto é percorrido de um início de linha com texto ao
+ * anterior; o primeiro que é precedido por dois ou mais '\n' (ou apenas por
+ * '\n' desde o início do buffer) começa um parágrafo, e a linha em branco
+ * começa logo antes dele. Se o cursor está em uma linha em branco, as linhas em
+ * branco vizinhas são puladas antes.
+ */
+
+void
+mover_cursor_para_proximo_paragrafo (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer), p = posicao_cursor(buffer);
+    bool apos_texto = (p > 0 && recuar_ate(buffer, p, TEXTO) == p);
+
+    while (p < n)
+    {
+        size_t q = avancar_ate(buffer, p, QUEBRA);
+        size_t r = (q < n) ? avancar_ate(buffer, q, TEXTO) : n;
+        if ((q > p || apos_texto) && r - q >= 2)
+        {
+            p = q + 1;
+            break;
+        }
+        p = r;
+        apos_texto = TRUE;
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+void
+mover_cursor_para_paragrafo_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), QUEBRA);
+
+    if (p == n || avancar_ate(buffer, p, TEXTO) != p)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        p = (t > 0) ? recuar_ate(buffer, t, QUEBRA) : 0;
+    }
+    while (p > 0)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        if (t == 0 || p - t >= 2)
+        {
+            p--;
+            break;
+        }
+        p = recuar_ate(buffer, t, QUEBRA);
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+/**
+ * Funções: tamanho_buffer, posicao_cursor
+ * Uso: n = tamanho_buffer(buffer);
+ *      p = posicao_cursor(buffer);
+ * ---------------------------------------
+ * Retornam os contadores mantidos pelas operações de edição e movimentação.
+ */
+
+size_t
+tamanho_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+    {
+        return tamanho_da_transacao(buffer->transacao);
+    }
+
+    return buffer->tamanho;
+}
+
+size_t
+posicao_cursor (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cursor de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+    {
+        return cursor_da_transacao(buffer->transacao);
+    }
+
+    return buffer->posicao;
+}
+
+/**
+ * Função: versao_buffer
+ * Uso: v = versao_buffer(buffer);
+ * -------------------------------
+ * Retorna o contador de alterações, incrementado pelas inserções e remoções.
+ */
+
+unsigned long
+versao_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: versão de buffer null.\n");
+        exit(1);
+    }
+
+    return buffer->versao;
+}
+
+/**
+ * Função: copiar_texto
+ * Uso: n = copiar_texto(buffer, inicio, n, destino);
+ * --------------------------------------------------
+ * Localiza a célula anterior a "inicio" pelo índice, sem mover o cursor, e
+ * copia as letras das células seguintes.
+ */
+
+size_t
+copiar_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[])
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cópia de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    if (inicio >= buffer->tamanho)
+    {
+        return 0;
+    }
+
+    size_t copiados = 0;
+    celulaTAD tmp = localizar(buffer, inicio, FALSE)->proximo;
+    for (; tmp != NULL && copiados < n; tmp = tmp->proximo)
+    {
+        destino[copiados++] = tmp->letra;
+    }
+
+    return copiados;
+}
+
+/**
+ * Função: substituir_tudo
+ * Uso: n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+ * ----------------------------------------------------------------
+ * A lista antiga é desligada do buffer, que fica vazio, e percorrida uma única
+ * vez: o padrão é procurado com o algoritmo de Knuth-Morris-Pratt, cada célula
+ * lida é liberada, e o novo texto é ligado ao final do buffer por
+ * "ligar_celula", que monta o índice à medida que as células são criadas. Ao
+ * final o cursor é localizado pelo índice. Na simulação a lista é apenas
+ * percorrida.
+ */
+
+size_t
+substituir_tudo (bufferTAD buffer, const char *padrao, size_t np,
+                 const char *novo, size_t nn, bool simular)
+{
+    if (buffer == NULL || (np > 0 && padrao == NULL) ||
+        (nn > 0 && novo == NULL))
+    {
+        fprintf(stderr, "Erro: substituição em buffer null.\n");
+        exit(1);
+    }
+    else if (np == 0)
+    {
+        return 0;
+    }
+
+    aplicar_pendentes(buffer);
+    if (!simular)
+    {
+        guardar_texto_para_desfazer(buffer->transacao, buffer);
+    }
+    size_t *falhas = tabela_falhas(padrao, np);
+    size_t cursor = buffer->posicao;
+    size_t quantidade = 0, j = 0, i = 0, saida = 0;
+    size_t ganho = 0, perda = 0, novo_cursor = 0;
+    bool dentro = FALSE;
+
+    celulaTAD atual = buffer->inicio->proximo, proxima;
+    if (!simular)
+    {
+        buffer->inicio->proximo = NULL;
+        buffer->cursor = buffer->inicio;
+        buffer->tamanho = buffer->posicao = 0;
+        buffer->topo = 0;
+    }
+
+    for (; atual != NULL; atual = proxima)
+    {
+        char c = atual->letra;
+        proxima = atual->proximo;
+        if (!simular)
+        {
+            remover_celula(buffer, &atual);
+        }
+        i++;
+
+        while (j > 0 && c != padrao[j])
+        {
+            anexar(buffer, simular, padrao, j - falhas[j - 1]);
+            saida += j - falhas[j - 1];
+            j = falhas[j - 1];
+        }
+        if (c == padrao[j])
+        {
+            j++;
+        }
+        else
+        {
+            anexar(buffer, simular, &c, 1);
+            saida++;
+        }
+
+        if (j == np)
+        {
+            if (i <= cursor)
+            {
+                ganho += nn;
+                perda += np;
+            }
+            else if (i - np < cursor)
+            {
+                novo_cursor = saida + nn;
+                dentro = TRUE;
+            }
+            anexar(buffer, simular, novo, nn);
+            saida += nn;
+            quantidade++;
+            j = 0;
+        }
+    }
+    anexar(buffer, simular, padrao, j);
+    free(falhas);
+
+    if (!simular)
+    {
+        if (!dentro)
+        {
+            novo_cursor = cursor + ganho - perda;
+        }
+        buffer->cursor = localizar(buffer, novo_cursor, TRUE);
+        buffer->posicao = novo_cursor;
+        if (quantidade > 0)
+        {
+            buffer->versao++;
+        }
+    }
+
+    return quantidade;
 }
 
 /**
@@ -319,6 +947,7 @@ exibir_buffer (bufferTAD buffer)
     {
         celulaTAD tmp;
 
+        aplicar_pendentes(buffer);
         for (tmp = buffer->inicio->proximo; tmp != NULL; tmp = tmp->proximo)
         {
             printf(" %c", tmp->letra);
@@ -332,39 +961,127 @@ exibir_buffer (bufferTAD buffer)
     }
 }
 
+/**
+ * Procedimentos: iniciar_transacao, confirmar_transacao
+ * Uso: iniciar_transacao(buffer);
+ *      . . .
+ *      confirmar_transacao(buffer);
+ * -----------------------------------------------------
+ * A transação aberta fica em "transacao". Na confirmação, as edições
+ * pendentes são aplicadas por "aplicar_pendentes", e a transação passa a ser
+ * o registro para desfazer, junto com a versão do buffer naquele momento.
+ */
+
+void
+iniciar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+
+    if (buffer->transacao != NULL)
+    {
+        aninhar_transacao(buffer->transacao);
+    }
+    else
+    {
+        buffer->transacao = criar_transacao();
+    }
+}
+
+void
+confirmar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao == NULL)
+    {
+        fprintf(stderr, "Erro: nenhuma transação aberta.\n");
+        return;
+    }
+    else if (desaninhar_transacao(buffer->transacao))
+    {
+        return;
+    }
+
+    aplicar_pendentes(buffer);
+    liberar_transacao(&buffer->desfazer);
+    buffer->desfazer = buffer->transacao;
+    buffer->transacao = NULL;
+    buffer->versao_desfazer = buffer->versao;
+}
+
+/**
+ * Predicado: desfazer_transacao
+ * Uso: if (desfazer_transacao(buffer)) . . .
+ * ------------------------------------------
+ * A versão guardada na confirmação diz se o buffer foi alterado depois dela.
+ * As edições inversas são feitas com as operações comuns do buffer.
+ */
+
+bool
+desfazer_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: desfazer em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao != NULL || buffer->desfazer == NULL ||
+             buffer->versao != buffer->versao_desfazer)
+    {
+        return FALSE;
+    }
+
+    transacaoTAD desfazer = buffer->desfazer;
+    buffer->desfazer = NULL;
+    bool desfeita = reverter_transacao(desfazer, buffer);
+    liberar_transacao(&desfazer);
+    return desfeita;
+}
+
 /*** Definições de Subprogramas Privados ***/
 
 /**
  * Função: criar_celula
- * Uso: celulaTAD = criar_celula( );
- * ---------------------------------
- * Cria uma célula da lista encadeada e retorna um ponteiro para a célula. Em
- * caso de erro, retorna NULL.
+ * Uso: celulaTAD = criar_celula(buffer, altura);
+ * ----------------------------------------------
+ * Cria, com o alocador do buffer, uma célula da lista encadeada, com espaço
+ * para "altura" níveis do índice, e retorna um ponteiro para a célula. Em caso
+ * de erro, retorna NULL.
  */
 
 static celulaTAD
-criar_celula (void)
+criar_celula (bufferTAD buffer, int altura)
 {
-    celulaTAD temp = calloc(1, sizeof(struct celulaTCD));
+    size_t n = sizeof(struct celulaTCD) + altura * sizeof(nivelTCD);
+    celulaTAD temp = alocar(&buffer->alocador, n);
     if (temp == NULL)
     {
         fprintf(stderr, "Erro: impossível criar célular.\n");
         return NULL;
     }
+    memset(temp, 0, n);
+    temp->altura = altura;
 
     return temp;
 }
 
 /**
  * Procedimento: remover_celula
- * Uso: remover_celula(&celula);
- * -----------------------------
- * Recebe um ponteiro para uma celulaTAD e faz a liberação de memória dessa
- * célula. Se o ponteiro recebido for NULL, imprime uma mensagem em stderr.
+ * Uso: remover_celula(buffer, &celula);
+ * -------------------------------------
+ * Recebe um ponteiro para uma celulaTAD e devolve a célula ao alocador do
+ * buffer. Se o ponteiro recebido for NULL, imprime uma mensagem em stderr.
  */
 
 static void
-remover_celula (celulaTAD *celula)
+remover_celula (bufferTAD buffer, celulaTAD *celula)
 {
     if (celula == NULL || *celula == NULL)
     {
@@ -372,7 +1089,446 @@ remover_celula (celulaTAD *celula)
     }
     else
     {
-        free(*celula);
+        desalocar(&buffer->alocador, *celula, sizeof(struct celulaTCD) +
+                  (*celula)->altura * sizeof(nivelTCD));
         *celula = NULL;
     }
 }
+
+/**
+ * Procedimento: ligar_celula
+ * Uso: ligar_celula(buffer, c);
+ * -----------------------------
+ * Cria uma célula com o caractere 'c' e uma altura sorteada, liga a célula
+ * logo após o cursor e move o cursor para ela. Em cada nível do qual a nova
+ * célula faz parte, ela é ligada logo após a célula do dedo (herdando o
+ * restante do salto) e passa a ser o dedo; nos níveis acima, o salto da célula
+ * do dedo fica um caractere maior. Nenhuma busca é feita: o custo é constante,
+ * mais uma atualização por nível em uso.
+ */
+
+static void
+ligar_celula (bufferTAD buffer, char c)
+{
+    int altura = sortear_altura(buffer);
+    while (buffer->topo < altura)
+    {
+        int k = buffer->topo++;
+        buffer->inicio->niveis[k].salto = NULL;
+        buffer->inicio->niveis[k].distancia = buffer->tamanho + 1;
+        buffer->dedo[k] = buffer->inicio;
+        buffer->posdedo[k] = 0;
+    }
+
+    // 1: cria a nova célula e copia o caractere para ela:
+    celulaTAD pc = criar_celula(buffer, altura);
+    if (pc == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar célula.\n");
+        exit(1);
+    }
+    pc->letra = c;
+
+    // 2: liga a nova célula logo após o cursor, e move o cursor para ela:
+    pc->proximo = buffer->cursor->proximo;
+    buffer->cursor->proximo = pc;
+    buffer->cursor = pc;
+    buffer->tamanho++;
+    buffer->posicao++;
+
+    // 3: liga a nova célula aos seus níveis do índice e ajusta os demais:
+    for (int k = 0; k < buffer->topo; k++)
+    {
+        nivelTCD *nivel = &buffer->dedo[k]->niveis[k];
+        if (k < altura)
+        {
+            pc->niveis[k].salto = nivel->salto;
+            pc->niveis[k].distancia = buffer->posdedo[k] + nivel->distancia -
+                                      (buffer->posicao - 1);
+            nivel->salto = pc;
+            nivel->distancia = buffer->posicao - buffer->posdedo[k];
+            buffer->dedo[k] = pc;
+            buffer->posdedo[k] = buffer->posicao;
+        }
+        else
+        {
+            nivel->distancia++;
+        }
+    }
+}
+
+/**
+ * Procedimento: desligar_celula
+ * Uso: desligar_celula(buffer);
+ * -----------------------------
+ * Desliga e libera a célula seguinte ao cursor (que deve existir). Nos níveis
+ * do índice dos quais a célula removida faz parte, a célula anterior nesse
+ * nível (que é a célula do dedo) passa a saltar até a próxima; nos demais
+ * níveis, o salto da célula do dedo fica um caractere menor.
+ */
+
+static void
+desligar_celula (bufferTAD buffer)
+{
+    celulaTAD temp = buffer->cursor->proximo;
+    buffer->cursor->proximo = temp->proximo;
+    for (int k = 0; k < buffer->topo; k++)
+    {
+        nivelTCD *nivel = &buffer->dedo[k]->niveis[k];
+        if (k < temp->altura)
+        {
+            nivel->salto = temp->niveis[k].salto;
+            nivel->distancia += temp->niveis[k].distancia;
+        }
+        nivel->distancia--;
+    }
+    remover_celula(buffer, &temp);
+    buffer->tamanho--;
+}
+
+/**
+ * Função: localizar
+ * Uso: celula = localizar(buffer, posicao, dedo);
+ * -----------------------------------------------
+ * Retorna a célula que está na posição "posicao" (a dummy cell é a posição 0),
+ * que não pode ser maior do que o tamanho do buffer. A busca começa na dummy
+ * cell, no nível mais alto do índice, e em cada nível avança enquanto o salto
+ * não passar da posição; depois desce um nível. Se "dedo" for TRUE, as
+ * células em que a busca desceu de nível são guardadas como o novo dedo.
+ */
+
+static celulaTAD
+localizar (bufferTAD buffer, size_t posicao, bool dedo)
+{
+    celulaTAD temp = buffer->inicio;
+    size_t pos = 0;
+
+    for (int k = buffer->topo - 1; k >= 0; k--)
+    {
+        while (temp->niveis[k].salto != NULL &&
+               pos + temp->niveis[k].distancia <= posicao)
+        {
+            pos += temp->niveis[k].distancia;
+            temp = temp->niveis[k].salto;
+        }
+        if (dedo)
+        {
+            buffer->dedo[k] = temp;
+            buffer->posdedo[k] = pos;
+        }
+    }
+    while (pos < posicao)
+    {
+        temp = temp->proximo;
+        pos++;
+    }
+
+    return temp;
+}
+
+/**
+ * Função: sortear_altura
+ * Uso: altura = sortear_altura(buffer);
+ * -------------------------------------
+ * Sorteia a altura de uma nova célula: 0 com probabilidade 3/4, e cada nível a
+ * mais com probabilidade 1/4 do anterior, até NIVEIS. Usa um gerador xorshift
+ * próprio do buffer, para não interferir com rand( ). Com -Dsemindice a altura
+ * é sempre 0.
+ */
+
+static int
+sortear_altura (bufferTAD buffer)
+{
+#ifdef semindice
+    (void) buffer;
+    return 0;
+#else
+    uint32_t x = buffer->sorteio;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    buffer->sorteio = x;
+
+    int altura = 0;
+    while (altura < NIVEIS && (x & 3) == 0)
+    {
+        altura++;
+        x >>= 2;
+    }
+
+    return altura;
+#endif
+}
+
+/**
+ * Função: tabela_falhas
+ * Uso: falhas = tabela_falhas(padrao, n);
+ * ---------------------------------------
+ * Retorna a tabela de falhas de Knuth-Morris-Pratt do padrão: falhas[k] é o
+ * tamanho do maior prefixo de padrao[0..k] que também é sufixo de
+ * padrao[1..k]. Termina o programa se não houver memória.
+ */
+
+static size_t *
+tabela_falhas (const char *padrao, size_t n)
+{
+    size_t *falhas = malloc(n * sizeof(size_t));
+    if (falhas == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar tabela de busca.\n");
+        exit(1);
+    }
+
+    falhas[0] = 0;
+    for (size_t k = 1, j = 0; k < n; k++)
+    {
+        while (j > 0 && padrao[k] != padrao[j])
+        {
+            j = falhas[j - 1];
+        }
+        if (padrao[k] == padrao[j])
+        {
+            j++;
+        }
+        falhas[k] = j;
+    }
+
+    return falhas;
+}
+
+/**
+ * Procedimento: anexar
+ * Uso: anexar(buffer, simular, texto, n);
+ * ---------------------------------------
+ * Liga "n" células com os caracteres de "texto" no cursor, que está no final
+ * do buffer durante "substituir_tudo". Na simulação não faz nada.
+ */
+
+static void
+anexar (bufferTAD buffer, bool simular, const char *texto, size_t n)
+{
+    if (!simular)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            ligar_celula(buffer, texto[k]);
+        }
+    }
+}
+
+/**
+ * Funções: avancar_ate, recuar_ate
+ * Uso: p = avancar_ate(buffer, posicao, classe);
+ *      p = recuar_ate(buffer, posicao, classe);
+ * ----------------------------------------------
+ * "avancar_ate" retorna a posição do primeiro caractere da classe a partir de
+ * "posicao" (ou o tamanho do buffer, se não houver um), percorrendo a lista a
+ * partir da célula do cursor ou da célula localizada pelo índice;
+ * "recuar_ate" retorna a posição logo após o último caractere da classe antes
+ * de "posicao" (ou 0), copiando janelas cada vez maiores (até JANELA
+ * caracteres) para um array local e percorrendo-as de trás para frente.
+ */
+
+static size_t
+avancar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    if (posicao >= buffer->tamanho)
+    {
+        return buffer->tamanho;
+    }
+
+    celulaTAD temp = (posicao == buffer->posicao) ? buffer->cursor
+                                                  : localizar(buffer, posicao,
+                                                              FALSE);
+    for (temp = temp->proximo; temp != NULL; temp = temp->proximo, posicao++)
+    {
+        if (pertence(temp->letra, classe))
+        {
+            return posicao;
+        }
+    }
+
+    return posicao;
+}
+
+static size_t
+recuar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    char janela[JANELA];
+    size_t largura = 64;
+
+    while (posicao > 0)
+    {
+        size_t inicio = (posicao > largura) ? posicao - largura : 0;
+        celulaTAD temp = localizar(buffer, inicio, FALSE)->proximo;
+        for (size_t i = 0; i < posicao - inicio; i++, temp = temp->proximo)
+        {
+            janela[i] = temp->letra;
+        }
+        for (size_t i = posicao - inicio; i > 0; i--)
+        {
+            if (pertence(janela[i - 1], classe))
+            {
+                return inicio + i;
+            }
+        }
+        posicao = inicio;
+        if (largura < JANELA)
+        {
+            largura *= 2;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Predicado: pertence
+ * Uso: if (pertence(c, classe)) . . .
+ * -----------------------------------
+ * Retorna TRUE se o caractere "c" é da classe "classe". Os caracteres de
+ * palavra são testados por intervalos, sem consultar a localidade, para que os
+ * laços de busca fiquem simples o bastante para serem vetorizados.
+ */
+
+static bool
+pertence (char c, classeT classe)
+{
+    unsigned char u = (unsigned char) c;
+    bool palavra = (unsigned) ((u | 0x20) - 'a') < 26 ||
+                   (unsigned) (u - '0') < 10 || u == '_' || u >= 0x80;
+
+    switch (classe)
+    {
+    case QUEBRA: return c == '\n';
+    case TEXTO: return c != '\n';
+    case PALAVRA: return palavra;
+    default: return !palavra;
+    }
+}
+
+/**
+ * Predicado: registrar
+ * Uso: if (registrar(buffer, texto, n, apagar)) return;
+ * -----------------------------------------------------
+ * Se há uma transação aberta, registra nela a inserção dos "n" caracteres de
+ * "texto" ou a remoção de "apagar" caracteres após o cursor e retorna TRUE;
+ * senão, retorna FALSE, e a edição deve ser feita no buffer.
+ */
+
+static bool
+registrar (bufferTAD buffer, const char *texto, size_t n, size_t apagar)
+{
+    if (buffer->transacao == NULL)
+    {
+        return FALSE;
+    }
+
+    sincronizar_transacao(buffer->transacao, tamanho_buffer(buffer),
+                          posicao_cursor(buffer));
+    if (n > 0 ? !registrar_insercao(buffer->transacao, texto, n)
+              : !registrar_remocao(buffer->transacao, apagar))
+    {
+        fprintf(stderr, "Erro: impossível registrar a edição.\n");
+    }
+    return TRUE;
+}
+
+/**
+ * Predicado: mover_na_transacao
+ * Uso: if (mover_na_transacao(buffer, posicao)) return;
+ * -----------------------------------------------------
+ * Se há edições pendentes, move o cursor da transação e retorna TRUE; senão,
+ * retorna FALSE, e o cursor do buffer deve ser movido.
+ */
+
+static bool
+mover_na_transacao (bufferTAD buffer, size_t posicao)
+{
+    if (!transacao_pendente(buffer->transacao))
+    {
+        return FALSE;
+    }
+
+    mover_cursor_da_transacao(buffer->transacao, posicao);
+    return TRUE;
+}
+
+/**
+ * Procedimento: aplicar_pendentes
+ * Uso: aplicar_pendentes(buffer);
+ * -------------------------------
+ * Aplica as edições pendentes da transação, se houver, percorrendo a lista uma
+ * única vez, em ordem de posição. Em cada trecho, as células dos caracteres
+ * removidos que seriam substituídos por caracteres inseridos apenas recebem a
+ * letra nova, na mesma passada que copia o texto removido (para desfazer):
+ * só a diferença entre removidos e inseridos custa células desligadas ou
+ * ligadas, com as atualizações do índice. A transação é desligada do buffer
+ * durante a aplicação, para que as operações usadas aqui não sejam
+ * registradas de novo.
+ */
+
+static void
+aplicar_pendentes (bufferTAD buffer)
+{
+    transacaoTAD transacao = buffer->transacao;
+    if (!transacao_pendente(transacao))
+    {
+        return;
+    }
+
+    size_t n = quantidade_de_trechos(transacao), capacidade = 0;
+    size_t inseridos = 0, removidos = 0;
+    char *removido = NULL;
+
+    buffer->transacao = NULL;
+    for (size_t k = 0; k < n; k++)
+    {
+        trechoT t = trecho_da_transacao(transacao, k);
+        size_t posicao = t.inicio + inseridos - removidos;
+        size_t comuns = (t.removidos < t.inseridos) ? t.removidos : t.inseridos;
+
+        if (t.removidos > capacidade)
+        {
+            char *novo = realloc(removido, t.removidos);
+            if (novo != NULL)
+            {
+                removido = novo;
+                capacidade = t.removidos;
+            }
+        }
+        bool guardado = (t.removidos <= capacidade);
+
+        mover_cursor_para_posicao(buffer, posicao);
+        celulaTAD tmp = buffer->cursor;
+        for (size_t i = 0; i < t.removidos; i++)
+        {
+            tmp = tmp->proximo;
+            if (guardado)
+            {
+                removido[i] = tmp->letra;
+            }
+            if (i < comuns)
+            {
+                tmp->letra = t.texto[i];
+            }
+        }
+        guardar_para_desfazer(transacao, posicao, t.inseridos,
+                              guardado ? removido : NULL, t.removidos);
+
+        mover_cursor_para_posicao(buffer, posicao + comuns);
+        apagar_texto(buffer, t.removidos - comuns);
+        if (t.inseridos > comuns)
+        {
+            inserir_texto(buffer, t.texto + comuns, t.inseridos - comuns);
+        }
+        inseridos += t.inseridos;
+        removidos += t.removidos;
+    }
+    free(removido);
+
+    mover_cursor_para_posicao(buffer, cursor_da_transacao(transacao));
+    buffer->versao++;
+    buffer->transacao = transacao;
+    concluir_aplicacao(transacao);
+}
@@ -0,0 +1,389 @@
+/**
+ * Arquivo: medir_aplicador.c
+ * Versão : 1.0
+ * Data   : 2026-10-19 04:20
+ * -------------------------
+ * Este programa exercita e mede a interface aplicador.h: várias threads
+ * produtoras enviam edições ao mesmo buffer, ao mesmo tempo, e uma única
+ * thread aplicadora as aplica. Cada produtora simula uma pessoa digitando em
+ * um lugar do texto (inserções curtas seguidas, apagamentos para trás e para
+ * frente, de vez em quando um texto longo ou um salto para outra posição), de
+ * modo que a aplicadora tenha edições para juntar.
+ *
+ * Cada edição é guardada em um registro, na posição dada pelo seu número de
+ * sequência. Ao final o programa confere que:
+ *
+ *     - os números de sequência de cada produtora são crescentes e, juntos,
+ *       cobrem exatamente 1 . . . total, sem repetição;
+ *     - depois de cada "aguardar_edicao", "edicoes_aplicadas" já inclui a
+ *       edição esperada;
+ *     - o texto final é igual ao de aplicar, em um segundo buffer e sem
+ *       threads, as edições do registro uma a uma, em ordem de sequência.
+ *
+ * Também são impressos o tempo, a vazão e as métricas do aplicador (lotes,
+ * operações no buffer e esperas por fila cheia). As medidas só fazem sentido
+ * com "make MODO=producao"; as conferências valem em qualquer modo.
+ *
+ * Uso: medir_aplicador_arraybuff [produtoras] [edições por produtora]
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "aplicador.h"
+#include "buffer.h"
+#include "genlib.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTES: PRODUTORAS_PADRAO, EDICOES_PADRAO, MAX_PRODUTORAS
+ * -------------------------------------------------------------
+ * A quantidade de produtoras e de edições por produtora se nenhuma for
+ * informada, e a maior quantidade de produtoras aceita.
+ */
+
+#define PRODUTORAS_PADRAO 4
+#define EDICOES_PADRAO 100000
+#define MAX_PRODUTORAS 64
+
+/**
+ * CONSTANTES: CAPACIDADE, ESPERA, LONGO, SALTO, JANELA
+ * ----------------------------------------------------
+ * A capacidade da fila do aplicador (pequena, para que as produtoras também
+ * encontrem a fila cheia), de quantas em quantas edições cada produtora chama
+ * "aguardar_edicao", o tamanho dos textos longos (maiores do que os copiados
+ * dentro da entrada da fila), o alcance dos saltos de posição e o tamanho das
+ * janelas comparadas no final.
+ */
+
+#define CAPACIDADE 256
+#define ESPERA 1000
+#define LONGO 100
+#define SALTO 4096
+#define JANELA 4096
+
+/*** Tipos de Dados: ***/
+
+/**
+ * TIPO: edicaoT
+ * -------------
+ * Uma edição enviada, como foi guardada no registro: "enviada" diz se a
+ * posição do registro foi preenchida; "texto" aponta para os caracteres de
+ * uma inserção (que nunca mudam, veja a variável "letras").
+ */
+
+typedef struct
+{
+    bool enviada;
+    bool remocao;
+    size_t posicao;
+    size_t n;
+    const char *texto;
+} edicaoT;
+
+/**
+ * TIPO: produtoraT
+ * ----------------
+ * Os dados de uma thread produtora: o aplicador, o seu número, a semente dos
+ * números aleatórios, quantas edições enviar e quantos erros encontrou.
+ */
+
+typedef struct
+{
+    aplicadorTAD aplicador;
+    int numero;
+    unsigned int semente;
+    size_t edicoes;
+    int erros;
+} produtoraT;
+
+/*** Variáveis Globais: ***/
+
+/**
+ * VARIÁVEIS: registro, total
+ * --------------------------
+ * O registro das edições, indexado pelo número de sequência menos 1, e a
+ * quantidade total de edições (o tamanho do registro).
+ */
+
+static edicaoT *registro;
+static size_t total;
+
+/**
+ * VARIÁVEL: letras
+ * ----------------
+ * O texto das inserções: a produtora "k" insere "letras + k" (quantos
+ * caracteres forem necessários), de modo que o texto de cada produtora seja
+ * reconhecível no resultado.
+ */
+
+static char letras[MAX_PRODUTORAS + LONGO];
+
+/*** Declarações de Subprogramas: ***/
+
+static void *executar_produtora (void *arg);
+static void guardar (produtoraT *p, unsigned long long sequencia,
+                     bool remocao, size_t posicao, const char *texto,
+                     size_t n);
+static bool comparar (bufferTAD a, bufferTAD b);
+static double agora (void);
+
+/*** Função Main: ***/
+
+int main (int argc, char *argv[])
+{
+    int produtoras = (argc > 1) ? atoi(argv[1]) : PRODUTORAS_PADRAO;
+    long edicoes = (argc > 2) ? atol(argv[2]) : EDICOES_PADRAO;
+    if (produtoras < 1 || produtoras > MAX_PRODUTORAS)
+        produtoras = PRODUTORAS_PADRAO;
+    if (edicoes < 1)
+        edicoes = EDICOES_PADRAO;
+    total = (size_t) produtoras * (size_t) edicoes;
+
+    for (size_t i = 0; i < sizeof(letras); i++)
+        letras[i] = (char) ('a' + i % 26);
+
+    bufferTAD buffer = criar_buffer();
+    bufferTAD serial = criar_buffer();
+    registro = calloc(total, sizeof(edicaoT));
+    produtoraT dados[MAX_PRODUTORAS];
+    pthread_t threads[MAX_PRODUTORAS];
+    if (buffer == NULL || serial == NULL || registro == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar os buffers.\n");
+        exit(1);
+    }
+    aplicadorTAD aplicador = iniciar_aplicador(buffer, CAPACIDADE);
+    if (aplicador == NULL)
+        exit(1);
+
+    printf("%d produtoras, %zu edições, fila de %d entradas\n", produtoras,
+           total, CAPACIDADE);
+
+    double t = agora();
+    for (int k = 0; k < produtoras; k++)
+    {
+        dados[k] = (produtoraT) {aplicador, k, 12345u + 977u * (unsigned) k,
+                                 (size_t) edicoes, 0};
+        if (pthread_create(&threads[k], NULL, executar_produtora,
+                           &dados[k]) != 0)
+        {
+            fprintf(stderr, "Erro: impossível criar a produtora %d.\n", k);
+            exit(1);
+        }
+    }
+    int erros = 0;
+    for (int k = 0; k < produtoras; k++)
+    {
+        pthread_join(threads[k], NULL);
+        erros += dados[k].erros;
+    }
+    aguardar_edicao(aplicador, total);
+    double s = (agora() - t) / 1e9;
+
+    metricas_aplicadorT m;
+    obter_metricas_aplicador(aplicador, &m);
+    encerrar_aplicador(&aplicador);
+
+    printf("%-14s %10.3f s %10.0f edições/s\n", "aplicação", s,
+           (double) total / s);
+    printf("%-14s %llu enviadas, %llu aplicadas, %llu lotes, %llu operações "
+           "(%.1f edições por operação), %llu esperas\n", "métricas",
+           m.enviadas, m.aplicadas, m.lotes, m.operacoes,
+           m.operacoes > 0 ? (double) m.aplicadas / (double) m.operacoes : 0.0,
+           m.esperas);
+    if (m.enviadas != total || m.aplicadas != total)
+    {
+        fprintf(stderr, "Erro: as métricas não contam %zu edições.\n", total);
+        erros++;
+    }
+
+    for (size_t i = 0; i < total; i++)
+    {
+        edicaoT *e = &registro[i];
+        if (!e->enviada)
+        {
+            fprintf(stderr, "Erro: nenhuma edição com a sequência %zu.\n",
+                    i + 1);
+            erros++;
+            continue;
+        }
+        mover_cursor_para_posicao(serial, e->posicao);
+        if (e->remocao)
+            apagar_texto(serial, e->n);
+        else
+            inserir_texto(serial, e->texto, e->n);
+    }
+    bool iguais = comparar(buffer, serial);
+    printf("%-14s %zu caracteres, %s\n", "reaplicação", tamanho_buffer(buffer),
+           iguais ? "texto igual" : "TEXTO DIFERENTE");
+    erros += !iguais;
+
+    printf("%-14s %d\n", "erros", erros);
+    free(registro);
+    liberar_buffer(&serial);
+    liberar_buffer(&buffer);
+    return erros == 0 ? 0 : 1;
+}
+
+/*** Definições de Subprogramas: ***/
+
+/**
+ * Função: executar_produtora
+ * Uso: pthread_create(&thread, NULL, executar_produtora, &produtora);
+ * -------------------------------------------------------------------
+ * Corpo de uma produtora: envia as edições em torno de uma posição própria,
+ * que anda com a digitação (e às vezes salta para outro lugar antes de uma
+ * inserção), guarda cada uma no registro e, a cada ESPERA
+ * edições, espera a última ser aplicada e confere "edicoes_aplicadas".
+ */
+
+static void *executar_produtora (void *arg)
+{
+    produtoraT *p = arg;
+    const char *texto = letras + p->numero;
+    size_t posicao = (size_t) rand_r(&p->semente) % SALTO;
+    unsigned long long anterior = 0, sequencia;
+
+    for (size_t i = 0; i < p->edicoes; i++)
+    {
+        int sorteio = rand_r(&p->semente) % 100;
+        if (sorteio >= 95)
+            posicao = (size_t) rand_r(&p->semente) % SALTO;
+        if (sorteio < 60 || sorteio >= 95)
+        {
+            size_t n = 1 + (size_t) rand_r(&p->semente) % 3;
+            sequencia = enviar_insercao(p->aplicador, posicao, texto, n);
+            guardar(p, sequencia, FALSE, posicao, texto, n);
+            posicao += n;
+        }
+        else if (sorteio < 61)
+        {
+            sequencia = enviar_insercao(p->aplicador, posicao, texto, LONGO);
+            guardar(p, sequencia, FALSE, posicao, texto, LONGO);
+            posicao += LONGO;
+        }
+        else if (sorteio < 80)
+        {
+            posicao -= (posicao > 0);
+            sequencia = enviar_remocao(p->aplicador, posicao, 1);
+            guardar(p, sequencia, TRUE, posicao, NULL, 1);
+        }
+        else
+        {
+            size_t n = 1 + (size_t) rand_r(&p->semente) % 2;
+            sequencia = enviar_remocao(p->aplicador, posicao, n);
+            guardar(p, sequencia, TRUE, posicao, NULL, n);
+        }
+
+        if (sequencia <= anterior)
+        {
+            fprintf(stderr, "Erro: a produtora %d recebeu a sequência %llu "
+                    "depois de %llu.\n", p->numero, sequencia, anterior);
+            p->erros++;
+        }
+        anterior = sequencia;
+
+        if (i % ESPERA == ESPERA - 1)
+        {
+            aguardar_edicao(p->aplicador, sequencia);
+            if (edicoes_aplicadas(p->aplicador) < sequencia)
+            {
+                fprintf(stderr, "Erro: a edição %llu não estava aplicada "
+                        "depois de aguardar_edicao.\n", sequencia);
+                p->erros++;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Procedimento: guardar
+ * Uso: guardar(p, sequencia, remocao, posicao, texto, n);
+ * -------------------------------------------------------
+ * Guarda a edição no registro, na posição do seu número de sequência, ou
+ * conta um erro se o número estiver fora de 1 . . . total.
+ */
+
+static void guardar (produtoraT *p, unsigned long long sequencia,
+                     bool remocao, size_t posicao, const char *texto,
+                     size_t n)
+{
+    if (sequencia == 0 || sequencia > total)
+    {
+        fprintf(stderr, "Erro: sequência %llu inválida.\n", sequencia);
+        p->erros++;
+        return;
+    }
+
+    registro[sequencia - 1] = (edicaoT) {TRUE, remocao, posicao, n, texto};
+}
+
+/**
+ * Predicado: comparar
+ * Uso: if (comparar(a, b)) . . .
+ * ------------------------------
+ * Retorna TRUE se os dois buffers têm o mesmo texto, comparando janelas de
+ * JANELA caracteres; imprime a posição da primeira diferença, se houver uma.
+ */
+
+static bool comparar (bufferTAD a, bufferTAD b)
+{
+    char ja[JANELA], jb[JANELA];
+    size_t tamanho = tamanho_buffer(a);
+
+    if (tamanho != tamanho_buffer(b))
+    {
+        fprintf(stderr, "Erro: %zu caracteres em vez de %zu.\n", tamanho,
+                tamanho_buffer(b));
+        return FALSE;
+    }
+    for (size_t i = 0; i < tamanho; i += JANELA)
+    {
+        size_t n = copiar_texto(a, i, JANELA, ja);
+        copiar_texto(b, i, JANELA, jb);
+        if (memcmp(ja, jb, n) != 0)
+        {
+            size_t k = 0;
+            while (ja[k] == jb[k])
+                k++;
+            fprintf(stderr, "Erro: os textos diferem na posição %zu.\n",
+                    i + k);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * Função: agora
+ * Uso: t = agora();
+ * -----------------
+ * Retorna o tempo do relógio monotônico, em nanossegundos.
+ */
+
+static double agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec * 1e9 + (double) t.tv_nsec;
+}
@@ -0,0 +1,196 @@
+/**
+ * Arquivo: medir_grande.c
+ * Versão : 1.0
+ * Data   : 2026-10-19 02:20
+ * -------------------------
+ * Este programa mede o desempenho de uma implementação de buffer.h com textos
+ * muito grandes (por padrão, 5 GB: acima de INT_MAX e de 4 GB), para verificar
+ * que tamanhos e posições são tratados como size_t de ponta a ponta e para
+ * medir o efeito das páginas enormes nas varreduras do texto inteiro:
+ *
+ *     preenchimento   inserir o texto no final, em pedaços de PEDACO bytes
+ *     varredura       copiar o texto inteiro com copiar_texto, em janelas de
+ *                     PEDACO bytes (como uma busca ou um salvamento)
+ *     verificação     copiar janelas pequenas em posições acima de 4 GB (e em
+ *                     cada gigabyte) e conferir o conteúdo
+ *     inserção        inserir um caractere no início do texto
+ *
+ * O caractere na posição "p" do texto é sempre 'a' + p % 26, de modo que
+ * qualquer janela pode ser conferida sem guardar uma cópia do texto.
+ *
+ * A Makefile compila um programa para cada implementação com texto contíguo
+ * ou em blocos: medir_grande_arraybuff (arraybuff.c) e medir_grande_blocobuff
+ * (blocobuff.c). As medidas só fazem sentido com "make MODO=producao", e a
+ * máquina precisa de memória suficiente para o texto.
+ *
+ * Uso: medir_grande_<implementação> [gigabytes]
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTES: PEDACO, JANELA, GIGABYTE, GIGABYTES_PADRAO
+ * ------------------------------------------------------
+ * O tamanho dos pedaços inseridos e das janelas da varredura, o tamanho das
+ * janelas conferidas na verificação, um gigabyte e o tamanho do texto, em
+ * gigabytes, se nenhum for informado.
+ */
+
+#define PEDACO ((size_t) 1 << 20)
+#define JANELA 64
+#define GIGABYTE ((size_t) 1 << 30)
+#define GIGABYTES_PADRAO 5.0
+
+/*** Variáveis Globais: ***/
+
+/**
+ * Variável: soma
+ * --------------
+ * Acumula os caracteres lidos, para que o compilador não elimine as leituras.
+ */
+
+static volatile unsigned long soma;
+
+/*** Declarações de Subprogramas: ***/
+
+static bool conferir (bufferTAD buffer, size_t posicao);
+static double agora (void);
+
+/*** Função Main: ***/
+
+int main (int argc, char *argv[])
+{
+    double gigabytes = (argc > 1) ? strtod(argv[1], NULL) : GIGABYTES_PADRAO;
+    if (gigabytes <= 0)
+        gigabytes = GIGABYTES_PADRAO;
+    size_t total = (size_t) (gigabytes * (double) GIGABYTE);
+
+    bufferTAD buffer = criar_buffer();
+    char *pedaco = malloc(PEDACO + 26);
+    if (buffer == NULL || pedaco == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar o buffer.\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < PEDACO + 26; i++)
+        pedaco[i] = (char) ('a' + i % 26);
+
+    printf("texto de %zu bytes (%.2f GB)\n", total,
+           (double) total / (double) GIGABYTE);
+
+    double t = agora();
+    for (size_t p = 0; p < total; p += PEDACO)
+    {
+        size_t n = (total - p < PEDACO) ? total - p : PEDACO;
+        inserir_texto(buffer, pedaco + p % 26, n);
+        if (tamanho_buffer(buffer) != p + n)
+        {
+            fprintf(stderr, "Erro: o buffer parou em %zu bytes.\n",
+                    tamanho_buffer(buffer));
+            exit(1);
+        }
+    }
+    double s = (agora() - t) / 1e9;
+    printf("%-14s %10.3f s %10.2f GB/s\n", "preenchimento", s,
+           (double) total / (double) GIGABYTE / s);
+
+    unsigned long acumulado = 0;
+    t = agora();
+    for (size_t p = 0; p < total; p += PEDACO)
+    {
+        size_t n = copiar_texto(buffer, p, PEDACO, pedaco);
+        for (size_t i = 0; i < n; i += 4096)
+            acumulado += (unsigned char) pedaco[i];
+    }
+    s = (agora() - t) / 1e9;
+    soma += acumulado;
+    printf("%-14s %10.3f s %10.2f GB/s\n", "varredura", s,
+           (double) total / (double) GIGABYTE / s);
+
+    int erros = 0, conferidas = 0;
+    for (size_t p = GIGABYTE; p < total; p += GIGABYTE)
+    {
+        erros += !conferir(buffer, p - 1);
+        erros += !conferir(buffer, p);
+        conferidas += 2;
+    }
+    erros += !conferir(buffer, total - JANELA);
+    conferidas++;
+    printf("%-14s %d janelas, %d erros\n", "verificação", conferidas, erros);
+
+    mover_cursor_para_inicio(buffer);
+    t = agora();
+    inserir_caractere(buffer, 'z');
+    s = (agora() - t) / 1e9;
+    printf("%-14s %10.3f s\n", "inserção", s);
+    if (tamanho_buffer(buffer) != total + 1)
+        erros++;
+
+    free(pedaco);
+    liberar_buffer(&buffer);
+    return erros == 0 ? 0 : 1;
+}
+
+/*** Definições de Subprogramas: ***/
+
+/**
+ * Predicado: conferir
+ * Uso: if (conferir(buffer, posicao)) . . .
+ * -----------------------------------------
+ * Copia JANELA caracteres a partir de "posicao" e retorna TRUE se todos forem
+ * os esperados; imprime a posição do primeiro erro, se houver um.
+ */
+
+static bool conferir (bufferTAD buffer, size_t posicao)
+{
+    char janela[JANELA];
+    size_t n = copiar_texto(buffer, posicao, JANELA, janela);
+
+    for (size_t i = 0; i < n; i++)
+        if (janela[i] != (char) ('a' + (posicao + i) % 26))
+        {
+            fprintf(stderr, "Erro: caractere errado na posição %zu.\n",
+                    posicao + i);
+            return FALSE;
+        }
+    if (n == 0 && posicao < tamanho_buffer(buffer))
+    {
+        fprintf(stderr, "Erro: nada copiado da posição %zu.\n", posicao);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * Função: agora
+ * Uso: t = agora();
+ * -----------------
+ * Retorna o tempo do relógio monotônico, em nanossegundos.
+ */
+
+static double agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec * 1e9 + (double) t.tv_nsec;
+}
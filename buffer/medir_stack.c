@@ -0,0 +1,245 @@
+/**
+ * Arquivo: medir_stack.c
+ * Versão : 1.0
+ * Data   : 2026-10-19 01:20
+ * -------------------------
+ * Este programa mede o desempenho de uma implementação do stackTAD nas
+ * operações das quais o stackbuff depende, para que a representação usada
+ * pelo meu_editor_stackbuff seja escolhida com base em medições:
+ *
+ *     push + pop      encher e esvaziar o stack, um elemento por vez
+ *     ver_elemento    percorrer o stack da base ao topo (como copiar_texto)
+ *     transferência   passar todos os elementos para outro stack e de volta,
+ *                     com pop e push (como mover o cursor no stackbuff)
+ *
+ * Cada medida é feita com as operações verificadas de stackTAD.h e com as
+ * operações rápidas de stackrapido.h, e o resultado é o tempo médio, em
+ * nanossegundos, por elemento. Os stacks têm ELEMENTOS elementos, que cabem
+ * no stack de tamanho fixo; nas implementações dinâmicas as medidas são
+ * repetidas com GRANDE elementos.
+ *
+ * A Makefile compila um programa para cada implementação: medir_stack_fixo
+ * (stackTAD.c), medir_stack_dinamico (stackTAD2.c) e medir_stack_blocos
+ * (stackTAD3.c). As medidas só fazem sentido com "make MODO=producao".
+ *
+ * Uso: medir_stack_<representação> [ciclos]
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "genlib.h"
+#include "stackrapido.h"
+#include "stackTAD.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTES: ELEMENTOS, GRANDE, CICLOS_PADRAO, REPRESENTACAO
+ * -----------------------------------------------------------
+ * A quantidade de elementos dos stacks nas medidas comuns e nas medidas com
+ * stacks grandes, a quantidade de ciclos se nenhuma for informada e o nome da
+ * representação medida.
+ */
+
+#define ELEMENTOS 1000
+#define GRANDE 1000000
+#define CICLOS_PADRAO 10000
+
+#if defined(stack_dinamico)
+#define REPRESENTACAO "dinâmico (stackTAD2.c)"
+#elif defined(stack_blocos)
+#define REPRESENTACAO "blocos de 4 KB (stackTAD3.c)"
+#else
+#define REPRESENTACAO "array fixo (stackTAD.c)"
+#endif
+
+/*** Tipos de Dados: ***/
+
+/**
+ * Tipo: medidaT
+ * -------------
+ * Os tempos médios, em nanossegundos por elemento, de cada medida.
+ */
+
+typedef struct
+{
+    double push_pop;
+    double ver;
+    double transferencia;
+} medidaT;
+
+/*** Variáveis Globais: ***/
+
+/**
+ * Variável: soma
+ * --------------
+ * Acumula os elementos lidos, para que o compilador não elimine as leituras.
+ */
+
+static volatile unsigned long soma;
+
+/*** Declarações de Subprogramas: ***/
+
+static void medir (int n, long ciclos, bool rapido, medidaT *medida);
+static double agora (void);
+static void imprimir (string nome, const medidaT *m);
+
+/*** Função Main: ***/
+
+int main (int argc, char *argv[])
+{
+    long ciclos = (argc > 1) ? strtol(argv[1], NULL, 10) : CICLOS_PADRAO;
+    if (ciclos <= 0)
+        ciclos = CICLOS_PADRAO;
+
+    medidaT verificada;
+    printf("stackTAD: %s, %d elementos, %ld ciclos\n", REPRESENTACAO,
+           ELEMENTOS, ciclos);
+    printf("%-26s %14s %14s %14s\n", "(ns por elemento)", "push + pop",
+           "ver_elemento", "transferência");
+
+    medir(ELEMENTOS, ciclos, FALSE, &verificada);
+    imprimir("verificadas", &verificada);
+#if !defined(stack_dinamico) && !defined(stack_blocos)
+    medidaT rapida;
+    medir(ELEMENTOS, ciclos, TRUE, &rapida);
+    imprimir("rápidas (stackrapido.h)", &rapida);
+#endif
+
+    stackTAD teste = criar_stackTAD();
+    if (teste != NULL && tamanho(teste) == 0)
+    {
+        long grandes = ciclos * ELEMENTOS / GRANDE;
+        medir(GRANDE, grandes > 0 ? grandes : 1, FALSE, &verificada);
+        printf("com %d elementos:\n", GRANDE);
+        imprimir("verificadas", &verificada);
+    }
+    remover_stackTAD(&teste);
+
+    return 0;
+}
+
+/*** Definições de Subprogramas: ***/
+
+/**
+ * Procedimento: medir
+ * Uso: medir(n, ciclos, rapido, &medida);
+ * ---------------------------------------
+ * Faz as três medidas com stacks de "n" elementos, repetindo cada uma
+ * "ciclos" vezes, com as operações verificadas ou com as rápidas.
+ */
+
+static void medir (int n, long ciclos, bool rapido, medidaT *medida)
+{
+    stackTAD a = criar_stackTAD();
+    stackTAD b = criar_stackTAD();
+    if (a == NULL || b == NULL)
+        exit(1);
+
+    double elementos = (double) n * (double) ciclos;
+    unsigned long s = 0;
+    double t;
+    long c;
+    int i;
+
+    t = agora();
+    for (c = 0; c < ciclos; c++)
+    {
+        if (rapido)
+        {
+            for (i = 0; i < n; i++)
+                push_rapido(a, (elementoT) ('a' + i % 26));
+            while (!vazia_rapida(a))
+                s += (unsigned char) pop_rapido(a);
+        }
+        else
+        {
+            for (i = 0; i < n; i++)
+                push(a, (elementoT) ('a' + i % 26));
+            while (!vazia(a))
+                s += (unsigned char) pop(a);
+        }
+    }
+    medida->push_pop = (agora() - t) / elementos;
+
+    for (i = 0; i < n; i++)
+        push(a, (elementoT) ('a' + i % 26));
+
+    t = agora();
+    for (c = 0; c < ciclos; c++)
+    {
+        if (rapido)
+            for (size_t p = 0, q = qtd_rapida(a); p < q; p++)
+                s += (unsigned char) ver_rapido(a, p);
+        else
+            for (i = 0; i < n; i++)
+                s += (unsigned char) ver_elemento(a, i);
+    }
+    medida->ver = (agora() - t) / elementos;
+
+    t = agora();
+    for (c = 0; c < ciclos; c++)
+    {
+        if (rapido)
+        {
+            while (!vazia_rapida(a))
+                push_rapido(b, pop_rapido(a));
+            while (!vazia_rapida(b))
+                push_rapido(a, pop_rapido(b));
+        }
+        else
+        {
+            while (!vazia(a))
+                push(b, pop(a));
+            while (!vazia(b))
+                push(a, pop(b));
+        }
+    }
+    medida->transferencia = (agora() - t) / (2 * elementos);
+
+    soma += s;
+    remover_stackTAD(&a);
+    remover_stackTAD(&b);
+}
+
+/**
+ * Função: agora
+ * Uso: t = agora();
+ * -----------------
+ * Retorna o tempo do relógio monotônico, em nanossegundos.
+ */
+
+static double agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec * 1e9 + (double) t.tv_nsec;
+}
+
+/**
+ * Procedimento: imprimir
+ * Uso: imprimir(nome, &medida);
+ * -----------------------------
+ * Imprime uma linha da tabela de resultados.
+ */
+
+static void imprimir (string nome, const medidaT *m)
+{
+    printf("%-26s %14.2f %14.2f %14.2f\n", nome, m->push_pop, m->ver,
+           m->transferencia);
+}
@@ -1,11 +1,60 @@
 /**
  * Arquivo: meu_editor.c
- * Versão : 1.0
- * Data   : 2024-10-18 23:22
+ * Versão : 1.20
+ * Data   : 2026-10-19 05:00
  * -------------------------
  * Este programa implementa um editor simples de buffers, utilizado para testar
  * a abstração bufferTAD. O editor lê e executa comandos simples informados pelo
- * usuário.
+ * usuário. Quando compilado com -Dblocobuff ou -Darraybuff, o editor também
+ * oferece comandos para as extensões definidas em blocobuff.h ou arraybuff.h.
+ *
+ * Se o editor for executado com o nome de uma sessão (meu_editor <sessão>),
+ * cada comando que altera o buffer é registrado no diário "<sessão>.diario"
+ * antes de ser executado, e o comando 'S' salva o buffer em "<sessão>.salvo".
+ * Ao iniciar, o editor recupera a sessão a partir desses dois arquivos, de
+ * modo que nada se perde se o programa terminar de forma inesperada. Durante a
+ * sessão o buffer também é salvo automaticamente, em segundo plano, no arquivo
+ * "<sessão>.auto".
+ *
+ * Quando compilado com -Drastreamento (make RASTREIO=sim), o editor oferece
+ * também um comando para ligar o rastreador de eventos de rastreador.h e
+ * gravar os eventos registrados.
+ *
+ * O editor mede, para cada comando, quanto tempo se passa entre a leitura da
+ * linha e o fim da exibição do buffer, separando a preparação do comando (o
+ * registro no diário), a execução do comando e a exibição. As medidas são
+ * acumuladas em histogramas por letra de comando, e os percentis p50, p99 e
+ * p99.9 são exibidos pelo comando 'P' e, ao sair, na saída de erros. A espera
+ * pelo usuário dentro de GetLine não é medida.
+ *
+ * Com o comando 'V' o buffer passa a ser exibido pela interface tela.h, que
+ * mantém o texto na parte de cima do terminal e redesenha apenas o que mudou
+ * após cada comando, em vez de reexibir o buffer inteiro. Com o comando 'W'
+ * apenas uma janela de linhas e colunas em volta do cursor é exibida, tanto
+ * na tela quanto no formato normal, de modo que exibir o buffer custa o mesmo
+ * qualquer que seja o seu tamanho.
+ *
+ * O comando 'R' substitui todas as ocorrências de um texto por outro, com uma
+ * única passagem pelo buffer, ou apenas conta as ocorrências. Com -Dblocobuff,
+ * os comandos 'C', 'X' e 'Y' copiam, recortam e colam trechos guardados em um
+ * anel, sem copiar o texto, e os comandos 'N' e 'O' gravam e abrem
+ * instantâneos binários do buffer; o comando 'U' limita a memória do buffer,
+ * que despeja os blocos frios em disco acima do limite (veja blocobuff.h); o
+ * comando '=' compara o buffer com um instantâneo e exibe as edições entre os
+ * dois.
+ * Com -Darraybuff, o comando 'G' publica o buffer em memória compartilhada,
+ * para que outros processos (como o meu_visor) o acompanhem sem cópias (veja
+ * visor.h).
+ *
+ * Os comandos '>' e '<', '^' e '$', '}' e '{' movem o cursor por palavras,
+ * até o início ou o final da linha e por parágrafos, como no vi, com uma
+ * única operação do buffer em vez de um 'F' ou 'B' por caractere.
+ *
+ * Os comandos '[' e ']' abrem e confirmam uma transação (veja buffer.h): as
+ * edições entre eles são aplicadas ao buffer de uma só vez, na confirmação, e
+ * o comando '~' desfaz a última transação confirmada. Enquanto há uma
+ * transação aberta, o buffer não é exibido nem salvo automaticamente (o que
+ * aplicaria as edições pendentes); apenas o tamanho e o cursor são exibidos.
  *
  * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
  *             Capítulo 9: Efficiency and ADTs (pg. 379-380).
@@ -22,29 +71,258 @@
 
 /*** Includes: ***/
 
+#define _POSIX_C_SOURCE 200809L
+
+#include "alocador.h"
+#include "autosalvamento.h"
 #include "buffer.h"
+#include "carregador.h"
 #include <ctype.h>
+#include "diario.h"
 #include "genlib.h"
+#include "histograma.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "simpio.h"
+#include "tela.h"
+#include <time.h>
+#ifdef rastreamento
+#include "rastreador.h"
+#endif
+#ifdef blocobuff
+#include "blocobuff.h"
+#include <inttypes.h>
+#endif
+#ifdef arraybuff
+#include "arraybuff.h"
+#include <sys/mman.h>
+#endif
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTE: INTERVALO_DIARIO
+ * ---------------------------
+ * Intervalo, em milissegundos, entre as sincronizações do diário da sessão com
+ * o disco.
+ */
+
+#define INTERVALO_DIARIO 50
+
+/**
+ * CONSTANTE: INTERVALO_AUTOSALVAMENTO
+ * -----------------------------------
+ * Intervalo mínimo, em milissegundos, entre dois salvamentos automáticos.
+ */
+
+#define INTERVALO_AUTOSALVAMENTO 2000
+
+/**
+ * CONSTANTE: EVENTOS_RASTREADOS
+ * -----------------------------
+ * Capacidade, em eventos, do anel de rastreamento de cada thread.
+ */
+
+#define EVENTOS_RASTREADOS 65536
+
+/**
+ * CONSTANTE: CAPACIDADE_ANEL
+ * --------------------------
+ * Quantidade de trechos copiados ou recortados guardados pelo editor.
+ */
+
+#define CAPACIDADE_ANEL 16
+
+/**
+ * CONSTANTE: EDICOES
+ * ------------------
+ * Quantidade máxima de edições exibidas pelo comando '='.
+ */
+
+#define EDICOES 8
+
+/**
+ * CONSTANTE: LIMITE_REGIAO
+ * ------------------------
+ * Limite, em caracteres, do buffer publicado pelo comando 'G' quando nenhum
+ * limite é informado (64 MiB).
+ */
+
+#define LIMITE_REGIAO (64u << 20)
+
+/**
+ * CONSTANTES: FASES, COMANDOS
+ * ---------------------------
+ * Quantidade de fases medidas em cada comando (preparação, execução, exibição
+ * e o total das três) e de grupos de comandos: um por letra, mais um para
+ * todos os outros caracteres.
+ */
+
+#define FASES 4
+#define COMANDOS 27
+
+/*** Variáveis Globais: ***/
+
+/**
+ * VARIÁVEIS: diario, arq_checkpoint, autosalvamento
+ * -------------------------------------------------
+ * O diário da sessão, o nome do arquivo onde o buffer é salvo e o salvamento
+ * automático. Ficam NULL se o editor for executado sem o nome de uma sessão.
+ */
+
+static diarioTAD diario = NULL;
+static string arq_checkpoint = NULL;
+static autosalvamentoTAD autosalvamento = NULL;
+
+/**
+ * VARIÁVEL: tela
+ * --------------
+ * A tela usada para o redesenho diferencial, ou NULL se o buffer é exibido
+ * por "exibir_buffer".
+ */
+
+static telaTAD tela = NULL;
+
+/**
+ * VARIÁVEIS: janela_linhas, janela_colunas
+ * ----------------------------------------
+ * O tamanho da janela exibida em volta do cursor, definido pelo comando 'W'.
+ * Sem tela, se "janela_linhas" for 0 o buffer inteiro é exibido; com tela, um
+ * valor 0 usa todo o terminal.
+ */
+
+static int janela_linhas = 0;
+static int janela_colunas = 0;
+
+/**
+ * VARIÁVEL: transacoes
+ * --------------------
+ * Quantidade de transações abertas pelo comando '[' e ainda não confirmadas
+ * pelo comando ']'.
+ */
+
+static int transacoes = 0;
+
+/**
+ * VARIÁVEL: latencias
+ * -------------------
+ * Os histogramas das latências, em nanossegundos, de cada fase de cada grupo
+ * de comandos, criados na primeira medida do grupo.
+ */
+
+static histogramaTAD latencias[COMANDOS][FASES];
+
+#ifdef blocobuff
+/**
+ * VARIÁVEL: anel
+ * --------------
+ * O anel dos trechos copiados e recortados, criado no primeiro 'C' ou 'X'.
+ */
+
+static anelTAD anel = NULL;
+#endif
+
+#ifdef arraybuff
+/**
+ * VARIÁVEL: regiao
+ * ----------------
+ * O nome da região onde o buffer foi publicado pelo comando 'G', ou NULL.
+ */
+
+static string regiao = NULL;
+#endif
+
+/**
+ * CONSTANTE: NOMES_FASES
+ * ----------------------
+ * O nome de cada fase, como aparece no relatório de latências (já completado
+ * com espaços, pois os acentos ocupam mais de um byte e atrapalhariam o
+ * alinhamento feito por printf).
+ */
+
+static const char *const NOMES_FASES[FASES] =
+{
+    "preparação  ", "execução    ", "exibição    ", "total       "
+};
 
 /*** Declarações de Subprogramas: ***/
 
 static void executar_comando (bufferTAD buffer, string linha);
+static bool altera_buffer (string linha);
+static void iniciar_sessao (bufferTAD buffer, string sessao);
+static void encerrar_sessao (void);
+static void salvar (bufferTAD buffer);
+static void exibir_autosalvamento (void);
+static void alternar_tela (void);
+static void definir_janela (string argumento);
+static void substituir (bufferTAD buffer, string argumento);
+static void restaurar_terminal (void);
+static void carregar (bufferTAD buffer, string nome);
+static void controlar_transacao (bufferTAD buffer, char comando);
 static void ajuda (void);
+static uint64_t agora (void);
+static void medir_latencias (char comando, const uint64_t instantes[]);
+static void exibir_latencias (FILE *saida);
+static void relatar_latencias (void);
+#ifdef rastreamento
+static void rastrear (string argumento);
+#endif
+#ifdef blocobuff
+static void verificar_alteracoes (bufferTAD buffer);
+static void comprimir_frios (bufferTAD buffer, string argumento);
+static void mapear (bufferTAD buffer, string nome);
+static void copiar (bufferTAD buffer, string argumento, bool recortar);
+static void colar (bufferTAD buffer, string argumento);
+static void gravar (bufferTAD buffer, string nome);
+static void abrir (bufferTAD buffer, string nome);
+static void limitar (bufferTAD buffer, string argumento);
+static void comparar (bufferTAD buffer, string nome);
+#endif
+#ifdef arraybuff
+static void publicar (bufferTAD buffer, string argumento);
+static void remover_regiao (void);
+#endif
 
 /*** Função Main: ***/
 
-int main (void)
+int main (int argc, char *argv[])
 {
-    bufferTAD buffer = criar_buffer();
+    // O buffer fica em uma arena própria, liberada de uma só vez no final:
+    alocadorT arena;
+    bufferTAD buffer = criar_arena(&arena) ? criar_buffer_com_alocador(&arena)
+                                           : criar_buffer();
+    uint64_t instantes[FASES];
+
+    if (argc > 1)
+        iniciar_sessao(buffer, argv[1]);
+    atexit(relatar_latencias);
+    atexit(restaurar_terminal);
 
     while (TRUE)
     {
         printf("*");
-        executar_comando(buffer, GetLine());
-        exibir_buffer(buffer);
+        string linha = GetLine();
+        instantes[0] = agora();
+        if (diario != NULL && altera_buffer(linha))
+            registrar_no_diario(diario, linha);
+        instantes[1] = agora();
+        executar_comando(buffer, linha);
+        if (autosalvamento != NULL && transacoes == 0)
+            autosalvar(autosalvamento, buffer);
+        instantes[2] = agora();
+        if (transacoes > 0)
+            printf("(transação aberta: %zu caracteres, cursor em %zu)\n",
+                   tamanho_buffer(buffer), posicao_cursor(buffer));
+        else if (tela != NULL)
+            desenhar_buffer(tela, buffer);
+        else if (janela_linhas > 0)
+            exibir_janela(buffer, janela_linhas, janela_colunas);
+        else
+            exibir_buffer(buffer);
+        instantes[3] = agora();
+        medir_latencias(linha[0], instantes);
     }
 
     liberar_buffer(&buffer);
@@ -69,16 +347,664 @@ static void executar_comando (bufferTAD buffer, string linha)
             inserir_caractere(buffer, linha[i]);
         break;
     case 'D': apagar_caractere(buffer); break;
+    case 'R': substituir(buffer, linha + 1); break;
     case 'F': mover_cursor_para_frente(buffer); break;
     case 'B': mover_cursor_para_tras(buffer); break;
     case 'J': mover_cursor_para_inicio(buffer); break;
     case 'E': mover_cursor_para_final(buffer); break;
+    case '>': mover_cursor_para_proxima_palavra(buffer); break;
+    case '<': mover_cursor_para_palavra_anterior(buffer); break;
+    case '^': mover_cursor_para_inicio_da_linha(buffer); break;
+    case '$': mover_cursor_para_final_da_linha(buffer); break;
+    case '}': mover_cursor_para_proximo_paragrafo(buffer); break;
+    case '{': mover_cursor_para_paragrafo_anterior(buffer); break;
+    case '[': case ']': case '~': controlar_transacao(buffer, linha[0]); break;
+    case 'L': carregar(buffer, linha + 1); break;
+    case 'S': salvar(buffer); break;
+    case 'A': exibir_autosalvamento(); break;
+    case 'P': exibir_latencias(stdout); break;
+    case 'V': alternar_tela(); break;
+    case 'W': definir_janela(linha + 1); break;
+#ifdef rastreamento
+    case 'T': rastrear(linha + 1); break;
+#endif
+#ifdef blocobuff
+    case 'K': verificar_alteracoes(buffer); break;
+    case 'Z': comprimir_frios(buffer, linha + 1); break;
+    case 'M': mapear(buffer, linha + 1); break;
+    case 'C': copiar(buffer, linha + 1, FALSE); break;
+    case 'X': copiar(buffer, linha + 1, TRUE); break;
+    case 'Y': colar(buffer, linha + 1); break;
+    case 'N': gravar(buffer, linha + 1); break;
+    case 'O': abrir(buffer, linha + 1); break;
+    case 'U': limitar(buffer, linha + 1); break;
+    case '=': comparar(buffer, linha + 1); break;
+#endif
+#ifdef arraybuff
+    case 'G': publicar(buffer, linha + 1); break;
+#endif
     case 'H': ajuda(); break;
     case 'Q': exit(0); break;
     default: printf("Comando inválido.\n"); break;
     }
 }
 
+/**
+ * Predicado: altera_buffer
+ * Uso: if (altera_buffer(linha)) . . .
+ * ------------------------------------
+ * Retorna TRUE se o comando da linha altera o conteúdo do buffer ou a posição
+ * do cursor, ou seja, se ele precisa ser registrado no diário. A contagem
+ * feita por "R?" não altera nada.
+ */
+
+static bool altera_buffer (string linha)
+{
+    if (toupper(linha[0]) == 'R' && linha[1] == '?')
+        return FALSE;
+
+    return linha[0] != '\0' &&
+           strchr("IDFBJELMORCXY<>^${}[]~", toupper(linha[0])) != NULL;
+}
+
+/**
+ * Procedimento: iniciar_sessao
+ * Uso: iniciar_sessao(buffer, sessao);
+ * ------------------------------------
+ * Recupera a sessão "sessao" no buffer, reaplicando os registros do diário com
+ * "executar_comando", abre o diário para os próximos comandos e inicia o
+ * salvamento automático. O diário é fechado (e os registros pendentes
+ * gravados) quando o programa termina. Se a sessão não puder ser recuperada,
+ * ou o diário não puder ser aberto, o editor termina, em vez de continuar sem
+ * registrar os comandos.
+ */
+
+static void iniciar_sessao (bufferTAD buffer, string sessao)
+{
+    char *arq_diario = malloc(strlen(sessao) + 8);
+    char *arq_auto = malloc(strlen(sessao) + 6);
+    arq_checkpoint = malloc(strlen(sessao) + 7);
+    if (arq_diario == NULL || arq_auto == NULL || arq_checkpoint == NULL)
+    {
+        fprintf(stderr, "Erro: impossível iniciar a sessão.\n");
+        exit(1);
+    }
+    sprintf(arq_diario, "%s.diario", sessao);
+    sprintf(arq_checkpoint, "%s.salvo", sessao);
+    sprintf(arq_auto, "%s.auto", sessao);
+
+    unsigned long geracao;
+    if (!recuperar_sessao(buffer, arq_checkpoint, arq_diario,
+                          executar_comando, &geracao))
+    {
+        fprintf(stderr, "Erro: impossível recuperar a sessão \"%s\"; os "
+                "arquivos foram mantidos.\n", sessao);
+        exit(1);
+    }
+    diario = abrir_diario(arq_diario, geracao, INTERVALO_DIARIO);
+    if (diario == NULL)
+        exit(1);
+    autosalvamento = iniciar_autosalvamento(arq_auto,
+                                            INTERVALO_AUTOSALVAMENTO);
+    free(arq_diario);
+    free(arq_auto);
+    atexit(encerrar_sessao);
+}
+
+/**
+ * Procedimento: encerrar_sessao
+ * Uso: atexit(encerrar_sessao);
+ * -----------------------------
+ * Grava os registros pendentes e fecha o diário da sessão, e espera o
+ * salvamento automático em andamento. Avisa se o diário falhou, já que os
+ * últimos comandos então só estão no buffer.
+ */
+
+static void encerrar_sessao (void)
+{
+    if (!sincronizar_diario(diario))
+        fprintf(stderr, "Erro: o diário da sessão falhou; os comandos "
+                "desde a falha não foram gravados.\n");
+    fechar_diario(&diario);
+    encerrar_autosalvamento(&autosalvamento);
+}
+
+/**
+ * Procedimento: salvar
+ * Uso: salvar(buffer);
+ * --------------------
+ * Salva o buffer no arquivo da sessão, o que também reinicia o diário.
+ */
+
+static void salvar (bufferTAD buffer)
+{
+    if (diario == NULL)
+        printf("Nenhuma sessão informada ao iniciar o editor.\n");
+    else if (salvar_checkpoint(buffer, diario, arq_checkpoint))
+        printf("Buffer salvo em \"%s\".\n", arq_checkpoint);
+}
+
+/**
+ * Procedimento: exibir_autosalvamento
+ * Uso: exibir_autosalvamento( );
+ * ------------------------------
+ * Exibe as métricas do salvamento automático da sessão.
+ */
+
+static void exibir_autosalvamento (void)
+{
+    metricas_autosalvamentoT m;
+
+    if (autosalvamento == NULL)
+    {
+        printf("Nenhuma sessão informada ao iniciar o editor.\n");
+        return;
+    }
+
+    obter_metricas_autosalvamento(autosalvamento, &m);
+    printf("Salvamentos: %lu (%llu bytes), ignorados: %lu, adiados: %lu, "
+           "falhas: %lu\n", m.salvamentos, m.bytes, m.ignorados, m.adiados,
+           m.falhas);
+    printf("Latência (ms): última %.3f, máxima %.3f, média %.3f; "
+           "captura %.3f\n", m.latencia_ultima, m.latencia_maxima,
+           m.salvamentos > 0 ? m.latencia_total / m.salvamentos : 0.0,
+           m.captura_ultima);
+}
+
+/**
+ * Procedimento: alternar_tela
+ * Uso: alternar_tela( );
+ * ----------------------
+ * Liga o redesenho diferencial (criando a tela) ou o desliga, exibindo quantos
+ * bytes foram enviados ao terminal enquanto esteve ligado.
+ */
+
+static void alternar_tela (void)
+{
+    metricas_telaT m;
+
+    if (tela == NULL)
+    {
+        tela = criar_tela(stdout);
+        if (tela != NULL)
+        {
+            configurar_janela(tela, janela_linhas, janela_colunas);
+            printf("Redesenho diferencial ligado.\n");
+        }
+        return;
+    }
+
+    obter_metricas_tela(tela, &m);
+    liberar_tela(&tela);
+    printf("Redesenho diferencial desligado: %lu desenhos, %llu bytes "
+           "(último: %zu).\n", m.desenhos, m.bytes, m.bytes_ultimo);
+}
+
+/**
+ * Procedimento: definir_janela
+ * Uso: definir_janela(argumento);
+ * -------------------------------
+ * Lê do argumento a quantidade de linhas e, opcionalmente, de colunas da
+ * janela exibida em volta do cursor (sem argumento, volta a exibir tudo).
+ */
+
+static void definir_janela (string argumento)
+{
+    char *resto;
+
+    janela_linhas = (int) strtol(argumento, &resto, 10);
+    janela_colunas = (int) strtol(resto, NULL, 10);
+    if (janela_linhas < 0)
+        janela_linhas = 0;
+    if (janela_colunas < 0)
+        janela_colunas = 0;
+
+    if (tela != NULL)
+        configurar_janela(tela, janela_linhas, janela_colunas);
+    if (janela_linhas > 0)
+        printf("Janela de %d linhas e %d colunas.\n", janela_linhas,
+               janela_colunas);
+    else
+        printf("Exibindo o buffer inteiro.\n");
+}
+
+/**
+ * Procedimento: substituir
+ * Uso: substituir(buffer, argumento);
+ * -----------------------------------
+ * Executa o comando 'R'. O argumento é "/padrão/novo", onde a barra pode ser
+ * qualquer caractere que não apareça nos dois textos, e a barra final é
+ * opcional; com "?/padrão" as ocorrências são apenas contadas.
+ */
+
+static void substituir (bufferTAD buffer, string argumento)
+{
+    bool simular = (argumento[0] == '?');
+    if (simular)
+        argumento++;
+
+    char separador = argumento[0];
+    if (separador == '\0')
+    {
+        printf("Uso: R/padrão/novo ou R?/padrão\n");
+        return;
+    }
+
+    const char *padrao = argumento + 1;
+    const char *fim = strchr(padrao, separador);
+    size_t np = (fim != NULL) ? (size_t) (fim - padrao) : strlen(padrao);
+    const char *novo = (fim != NULL) ? fim + 1 : "";
+    fim = strchr(novo, separador);
+    size_t nn = (fim != NULL) ? (size_t) (fim - novo) : strlen(novo);
+
+    size_t n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+    if (simular)
+        printf("%zu ocorrência(s).\n", n);
+    else
+        printf("%zu substituição(ões).\n", n);
+}
+
+/**
+ * Procedimento: restaurar_terminal
+ * Uso: atexit(restaurar_terminal);
+ * --------------------------------
+ * Devolve o terminal ao estado normal, se o redesenho diferencial estiver
+ * ligado ao sair.
+ */
+
+static void restaurar_terminal (void)
+{
+    liberar_tela(&tela);
+}
+
+/**
+ * Procedimento: carregar
+ * Uso: carregar(buffer, nome);
+ * ----------------------------
+ * Carrega o arquivo "nome" na posição do cursor, ignorando os espaços antes do
+ * nome, e informa quantos bytes e linhas foram carregados.
+ */
+
+static void carregar (bufferTAD buffer, string nome)
+{
+    resumo_cargaT resumo;
+
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    if (carregar_arquivo(buffer, nome, 0, &resumo))
+        printf("%zu bytes, %zu linhas carregados%s.\n", resumo.bytes,
+               resumo.linhas, resumo.utf8_valido ? "" : " (UTF-8 inválido)");
+}
+
+/**
+ * Procedimento: controlar_transacao
+ * Uso: controlar_transacao(buffer, comando);
+ * ------------------------------------------
+ * Executa os comandos '[' (abre uma transação), ']' (confirma a transação
+ * aberta) e '~' (desfaz a última transação confirmada), mantendo a contagem
+ * das transações abertas.
+ */
+
+static void controlar_transacao (bufferTAD buffer, char comando)
+{
+    if (comando == '[')
+    {
+        iniciar_transacao(buffer);
+        transacoes++;
+    }
+    else if (comando == ']')
+    {
+        if (transacoes == 0)
+        {
+            printf("Nenhuma transação aberta.\n");
+            return;
+        }
+        confirmar_transacao(buffer);
+        transacoes--;
+    }
+    else if (transacoes > 0)
+        printf("Confirme a transação aberta antes de desfazer.\n");
+    else if (!desfazer_transacao(buffer))
+        printf("Nada a desfazer.\n");
+}
+
+#ifdef rastreamento
+/**
+ * Procedimento: rastrear
+ * Uso: rastrear(argumento);
+ * -------------------------
+ * Sem argumento, liga ou desliga o rastreamento. Com "C" ou "P" seguido do
+ * nome de um arquivo, grava nesse arquivo os eventos registrados até agora,
+ * no formato do Chrome ou do perf script. O rastreamento fica desligado
+ * durante a gravação.
+ */
+
+static void rastrear (string argumento)
+{
+    char formato = toupper(argumento[0]);
+    if (formato == '\0')
+    {
+        if (rastreamento_ativo)
+            desligar_rastreamento();
+        else
+            ligar_rastreamento(EVENTOS_RASTREADOS);
+        printf("Rastreamento %s.\n", rastreamento_ativo ? "ligado"
+                                                        : "desligado");
+        return;
+    }
+    else if (formato != 'C' && formato != 'P')
+    {
+        printf("Comando inválido.\n");
+        return;
+    }
+
+    string nome = argumento + 1;
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    int ativo = rastreamento_ativo;
+    desligar_rastreamento();
+    long n = gravar_rastreamento(nome, formato == 'C' ? RASTRO_CHROME
+                                                      : RASTRO_PERF);
+    if (n >= 0)
+        printf("%ld eventos gravados em \"%s\".\n", n, nome);
+    if (ativo)
+        ligar_rastreamento(EVENTOS_RASTREADOS);
+}
+#endif
+
+#ifdef blocobuff
+/**
+ * Procedimento: verificar_alteracoes
+ * Uso: verificar_alteracoes(buffer);
+ * ----------------------------------
+ * Exibe o hash do buffer e as regiões alteradas desde a última vez em que este
+ * comando foi executado.
+ */
+
+static void verificar_alteracoes (bufferTAD buffer)
+{
+    static assinaturaTAD anterior = NULL;
+    regiaoT regioes[8];
+
+    printf("Hash: %016" PRIx64 "\n", hash_buffer(buffer));
+    if (anterior != NULL && buffer_alterado(buffer, anterior))
+    {
+        size_t n = regioes_alteradas(buffer, anterior, regioes, 8);
+        for (size_t i = 0; i < n && i < 8; i++)
+            printf("  alterado: %zu caracteres a partir de %zu\n",
+                   regioes[i].tamanho, regioes[i].inicio);
+        if (n > 8)
+            printf("  . . . e mais %zu regiões\n", n - 8);
+    }
+    else if (anterior != NULL)
+        printf("  sem alterações\n");
+
+    liberar_assinatura(&anterior);
+    anterior = assinar_buffer(buffer);
+}
+
+/**
+ * Procedimento: comprimir_frios
+ * Uso: comprimir_frios(buffer, argumento);
+ * ----------------------------------------
+ * Se "argumento" contém um número, configura a janela da compressão dos
+ * blocos frios; em seguida exibe a taxa de compressão e a latência que as
+ * descompressões acrescentaram aos movimentos do cursor.
+ */
+
+static void comprimir_frios (bufferTAD buffer, string argumento)
+{
+    metricas_compressaoT m;
+
+    while (isspace((unsigned char) *argumento))
+        argumento++;
+    if (*argumento != '\0')
+        configurar_compressao(buffer, strtoul(argumento, NULL, 10));
+
+    obter_metricas_compressao(buffer, &m);
+    printf("Blocos comprimidos: %zu (%zu -> %zu bytes, taxa %.2f)\n",
+           m.comprimidos, m.bytes_originais, m.bytes_comprimidos,
+           m.bytes_comprimidos > 0 ?
+           (double) m.bytes_originais / m.bytes_comprimidos : 1.0);
+    printf("Compressões: %lu, descompressões: %lu, leituras: %lu\n",
+           m.compressoes, m.descompressoes, m.leituras);
+    printf("Latência das descompressões (ms): total %.3f, máxima %.3f, "
+           "média %.3f\n", m.latencia_total, m.latencia_maxima,
+           m.descompressoes > 0 ? m.latencia_total / m.descompressoes : 0.0);
+}
+
+/**
+ * Procedimento: mapear
+ * Uso: mapear(buffer, nome);
+ * --------------------------
+ * Abre o arquivo "nome" no buffer em modo mapeado.
+ */
+
+static void mapear (bufferTAD buffer, string nome)
+{
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    if (mapear_arquivo(buffer, nome))
+        printf("%zu bytes mapeados.\n", tamanho_buffer(buffer));
+}
+
+/**
+ * Procedimento: copiar
+ * Uso: copiar(buffer, argumento, recortar);
+ * -----------------------------------------
+ * Copia (ou recorta) a quantidade de caracteres informada no argumento, a
+ * partir do cursor, e guarda o trecho no anel.
+ */
+
+static void copiar (bufferTAD buffer, string argumento, bool recortar)
+{
+    if (anel == NULL && (anel = criar_anel(CAPACIDADE_ANEL)) == NULL)
+        return;
+
+    size_t n = strtoul(argumento, NULL, 10);
+    trechoTAD trecho = recortar ? recortar_trecho(buffer, n) :
+                                  copiar_trecho(buffer, n);
+    if (trecho == NULL)
+        return;
+
+    printf("%zu caracteres %s (%d no anel).\n", tamanho_trecho(trecho),
+           recortar ? "recortados" : "copiados", quantidade_no_anel(anel) + 1);
+    guardar_no_anel(anel, trecho);
+}
+
+/**
+ * Procedimento: colar
+ * Uso: colar(buffer, argumento);
+ * ------------------------------
+ * Cola no cursor o trecho do anel indicado no argumento (0, ou nada, para o
+ * mais recente).
+ */
+
+static void colar (bufferTAD buffer, string argumento)
+{
+    int k = (int) strtol(argumento, NULL, 10);
+    trechoTAD trecho = (anel != NULL) ? trecho_do_anel(anel, k) : NULL;
+
+    if (trecho == NULL)
+        printf("Não há trecho %d no anel.\n", k);
+    else
+        colar_trecho(buffer, trecho);
+}
+
+/**
+ * Procedimento: gravar
+ * Uso: gravar(buffer, nome);
+ * --------------------------
+ * Grava um instantâneo do buffer no arquivo "nome".
+ */
+
+static void gravar (bufferTAD buffer, string nome)
+{
+    resumo_instantaneoT resumo;
+
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    if (gravar_instantaneo(buffer, nome, &resumo))
+        printf("Instantâneo gravado: %zu blocos, %zu linhas.\n",
+               resumo.blocos, resumo.linhas);
+}
+
+/**
+ * Procedimento: abrir
+ * Uso: abrir(buffer, nome);
+ * -------------------------
+ * Abre no buffer o instantâneo gravado no arquivo "nome".
+ */
+
+static void abrir (bufferTAD buffer, string nome)
+{
+    resumo_instantaneoT resumo;
+
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    if (abrir_instantaneo(buffer, nome, &resumo))
+        printf("%zu bytes, %zu linhas em %zu blocos (hash %016" PRIx64 ").\n",
+               tamanho_buffer(buffer), resumo.linhas, resumo.blocos,
+               resumo.hash);
+}
+
+/**
+ * Procedimento: limitar
+ * Uso: limitar(buffer, argumento);
+ * --------------------------------
+ * Se "argumento" contém um número, limita a esse número de kilobytes a
+ * memória dos blocos do buffer (0 remove o limite); em seguida exibe as
+ * métricas do despejo.
+ */
+
+static void limitar (bufferTAD buffer, string argumento)
+{
+    metricas_despejoT m;
+
+    while (isspace((unsigned char) *argumento))
+        argumento++;
+    if (*argumento != '\0')
+        limitar_memoria(buffer, strtoul(argumento, NULL, 10) * 1024);
+
+    obter_metricas_despejo(buffer, &m);
+    printf("Memória dos blocos: %zu KiB (processo: %zu KiB)\n",
+           m.residentes / 1024, m.processo / 1024);
+    printf("Despejados: %zu blocos; despejos: %lu, recargas: %lu, "
+           "leituras: %lu\n", m.despejados, m.despejos, m.recargas,
+           m.leituras);
+}
+
+/**
+ * Procedimento: comparar
+ * Uso: comparar(buffer, nome);
+ * ----------------------------
+ * Abre o instantâneo gravado no arquivo "nome" em um buffer temporário,
+ * compara-o com o buffer e exibe as métricas da comparação e as primeiras
+ * EDICOES edições que transformam o instantâneo no buffer.
+ */
+
+static void comparar (bufferTAD buffer, string nome)
+{
+    while (isspace((unsigned char) *nome))
+        nome++;
+
+    bufferTAD antigo = criar_buffer();
+    if (antigo == NULL)
+        return;
+    if (!abrir_instantaneo(antigo, nome, NULL))
+    {
+        liberar_buffer(&antigo);
+        return;
+    }
+
+    diferencaTAD diferenca = comparar_buffers(antigo, buffer);
+    if (diferenca != NULL)
+    {
+        metricas_diferencaT m;
+        size_t n = quantidade_de_edicoes(diferenca);
+
+        obter_metricas_diferenca(diferenca, &m);
+        printf("%zu edições; blocos iguais: %zu, janelas: %zu, caracteres "
+               "lidos: %zu\n", n, m.iguais, m.janelas, m.lidos);
+        for (size_t k = 0; k < n && k < EDICOES; k++)
+        {
+            edicaoT e = edicao_da_diferenca(diferenca, k);
+            printf("  -%zu +%zu em %zu (%zu no buffer)\n", e.removidos,
+                   e.inseridos, e.antiga, e.nova);
+        }
+        if (n > EDICOES)
+            printf("  e mais %zu.\n", n - EDICOES);
+        liberar_diferenca(&diferenca);
+    }
+    liberar_buffer(&antigo);
+}
+#endif
+
+#ifdef arraybuff
+/**
+ * Procedimento: publicar
+ * Uso: publicar(buffer, argumento);
+ * ---------------------------------
+ * Publica o buffer na região cujo nome é informado no argumento, seguido
+ * opcionalmente pelo limite do texto. A região é removida ao sair do editor.
+ */
+
+static void publicar (bufferTAD buffer, string argumento)
+{
+    char nome[256];
+    unsigned long limite = LIMITE_REGIAO;
+
+    if (regiao != NULL)
+    {
+        printf("O buffer já está publicado em \"%s\".\n", regiao);
+        return;
+    }
+    if (sscanf(argumento, " %255s %lu", nome, &limite) < 1 || nome[0] != '/')
+    {
+        printf("Uso: G /nome [limite]\n");
+        return;
+    }
+
+    regiao = malloc(strlen(nome) + 1);
+    if (regiao == NULL)
+    {
+        fprintf(stderr, "Erro: impossível publicar o buffer.\n");
+        exit(1);
+    }
+    strcpy(regiao, nome);
+
+    if (!compartilhar_buffer(buffer, nome, limite))
+    {
+        free(regiao);
+        regiao = NULL;
+    }
+    else
+    {
+        atexit(remover_regiao);
+        printf("Buffer publicado em \"%s\" (limite de %lu caracteres).\n",
+               nome, limite);
+    }
+}
+
+/**
+ * Procedimento: remover_regiao
+ * Uso: atexit(remover_regiao);
+ * ----------------------------
+ * Remove a região publicada, pois o editor sai sem liberar o buffer. Os
+ * visores que já a mapearam continuam com o último estado do buffer.
+ */
+
+static void remover_regiao (void)
+{
+    shm_unlink(regiao);
+}
+#endif
+
 /**
  * Procedimento: ajuda
  * Uso: ajuda( );
@@ -94,7 +1020,142 @@ static void ajuda (void)
     printf("  B       Move o cursor 1 caractere para trás.\n");
     printf("  J       Move o cursor para o início do buffer.\n");
     printf("  E       Move o cursor para o final do buffer.\n");
+    printf("  > <     Move o cursor para a próxima palavra ou a anterior.\n");
+    printf("  ^ $     Move o cursor para o início ou o final da linha.\n");
+    printf("  } {     Move o cursor para o próximo parágrafo ou o anterior.\n");
+    printf("  [ ]     Abre e confirma uma transação: as edições entre os dois\n"
+           "          comandos são aplicadas ao buffer de uma só vez.\n");
+    printf("  ~       Desfaz a última transação confirmada, se o buffer não\n"
+           "          mudou depois dela.\n");
+    printf("  L...    Carrega o arquivo informado após a letra \'L\'.\n");
+    printf("  S       Salva o buffer no arquivo da sessão.\n");
+    printf("  A       Exibe as métricas do salvamento automático.\n");
+    printf("  P       Exibe as latências dos comandos (p50, p99, p99.9).\n");
+    printf("  V       Liga ou desliga o redesenho diferencial do buffer.\n");
+    printf("  W l c   Exibe só uma janela de \'l\' linhas e \'c\' colunas em\n"
+           "          volta do cursor (\'W\' sozinho exibe o buffer todo).\n");
+#ifdef rastreamento
+    printf("  T       Liga ou desliga o rastreamento das operações.\n");
+    printf("  TC...   Grava os eventos no formato do Chrome no arquivo\n"
+           "          informado após \'TC\' (TP...: formato do perf script).\n");
+#endif
     printf("  D       Apaga o próximo caractere.\n");
+    printf("  R/a/b   Substitui todas as ocorrências de \'a\' por \'b\'\n"
+           "          (R?/a apenas conta as ocorrências).\n");
+#ifdef blocobuff
+    printf("  K       Exibe o hash e as regiões alteradas desde o último K.\n");
+    printf("  Z...    Comprime os blocos fora da janela informada após a letra\n"
+           "          \'Z\' (0 desliga) e exibe as métricas da compressão.\n");
+    printf("  M...    Abre, sem ler, o arquivo informado após a letra \'M\'\n"
+           "          (o buffer precisa estar vazio).\n");
+    printf("  C n     Copia os \'n\' caracteres após o cursor para o anel.\n");
+    printf("  X n     Recorta os \'n\' caracteres após o cursor para o anel.\n");
+    printf("  Y k     Cola o k-ésimo trecho mais recente do anel (Y: o último).\n");
+    printf("  N...    Grava um instantâneo do buffer no arquivo informado após\n"
+           "          a letra \'N\'.\n");
+    printf("  O...    Abre o instantâneo informado após a letra \'O\' (o buffer\n"
+           "          precisa estar vazio).\n");
+    printf("  U...    Limita a memória do buffer aos kilobytes informados após\n"
+           "          a letra \'U\' (0 remove o limite) e exibe o despejo.\n");
+    printf("  =...    Compara o buffer com o instantâneo informado após o \'=\'\n"
+           "          e exibe as edições.\n");
+#endif
+#ifdef arraybuff
+    printf("  G /n l  Publica o buffer na memória compartilhada \'/n\', com\n"
+           "          até \'l\' caracteres, para o meu_visor.\n");
+#endif
     printf("  H       Exibe esta ajuda.\n");
     printf("  Q       Sai do programa.\n");
 }
+
+/**
+ * Função: agora
+ * Uso: t = agora( );
+ * ------------------
+ * Retorna o instante atual do relógio monotônico, em nanossegundos.
+ */
+
+static uint64_t agora (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+/**
+ * Procedimento: medir_latencias
+ * Uso: medir_latencias(comando, instantes);
+ * -----------------------------------------
+ * Registra nos histogramas do grupo do comando a duração de cada fase, dados
+ * os instantes em que a preparação, a execução e a exibição começaram e o
+ * instante em que a exibição terminou.
+ */
+
+static void medir_latencias (char comando, const uint64_t instantes[])
+{
+    int c = toupper((unsigned char) comando);
+    int grupo = c >= 'A' && c <= 'Z' ? c - 'A' : COMANDOS - 1;
+
+    if (latencias[grupo][FASES - 1] == NULL)
+        for (int f = 0; f < FASES; f++)
+            if (latencias[grupo][f] == NULL &&
+                (latencias[grupo][f] = criar_histograma()) == NULL)
+                return;
+
+    for (int f = 0; f < FASES - 1; f++)
+        registrar_valor(latencias[grupo][f], instantes[f + 1] - instantes[f]);
+    registrar_valor(latencias[grupo][FASES - 1], instantes[FASES - 1] -
+                                                 instantes[0]);
+}
+
+/**
+ * Procedimento: exibir_latencias
+ * Uso: exibir_latencias(saida);
+ * -----------------------------
+ * Exibe em "saida", para cada grupo de comandos já executado, a quantidade de
+ * execuções e os percentis p50, p99 e p99.9 de cada fase, em microssegundos.
+ */
+
+static void exibir_latencias (FILE *saida)
+{
+    fprintf(saida, "Cmd Fase         Amostras        p50        p99      "
+            "p99.9 (us)\n");
+    for (int g = 0; g < COMANDOS; g++)
+    {
+        if (latencias[g][FASES - 1] == NULL)
+            continue;
+        for (int f = 0; f < FASES; f++)
+        {
+            histogramaTAD h = latencias[g][f];
+            fprintf(saida, "%-3c %s%9llu %10.3f %10.3f %10.3f\n",
+                    f > 0 ? ' ' : g < COMANDOS - 1 ? 'A' + g : '?',
+                    NOMES_FASES[f],
+                    (unsigned long long) quantidade_valores(h),
+                    percentil(h, 50.0) / 1000.0, percentil(h, 99.0) / 1000.0,
+                    percentil(h, 99.9) / 1000.0);
+        }
+    }
+}
+
+/**
+ * Procedimento: relatar_latencias
+ * Uso: atexit(relatar_latencias);
+ * -------------------------------
+ * Ao sair, exibe as latências na saída de erros (se algum comando foi medido)
+ * e libera os histogramas.
+ */
+
+static void relatar_latencias (void)
+{
+    bool medido = FALSE;
+
+    for (int g = 0; g < COMANDOS; g++)
+        medido = medido || latencias[g][FASES - 1] != NULL;
+    if (medido)
+        exibir_latencias(stderr);
+
+    for (int g = 0; g < COMANDOS; g++)
+        for (int f = 0; f < FASES; f++)
+            liberar_histograma(&latencias[g][f]);
+}
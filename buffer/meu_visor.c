@@ -0,0 +1,168 @@
+/**
+ * Arquivo: meu_visor.c
+ * Versão : 1.0
+ * Data   : 2026-10-18 22:50
+ * -------------------------
+ * Este programa acompanha, de outro processo, um buffer publicado pelo
+ * meu_editor com o comando 'G' (veja visor.h). A cada intervalo o programa
+ * obtém uma vista do buffer e, se a versão mudou, conta as linhas e calcula a
+ * linha e a coluna do cursor lendo o texto diretamente da memória
+ * compartilhada, sem copiá-lo. Se o editor alterar o buffer durante a
+ * contagem, a vista é descartada e a contagem refeita.
+ *
+ * Uso: meu_visor /nome [intervalo_ms]
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "genlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "visor.h"
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTE: INTERVALO_PADRAO
+ * ---------------------------
+ * Intervalo, em milissegundos, entre duas consultas ao buffer, se nenhum for
+ * informado.
+ */
+
+#define INTERVALO_PADRAO 200
+
+/*** Tipos de Dados: ***/
+
+/**
+ * Tipo: resumoT
+ * -------------
+ * O que o programa calcula a partir de uma vista: a quantidade de linhas e a
+ * linha e a coluna do cursor (a partir de 1).
+ */
+
+typedef struct
+{
+    size_t linhas;
+    size_t linha_cursor;
+    size_t coluna_cursor;
+} resumoT;
+
+/*** Declarações de Subprogramas: ***/
+
+static void resumir (const vistaT *vista, resumoT *resumo);
+static void esperar (long milissegundos);
+
+/*** Função Main: ***/
+
+int main (int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Uso: %s /nome [intervalo_ms]\n", argv[0]);
+        return 1;
+    }
+    long intervalo = (argc > 2) ? strtol(argv[2], NULL, 10) : INTERVALO_PADRAO;
+    if (intervalo <= 0)
+        intervalo = INTERVALO_PADRAO;
+
+    visorTAD visor = abrir_visor(argv[1]);
+    if (visor == NULL)
+        return 1;
+
+    unsigned long ultima = 0;
+    bool primeira = TRUE;
+    unsigned long descartadas = 0;
+    vistaT vista;
+    resumoT resumo;
+
+    while (TRUE)
+    {
+        obter_vista(visor, &vista);
+        if (primeira || vista.versao != ultima)
+        {
+            resumir(&vista, &resumo);
+            if (!vista_valida(visor, &vista))
+            {
+                descartadas++;
+                continue;
+            }
+            printf("versão %lu: %zu caracteres, %zu linhas, cursor em "
+                   "%zu:%zu (vistas descartadas: %lu)\n", vista.versao,
+                   vista.tamanho, resumo.linhas, resumo.linha_cursor,
+                   resumo.coluna_cursor, descartadas);
+            fflush(stdout);
+            ultima = vista.versao;
+            primeira = FALSE;
+        }
+        esperar(intervalo);
+    }
+
+    fechar_visor(&visor);
+    return 0;
+}
+
+/*** Definições de Subprogramas: ***/
+
+/**
+ * Procedimento: resumir
+ * Uso: resumir(&vista, &resumo);
+ * ------------------------------
+ * Conta as linhas do texto da vista e a posição do cursor com memchr, direto
+ * na região compartilhada. O resultado só vale se a vista continuar válida.
+ */
+
+static void resumir (const vistaT *vista, resumoT *resumo)
+{
+    const char *texto = vista->texto;
+    size_t cursor = (vista->cursor <= vista->tamanho) ? vista->cursor
+                                                      : vista->tamanho;
+    size_t quebras = 0, inicio_linha = 0;
+    const char *p = texto, *fim = texto + cursor;
+    const char *q;
+
+    while ((q = memchr(p, '\n', fim - p)) != NULL)
+    {
+        quebras++;
+        p = q + 1;
+    }
+    inicio_linha = p - texto;
+    resumo->linha_cursor = quebras + 1;
+    resumo->coluna_cursor = cursor - inicio_linha + 1;
+
+    fim = texto + vista->tamanho;
+    while ((q = memchr(p, '\n', fim - p)) != NULL)
+    {
+        quebras++;
+        p = q + 1;
+    }
+    resumo->linhas = quebras + (p < fim ? 1 : 0);
+}
+
+/**
+ * Procedimento: esperar
+ * Uso: esperar(milissegundos);
+ * ----------------------------
+ * Suspende o programa pelo intervalo informado.
+ */
+
+static void esperar (long milissegundos)
+{
+    struct timespec t;
+
+    t.tv_sec = milissegundos / 1000;
+    t.tv_nsec = (milissegundos % 1000) * 1000000L;
+    nanosleep(&t, NULL);
+}
@@ -0,0 +1,403 @@
+/**
+ * Arquivo: rastreador.c
+ * Versão : 1.5
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo implementa a interface rastreador.h. Os anéis de todas as
+ * threads são alocados de uma só vez, em um único bloco, quando o rastreamento
+ * é ligado pela primeira vez; cada thread pega um anel no primeiro evento e o
+ * guarda em uma variável local da thread. Daí em diante, registrar um evento
+ * é apenas ler o relógio e preencher uma posição do anel. Quando a thread
+ * termina, o seu anel volta para uma lista de anéis livres e é continuado
+ * pela próxima thread que precisar de um; os eventos já registrados nele são
+ * mantidos, cada um com o número da thread que o registrou.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "genlib.h"
+#include "rastreador.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTE: MAXANEIS
+ * -------------------
+ * Quantidade máxima de threads vivas com anel próprio. Os eventos de threads
+ * além desse limite são descartados (e contados em "descartados").
+ */
+
+#define MAXANEIS 16
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: eventoT
+ * -------------
+ * Um evento registrado: a operação, o instante de início e a duração (em
+ * nanossegundos), o tamanho do buffer depois da operação e até dois
+ * argumentos da operação, e o número da thread que o registrou.
+ */
+
+typedef struct
+{
+    uint64_t inicio;
+    uint64_t duracao;
+    uint64_t tamanho;
+    uint64_t arg1;
+    uint64_t arg2;
+    operacaoT operacao;
+    int thread;
+} eventoT;
+
+/**
+ * Tipo: anelT
+ * -----------
+ * O anel de eventos de uma thread: "escritos" conta todos os eventos já
+ * registrados, e o evento de número i fica na posição i % capacidade.
+ */
+
+typedef struct
+{
+    eventoT *eventos;
+    uint64_t escritos;
+} anelT;
+
+/*** Variáveis Globais ***/
+
+volatile int rastreamento_ativo = 0;
+
+/**
+ * VARIÁVEIS: aneis, memoria, capacidade, usados, livres, nlivres, threads,
+ *            trava, chave, descartados, anel_da_thread, numero_da_thread,
+ *            sem_anel
+ * --------------------------------------------------------------------------
+ * Os anéis, o bloco de memória que contém os eventos de todos eles, a
+ * capacidade de cada anel (uma potência de 2), a quantidade de anéis já
+ * entregues a alguma thread, a pilha de anéis devolvidos por threads que
+ * terminaram, a quantidade de threads que já pegaram um anel, a trava que
+ * protege essas quatro últimas, a chave cujo destrutor devolve o anel, a
+ * quantidade de eventos descartados por falta de anel, o anel e o número da
+ * thread atual e se a thread atual ficou sem anel.
+ */
+
+static anelT aneis[MAXANEIS];
+static eventoT *memoria = NULL;
+static size_t capacidade = 0;
+static atomic_int usados = 0;
+static int livres[MAXANEIS];
+static int nlivres = 0;
+static int threads = 0;
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t chave;
+static atomic_ulong descartados = 0;
+static _Thread_local anelT *anel_da_thread = NULL;
+static _Thread_local int numero_da_thread = 0;
+static _Thread_local bool sem_anel = FALSE;
+
+/**
+ * CONSTANTE: NOMES
+ * ----------------
+ * O nome de cada operação, como aparece nos arquivos gravados.
+ */
+
+static const char *const NOMES[OPERACOES] =
+{
+    "criar_buffer", "liberar_buffer", "mover_cursor_para_frente",
+    "mover_cursor_para_tras", "mover_cursor_para_final",
+    "mover_cursor_para_inicio", "mover_cursor_para_posicao",
+    "mover_cursor_para_proxima_palavra", "mover_cursor_para_palavra_anterior",
+    "mover_cursor_para_inicio_da_linha", "mover_cursor_para_final_da_linha",
+    "mover_cursor_para_proximo_paragrafo",
+    "mover_cursor_para_paragrafo_anterior",
+    "tamanho_buffer", "posicao_cursor", "versao_buffer", "copiar_texto",
+    "inserir_caractere", "inserir_texto", "apagar_caractere",
+    "apagar_texto", "substituir_tudo", "exibir_buffer",
+    "iniciar_transacao", "confirmar_transacao", "desfazer_transacao"
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static anelT *pegar_anel (void);
+static void devolver_anel (void *anel);
+static int comparar_eventos (const void *a, const void *b);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: ligar_rastreamento
+ * Uso: if (ligar_rastreamento(eventos)) . . .
+ * -------------------------------------------
+ * Na primeira chamada arredonda a capacidade para uma potência de 2 (para que
+ * o resto da divisão seja uma máscara), aloca os eventos de todos os anéis e
+ * cria a chave que devolve o anel de cada thread quando ela termina.
+ */
+
+bool ligar_rastreamento (size_t eventos)
+{
+    if (memoria == NULL)
+    {
+        size_t cap = 1;
+        while (cap < eventos)
+            cap *= 2;
+        memoria = calloc(MAXANEIS * cap, sizeof(eventoT));
+        if (memoria == NULL)
+        {
+            fprintf(stderr, "Erro: impossível alocar o rastreamento.\n");
+            return FALSE;
+        }
+        if (pthread_key_create(&chave, devolver_anel) != 0)
+        {
+            fprintf(stderr, "Erro: impossível alocar o rastreamento.\n");
+            free(memoria);
+            memoria = NULL;
+            return FALSE;
+        }
+        for (int i = 0; i < MAXANEIS; i++)
+            aneis[i].eventos = memoria + i * cap;
+        capacidade = cap;
+    }
+
+    rastreamento_ativo = 1;
+    return TRUE;
+}
+
+/**
+ * Procedimento: desligar_rastreamento
+ * Uso: desligar_rastreamento( );
+ * ------------------------------
+ * Apenas desliga o indicador consultado pelas funções inline.
+ */
+
+void desligar_rastreamento (void)
+{
+    rastreamento_ativo = 0;
+}
+
+/**
+ * Função: gravar_rastreamento
+ * Uso: n = gravar_rastreamento(nome, formato);
+ * --------------------------------------------
+ * Junta os eventos de todos os anéis em um único array, ordena por instante
+ * de início e grava. No formato do Chrome cada evento é um evento completo
+ * ("ph": "X"), com tempos em microssegundos contados a partir do primeiro
+ * evento e o número da thread como "tid". No formato do perf script cada
+ * evento é uma amostra cujo "período" é a duração em nanossegundos, com uma
+ * pilha de um único quadro: o nome da operação.
+ */
+
+long gravar_rastreamento (string nome, formato_rastroT formato)
+{
+    if (nome == NULL)
+    {
+        fprintf(stderr, "Erro: nome de arquivo null.\n");
+        return -1;
+    }
+
+    int n_aneis = atomic_load(&usados);
+    if (n_aneis > MAXANEIS)
+        n_aneis = MAXANEIS;
+
+    size_t total = 0;
+    for (int i = 0; i < n_aneis; i++)
+        total += aneis[i].escritos < capacidade ? aneis[i].escritos
+                                                : capacidade;
+
+    eventoT *todos = malloc((total > 0 ? total : 1) * sizeof(eventoT));
+    FILE *arq = fopen(nome, "w");
+    if (todos == NULL || arq == NULL)
+    {
+        fprintf(stderr, "Erro: impossível gravar \"%s\".\n", nome);
+        free(todos);
+        if (arq != NULL)
+            fclose(arq);
+        return -1;
+    }
+
+    size_t k = 0;
+    for (int i = 0; i < n_aneis; i++)
+    {
+        uint64_t escritos = aneis[i].escritos;
+        uint64_t primeiro = escritos > capacidade ? escritos - capacidade : 0;
+        for (uint64_t j = primeiro; j < escritos; j++)
+            todos[k++] = aneis[i].eventos[j & (capacidade - 1)];
+    }
+    qsort(todos, total, sizeof(eventoT), comparar_eventos);
+
+    int pid = (int) getpid();
+    uint64_t base = total > 0 ? todos[0].inicio : 0;
+    if (formato == RASTRO_CHROME)
+        fprintf(arq, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    for (size_t j = 0; j < total; j++)
+    {
+        eventoT *e = &todos[j];
+        if (formato == RASTRO_CHROME)
+            fprintf(arq, "{\"name\":\"%s\",\"cat\":\"buffer\",\"ph\":\"X\","
+                    "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+                    "\"args\":{\"tamanho\":%llu,\"arg1\":%llu,"
+                    "\"arg2\":%llu}}%s\n", NOMES[e->operacao],
+                    (e->inicio - base) / 1000.0, e->duracao / 1000.0, pid,
+                    e->thread, (unsigned long long) e->tamanho,
+                    (unsigned long long) e->arg1,
+                    (unsigned long long) e->arg2, j + 1 < total ? "," : "");
+        else
+            fprintf(arq, "buffer %d/%d [000] %llu.%06llu: %llu "
+                    "buffer:%s: tamanho=%llu arg1=%llu arg2=%llu\n"
+                    "\t%016llx %s (buffer.h)\n\n", pid, pid + e->thread - 1,
+                    (unsigned long long) (e->inicio / 1000000000u),
+                    (unsigned long long) (e->inicio % 1000000000u / 1000),
+                    (unsigned long long) e->duracao, NOMES[e->operacao],
+                    (unsigned long long) e->tamanho,
+                    (unsigned long long) e->arg1,
+                    (unsigned long long) e->arg2,
+                    (unsigned long long) e->operacao, NOMES[e->operacao]);
+    }
+    if (formato == RASTRO_CHROME)
+        fprintf(arq, "]}\n");
+
+    unsigned long perdidos = atomic_load(&descartados);
+    if (perdidos > 0)
+        fprintf(stderr, "Aviso: %lu eventos descartados (threads demais).\n",
+                perdidos);
+
+    free(todos);
+    if (fclose(arq) != 0)
+    {
+        fprintf(stderr, "Erro: impossível gravar \"%s\".\n", nome);
+        return -1;
+    }
+
+    return (long) total;
+}
+
+/**
+ * Função: instante_rastreamento
+ * Uso: t0 = instante_rastreamento( );
+ * -----------------------------------
+ * Lê o relógio monotônico (no Linux, sem chamada ao sistema, pelo vDSO).
+ */
+
+uint64_t instante_rastreamento (void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+/**
+ * Procedimento: registrar_evento
+ * Uso: registrar_evento(operacao, t0, tamanho, arg1, arg2);
+ * ---------------------------------------------------------
+ * Na primeira chamada de cada thread, pega um anel (ou, se não houver,
+ * passa a descartar os eventos da thread); depois apenas preenche a próxima
+ * posição do anel da thread.
+ */
+
+void registrar_evento (operacaoT operacao, uint64_t t0, size_t tamanho,
+                       uint64_t arg1, uint64_t arg2)
+{
+    uint64_t t1 = instante_rastreamento();
+
+    anelT *anel = anel_da_thread;
+    if (anel == NULL)
+    {
+        if (!sem_anel)
+            anel = pegar_anel();
+        if (anel == NULL)
+        {
+            sem_anel = TRUE;
+            atomic_fetch_add(&descartados, 1);
+            return;
+        }
+    }
+
+    eventoT *e = &anel->eventos[anel->escritos & (capacidade - 1)];
+    e->operacao = operacao;
+    e->inicio = t0;
+    e->duracao = t1 - t0;
+    e->tamanho = tamanho;
+    e->arg1 = arg1;
+    e->arg2 = arg2;
+    e->thread = numero_da_thread;
+    anel->escritos++;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: pegar_anel
+ * Uso: anel = pegar_anel( );
+ * --------------------------
+ * Entrega à thread atual um anel devolvido por uma thread que terminou ou,
+ * se não houver, um anel ainda não usado, e associa o anel à chave para que
+ * seja devolvido quando a thread terminar. Retorna NULL se todos os anéis
+ * estiverem com threads vivas.
+ */
+
+static anelT *pegar_anel (void)
+{
+    int i = MAXANEIS;
+
+    pthread_mutex_lock(&trava);
+    if (nlivres > 0)
+        i = livres[--nlivres];
+    else if (atomic_load(&usados) < MAXANEIS)
+        i = atomic_fetch_add(&usados, 1);
+    if (i < MAXANEIS)
+        numero_da_thread = ++threads;
+    pthread_mutex_unlock(&trava);
+
+    if (i == MAXANEIS)
+        return NULL;
+    anel_da_thread = &aneis[i];
+    pthread_setspecific(chave, anel_da_thread);
+    return anel_da_thread;
+}
+
+/**
+ * Procedimento: devolver_anel
+ * Uso: pthread_key_create(&chave, devolver_anel);
+ * -----------------------------------------------
+ * Destrutor da chave: coloca o anel da thread que terminou na lista de anéis
+ * livres.
+ */
+
+static void devolver_anel (void *anel)
+{
+    pthread_mutex_lock(&trava);
+    livres[nlivres++] = (int) ((anelT *) anel - aneis);
+    pthread_mutex_unlock(&trava);
+}
+
+/**
+ * Função: comparar_eventos
+ * Uso: qsort(eventos, n, sizeof(eventoT), comparar_eventos);
+ * ----------------------------------------------------------
+ * Ordena os eventos pelo instante de início.
+ */
+
+static int comparar_eventos (const void *a, const void *b)
+{
+    const eventoT *x = a, *y = b;
+
+    return (x->inicio > y->inicio) - (x->inicio < y->inicio);
+}
@@ -0,0 +1,381 @@
+/**
+ * Arquivo: rastreador.h
+ * Versão : 1.6
+ * Data   : 2026-10-19 05:00
+ * -------------------------
+ * Este arquivo define um rastreador de eventos para as operações da interface
+ * buffer.h, usado para descobrir qual operação causou uma demora percebida
+ * pelo usuário. Quando um programa é compilado com -Drastreamento, buffer.h
+ * inclui este arquivo, e cada chamada a uma operação do buffer passa por uma
+ * função inline que mede a duração da chamada e registra um evento com o tipo
+ * da operação, os seus argumentos e o tamanho do buffer.
+ *
+ * O rastreamento começa desligado. Ao ser ligado, são alocados anéis de
+ * eventos de tamanho fixo, um por thread; cada thread escreve apenas no seu
+ * próprio anel, sem travas e sem alocar memória, e quando o anel enche os
+ * eventos mais antigos são sobrescritos. Há anéis para até 16 threads vivas
+ * ao mesmo tempo (os eventos das demais são descartados); o anel de uma thread
+ * que termina é continuado pela próxima thread que começar a registrar
+ * eventos, sem perder os eventos anteriores. Os eventos podem ser gravados no
+ * formato do Chrome (chrome://tracing, Perfetto) ou no formato de texto do
+ * "perf script" (aceito por ferramentas como FlameGraph e speedscope).
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _RASTREADOR_H
+#define _RASTREADOR_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: operacaoT
+ * ---------------
+ * As operações de buffer.h que são rastreadas.
+ */
+
+typedef enum
+{
+    OP_CRIAR_BUFFER,
+    OP_LIBERAR_BUFFER,
+    OP_MOVER_CURSOR_PARA_FRENTE,
+    OP_MOVER_CURSOR_PARA_TRAS,
+    OP_MOVER_CURSOR_PARA_FINAL,
+    OP_MOVER_CURSOR_PARA_INICIO,
+    OP_MOVER_CURSOR_PARA_POSICAO,
+    OP_MOVER_CURSOR_PARA_PROXIMA_PALAVRA,
+    OP_MOVER_CURSOR_PARA_PALAVRA_ANTERIOR,
+    OP_MOVER_CURSOR_PARA_INICIO_DA_LINHA,
+    OP_MOVER_CURSOR_PARA_FINAL_DA_LINHA,
+    OP_MOVER_CURSOR_PARA_PROXIMO_PARAGRAFO,
+    OP_MOVER_CURSOR_PARA_PARAGRAFO_ANTERIOR,
+    OP_TAMANHO_BUFFER,
+    OP_POSICAO_CURSOR,
+    OP_VERSAO_BUFFER,
+    OP_COPIAR_TEXTO,
+    OP_INSERIR_CARACTERE,
+    OP_INSERIR_TEXTO,
+    OP_APAGAR_CARACTERE,
+    OP_APAGAR_TEXTO,
+    OP_SUBSTITUIR_TUDO,
+    OP_EXIBIR_BUFFER,
+    OP_INICIAR_TRANSACAO,
+    OP_CONFIRMAR_TRANSACAO,
+    OP_DESFAZER_TRANSACAO,
+    OPERACOES
+} operacaoT;
+
+/**
+ * TIPO: formato_rastroT
+ * ---------------------
+ * Os formatos em que os eventos podem ser gravados.
+ */
+
+typedef enum
+{
+    RASTRO_CHROME,
+    RASTRO_PERF
+} formato_rastroT;
+
+/*** Variáveis Globais ***/
+
+/**
+ * VARIÁVEL: rastreamento_ativo
+ * ----------------------------
+ * Diferente de zero enquanto o rastreamento está ligado. É consultada pelas
+ * funções inline abaixo antes de qualquer outro trabalho; não deve ser
+ * alterada diretamente.
+ */
+
+extern volatile int rastreamento_ativo;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: ligar_rastreamento
+ * Uso: if (ligar_rastreamento(eventos)) . . .
+ * -------------------------------------------
+ * Liga o rastreamento. Na primeira vez, aloca os anéis com espaço para
+ * "eventos" eventos por thread (arredondado para uma potência de 2); nas
+ * seguintes o argumento é ignorado e os eventos já registrados são mantidos.
+ * Retorna FALSE se não houver memória.
+ */
+
+bool ligar_rastreamento (size_t eventos);
+
+/**
+ * PROCEDIMENTO: desligar_rastreamento
+ * Uso: desligar_rastreamento( );
+ * ------------------------------
+ * Desliga o rastreamento, mantendo os eventos registrados.
+ */
+
+void desligar_rastreamento (void);
+
+/**
+ * FUNÇÃO: gravar_rastreamento
+ * Uso: n = gravar_rastreamento(nome, formato);
+ * --------------------------------------------
+ * Grava os eventos registrados por todas as threads, em ordem de início, no
+ * arquivo "nome", no formato indicado. Deve ser chamada com o rastreamento
+ * desligado ou quando as outras threads não estão usando buffers. Retorna a
+ * quantidade de eventos gravados, ou -1 em caso de erro.
+ */
+
+long gravar_rastreamento (string nome, formato_rastroT formato);
+
+/**
+ * FUNÇÕES: instante_rastreamento, registrar_evento
+ * Uso: t0 = instante_rastreamento( );
+ *      registrar_evento(operacao, t0, tamanho, arg1, arg2);
+ * --------------------------------------------------------
+ * Usadas pelas funções inline abaixo: "instante_rastreamento" retorna o
+ * instante atual, em nanossegundos, e "registrar_evento" registra no anel da
+ * thread um evento que começou em "t0" e termina agora.
+ */
+
+uint64_t instante_rastreamento (void);
+void registrar_evento (operacaoT operacao, uint64_t t0, size_t tamanho,
+                       uint64_t arg1, uint64_t arg2);
+
+/*** Funções Inline de Rastreamento ***/
+
+/**
+ * As funções abaixo têm os mesmos parâmetros das operações de buffer.h, e as
+ * macros logo depois delas fazem com que as chamadas do programa passem por
+ * elas. Com o rastreamento desligado, o custo adicional de cada chamada é o
+ * teste de "rastreamento_ativo".
+ */
+
+static inline bufferTAD rastrear_criar_buffer (void)
+{
+    if (!rastreamento_ativo)
+        return criar_buffer();
+    uint64_t t0 = instante_rastreamento();
+    bufferTAD buffer = criar_buffer();
+    registrar_evento(OP_CRIAR_BUFFER, t0, 0, 0, 0);
+    return buffer;
+}
+
+static inline bufferTAD
+rastrear_criar_buffer_com_alocador (const alocadorT *alocador)
+{
+    if (!rastreamento_ativo)
+        return criar_buffer_com_alocador(alocador);
+    uint64_t t0 = instante_rastreamento();
+    bufferTAD buffer = criar_buffer_com_alocador(alocador);
+    registrar_evento(OP_CRIAR_BUFFER, t0, 0, 0, 0);
+    return buffer;
+}
+
+static inline void rastrear_liberar_buffer (bufferTAD *buffer)
+{
+    if (!rastreamento_ativo || buffer == NULL || *buffer == NULL)
+    {
+        liberar_buffer(buffer);
+        return;
+    }
+    size_t tamanho = tamanho_buffer(*buffer);
+    uint64_t t0 = instante_rastreamento();
+    liberar_buffer(buffer);
+    registrar_evento(OP_LIBERAR_BUFFER, t0, tamanho, 0, 0);
+}
+
+static inline void rastrear_operacao (void (*operar) (bufferTAD),
+                                      operacaoT operacao, bufferTAD buffer)
+{
+    if (!rastreamento_ativo)
+    {
+        operar(buffer);
+        return;
+    }
+    uint64_t t0 = instante_rastreamento();
+    operar(buffer);
+    registrar_evento(operacao, t0, tamanho_buffer(buffer),
+                     posicao_cursor(buffer), 0);
+}
+
+static inline void rastrear_mover_cursor_para_posicao (bufferTAD buffer,
+                                                       size_t posicao)
+{
+    if (!rastreamento_ativo)
+    {
+        mover_cursor_para_posicao(buffer, posicao);
+        return;
+    }
+    uint64_t t0 = instante_rastreamento();
+    mover_cursor_para_posicao(buffer, posicao);
+    registrar_evento(OP_MOVER_CURSOR_PARA_POSICAO, t0, tamanho_buffer(buffer),
+                     posicao, 0);
+}
+
+static inline size_t rastrear_consulta (size_t (*consultar) (bufferTAD),
+                                        operacaoT operacao, bufferTAD buffer)
+{
+    if (!rastreamento_ativo)
+        return consultar(buffer);
+    uint64_t t0 = instante_rastreamento();
+    size_t valor = consultar(buffer);
+    registrar_evento(operacao, t0, tamanho_buffer(buffer), valor, 0);
+    return valor;
+}
+
+static inline unsigned long rastrear_versao_buffer (bufferTAD buffer)
+{
+    if (!rastreamento_ativo)
+        return versao_buffer(buffer);
+    uint64_t t0 = instante_rastreamento();
+    unsigned long versao = versao_buffer(buffer);
+    registrar_evento(OP_VERSAO_BUFFER, t0, tamanho_buffer(buffer), versao, 0);
+    return versao;
+}
+
+static inline size_t rastrear_copiar_texto (bufferTAD buffer, size_t inicio,
+                                            size_t n, char destino[])
+{
+    if (!rastreamento_ativo)
+        return copiar_texto(buffer, inicio, n, destino);
+    uint64_t t0 = instante_rastreamento();
+    size_t copiados = copiar_texto(buffer, inicio, n, destino);
+    registrar_evento(OP_COPIAR_TEXTO, t0, tamanho_buffer(buffer), inicio,
+                     copiados);
+    return copiados;
+}
+
+static inline void rastrear_inserir_caractere (bufferTAD buffer, char c)
+{
+    if (!rastreamento_ativo)
+    {
+        inserir_caractere(buffer, c);
+        return;
+    }
+    uint64_t t0 = instante_rastreamento();
+    inserir_caractere(buffer, c);
+    registrar_evento(OP_INSERIR_CARACTERE, t0, tamanho_buffer(buffer),
+                     (unsigned char) c, 0);
+}
+
+static inline void rastrear_inserir_texto (bufferTAD buffer,
+                                           const char *texto, size_t n)
+{
+    if (!rastreamento_ativo)
+    {
+        inserir_texto(buffer, texto, n);
+        return;
+    }
+    uint64_t t0 = instante_rastreamento();
+    inserir_texto(buffer, texto, n);
+    registrar_evento(OP_INSERIR_TEXTO, t0, tamanho_buffer(buffer), n, 0);
+}
+
+static inline void rastrear_apagar_texto (bufferTAD buffer, size_t n)
+{
+    if (!rastreamento_ativo)
+    {
+        apagar_texto(buffer, n);
+        return;
+    }
+    uint64_t t0 = instante_rastreamento();
+    apagar_texto(buffer, n);
+    registrar_evento(OP_APAGAR_TEXTO, t0, tamanho_buffer(buffer), n, 0);
+}
+
+static inline size_t rastrear_substituir_tudo (bufferTAD buffer,
+                                               const char *padrao, size_t np,
+                                               const char *novo, size_t nn,
+                                               bool simular)
+{
+    if (!rastreamento_ativo)
+        return substituir_tudo(buffer, padrao, np, novo, nn, simular);
+    uint64_t t0 = instante_rastreamento();
+    size_t quantidade = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+    registrar_evento(OP_SUBSTITUIR_TUDO, t0, tamanho_buffer(buffer),
+                     quantidade, simular);
+    return quantidade;
+}
+
+static inline bool rastrear_desfazer_transacao (bufferTAD buffer)
+{
+    if (!rastreamento_ativo)
+        return desfazer_transacao(buffer);
+    uint64_t t0 = instante_rastreamento();
+    bool desfeita = desfazer_transacao(buffer);
+    registrar_evento(OP_DESFAZER_TRANSACAO, t0, tamanho_buffer(buffer),
+                     desfeita, 0);
+    return desfeita;
+}
+
+/*** Redirecionamento das Operações de buffer.h ***/
+
+#define criar_buffer rastrear_criar_buffer
+#define criar_buffer_com_alocador rastrear_criar_buffer_com_alocador
+#define liberar_buffer rastrear_liberar_buffer
+#define mover_cursor_para_frente(B) \
+    rastrear_operacao(mover_cursor_para_frente, \
+                       OP_MOVER_CURSOR_PARA_FRENTE, (B))
+#define mover_cursor_para_tras(B) \
+    rastrear_operacao(mover_cursor_para_tras, OP_MOVER_CURSOR_PARA_TRAS, (B))
+#define mover_cursor_para_final(B) \
+    rastrear_operacao(mover_cursor_para_final, OP_MOVER_CURSOR_PARA_FINAL, \
+                       (B))
+#define mover_cursor_para_inicio(B) \
+    rastrear_operacao(mover_cursor_para_inicio, \
+                       OP_MOVER_CURSOR_PARA_INICIO, (B))
+#define mover_cursor_para_posicao rastrear_mover_cursor_para_posicao
+#define mover_cursor_para_proxima_palavra(B) \
+    rastrear_operacao(mover_cursor_para_proxima_palavra, \
+                       OP_MOVER_CURSOR_PARA_PROXIMA_PALAVRA, (B))
+#define mover_cursor_para_palavra_anterior(B) \
+    rastrear_operacao(mover_cursor_para_palavra_anterior, \
+                       OP_MOVER_CURSOR_PARA_PALAVRA_ANTERIOR, (B))
+#define mover_cursor_para_inicio_da_linha(B) \
+    rastrear_operacao(mover_cursor_para_inicio_da_linha, \
+                       OP_MOVER_CURSOR_PARA_INICIO_DA_LINHA, (B))
+#define mover_cursor_para_final_da_linha(B) \
+    rastrear_operacao(mover_cursor_para_final_da_linha, \
+                       OP_MOVER_CURSOR_PARA_FINAL_DA_LINHA, (B))
+#define mover_cursor_para_proximo_paragrafo(B) \
+    rastrear_operacao(mover_cursor_para_proximo_paragrafo, \
+                       OP_MOVER_CURSOR_PARA_PROXIMO_PARAGRAFO, (B))
+#define mover_cursor_para_paragrafo_anterior(B) \
+    rastrear_operacao(mover_cursor_para_paragrafo_anterior, \
+                       OP_MOVER_CURSOR_PARA_PARAGRAFO_ANTERIOR, (B))
+#define tamanho_buffer(B) \
+    rastrear_consulta(tamanho_buffer, OP_TAMANHO_BUFFER, (B))
+#define posicao_cursor(B) \
+    rastrear_consulta(posicao_cursor, OP_POSICAO_CURSOR, (B))
+#define versao_buffer rastrear_versao_buffer
+#define copiar_texto rastrear_copiar_texto
+#define inserir_caractere rastrear_inserir_caractere
+#define inserir_texto rastrear_inserir_texto
+#define apagar_caractere(B) \
+    rastrear_operacao(apagar_caractere, OP_APAGAR_CARACTERE, (B))
+#define apagar_texto rastrear_apagar_texto
+#define substituir_tudo rastrear_substituir_tudo
+#define exibir_buffer(B) \
+    rastrear_operacao(exibir_buffer, OP_EXIBIR_BUFFER, (B))
+#define iniciar_transacao(B) \
+    rastrear_operacao(iniciar_transacao, OP_INICIAR_TRANSACAO, (B))
+#define confirmar_transacao(B) \
+    rastrear_operacao(confirmar_transacao, OP_CONFIRMAR_TRANSACAO, (B))
+#define desfazer_transacao rastrear_desfazer_transacao
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -1,7 +1,7 @@
 /**
  * Arquivo: stackTAD1.c
- * Versão : 1.0
- * Data   : 2024-10-15 21:53
+ * Versão : 1.2
+ * Data   : 2026-10-19 02:20
  * -------------------------
  * Este arquivo implementa a interface stackTAD.h. Nesta implementação o stack
  * terá tamanho fixo máximo. A implementação, em tese, é independente do tipo de
@@ -12,6 +12,11 @@
  * implementações finais. A estrutura de dados escolhida para armazenar os dados
  * é um array.
  *
+ * A constante TAMMAX e a definição do stackTCD ficam em stackrapido.h, que
+ * também define versões inline e sem verificações das operações usadas a cada
+ * caractere. As operações daqui verificam os argumentos uma única vez e
+ * consultam a contagem diretamente, sem chamar "vazia" e "cheia".
+ *
  * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
  *             Capítulo 8: Abstract Data Types (pg. 327-347).
  *
@@ -29,43 +34,11 @@
 
 #include "genlib.h"
 #include "math.h"
+#include "stackrapido.h"
 #include "stackTAD.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-/*** Constantes Simbólicas: ***/
-
-/**
- * CONSTANTE: TAMMAX
- * -----------------
- * Esta constante especifica o tamanho máximo de espaço a ser alocado para o
- * array que armazenará os elementos do stack. Se o usuário fizer um push de
- * elementos além deste limite, receberá um erro. Se TAMMAX estiver definido
- * como 0 (zero), indica que o array é dinâmico e não tem tamanho máximo
- * limitante.
- */
-
-#define TAMMAX 1000
-
-/*** Tipos de Dados: ***/
-
-/**
- * TIPO: stackTCD
- * --------------
- * O tipo stackTCD é a representação concreta do tipo abstrato de dado stackTAD
- * definido na interface. Nesta implementação os elementos serão armazenados em
- * um array. Como a definição do stackTCD aparece apenas na implementação, e não
- * na interface, podemos alterar esta definição à vontade, desde que a interface
- * não seja alterada e o comportamento do stack seja mantido. A variável inteira
- * "contagem" manterá o número atual de elementos no stack.
- */
-
-struct stackTCD
-{
-    elementoT dados[TAMMAX];
-    int contagem;
-};
-
 /*** Definições de Subprogramas (comportamentos): ***/
 
 /**
@@ -119,7 +92,7 @@ void push (stackTAD stack, elementoT elemento)
 {
     if (stack == NULL)
         fprintf(stderr, "Erro: push em stack null.\n");
-    else if (cheia(stack))
+    else if (stack->contagem == TAMMAX)
         fprintf(stderr, "Erro: o stack está cheio.\n");
     else
         stack->dados[stack->contagem++] = elemento;
@@ -139,7 +112,7 @@ elementoT pop (stackTAD stack)
         fprintf(stderr, "Erro: pop em stack null.\n");
         exit(1);
     }
-    else if (vazia(stack))
+    else if (stack->contagem == 0)
     {
         fprintf(stderr, "Erro: stack vazio.\n");
         exit(1);
@@ -225,19 +198,14 @@ long int qtd_elementos (stackTAD stack)
  * o programa com um erro.
  */
 
-elementoT ver_elemento (stackTAD stack, int posicao)
+elementoT ver_elemento (stackTAD stack, size_t posicao)
 {
     if (stack == NULL)
     {
         fprintf(stderr, "Erro: ver_elemento de stack null.\n");
         exit(1);
     }
-    else if (vazia(stack))
-    {
-        fprintf(stderr, "Erro: stack vazio.\n");
-        exit(1);
-    }
-    else if (posicao < 0 || posicao >= stack->contagem)
+    else if (posicao >= stack->contagem)
     {
         fprintf(stderr, "Erro: posição inválida.\n");
         exit(1);
@@ -287,10 +255,10 @@ void imprimir_stack (stackTAD stack, int limite)
         fprintf(stderr, "Erro: imprimir_stack de stack null.\n");
     else if (vazia(stack))
         fprintf(stderr, "Erro: stack está vazio.\n");
-    else if (limite < 0 || limite > stack->contagem)
-        limite = stack->contagem;
+    else if (limite < 0 || (size_t) limite > stack->contagem)
+        limite = (int) stack->contagem;
 
-    for (int i = 0; i < stack->contagem && i < limite; i++)
+    for (size_t i = 0; i < stack->contagem && i < (size_t) limite; i++)
         printf("%c\n", stack->dados[i]);
 }
 #endif
@@ -1,7 +1,7 @@
 /**
  * Arquivo: stackTAD.h
- * Versão : 1.0
- * Data   : 2024-10-15 00:51
+ * Versão : 1.1
+ * Data   : 2026-10-19 02:20
  * -------------------------
  * Este arquivo define uma interface para um tipo abstrato de dado do tipo
  * piha (stack). Esta NÃO É UMA PILHA GENÉRICA, ou seja, não pode ser usada
@@ -30,6 +30,7 @@
 /*** Includes: ***/
 
 #include "genlib.h"
+#include <stddef.h>
 
 /*** Tipos de Dados: ***/
 
@@ -142,10 +143,11 @@ long int qtd_elementos (stackTAD stack);
  * Uso: elemento = ver_elemento(stack, posicao);
  * ---------------------------------------------
  * Retorna o elemento especificado em uma posição qualquer da pilha, sem
- * fazer o pop de nenhum elemento.
+ * fazer o pop de nenhum elemento. A posição é um size_t, para que stacks
+ * dinâmicos possam ter mais do que INT_MAX elementos.
  */
 
-elementoT ver_elemento (stackTAD stack, int posicao);
+elementoT ver_elemento (stackTAD stack, size_t posicao);
 
 /**
  * FUNÇÃO: espaco_restante
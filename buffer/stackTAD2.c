@@ -0,0 +1,319 @@
+/**
+ * Arquivo: stackTAD2.c
+ * Versão : 1.1
+ * Data   : 2026-10-19 02:20
+ * -------------------------
+ * Este arquivo implementa a interface stackTAD.h com um stack dinâmico, sem
+ * tamanho máximo pré-definido. Os elementos continuam armazenados em um único
+ * array, como em stackTAD.c, mas o array começa com CAPINICIAL elementos e tem
+ * a sua capacidade dobrada (com realloc) sempre que um push o encontra cheio.
+ * O custo de cada push continua O(1) amortizado, e pop e ver_elemento são
+ * acessos diretos ao array. A capacidade nunca diminui.
+ *
+ * Como o stack não tem limite, "cheia" sempre retorna FALSE e "tamanho" e
+ * "espaco_restante" retornam 0. Um push só falha se não for possível aumentar
+ * o array; nesse caso o elemento é descartado e o stack continua como estava.
+ *
+ * Para compilar o meu_editor_stackbuff com esta implementação, faça
+ * "make STACK=dinamico" (veja a Makefile e stackrapido.h).
+ *
+ * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
+ *             Capítulo 8: Abstract Data Types (pg. 327-347).
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#include "genlib.h"
+#include "stackTAD.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTE: CAPINICIAL
+ * ---------------------
+ * Quantidade de elementos que cabem no array de um stack recém-criado.
+ */
+
+#define CAPINICIAL 64
+
+/*** Tipos de Dados: ***/
+
+/**
+ * TIPO: stackTCD
+ * --------------
+ * A representação concreta do stackTAD: o array de elementos, a quantidade de
+ * elementos que cabem nele ("capacidade") e a quantidade de elementos que
+ * estão no stack ("contagem").
+ */
+
+struct stackTCD
+{
+    elementoT *dados;
+    size_t capacidade;
+    size_t contagem;
+};
+
+/*** Declarações de Subprogramas Privados: ***/
+
+static bool crescer (stackTAD stack);
+
+/*** Definições de Subprogramas (comportamentos): ***/
+
+/**
+ * FUNÇÃO: criar_stackTAD
+ * Uso: stackTAD = criar_stackTAD( );
+ * ----------------------------------
+ * Aloca o stackTCD e o array inicial. Retorna NULL se não for possível alocar
+ * a memória.
+ */
+
+stackTAD criar_stackTAD (void)
+{
+    stackTAD S = malloc(sizeof(struct stackTCD));
+    elementoT *dados = malloc(CAPINICIAL * sizeof(elementoT));
+    if (S == NULL || dados == NULL)
+    {
+        fprintf(stderr, "Erro: não foi possível alocar o stack.\n");
+        free(S);
+        free(dados);
+        return NULL;
+    }
+    S->dados = dados;
+    S->capacidade = CAPINICIAL;
+    S->contagem = 0;
+    return S;
+}
+
+/**
+ * PROCEDIMENTO: remover_stackTAD
+ * Uso: remover_stackTAD(&stackTAD);
+ * ---------------------------------
+ * Libera o array e o stackTCD e atribui NULL para o ponteiro original. Se o
+ * ponteiro original já aponta para NULL, não faz nada.
+ */
+
+void remover_stackTAD (stackTAD *stack)
+{
+    if (*stack != NULL)
+    {
+        free((*stack)->dados);
+        free(*stack);
+        *stack = NULL;
+    }
+}
+
+/**
+ * PROCEDIMENTO: push
+ * Uso: push(stack, elemento);
+ * ---------------------------
+ * Coloca o elemento no topo do stack, aumentando o array se necessário.
+ */
+
+void push (stackTAD stack, elementoT elemento)
+{
+    if (stack == NULL)
+        fprintf(stderr, "Erro: push em stack null.\n");
+    else if (stack->contagem < stack->capacidade || crescer(stack))
+        stack->dados[stack->contagem++] = elemento;
+}
+
+/**
+ * FUNÇÃO: pop
+ * Uso: elemento = pop(stack);
+ * ---------------------------
+ * Retorna o elemento do topo da pilha, ou termina o programa com um erro.
+ */
+
+elementoT pop (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: pop em stack null.\n");
+        exit(1);
+    }
+    else if (stack->contagem == 0)
+    {
+        fprintf(stderr, "Erro: stack vazio.\n");
+        exit(1);
+    }
+
+    return stack->dados[--stack->contagem];
+}
+
+/**
+ * PREDICADOS: vazia, cheia
+ * Uso: if (vazia(stack)) . . .
+ *      if (cheia(stack)) . . .
+ * ----------------------------
+ * Retornam TRUE caso a pilha esteja vazia ou cheia, respectivamente. Como o
+ * stack é dinâmico, "cheia" sempre retorna FALSE.
+ */
+
+bool vazia (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        printf("Erro: stack null.\n");
+        exit(1);
+    }
+    return (stack->contagem == 0);
+}
+
+bool cheia (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        printf("Erro: stack null.\n");
+        exit(1);
+    }
+    return FALSE;
+}
+
+/**
+ * FUNÇÃO: tamanho
+ * Uso: n = tamanho(stack);
+ * ------------------------
+ * Retorna 0, pois o stack não tem tamanho máximo, ou -1 se ocorrer algum erro.
+ */
+
+long int tamanho (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de stack null.\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * FUNÇÃO: qtd_elementos
+ * Uso: n = qtd_elementos(stack);
+ * ------------------------------
+ * Retorna a quantidade de elementos atualmente dentro da pilha, ou -1 se
+ * ocorrer algum erro.
+ */
+
+long int qtd_elementos (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: qtd_elementos de stack null.\n");
+        return -1;
+    }
+    return (stack->contagem);
+}
+
+/**
+ * FUNÇÃO: ver_elemento
+ * Uso: elemento = ver_elemento(stack, posicao);
+ * ---------------------------------------------
+ * Retorna o elemento que está em uma determinada posição do stack, ou termina
+ * o programa com um erro.
+ */
+
+elementoT ver_elemento (stackTAD stack, size_t posicao)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: ver_elemento de stack null.\n");
+        exit(1);
+    }
+    else if (posicao >= stack->contagem)
+    {
+        fprintf(stderr, "Erro: posição inválida.\n");
+        exit(1);
+    }
+
+    return (stack->dados[posicao]);
+}
+
+/**
+ * FUNÇÃO: espaco_restante
+ * Uso: n = espaco_restante(stack);
+ * --------------------------------
+ * Retorna 0, pois a pilha é dinâmica, ou -1 se houver algum erro.
+ */
+
+#ifdef debug
+long int espaco_restante (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: espaco_restante de stack null.\n");
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+/**
+ * PROCEDIMENTO: imprimir_stack
+ * Uso: imprimir_stack(stack, limite);
+ * -----------------------------------
+ * Imprime os elementos da pilha, até um certo limite.
+ */
+
+#ifdef debug
+void imprimir_stack (stackTAD stack, int limite)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: imprimir_stack de stack null.\n");
+        return;
+    }
+    else if (vazia(stack))
+        fprintf(stderr, "Erro: stack está vazio.\n");
+    else if (limite < 0 || (size_t) limite > stack->contagem)
+        limite = (int) stack->contagem;
+
+    for (size_t i = 0; i < stack->contagem && i < (size_t) limite; i++)
+        printf("%c\n", stack->dados[i]);
+}
+#endif
+
+/*** Definições de Subprogramas Privados: ***/
+
+/**
+ * PREDICADO: crescer
+ * Uso: if (crescer(stack)) . . .
+ * ------------------------------
+ * Dobra a capacidade do array. Retorna FALSE, sem alterar o stack, se o array
+ * já tem o maior tamanho representável em um size_t ou se não houver memória.
+ */
+
+static bool crescer (stackTAD stack)
+{
+    size_t limite = SIZE_MAX / sizeof(elementoT);
+    size_t nova;
+    elementoT *dados;
+
+    if (stack->capacidade == limite)
+    {
+        fprintf(stderr, "Erro: o stack está cheio.\n");
+        return FALSE;
+    }
+    nova = (stack->capacidade > limite / 2) ? limite
+                                            : 2 * stack->capacidade;
+    dados = realloc(stack->dados, nova * sizeof(elementoT));
+    if (dados == NULL)
+    {
+        fprintf(stderr, "Erro: impossível aumentar o stack.\n");
+        return FALSE;
+    }
+    stack->dados = dados;
+    stack->capacidade = nova;
+    return TRUE;
+}
@@ -0,0 +1,384 @@
+/**
+ * Arquivo: stackTAD3.c
+ * Versão : 1.1
+ * Data   : 2026-10-19 02:20
+ * -------------------------
+ * Este arquivo implementa a interface stackTAD.h com um stack dinâmico formado
+ * por blocos de TAMBLOCO bytes (4 KB, uma página de memória na maioria dos
+ * sistemas), duplamente encadeados da base para o topo. Ao contrário do array
+ * dinâmico de stackTAD2.c, o stack cresce sem nunca copiar os elementos que já
+ * estão nele e sem precisar de uma região contígua de memória: um push que
+ * encontra o bloco do topo cheio apenas encadeia um novo bloco.
+ *
+ * Para que uma sequência de push e pop na fronteira entre dois blocos não
+ * aloque e libere um bloco a cada operação, o bloco que fica vazio depois de
+ * um pop é mantido como reserva, logo acima do topo; só há uma reserva, e ela
+ * é liberada quando um segundo bloco fica vazio.
+ *
+ * O acesso por posição (ver_elemento) percorre os blocos, mas a partir do
+ * último bloco visitado, e não da base: acessos em sequência, como os de
+ * stackbuff.c, custam O(1) amortizado por elemento.
+ *
+ * Como o stack não tem limite, "cheia" sempre retorna FALSE e "tamanho" e
+ * "espaco_restante" retornam 0. Para compilar o meu_editor_stackbuff com esta
+ * implementação, faça "make STACK=blocos" (veja a Makefile e stackrapido.h).
+ *
+ * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
+ *             Capítulo 8: Abstract Data Types (pg. 327-347).
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes: ***/
+
+#include "genlib.h"
+#include "stackTAD.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTES: TAMBLOCO, POR_BLOCO
+ * -------------------------------
+ * O tamanho, em bytes, de cada bloco (ponteiros de encadeamento incluídos) e
+ * a quantidade de elementos que cabem em um bloco.
+ */
+
+#define TAMBLOCO 4096
+#define POR_BLOCO ((TAMBLOCO - 2 * sizeof(void *)) / sizeof(elementoT))
+
+/*** Tipos de Dados: ***/
+
+/**
+ * TIPO: blocoT
+ * ------------
+ * Um bloco do stack: os ponteiros para o bloco mais próximo da base
+ * ("anterior") e para o mais próximo do topo ("proximo"), e os elementos.
+ */
+
+typedef struct blocoTCD
+{
+    struct blocoTCD *anterior;
+    struct blocoTCD *proximo;
+    elementoT dados[POR_BLOCO];
+} blocoT;
+
+/**
+ * TIPO: stackTCD
+ * --------------
+ * A representação concreta do stackTAD:
+ *
+ *     base       o primeiro bloco (NULL se nenhum foi alocado ainda)
+ *     topo       o bloco que contém o topo do stack
+ *     usados     quantidade de elementos no bloco do topo
+ *     contagem   quantidade de elementos no stack
+ *     visto      o último bloco visitado por ver_elemento (ou NULL)
+ *     inicio     posição, no stack, do primeiro elemento de "visto"
+ *
+ * O bloco acima do topo, se existir, é a reserva (vazia).
+ */
+
+struct stackTCD
+{
+    blocoT *base;
+    blocoT *topo;
+    size_t usados;
+    size_t contagem;
+    blocoT *visto;
+    size_t inicio;
+};
+
+/*** Definições de Subprogramas (comportamentos): ***/
+
+/**
+ * FUNÇÃO: criar_stackTAD
+ * Uso: stackTAD = criar_stackTAD( );
+ * ----------------------------------
+ * Aloca o stackTCD, ainda sem blocos. Retorna NULL se não for possível alocar
+ * a memória.
+ */
+
+stackTAD criar_stackTAD (void)
+{
+    stackTAD S = malloc(sizeof(struct stackTCD));
+    if (S == NULL)
+    {
+        fprintf(stderr, "Erro: não foi possível alocar o stack.\n");
+        return NULL;
+    }
+    S->base = S->topo = S->visto = NULL;
+    S->usados = S->contagem = S->inicio = 0;
+    return S;
+}
+
+/**
+ * PROCEDIMENTO: remover_stackTAD
+ * Uso: remover_stackTAD(&stackTAD);
+ * ---------------------------------
+ * Libera todos os blocos (inclusive a reserva) e o stackTCD e atribui NULL
+ * para o ponteiro original. Se o ponteiro original já aponta para NULL, não
+ * faz nada.
+ */
+
+void remover_stackTAD (stackTAD *stack)
+{
+    if (*stack != NULL)
+    {
+        blocoT *b = (*stack)->base, *proximo;
+        while (b != NULL)
+        {
+            proximo = b->proximo;
+            free(b);
+            b = proximo;
+        }
+        free(*stack);
+        *stack = NULL;
+    }
+}
+
+/**
+ * PROCEDIMENTO: push
+ * Uso: push(stack, elemento);
+ * ---------------------------
+ * Coloca o elemento no topo do stack. Se o bloco do topo está cheio, passa
+ * para a reserva ou, se não houver reserva, encadeia um novo bloco.
+ */
+
+void push (stackTAD stack, elementoT elemento)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: push em stack null.\n");
+        return;
+    }
+
+    if (stack->topo == NULL || stack->usados == POR_BLOCO)
+    {
+        blocoT *b = (stack->topo != NULL) ? stack->topo->proximo
+                                          : stack->base;
+        if (b == NULL)
+        {
+            if (stack->contagem == SIZE_MAX)
+            {
+                fprintf(stderr, "Erro: o stack está cheio.\n");
+                return;
+            }
+            b = malloc(sizeof(blocoT));
+            if (b == NULL)
+            {
+                fprintf(stderr, "Erro: impossível aumentar o stack.\n");
+                return;
+            }
+            b->anterior = stack->topo;
+            b->proximo = NULL;
+            if (stack->topo != NULL)
+                stack->topo->proximo = b;
+            else
+                stack->base = b;
+        }
+        stack->topo = b;
+        stack->usados = 0;
+    }
+
+    stack->topo->dados[stack->usados++] = elemento;
+    stack->contagem++;
+}
+
+/**
+ * FUNÇÃO: pop
+ * Uso: elemento = pop(stack);
+ * ---------------------------
+ * Retorna o elemento do topo da pilha, ou termina o programa com um erro. Se
+ * o bloco do topo fica vazio, ele passa a ser a reserva e a reserva anterior
+ * é liberada.
+ */
+
+elementoT pop (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: pop em stack null.\n");
+        exit(1);
+    }
+    else if (stack->contagem == 0)
+    {
+        fprintf(stderr, "Erro: stack vazio.\n");
+        exit(1);
+    }
+
+    elementoT elemento = stack->topo->dados[--stack->usados];
+    stack->contagem--;
+
+    if (stack->usados == 0 && stack->topo->anterior != NULL)
+    {
+        blocoT *reserva = stack->topo->proximo;
+        if (reserva != NULL)
+        {
+            if (stack->visto == reserva)
+                stack->visto = NULL;
+            free(reserva);
+            stack->topo->proximo = NULL;
+        }
+        stack->topo = stack->topo->anterior;
+        stack->usados = POR_BLOCO;
+    }
+
+    return elemento;
+}
+
+/**
+ * PREDICADOS: vazia, cheia
+ * Uso: if (vazia(stack)) . . .
+ *      if (cheia(stack)) . . .
+ * ----------------------------
+ * Retornam TRUE caso a pilha esteja vazia ou cheia, respectivamente. Como o
+ * stack é dinâmico, "cheia" sempre retorna FALSE.
+ */
+
+bool vazia (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        printf("Erro: stack null.\n");
+        exit(1);
+    }
+    return (stack->contagem == 0);
+}
+
+bool cheia (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        printf("Erro: stack null.\n");
+        exit(1);
+    }
+    return FALSE;
+}
+
+/**
+ * FUNÇÃO: tamanho
+ * Uso: n = tamanho(stack);
+ * ------------------------
+ * Retorna 0, pois o stack não tem tamanho máximo, ou -1 se ocorrer algum erro.
+ */
+
+long int tamanho (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de stack null.\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * FUNÇÃO: qtd_elementos
+ * Uso: n = qtd_elementos(stack);
+ * ------------------------------
+ * Retorna a quantidade de elementos atualmente dentro da pilha, ou -1 se
+ * ocorrer algum erro.
+ */
+
+long int qtd_elementos (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: qtd_elementos de stack null.\n");
+        return -1;
+    }
+    return (stack->contagem);
+}
+
+/**
+ * FUNÇÃO: ver_elemento
+ * Uso: elemento = ver_elemento(stack, posicao);
+ * ---------------------------------------------
+ * Retorna o elemento que está em uma determinada posição do stack, ou termina
+ * o programa com um erro. A busca pelo bloco parte do último bloco visitado.
+ */
+
+elementoT ver_elemento (stackTAD stack, size_t posicao)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: ver_elemento de stack null.\n");
+        exit(1);
+    }
+    else if (posicao >= stack->contagem)
+    {
+        fprintf(stderr, "Erro: posição inválida.\n");
+        exit(1);
+    }
+
+    if (stack->visto == NULL)
+    {
+        stack->visto = stack->base;
+        stack->inicio = 0;
+    }
+    while (posicao < stack->inicio)
+    {
+        stack->visto = stack->visto->anterior;
+        stack->inicio -= POR_BLOCO;
+    }
+    while (posicao - stack->inicio >= POR_BLOCO)
+    {
+        stack->visto = stack->visto->proximo;
+        stack->inicio += POR_BLOCO;
+    }
+
+    return (stack->visto->dados[posicao - stack->inicio]);
+}
+
+/**
+ * FUNÇÃO: espaco_restante
+ * Uso: n = espaco_restante(stack);
+ * --------------------------------
+ * Retorna 0, pois a pilha é dinâmica, ou -1 se houver algum erro.
+ */
+
+#ifdef debug
+long int espaco_restante (stackTAD stack)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: espaco_restante de stack null.\n");
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+/**
+ * PROCEDIMENTO: imprimir_stack
+ * Uso: imprimir_stack(stack, limite);
+ * -----------------------------------
+ * Imprime os elementos da pilha, até um certo limite.
+ */
+
+#ifdef debug
+void imprimir_stack (stackTAD stack, int limite)
+{
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: imprimir_stack de stack null.\n");
+        return;
+    }
+    else if (vazia(stack))
+        fprintf(stderr, "Erro: stack está vazio.\n");
+    else if (limite < 0 || (size_t) limite > stack->contagem)
+        limite = (int) stack->contagem;
+
+    for (size_t i = 0; i < stack->contagem && i < (size_t) limite; i++)
+        printf("%c\n", ver_elemento(stack, i));
+}
+#endif
@@ -1,11 +1,26 @@
 /**
  * Arquivo: stackbuff.c
- * Versão : 1.0
- * Data   : 2024-10-18 17:27
+ * Versão : 1.12
+ * Data   : 2026-10-19 05:00
  * -------------------------
  * Este arquivo implemeta a interface buffer.h, utilizando pilhas para o
  * armazenamento dos caracteres do buffer.
  *
+ * Cada operação verifica o buffer uma única vez, na entrada; os laços que
+ * transferem, leem ou empilham caracteres um a um usam as operações inline de
+ * stackrapido.h, que só verificam os argumentos nos programas compilados com
+ * -Ddebug.
+ *
+ * As pilhas podem ter qualquer uma das representações do stackTAD, escolhida
+ * na compilação pela variável STACK da Makefile. Com a representação padrão,
+ * de tamanho fixo, o buffer tem no máximo 1000 caracteres de cada lado do
+ * cursor; com as dinâmicas ("dinamico" e "blocos") não há limite, mas as
+ * operações rápidas passam a ser chamadas de função (veja medir_stack.c).
+ *
+ * Dentro de uma transação (veja transacao.h), os movimentos do cursor não
+ * transferem nenhum caractere entre as pilhas: as edições pendentes são
+ * aplicadas de uma só vez, com o cursor andando sempre para frente.
+ *
  * Baseado em: Programming Abstractions in C, de Eric S. Roberts.
  *             Capítulo 9: Efficiency and ADTs (pg. 386-391).
  *
@@ -21,13 +36,20 @@
 
 /*** Includes: ***/
 
+#define IMPLEMENTANDO_BUFFER
+
+#include "alocador.h"
 #include "buffer.h"
 #include "genlib.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "simpio.h"
+#include "stackrapido.h"
 #include "stackTAD.h"
 #include "strlib.h"
+#include "transacao.h"
 
 /*** Tipos de Dados: ***/
 
@@ -46,14 +68,68 @@
  *       A        E
  *     -----   ------
  *     antes   depois
+ *
+ * O campo "versao" conta as alterações do conteúdo do buffer. O "alocador" é
+ * o alocador do qual a estrutura do buffer foi obtida; as pilhas continuam
+ * sendo alocadas pelo stackTAD. A "transacao" é a transação aberta (NULL se
+ * não houver), e "desfazer" é a última transação confirmada, com a versão do
+ * buffer logo após a confirmação em "versao_desfazer".
  */
 
 struct bufferTCD
 {
     stackTAD antes;
     stackTAD depois;
+    unsigned long versao;
+    alocadorT alocador;
+    transacaoTAD transacao;
+    transacaoTAD desfazer;
+    unsigned long versao_desfazer;
 };
 
+/**
+ * Tipo: saidaT
+ * ------------
+ * O array em que "substituir_tudo" monta o novo texto antes de distribuí-lo
+ * entre as pilhas. Se "texto" for NULL, os caracteres são apenas contados.
+ */
+
+typedef struct
+{
+    char *texto;
+    size_t capacidade;
+    size_t tamanho;
+} saidaT;
+
+/**
+ * Tipo: classeT
+ * -------------
+ * As classes de caracteres procuradas pelos movimentos de palavra, linha e
+ * parágrafo: o '\n' (QUEBRA), qualquer outro caractere (TEXTO), os
+ * caracteres de palavra (PALAVRA) e os demais (SEPARADOR).
+ */
+
+typedef enum
+{
+    QUEBRA,
+    TEXTO,
+    PALAVRA,
+    SEPARADOR
+} classeT;
+
+/*** Declarações de Subprogramas Privados: ***/
+
+static size_t *tabela_falhas (const char *padrao, size_t n);
+static void anexar (saidaT *saida, const char *texto, size_t n);
+static bool cabe (stackTAD stack, size_t n);
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe);
+static bool pertence (char c, classeT classe);
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar);
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao);
+static void aplicar_pendentes (bufferTAD buffer);
+
 /*** Definições de Subprogramas Exportados: ***/
 
 /**
@@ -67,18 +143,43 @@ struct bufferTCD
 
 bufferTAD criar_buffer (void)
 {
-    bufferTAD buffer = malloc(sizeof(struct bufferTCD));
+    return criar_buffer_com_alocador(NULL);
+}
+
+/**
+ * FUNÇÃO: criar_buffer_com_alocador
+ * Uso: buffer = criar_buffer_com_alocador(&alocador);
+ * ---------------------------------------------------
+ * Igual a criar_buffer, mas a estrutura do buffer é obtida do alocador (ou de
+ * malloc, se o alocador for NULL). Em caso de erro, libera o que já foi
+ * alocado e o alocador, se for o dono da sua memória, e retorna NULL.
+ */
+
+bufferTAD criar_buffer_com_alocador (const alocadorT *alocador)
+{
+    alocadorT a = (alocador != NULL) ? *alocador : alocador_padrao();
+    bufferTAD buffer = alocar(&a, sizeof(struct bufferTCD));
     if (buffer == NULL)
     {
         fprintf(stderr, "Erro: impossível alocar buffer.\n");
+        liberar_alocador(&a);
         return NULL;
     }
 
+    buffer->versao = 0;
+    buffer->alocador = a;
+    buffer->transacao = NULL;
+    buffer->desfazer = NULL;
+    buffer->versao_desfazer = 0;
     buffer->antes = criar_stackTAD();
     buffer->depois = criar_stackTAD();
     if (buffer->antes == NULL || buffer->depois == NULL)
     {
         fprintf(stderr, "Erro: impossível alocar pilhas do buffer.\n");
+        remover_stackTAD(&buffer->antes);
+        remover_stackTAD(&buffer->depois);
+        desalocar(&a, buffer, sizeof(struct bufferTCD));
+        liberar_alocador(&a);
         return NULL;
     }
 
@@ -100,8 +201,12 @@ void liberar_buffer (bufferTAD *buffer)
     {
         remover_stackTAD(&((*buffer)->antes));
         remover_stackTAD(&((*buffer)->depois));
-        free(*buffer);
-        buffer = NULL;
+        liberar_transacao(&(*buffer)->transacao);
+        liberar_transacao(&(*buffer)->desfazer);
+        alocadorT alocador = (*buffer)->alocador;
+        desalocar(&alocador, *buffer, sizeof(struct bufferTCD));
+        liberar_alocador(&alocador);
+        *buffer = NULL;
     }
 }
 
@@ -125,8 +230,11 @@ void mover_cursor_para_frente (bufferTAD buffer)
         exit(1);
     }
 
-    if (!vazia(buffer->depois))
-        push(buffer->antes, pop(buffer->depois));
+    if (mover_na_transacao(buffer, posicao_cursor(buffer) + 1))
+        return;
+
+    if (!vazia_rapida(buffer->depois) && !cheia_rapida(buffer->antes))
+        push_rapido(buffer->antes, pop_rapido(buffer->depois));
 }
 
 void mover_cursor_para_tras (bufferTAD buffer)
@@ -137,8 +245,12 @@ void mover_cursor_para_tras (bufferTAD buffer)
         exit(1);
     }
 
-    if (!vazia(buffer->antes))
-        push(buffer->depois, pop(buffer->antes));
+    size_t atual = posicao_cursor(buffer);
+    if (mover_na_transacao(buffer, atual > 0 ? atual - 1 : 0))
+        return;
+
+    if (!vazia_rapida(buffer->antes) && !cheia_rapida(buffer->depois))
+        push_rapido(buffer->depois, pop_rapido(buffer->antes));
 }
 
 /**
@@ -148,7 +260,7 @@ void mover_cursor_para_tras (bufferTAD buffer)
  *      mover_cursor_para_inicio(buffer);
  * ---------------------------------------
  * Estes procedimentos movem o cursor apra o final ou para o início do buffer,
- * respectivamente.
+ * respectivamente. Se a pilha de destino encher, o cursor para onde está.
  */
 
 void mover_cursor_para_final (bufferTAD buffer)
@@ -159,8 +271,11 @@ void mover_cursor_para_final (bufferTAD buffer)
         exit(1);
     }
 
-    while (!vazia(buffer->depois))
-        push(buffer->antes, pop(buffer->depois));
+    if (mover_na_transacao(buffer, SIZE_MAX))
+        return;
+
+    while (!vazia_rapida(buffer->depois) && !cheia_rapida(buffer->antes))
+        push_rapido(buffer->antes, pop_rapido(buffer->depois));
 }
 
 void mover_cursor_para_inicio (bufferTAD buffer)
@@ -171,8 +286,271 @@ void mover_cursor_para_inicio (bufferTAD buffer)
         exit(1);
     }
 
-    while (!vazia(buffer->antes))
-        push(buffer->depois, pop(buffer->antes));
+    if (mover_na_transacao(buffer, 0))
+        return;
+
+    while (!vazia_rapida(buffer->antes) && !cheia_rapida(buffer->depois))
+        push_rapido(buffer->depois, pop_rapido(buffer->antes));
+}
+
+/**
+ * PROCEDIMENTO: mover_cursor_para_posicao
+ * Uso: mover_cursor_para_posicao(buffer, posicao);
+ * ------------------------------------------------
+ * Transfere caracteres de uma pilha para a outra até que a pilha "antes" tenha
+ * exatamente "posicao" elementos (ou até que a pilha "depois" se esvazie, ou
+ * que a pilha de destino encha).
+ */
+
+void mover_cursor_para_posicao (bufferTAD buffer, size_t posicao)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    if (mover_na_transacao(buffer, posicao))
+        return;
+
+    while (qtd_rapida(buffer->antes) > posicao &&
+           !cheia_rapida(buffer->depois))
+        push_rapido(buffer->depois, pop_rapido(buffer->antes));
+    while (qtd_rapida(buffer->antes) < posicao &&
+           !vazia_rapida(buffer->depois) && !cheia_rapida(buffer->antes))
+        push_rapido(buffer->antes, pop_rapido(buffer->depois));
+}
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_proxima_palavra
+ *                mover_cursor_para_palavra_anterior
+ * Uso: mover_cursor_para_proxima_palavra(buffer);
+ *      mover_cursor_para_palavra_anterior(buffer);
+ * -------------------------------------------------
+ * As buscas leem as pilhas com ver_rapido, sem transferir nenhum caractere;
+ * apenas o salto final, com mover_cursor_para_posicao, passa de uma pilha para
+ * a outra os caracteres entre o cursor antigo e o novo.
+ */
+
+void mover_cursor_para_proxima_palavra (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = avancar_ate(buffer, posicao_cursor(buffer), SEPARADOR);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, p, PALAVRA));
+}
+
+void mover_cursor_para_palavra_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), PALAVRA);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, p, SEPARADOR));
+}
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_inicio_da_linha
+ *                mover_cursor_para_final_da_linha
+ * Uso: mover_cursor_para_inicio_da_linha(buffer);
+ *      mover_cursor_para_final_da_linha(buffer);
+ * -----------------------------------------------
+ * Uma única busca pelo '\n' anterior ou seguinte ao cursor.
+ */
+
+void mover_cursor_para_inicio_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, recuar_ate(buffer, posicao_cursor(buffer),
+                                                 QUEBRA));
+}
+
+void mover_cursor_para_final_da_linha (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    mover_cursor_para_posicao(buffer, avancar_ate(buffer, posicao_cursor(buffer),
+                                                  QUEBRA));
+}
+
+/**
+ * PROCEDIMENTOS: mover_cursor_para_proximo_paragrafo
+ *                mover_cursor_para_paragrafo_anterior
+ * Uso: mover_cursor_para_proximo_paragrafo(buffer);
+ *      mover_cursor_para_paragrafo_anterior(buffer);
+ * ---------------------------------------------------
+ * Para frente, o texto é percorrido de uma sequência de '\n' a outra; a
+ * primeira sequência com dois ou mais '\n' que vem depois de um caractere de
+ * texto termina o parágrafo, e a linha em branco começa logo após o primeiro
+ * '\n'. Para trás, o texto é percorrido de um início de linha com texto ao
+ * anterior; o primeiro que é precedido por dois ou mais '\n' (ou apenas por
+ * '\n' desde o início do buffer) começa um parágrafo, e a linha em branco
+ * começa logo antes dele. Se o cursor está em uma linha em branco, as linhas em
+ * branco vizinhas são puladas antes.
+ */
+
+void mover_cursor_para_proximo_paragrafo (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer), p = posicao_cursor(buffer);
+    bool apos_texto = (p > 0 && recuar_ate(buffer, p, TEXTO) == p);
+
+    while (p < n)
+    {
+        size_t q = avancar_ate(buffer, p, QUEBRA);
+        size_t r = (q < n) ? avancar_ate(buffer, q, TEXTO) : n;
+        if ((q > p || apos_texto) && r - q >= 2)
+        {
+            p = q + 1;
+            break;
+        }
+        p = r;
+        apos_texto = TRUE;
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+void mover_cursor_para_paragrafo_anterior (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: movimentação em buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t n = tamanho_buffer(buffer);
+    size_t p = recuar_ate(buffer, posicao_cursor(buffer), QUEBRA);
+
+    if (p == n || avancar_ate(buffer, p, TEXTO) != p)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        p = (t > 0) ? recuar_ate(buffer, t, QUEBRA) : 0;
+    }
+    while (p > 0)
+    {
+        size_t t = recuar_ate(buffer, p, TEXTO);
+        if (t == 0 || p - t >= 2)
+        {
+            p--;
+            break;
+        }
+        p = recuar_ate(buffer, t, QUEBRA);
+    }
+    mover_cursor_para_posicao(buffer, p);
+}
+
+/**
+ * FUNÇÕES: tamanho_buffer, posicao_cursor
+ * Uso: n = tamanho_buffer(buffer);
+ *      p = posicao_cursor(buffer);
+ * ---------------------------------------
+ * O tamanho do buffer é a soma dos elementos das duas pilhas, e a posição do
+ * cursor é a quantidade de elementos da pilha "antes".
+ */
+
+size_t tamanho_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: tamanho de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return tamanho_da_transacao(buffer->transacao);
+
+    return qtd_rapida(buffer->antes) + qtd_rapida(buffer->depois);
+}
+
+size_t posicao_cursor (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cursor de buffer null.\n");
+        exit(1);
+    }
+    else if (transacao_pendente(buffer->transacao))
+        return cursor_da_transacao(buffer->transacao);
+
+    return qtd_rapida(buffer->antes);
+}
+
+/**
+ * FUNÇÃO: versao_buffer
+ * Uso: v = versao_buffer(buffer);
+ * -------------------------------
+ * Retorna o contador de alterações, incrementado pelas inserções e remoções.
+ */
+
+unsigned long versao_buffer (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: versão de buffer null.\n");
+        exit(1);
+    }
+
+    return buffer->versao;
+}
+
+/**
+ * FUNÇÃO: copiar_texto
+ * Uso: n = copiar_texto(buffer, inicio, n, destino);
+ * --------------------------------------------------
+ * Lê os caracteres com "ver_rapido", sem transferir nada entre as pilhas. Os
+ * caracteres depois do cursor estão na pilha "depois" em ordem inversa (o
+ * primeiro deles está no topo).
+ */
+
+size_t copiar_texto (bufferTAD buffer, size_t inicio, size_t n, char destino[])
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: cópia de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t nantes = qtd_rapida(buffer->antes);
+    size_t ndepois = qtd_rapida(buffer->depois);
+    size_t copiados = 0;
+
+    for (size_t i = inicio; copiados < n && i < nantes + ndepois; i++)
+    {
+        if (i < nantes)
+            destino[copiados++] = ver_rapido(buffer->antes, i);
+        else
+            destino[copiados++] = ver_rapido(buffer->depois,
+                                             ndepois - 1 - (i - nantes));
+    }
+
+    return copiados;
 }
 
 /**
@@ -191,8 +569,46 @@ void inserir_caractere (bufferTAD buffer, char c)
         fprintf(stderr, "Erro: inserção em buffer null.\n");
         exit(1);
     }
+    else if (registrar(buffer, &c, 1, 0))
+        return;
 
-    push(buffer->antes, c);
+    if (cheia_rapida(buffer->antes))
+    {
+        fprintf(stderr, "Erro: o stack está cheio.\n");
+        return;
+    }
+    push_rapido(buffer->antes, c);
+    buffer->versao++;
+}
+
+/**
+ * PROCEDIMENTO: inserir_texto
+ * Uso: inserir_texto(buffer, texto, n);
+ * -------------------------------------
+ * Insere os "n" caracteres de "texto" na posição atual do cursor. Como todos os
+ * caracteres inseridos ficam antes do cursor, basta empilhá-los, em ordem, na
+ * pilha "antes"; a pilha "depois" não é alterada. Os caracteres que não
+ * couberem na pilha são descartados, com uma única mensagem de erro; a versão
+ * só muda se algum caractere foi inserido.
+ */
+
+void inserir_texto (bufferTAD buffer, const char *texto, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: inserção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, texto, n, 0))
+        return;
+
+    size_t i;
+    for (i = 0; i < n && !cheia_rapida(buffer->antes); i++)
+        push_rapido(buffer->antes, texto[i]);
+    if (i < n)
+        fprintf(stderr, "Erro: o stack está cheio.\n");
+    if (i > 0)
+        buffer->versao++;
 }
 
 /**
@@ -210,30 +626,465 @@ void apagar_caractere (bufferTAD buffer)
         fprintf(stderr, "Erro: remoção em buffer null.\n");
         exit(1);
     }
+    else if (registrar(buffer, NULL, 0, 1))
+        return;
 
-    if (!vazia(buffer->depois))
-        (void) pop(buffer->depois);
+    if (!vazia_rapida(buffer->depois))
+    {
+        (void) pop_rapido(buffer->depois);
+        buffer->versao++;
+    }
+}
+
+/**
+ * PROCEDIMENTO: apagar_texto
+ * Uso: apagar_texto(buffer, n);
+ * -----------------------------
+ * Apaga até "n" caracteres após o cursor, desempilhando-os da pilha "depois".
+ */
+
+void apagar_texto (bufferTAD buffer, size_t n)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: remoção em buffer null.\n");
+        exit(1);
+    }
+    else if (registrar(buffer, NULL, 0, n))
+        return;
+
+    size_t removidos = 0;
+    while (removidos < n && !vazia_rapida(buffer->depois))
+    {
+        (void) pop_rapido(buffer->depois);
+        removidos++;
+    }
+    if (removidos > 0)
+        buffer->versao++;
+}
+
+/**
+ * FUNÇÃO: substituir_tudo
+ * Uso: n = substituir_tudo(buffer, padrao, np, novo, nn, simular);
+ * ----------------------------------------------------------------
+ * Lê os caracteres das duas pilhas, em ordem, uma única vez, procurando o
+ * padrão com o algoritmo de Knuth-Morris-Pratt, e monta o novo texto em um
+ * array auxiliar. Depois as pilhas são esvaziadas e recebem o novo texto,
+ * dividido na nova posição do cursor. Se alguma das pilhas não comportar a
+ * sua parte, o buffer não é alterado e a função retorna 0.
+ */
+
+size_t substituir_tudo (bufferTAD buffer, const char *padrao, size_t np,
+                        const char *novo, size_t nn, bool simular)
+{
+    if (buffer == NULL || (np > 0 && padrao == NULL) ||
+        (nn > 0 && novo == NULL))
+    {
+        fprintf(stderr, "Erro: substituição em buffer null.\n");
+        exit(1);
+    }
+    else if (np == 0)
+        return 0;
+
+    aplicar_pendentes(buffer);
+    if (!simular)
+        guardar_texto_para_desfazer(buffer->transacao, buffer);
+    size_t nantes = qtd_rapida(buffer->antes);
+    size_t ndepois = qtd_rapida(buffer->depois);
+    size_t tamanho = nantes + ndepois;
+
+    saidaT saida = {NULL, 0, 0};
+    if (!simular)
+    {
+        saida.capacidade = tamanho > 0 ? tamanho : 1;
+        saida.texto = malloc(saida.capacidade);
+        if (saida.texto == NULL)
+        {
+            fprintf(stderr, "Erro: impossível alocar texto substituído.\n");
+            exit(1);
+        }
+    }
+
+    size_t *falhas = tabela_falhas(padrao, np);
+    size_t quantidade = 0, j = 0, ganho = 0, perda = 0, novo_cursor = 0;
+    bool dentro = FALSE;
+
+    for (size_t i = 0; i < tamanho; )
+    {
+        char c;
+        if (i < nantes)
+            c = ver_rapido(buffer->antes, i);
+        else
+            c = ver_rapido(buffer->depois, ndepois - 1 - (i - nantes));
+        i++;
+
+        while (j > 0 && c != padrao[j])
+        {
+            anexar(&saida, padrao, j - falhas[j - 1]);
+            j = falhas[j - 1];
+        }
+        if (c == padrao[j])
+            j++;
+        else
+            anexar(&saida, &c, 1);
+
+        if (j == np)
+        {
+            if (i <= nantes)
+            {
+                ganho += nn;
+                perda += np;
+            }
+            else if (i - np < nantes)
+            {
+                novo_cursor = saida.tamanho + nn;
+                dentro = TRUE;
+            }
+            anexar(&saida, novo, nn);
+            quantidade++;
+            j = 0;
+        }
+    }
+    anexar(&saida, padrao, j);
+    free(falhas);
+
+    if (!dentro)
+        novo_cursor = nantes + ganho - perda;
+    if (!simular && quantidade > 0 &&
+        (!cabe(buffer->antes, novo_cursor) ||
+         !cabe(buffer->depois, saida.tamanho - novo_cursor)))
+    {
+        fprintf(stderr, "Erro: o texto substituído não cabe no buffer.\n");
+        quantidade = 0;
+    }
+    if (simular || quantidade == 0)
+    {
+        free(saida.texto);
+        return quantidade;
+    }
+
+    while (!vazia_rapida(buffer->antes))
+        (void) pop_rapido(buffer->antes);
+    while (!vazia_rapida(buffer->depois))
+        (void) pop_rapido(buffer->depois);
+    for (size_t i = 0; i < novo_cursor; i++)
+        push_rapido(buffer->antes, saida.texto[i]);
+    for (size_t i = saida.tamanho; i > novo_cursor; i--)
+        push_rapido(buffer->depois, saida.texto[i - 1]);
+    free(saida.texto);
+    buffer->versao++;
+
+    return quantidade;
 }
 
 /**
  * PROCEDIMENTO: exibir_buffer
  * Uso: exibir_buffer(buffer);
  * ---------------------------
- * Exibe o conteúdo atual do buffer no terminal.
+ * Exibe o conteúdo atual do buffer no terminal. As quantidades de elementos
+ * das pilhas são lidas uma única vez, antes dos laços.
  */
 
 void exibir_buffer (bufferTAD buffer)
 {
-    for (int i = 0; i < qtd_elementos(buffer->antes); i++)
-        printf(" %c", ver_elemento(buffer->antes, i));
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: exibição de buffer null.\n");
+        exit(1);
+    }
+
+    aplicar_pendentes(buffer);
+    size_t nantes = qtd_rapida(buffer->antes);
+    size_t ndepois = qtd_rapida(buffer->depois);
+
+    for (size_t i = 0; i < nantes; i++)
+        printf(" %c", ver_rapido(buffer->antes, i));
 
-    for (int i = qtd_elementos(buffer->depois) - 1; i >= 0; i--)
-        printf(" %c", ver_elemento(buffer->depois, i));
+    for (size_t i = ndepois; i > 0; i--)
+        printf(" %c", ver_rapido(buffer->depois, i - 1));
 
     printf("\n");
 
-    for (int i = 0; i < qtd_elementos(buffer->antes); i++)
+    for (size_t i = 0; i < nantes; i++)
         printf("  ");
 
     printf("^\n");
 }
+
+/**
+ * PROCEDIMENTOS: iniciar_transacao, confirmar_transacao
+ * Uso: iniciar_transacao(buffer);
+ *      . . .
+ *      confirmar_transacao(buffer);
+ * -----------------------------------------------------
+ * A transação aberta fica em "transacao". Na confirmação, as edições
+ * pendentes são aplicadas por "aplicar_pendentes", e a transação passa a ser
+ * o registro para desfazer, junto com a versão do buffer naquele momento.
+ */
+
+void iniciar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+
+    if (buffer->transacao != NULL)
+        aninhar_transacao(buffer->transacao);
+    else
+        buffer->transacao = criar_transacao();
+}
+
+void confirmar_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: transação em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao == NULL)
+    {
+        fprintf(stderr, "Erro: nenhuma transação aberta.\n");
+        return;
+    }
+    else if (desaninhar_transacao(buffer->transacao))
+        return;
+
+    aplicar_pendentes(buffer);
+    liberar_transacao(&buffer->desfazer);
+    buffer->desfazer = buffer->transacao;
+    buffer->transacao = NULL;
+    buffer->versao_desfazer = buffer->versao;
+}
+
+/**
+ * PREDICADO: desfazer_transacao
+ * Uso: if (desfazer_transacao(buffer)) . . .
+ * ------------------------------------------
+ * A versão guardada na confirmação diz se o buffer foi alterado depois dela.
+ * As edições inversas são feitas com as operações comuns do buffer.
+ */
+
+bool desfazer_transacao (bufferTAD buffer)
+{
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: desfazer em buffer null.\n");
+        exit(1);
+    }
+    else if (buffer->transacao != NULL || buffer->desfazer == NULL ||
+             buffer->versao != buffer->versao_desfazer)
+        return FALSE;
+
+    transacaoTAD desfazer = buffer->desfazer;
+    buffer->desfazer = NULL;
+    bool desfeita = reverter_transacao(desfazer, buffer);
+    liberar_transacao(&desfazer);
+    return desfeita;
+}
+
+/*** Definições de Subprogramas Privados: ***/
+
+/**
+ * FUNÇÃO: tabela_falhas
+ * Uso: falhas = tabela_falhas(padrao, n);
+ * ---------------------------------------
+ * Retorna a tabela de falhas de Knuth-Morris-Pratt do padrão: falhas[k] é o
+ * tamanho do maior prefixo de padrao[0..k] que também é sufixo de
+ * padrao[1..k]. Termina o programa se não houver memória.
+ */
+
+static size_t *tabela_falhas (const char *padrao, size_t n)
+{
+    size_t *falhas = malloc(n * sizeof(size_t));
+    if (falhas == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar tabela de busca.\n");
+        exit(1);
+    }
+
+    falhas[0] = 0;
+    for (size_t k = 1, j = 0; k < n; k++)
+    {
+        while (j > 0 && padrao[k] != padrao[j])
+            j = falhas[j - 1];
+        if (padrao[k] == padrao[j])
+            j++;
+        falhas[k] = j;
+    }
+
+    return falhas;
+}
+
+/**
+ * PROCEDIMENTO: anexar
+ * Uso: anexar(&saida, texto, n);
+ * ------------------------------
+ * Acrescenta "n" caracteres ao final da saída, dobrando a capacidade do array
+ * quando necessário. Termina o programa se não houver memória.
+ */
+
+static void anexar (saidaT *saida, const char *texto, size_t n)
+{
+    if (saida->texto != NULL && n > 0)
+    {
+        if (saida->tamanho + n > saida->capacidade)
+        {
+            size_t nova = saida->capacidade;
+            while (nova < saida->tamanho + n)
+                nova *= 2;
+
+            char *maior = realloc(saida->texto, nova);
+            if (maior == NULL)
+            {
+                fprintf(stderr, "Erro: impossível alocar texto substituído.\n");
+                exit(1);
+            }
+            saida->texto = maior;
+            saida->capacidade = nova;
+        }
+        memcpy(saida->texto + saida->tamanho, texto, n);
+    }
+    saida->tamanho += n;
+}
+
+/**
+ * PREDICADO: cabe
+ * Uso: if (cabe(stack, n)) . . .
+ * ------------------------------
+ * Retorna TRUE se a pilha comporta "n" elementos (uma pilha de tamanho 0 não
+ * tem limite).
+ */
+
+static bool cabe (stackTAD stack, size_t n)
+{
+    long int limite = tamanho(stack);
+
+    return limite == 0 || n <= (size_t) limite;
+}
+
+/**
+ * FUNÇÕES: avancar_ate, recuar_ate
+ * Uso: p = avancar_ate(buffer, posicao, classe);
+ *      p = recuar_ate(buffer, posicao, classe);
+ * ----------------------------------------------
+ * "avancar_ate" retorna a posição do primeiro caractere da classe a partir de
+ * "posicao" (ou o tamanho do buffer, se não houver um); "recuar_ate" retorna a
+ * posição logo após o último caractere da classe antes de "posicao" (ou 0). Os
+ * caracteres depois do cursor estão na pilha "depois" em ordem inversa, de
+ * modo que as duas buscas percorrem o array de uma das pilhas de cima para
+ * baixo.
+ */
+
+static size_t avancar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    size_t nantes = qtd_rapida(buffer->antes);
+    size_t total = nantes + qtd_rapida(buffer->depois);
+
+    for (; posicao < nantes; posicao++)
+        if (pertence(ver_rapido(buffer->antes, posicao), classe))
+            return posicao;
+    for (; posicao < total; posicao++)
+        if (pertence(ver_rapido(buffer->depois, total - 1 - posicao), classe))
+            return posicao;
+    return total;
+}
+
+static size_t recuar_ate (bufferTAD buffer, size_t posicao, classeT classe)
+{
+    size_t nantes = qtd_rapida(buffer->antes);
+    size_t total = nantes + qtd_rapida(buffer->depois);
+
+    for (; posicao > nantes; posicao--)
+        if (pertence(ver_rapido(buffer->depois, total - posicao), classe))
+            return posicao;
+    for (; posicao > 0; posicao--)
+        if (pertence(ver_rapido(buffer->antes, posicao - 1), classe))
+            return posicao;
+    return 0;
+}
+
+/**
+ * PREDICADO: pertence
+ * Uso: if (pertence(c, classe)) . . .
+ * -----------------------------------
+ * Retorna TRUE se o caractere "c" é da classe "classe". Os caracteres de
+ * palavra são testados por intervalos, sem consultar a localidade, para que os
+ * laços de busca fiquem simples o bastante para serem vetorizados.
+ */
+
+static bool pertence (char c, classeT classe)
+{
+    unsigned char u = (unsigned char) c;
+    bool palavra = (unsigned) ((u | 0x20) - 'a') < 26 ||
+                   (unsigned) (u - '0') < 10 || u == '_' || u >= 0x80;
+
+    switch (classe)
+    {
+    case QUEBRA: return c == '\n';
+    case TEXTO: return c != '\n';
+    case PALAVRA: return palavra;
+    default: return !palavra;
+    }
+}
+
+/**
+ * PREDICADO: registrar
+ * Uso: if (registrar(buffer, texto, n, apagar)) return;
+ * -----------------------------------------------------
+ * Se há uma transação aberta, registra nela a inserção dos "n" caracteres de
+ * "texto" ou a remoção de "apagar" caracteres após o cursor e retorna TRUE;
+ * senão, retorna FALSE, e a edição deve ser feita no buffer.
+ */
+
+static bool registrar (bufferTAD buffer, const char *texto, size_t n,
+                       size_t apagar)
+{
+    if (buffer->transacao == NULL)
+        return FALSE;
+
+    sincronizar_transacao(buffer->transacao, tamanho_buffer(buffer),
+                          posicao_cursor(buffer));
+    if (n > 0 ? !registrar_insercao(buffer->transacao, texto, n)
+              : !registrar_remocao(buffer->transacao, apagar))
+        fprintf(stderr, "Erro: impossível registrar a edição.\n");
+    return TRUE;
+}
+
+/**
+ * PREDICADO: mover_na_transacao
+ * Uso: if (mover_na_transacao(buffer, posicao)) return;
+ * -----------------------------------------------------
+ * Se há edições pendentes, move o cursor da transação e retorna TRUE; senão,
+ * retorna FALSE, e o cursor do buffer deve ser movido.
+ */
+
+static bool mover_na_transacao (bufferTAD buffer, size_t posicao)
+{
+    if (!transacao_pendente(buffer->transacao))
+        return FALSE;
+
+    mover_cursor_da_transacao(buffer->transacao, posicao);
+    return TRUE;
+}
+
+/**
+ * PROCEDIMENTO: aplicar_pendentes
+ * Uso: aplicar_pendentes(buffer);
+ * -------------------------------
+ * Aplica as edições pendentes da transação, se houver, com aplicar_trechos:
+ * um trecho por vez, em ordem de posição. A transação é desligada do buffer
+ * durante a aplicação, para que as operações não sejam registradas de novo.
+ */
+
+static void aplicar_pendentes (bufferTAD buffer)
+{
+    transacaoTAD transacao = buffer->transacao;
+    if (!transacao_pendente(transacao))
+        return;
+
+    buffer->transacao = NULL;
+    aplicar_trechos(transacao, buffer);
+    buffer->transacao = transacao;
+}
@@ -0,0 +1,213 @@
+/**
+ * Arquivo: stackrapido.h
+ * Versão : 1.2
+ * Data   : 2026-10-19 02:20
+ * -------------------------
+ * Este arquivo define uma camada opcional, apenas de cabeçalho, com versões
+ * inline das operações de stackTAD.h que são chamadas uma vez por caractere
+ * (push, pop, vazia, cheia, qtd_elementos e ver_elemento). Ela é usada pelos
+ * laços internos de stackbuff.c, nos quais uma chamada de função e as
+ * verificações repetidas de stackTAD.c custam mais do que a própria operação.
+ *
+ * As operações rápidas NÃO verificam nada: cabe a quem chama garantir que o
+ * stack existe, que não está cheio antes de um push, que não está vazio antes
+ * de um pop e que a posição de ver_rapido é válida. Nos programas compilados
+ * com -Ddebug (o MODO padrão da Makefile) as verificações são compiladas e
+ * terminam o programa com uma mensagem de erro; no MODO=producao cada operação
+ * se reduz a um acesso ao array. A interface stackTAD.h, com as verificações,
+ * continua sendo a padrão para os demais clientes.
+ *
+ * Como as funções precisam conhecer a representação do stack, a definição do
+ * stackTCD fica neste arquivo, e não em stackTAD.c. Os clientes comuns do
+ * stackTAD não devem incluir este arquivo.
+ *
+ * As outras representações do stackTAD (stackTAD2.c, com um array que cresce,
+ * e stackTAD3.c, com blocos encadeados) não estão neste arquivo. Um programa
+ * compilado para usar uma delas (com -Dstack_dinamico ou -Dstack_blocos; veja
+ * a variável STACK da Makefile) continua podendo chamar as operações rápidas,
+ * mas elas passam a ser apenas outros nomes para as operações verificadas.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicialização do Boilerplate da Interface: ***/
+
+#ifndef _STACKRAPIDO_H
+#define _STACKRAPIDO_H
+
+/*** Includes: ***/
+
+#include "genlib.h"
+#include "stackTAD.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(stack_dinamico) || defined(stack_blocos)
+
+/*** Operações Rápidas Sem Representação Conhecida: ***/
+
+#define push_rapido push
+#define pop_rapido pop
+#define vazia_rapida vazia
+#define cheia_rapida cheia
+#define qtd_rapida(S) ((size_t) qtd_elementos(S))
+#define ver_rapido(S, P) ver_elemento((S), (size_t) (P))
+
+#else
+
+/*** Constantes Simbólicas: ***/
+
+/**
+ * CONSTANTE: TAMMAX
+ * -----------------
+ * Esta constante especifica o tamanho máximo de espaço a ser alocado para o
+ * array que armazenará os elementos do stack. Se o usuário fizer um push de
+ * elementos além deste limite, receberá um erro. Se TAMMAX estiver definido
+ * como 0 (zero), indica que o array é dinâmico e não tem tamanho máximo
+ * limitante.
+ */
+
+#define TAMMAX 1000
+
+/*** Tipos de Dados: ***/
+
+/**
+ * TIPO: stackTCD
+ * --------------
+ * O tipo stackTCD é a representação concreta do tipo abstrato de dado stackTAD
+ * definido na interface. Nesta implementação os elementos serão armazenados em
+ * um array. A variável inteira "contagem" manterá o número atual de elementos
+ * no stack.
+ */
+
+struct stackTCD
+{
+    elementoT dados[TAMMAX];
+    size_t contagem;
+};
+
+/*** Definições de Subprogramas: ***/
+
+/**
+ * PROCEDIMENTO: push_rapido
+ * Uso: push_rapido(stack, elemento);
+ * ----------------------------------
+ * Coloca o elemento no topo do stack, que não pode estar cheio.
+ */
+
+static inline void push_rapido (stackTAD stack, elementoT elemento)
+{
+#ifdef debug
+    if (stack == NULL || stack->contagem == TAMMAX)
+    {
+        fprintf(stderr, "Erro: push_rapido em stack null ou cheio.\n");
+        exit(1);
+    }
+#endif
+    stack->dados[stack->contagem++] = elemento;
+}
+
+/**
+ * FUNÇÃO: pop_rapido
+ * Uso: elemento = pop_rapido(stack);
+ * ----------------------------------
+ * Retira e retorna o elemento do topo do stack, que não pode estar vazio.
+ */
+
+static inline elementoT pop_rapido (stackTAD stack)
+{
+#ifdef debug
+    if (stack == NULL || stack->contagem == 0)
+    {
+        fprintf(stderr, "Erro: pop_rapido em stack null ou vazio.\n");
+        exit(1);
+    }
+#endif
+    return stack->dados[--stack->contagem];
+}
+
+/**
+ * PREDICADOS: vazia_rapida, cheia_rapida
+ * Uso: if (vazia_rapida(stack)) . . .
+ *      if (cheia_rapida(stack)) . . .
+ * --------------------------------------
+ * Retornam TRUE se o stack está vazio ou cheio, respectivamente.
+ */
+
+static inline bool vazia_rapida (stackTAD stack)
+{
+#ifdef debug
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: vazia_rapida em stack null.\n");
+        exit(1);
+    }
+#endif
+    return stack->contagem == 0;
+}
+
+static inline bool cheia_rapida (stackTAD stack)
+{
+#ifdef debug
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: cheia_rapida em stack null.\n");
+        exit(1);
+    }
+#endif
+    return stack->contagem == TAMMAX;
+}
+
+/**
+ * FUNÇÃO: qtd_rapida
+ * Uso: n = qtd_rapida(stack);
+ * ---------------------------
+ * Retorna a quantidade de elementos do stack.
+ */
+
+static inline size_t qtd_rapida (stackTAD stack)
+{
+#ifdef debug
+    if (stack == NULL)
+    {
+        fprintf(stderr, "Erro: qtd_rapida em stack null.\n");
+        exit(1);
+    }
+#endif
+    return stack->contagem;
+}
+
+/**
+ * FUNÇÃO: ver_rapido
+ * Uso: elemento = ver_rapido(stack, posicao);
+ * -------------------------------------------
+ * Retorna o elemento da posição "posicao" (0 é a base do stack), que deve ser
+ * menor do que a quantidade de elementos.
+ */
+
+static inline elementoT ver_rapido (stackTAD stack, size_t posicao)
+{
+#ifdef debug
+    if (stack == NULL || posicao >= stack->contagem)
+    {
+        fprintf(stderr, "Erro: ver_rapido em stack null ou posição "
+                "inválida.\n");
+        exit(1);
+    }
+#endif
+    return stack->dados[posicao];
+}
+
+#endif
+
+/*** Finalização do Bolierplate da Interface: ***/
+
+#endif
@@ -0,0 +1,1186 @@
+/**
+ * Arquivo: tela.c
+ * Versão : 1.1
+ * Data   : 2026-10-18 20:20
+ * -------------------------
+ * Este arquivo implementa a interface tela.h. A tela guarda dois quadros de
+ * células: o que está no terminal ("anterior") e o que deve estar ("atual").
+ * A cada desenho o quadro atual é montado a partir do buffer e comparado com
+ * o anterior em três etapas:
+ *
+ *     1) se um bloco de linhas do texto apenas desceu ou subiu (uma quebra de
+ *        linha foi inserida ou apagada), as linhas são inseridas ou apagadas
+ *        no terminal (IL/DL), sem reescrever o que foi deslocado;
+ *     2) em cada linha, se o resto da linha apenas andou para a direita ou
+ *        para a esquerda (caracteres inseridos ou apagados), os caracteres são
+ *        inseridos ou apagados no terminal (ICH/DCH);
+ *     3) as células que ainda diferem são reescritas, e o final de uma linha
+ *        que ficou em branco é apagado de uma vez (EL).
+ *
+ * Cada etapa aplica a mesma mudança ao quadro anterior, de modo que ele sempre
+ * reflete o conteúdo do terminal. Toda a saída de um desenho é acumulada e
+ * enviada com uma única escrita.
+ *
+ * O quadro mostra apenas uma janela do buffer em volta do cursor: a posição
+ * do início da primeira linha exibida ("topo") e a primeira coluna exibida
+ * são mantidas entre os desenhos, e só mudam quando o cursor sai da janela.
+ * As linhas da janela são encontradas a partir do topo (ou, quando o cursor
+ * saiu da janela, procurando quebras de linha para trás a partir do cursor),
+ * e apenas a parte visível de cada linha é copiada do buffer. Para que esse
+ * trabalho não dependa do tamanho do buffer nem mesmo com linhas enormes,
+ * uma linha com mais de MAXLINHA caracteres é exibida como várias.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include "tela.h"
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: LINHAS_COMANDO, MINLINHAS, MINCOLUNAS
+ * -------------------------------------------------
+ * Quantidade de linhas do terminal reservadas para os comandos (abaixo da
+ * linha de estado) e o menor terminal aceito.
+ */
+
+#define LINHAS_COMANDO 5
+#define MINLINHAS (LINHAS_COMANDO + 3)
+#define MINCOLUNAS 20
+
+/**
+ * CONSTANTE: TAMLEITURA
+ * ---------------------
+ * Quantidade de caracteres copiados do buffer de cada vez.
+ */
+
+#define TAMLEITURA 4096
+
+/**
+ * CONSTANTE: MAXLINHA
+ * -------------------
+ * Quantidade máxima de caracteres de uma linha exibida; as linhas mais longas
+ * do buffer são quebradas a cada MAXLINHA caracteres.
+ */
+
+#define MAXLINHA 1024
+
+/**
+ * CONSTANTE: COLUNAS_PADRAO
+ * -------------------------
+ * Largura da janela de "exibir_janela" quando nenhuma é informada: como cada
+ * caractere ocupa duas colunas, cabe em um terminal de 80 colunas.
+ */
+
+#define COLUNAS_PADRAO 38
+
+/**
+ * CONSTANTE: INTERVALO_MINIMO
+ * ---------------------------
+ * Quantidade de células iguais entre duas células diferentes a partir da qual
+ * compensa reposicionar o cursor do terminal em vez de reescrevê-las.
+ */
+
+#define INTERVALO_MINIMO 4
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: celulaT
+ * -------------
+ * Uma célula do terminal: os bytes do caractere (até 4, em UTF-8), quantos
+ * bytes são usados e se a célula está em vídeo reverso (o cursor do buffer).
+ */
+
+typedef struct
+{
+    char bytes[4];
+    unsigned char tamanho;
+    unsigned char inverso;
+} celulaT;
+
+/**
+ * Tipo: janelaT
+ * -------------
+ * Uma janela de "linhas" linhas e "colunas" colunas sobre o buffer: a posição
+ * do início da primeira linha ("topo"), a primeira coluna exibida e, depois
+ * de enquadrada, as "n" linhas encontradas (onde cada uma começa, onde termina
+ * o seu texto e onde começa a próxima) e a linha e coluna do cursor.
+ */
+
+typedef struct
+{
+    int linhas;
+    int colunas;
+    size_t topo;
+    size_t coluna;
+    size_t *inicios;
+    size_t *fins;
+    size_t *proximos;
+    int n;
+    int lin_cursor;
+    size_t col_cursor;
+} janelaT;
+
+/**
+ * Tipo: telaTCD
+ * -------------
+ * O terminal ("saida", com "altura" linhas de "largura" colunas), a janela
+ * exibida nas linhas de cima (a linha seguinte é a de estado) e o seu tamanho
+ * ("linhas" por "colunas"), os dois quadros, os hashes de cada linha de texto
+ * dos dois quadros, a saída do desenho em andamento, a posição do cursor do
+ * terminal (linha -1 se desconhecida), se o vídeo reverso está ligado e as
+ * métricas.
+ */
+
+struct telaTCD
+{
+    FILE *saida;
+    int altura;
+    int largura;
+    janelaT janela;
+    int linhas;
+    int colunas;
+    celulaT *anterior;
+    celulaT *atual;
+    unsigned long *hash_anterior;
+    unsigned long *hash_atual;
+    char *texto;
+    size_t usados;
+    size_t capacidade;
+    int lin;
+    int col;
+    bool invertido;
+    metricas_telaT metricas;
+};
+
+/*** Declarações de Subprogramas Privados ***/
+
+static void medir_terminal (FILE *saida, int *altura, int *colunas);
+static bool preparar_terminal (telaTAD tela);
+static bool alocar_janela (janelaT *janela);
+static void liberar_janela (janelaT *janela);
+static void enquadrar (janelaT *janela, bufferTAD buffer, bool manter);
+static void percorrer_linhas (janelaT *janela, bufferTAD buffer,
+                              size_t tamanho);
+static int achar_cursor (janelaT *janela, size_t cursor);
+static size_t recuar_linhas (bufferTAD buffer, size_t posicao, int n);
+static size_t contar_colunas (bufferTAD buffer, size_t inicio, size_t fim);
+static size_t ler_linha (janelaT *janela, bufferTAD buffer, int lin,
+                         char destino[]);
+static void montar_quadro (telaTAD tela, bufferTAD buffer);
+static void escrever_estado (telaTAD tela, size_t cursor, size_t tamanho);
+static void colocar (telaTAD tela, int lin, int *col, char c);
+static void limpar_celulas (celulaT *celulas, int n);
+static bool iguais (const celulaT *a, const celulaT *b);
+static bool mesmo_texto (const celulaT *a, const celulaT *b, int n);
+static bool em_branco (const celulaT *celulas, int n);
+static unsigned long hash_linha (const celulaT *celulas, int n);
+static void deslocar_linhas (telaTAD tela);
+static void deslocar_colunas (telaTAD tela, int lin);
+static void atualizar_linha (telaTAD tela, int lin);
+static void mover (telaTAD tela, int lin, int col);
+static void normal (telaTAD tela);
+static void emitir_celula (telaTAD tela, const celulaT *celula);
+static void emitir (telaTAD tela, const char *s, size_t n);
+static void emitir_formato (telaTAD tela, const char *formato, ...);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: criar_tela
+ * Uso: tela = criar_tela(saida);
+ * ------------------------------
+ * Mede o terminal e o prepara com a maior janela possível.
+ */
+
+telaTAD criar_tela (FILE *saida)
+{
+    int altura, largura;
+
+    medir_terminal(saida, &altura, &largura);
+    if (altura < MINLINHAS || largura < MINCOLUNAS)
+    {
+        fprintf(stderr, "Erro: terminal pequeno demais (%dx%d).\n", altura,
+                largura);
+        return NULL;
+    }
+
+    telaTAD T = calloc(1, sizeof(struct telaTCD));
+    if (T == NULL)
+    {
+        fprintf(stderr, "Erro: impossível alocar a tela.\n");
+        return NULL;
+    }
+    T->saida = saida;
+    T->altura = altura;
+    T->largura = largura;
+    T->linhas = altura - LINHAS_COMANDO - 1;
+    T->colunas = largura;
+
+    if (!preparar_terminal(T))
+    {
+        liberar_tela(&T);
+        return NULL;
+    }
+
+    return T;
+}
+
+/**
+ * Procedimento: liberar_tela
+ * Uso: liberar_tela(&tela);
+ * -------------------------
+ * Devolve a rolagem ao terminal inteiro, põe o cursor do terminal na última
+ * linha e libera a memória.
+ */
+
+void liberar_tela (telaTAD *tela)
+{
+    if (tela == NULL || *tela == NULL)
+        return;
+
+    telaTAD T = *tela;
+    if (T->anterior != NULL)
+    {
+        fprintf(T->saida, "\x1b[m\x1b[r\x1b[%d;1H\n", T->altura);
+        fflush(T->saida);
+    }
+
+    free(T->anterior);
+    free(T->atual);
+    free(T->hash_anterior);
+    free(T->hash_atual);
+    free(T->texto);
+    liberar_janela(&T->janela);
+    free(T);
+    *tela = NULL;
+}
+
+/**
+ * Procedimento: configurar_janela
+ * Uso: configurar_janela(tela, linhas, colunas);
+ * ----------------------------------------------
+ * Ajusta o tamanho pedido ao terminal e prepara o terminal novamente, pois as
+ * linhas de comando mudam de lugar.
+ */
+
+void configurar_janela (telaTAD tela, int linhas, int colunas)
+{
+    if (tela == NULL)
+    {
+        fprintf(stderr, "Erro: configuração de tela null.\n");
+        exit(1);
+    }
+
+    int maximo = tela->altura - LINHAS_COMANDO - 1;
+    tela->linhas = linhas > 0 && linhas < maximo ? linhas : maximo;
+    tela->colunas = colunas > 0 && colunas < tela->largura ? colunas
+                                                           : tela->largura;
+    if (!preparar_terminal(tela))
+    {
+        fprintf(stderr, "Erro: impossível alocar a tela.\n");
+        exit(1);
+    }
+}
+
+/**
+ * Procedimento: desenhar_buffer
+ * Uso: desenhar_buffer(tela, buffer);
+ * -----------------------------------
+ * Monta o quadro atual e emite as diferenças entre os quadros, entre um
+ * "salvar cursor" e um "restaurar cursor" (DECSC/DECRC), para que o cursor do
+ * terminal volte para a linha de comandos. Se nada mudou, nada é escrito.
+ */
+
+void desenhar_buffer (telaTAD tela, bufferTAD buffer)
+{
+    if (tela == NULL || buffer == NULL)
+    {
+        fprintf(stderr, "Erro: tela ou buffer null.\n");
+        exit(1);
+    }
+
+    montar_quadro(tela, buffer);
+
+    tela->usados = 0;
+    tela->lin = -1;
+    tela->invertido = FALSE;
+    emitir(tela, "\x1b" "7", 2);
+    size_t inicio = tela->usados;
+
+    deslocar_linhas(tela);
+    for (int lin = 0; lin <= tela->linhas; lin++)
+        atualizar_linha(tela, lin);
+
+    if (tela->usados == inicio)
+        tela->usados = 0;
+    else
+    {
+        normal(tela);
+        emitir(tela, "\x1b" "8", 2);
+        fwrite(tela->texto, 1, tela->usados, tela->saida);
+        fflush(tela->saida);
+    }
+
+    tela->metricas.desenhos++;
+    tela->metricas.bytes += tela->usados;
+    tela->metricas.bytes_ultimo = tela->usados;
+
+    celulaT *quadro = tela->anterior;
+    tela->anterior = tela->atual;
+    tela->atual = quadro;
+}
+
+/**
+ * Procedimento: obter_metricas_tela
+ * Uso: obter_metricas_tela(tela, &m);
+ * -----------------------------------
+ * Copia as métricas mantidas pela tela.
+ */
+
+void obter_metricas_tela (telaTAD tela, metricas_telaT *metricas)
+{
+    if (tela == NULL || metricas == NULL)
+    {
+        fprintf(stderr, "Erro: tela ou métricas null.\n");
+        exit(1);
+    }
+
+    *metricas = tela->metricas;
+}
+
+/**
+ * Procedimento: exibir_janela
+ * Uso: exibir_janela(buffer, linhas, colunas);
+ * --------------------------------------------
+ * Enquadra uma janela centrada no cursor e a exibe no formato de
+ * exibir_buffer: cada caractere precedido de um espaço e, abaixo da linha do
+ * cursor, uma linha com o '^'.
+ */
+
+void exibir_janela (bufferTAD buffer, int linhas, int colunas)
+{
+    janelaT janela = {0};
+    char texto[MAXLINHA];
+
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Erro: exibição de buffer null.\n");
+        exit(1);
+    }
+
+    janela.linhas = linhas > 0 ? linhas : 1;
+    janela.colunas = colunas > 0 ? colunas : COLUNAS_PADRAO;
+    if (!alocar_janela(&janela))
+    {
+        fprintf(stderr, "Erro: impossível alocar a janela.\n");
+        return;
+    }
+    enquadrar(&janela, buffer, FALSE);
+
+    for (int lin = 0; lin < janela.n; lin++)
+    {
+        size_t n = ler_linha(&janela, buffer, lin, texto);
+        size_t col = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            unsigned char u = (unsigned char) texto[i];
+            bool continuacao = (u & 0xC0) == 0x80 && i > 0;
+            if (!continuacao)
+                col++;
+            if (col <= janela.coluna || col > janela.coluna + janela.colunas)
+                continue;
+            else if (continuacao)
+                putchar(texto[i]);
+            else
+                printf(" %c", u == '\t' ? ' ' : u < 32 || u == 127 ? '?' :
+                              texto[i]);
+        }
+        printf("\n");
+
+        if (lin == janela.lin_cursor)
+        {
+            for (size_t i = janela.coluna; i < janela.col_cursor; i++)
+                printf("  ");
+            printf("^\n");
+        }
+    }
+
+    liberar_janela(&janela);
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Procedimento: medir_terminal
+ * Uso: medir_terminal(saida, &altura, &colunas);
+ * ----------------------------------------------
+ * Obtém o tamanho do terminal ligado a "saida"; se "saida" não for um
+ * terminal, usa as variáveis de ambiente LINES e COLUMNS ou, na falta delas,
+ * 24 linhas de 80 colunas.
+ */
+
+static void medir_terminal (FILE *saida, int *altura, int *colunas)
+{
+    struct winsize ws;
+
+    if (ioctl(fileno(saida), TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 &&
+        ws.ws_col > 0)
+    {
+        *altura = ws.ws_row;
+        *colunas = ws.ws_col;
+        return;
+    }
+
+    char *linhas = getenv("LINES");
+    char *cols = getenv("COLUMNS");
+    *altura = linhas != NULL ? atoi(linhas) : 24;
+    *colunas = cols != NULL ? atoi(cols) : 80;
+}
+
+/**
+ * Função: preparar_terminal
+ * Uso: if (preparar_terminal(tela)) . . .
+ * ---------------------------------------
+ * (Re)aloca os quadros e a janela para o tamanho atual, com o quadro anterior
+ * em branco, pois o terminal é limpo; depois limpa o terminal, restringe a
+ * rolagem às linhas abaixo da linha de estado e põe o cursor do terminal na
+ * última linha. Retorna FALSE se não houver memória.
+ */
+
+static bool preparar_terminal (telaTAD tela)
+{
+    size_t celulas = (size_t) (tela->linhas + 1) * tela->colunas;
+
+    free(tela->anterior);
+    free(tela->atual);
+    free(tela->hash_anterior);
+    free(tela->hash_atual);
+    liberar_janela(&tela->janela);
+
+    tela->anterior = malloc(celulas * sizeof(celulaT));
+    tela->atual = malloc(celulas * sizeof(celulaT));
+    tela->hash_anterior = malloc(tela->linhas * sizeof(unsigned long));
+    tela->hash_atual = malloc(tela->linhas * sizeof(unsigned long));
+    tela->janela.linhas = tela->linhas;
+    tela->janela.colunas = tela->colunas;
+    tela->janela.topo = tela->janela.coluna = 0;
+    if (tela->anterior == NULL || tela->atual == NULL ||
+        tela->hash_anterior == NULL || tela->hash_atual == NULL ||
+        !alocar_janela(&tela->janela))
+    {
+        fprintf(stderr, "Erro: impossível alocar a tela.\n");
+        return FALSE;
+    }
+    limpar_celulas(tela->anterior, (int) celulas);
+
+    tela->usados = 0;
+    emitir_formato(tela, "\x1b[m\x1b[2J\x1b[%d;%dr\x1b[%d;1H",
+                   tela->linhas + 2, tela->altura, tela->altura);
+    fwrite(tela->texto, 1, tela->usados, tela->saida);
+    fflush(tela->saida);
+    tela->usados = 0;
+
+    return TRUE;
+}
+
+/**
+ * Função: alocar_janela
+ * Uso: if (alocar_janela(&janela)) . . .
+ * --------------------------------------
+ * Aloca os arrays das linhas de uma janela com o tamanho já preenchido.
+ * Retorna FALSE se não houver memória.
+ */
+
+static bool alocar_janela (janelaT *janela)
+{
+    janela->inicios = malloc(janela->linhas * sizeof(size_t));
+    janela->fins = malloc(janela->linhas * sizeof(size_t));
+    janela->proximos = malloc(janela->linhas * sizeof(size_t));
+    janela->n = 0;
+
+    return janela->inicios != NULL && janela->fins != NULL &&
+           janela->proximos != NULL;
+}
+
+/**
+ * Procedimento: liberar_janela
+ * Uso: liberar_janela(&janela);
+ * -----------------------------
+ * Libera os arrays das linhas de uma janela.
+ */
+
+static void liberar_janela (janelaT *janela)
+{
+    free(janela->inicios);
+    free(janela->fins);
+    free(janela->proximos);
+    janela->inicios = janela->fins = janela->proximos = NULL;
+}
+
+/**
+ * Procedimento: enquadrar
+ * Uso: enquadrar(&janela, buffer, manter);
+ * ----------------------------------------
+ * Encontra as linhas da janela e a linha e a coluna do cursor. Se "manter"
+ * for TRUE, a janela só se move o necessário para que o cursor continue
+ * visível: se o cursor subiu acima do topo, a linha do cursor passa a ser a
+ * primeira; se desceu abaixo da última linha, passa a ser a última (ou, se
+ * houver linhas longas no caminho, a primeira). Se for FALSE, a janela é
+ * centrada no cursor. A coluna exibida segue a mesma regra.
+ */
+
+static void enquadrar (janelaT *janela, bufferTAD buffer, bool manter)
+{
+    size_t tamanho = tamanho_buffer(buffer);
+    size_t cursor = posicao_cursor(buffer);
+
+    if (!manter || janela->topo > cursor)
+        janela->topo = recuar_linhas(buffer, cursor,
+                                     manter ? 0 : janela->linhas / 2);
+    percorrer_linhas(janela, buffer, tamanho);
+    int lin = achar_cursor(janela, cursor);
+    if (lin < 0)
+    {
+        janela->topo = recuar_linhas(buffer, cursor, janela->linhas - 1);
+        percorrer_linhas(janela, buffer, tamanho);
+        lin = achar_cursor(janela, cursor);
+    }
+    if (lin < 0)
+    {
+        janela->topo = recuar_linhas(buffer, cursor, 0);
+        percorrer_linhas(janela, buffer, tamanho);
+        lin = achar_cursor(janela, cursor);
+    }
+    if (lin < 0)
+        lin = 0;
+
+    size_t col = contar_colunas(buffer, janela->inicios[lin], cursor);
+    size_t largura = (size_t) janela->colunas;
+    if (!manter)
+        janela->coluna = col >= largura ? col - largura / 2 : 0;
+    else if (col < janela->coluna)
+        janela->coluna = col;
+    else if (col >= janela->coluna + largura)
+        janela->coluna = col - largura + 1;
+
+    janela->lin_cursor = lin;
+    janela->col_cursor = col;
+}
+
+/**
+ * Procedimento: percorrer_linhas
+ * Uso: percorrer_linhas(&janela, buffer, tamanho);
+ * ------------------------------------------------
+ * Encontra, a partir do topo, até "linhas" linhas da janela, procurando as
+ * quebras de linha com memchr em pedaços copiados do buffer. Uma linha termina
+ * em uma quebra de linha (e a próxima começa depois dela), no final do buffer
+ * (e não há próxima: "proximos" recebe tamanho + 1) ou depois de MAXLINHA
+ * caracteres (e a próxima começa ali mesmo).
+ */
+
+static void percorrer_linhas (janelaT *janela, bufferTAD buffer,
+                              size_t tamanho)
+{
+    char bloco[TAMLEITURA];
+    size_t base = 0, lidos = 0;
+    size_t pos = janela->topo;
+
+    janela->n = 0;
+    while (janela->n < janela->linhas)
+    {
+        size_t limite = pos + MAXLINHA < tamanho ? pos + MAXLINHA : tamanho;
+        size_t q = pos;
+        bool quebra = FALSE;
+        while (q < limite && !quebra)
+        {
+            if (q < base || q >= base + lidos)
+            {
+                base = q;
+                lidos = copiar_texto(buffer, q, TAMLEITURA, bloco);
+                if (lidos == 0)
+                    break;
+            }
+            size_t fim = base + lidos < limite ? base + lidos : limite;
+            char *achado = memchr(bloco + (q - base), '\n', fim - q);
+            quebra = achado != NULL;
+            q = quebra ? base + (size_t) (achado - bloco) : fim;
+        }
+
+        int i = janela->n++;
+        janela->inicios[i] = pos;
+        janela->fins[i] = q;
+        janela->proximos[i] = quebra ? q + 1 : q >= tamanho ? tamanho + 1 : q;
+        if (janela->proximos[i] > tamanho)
+            break;
+        pos = janela->proximos[i];
+    }
+}
+
+/**
+ * Função: achar_cursor
+ * Uso: lin = achar_cursor(&janela, cursor);
+ * -----------------------------------------
+ * Retorna a linha da janela que contém a posição "cursor", ou -1 se o cursor
+ * está fora da janela.
+ */
+
+static int achar_cursor (janelaT *janela, size_t cursor)
+{
+    for (int i = 0; i < janela->n; i++)
+        if (janela->inicios[i] <= cursor && cursor < janela->proximos[i])
+            return i;
+
+    return -1;
+}
+
+/**
+ * Função: recuar_linhas
+ * Uso: inicio = recuar_linhas(buffer, posicao, n);
+ * ------------------------------------------------
+ * Retorna o início da linha que fica "n" linhas acima da linha que contém
+ * "posicao", procurando quebras de linha para trás em pedaços copiados do
+ * buffer. Cada linha é considerada com no máximo MAXLINHA - 1 caracteres,
+ * para que a busca nunca leia mais do que "n" + 1 linhas desse tamanho.
+ */
+
+static size_t recuar_linhas (bufferTAD buffer, size_t posicao, int n)
+{
+    char bloco[TAMLEITURA];
+    size_t comprimento = 0;
+    int achadas = 0;
+
+    while (posicao > 0)
+    {
+        size_t base = posicao > TAMLEITURA ? posicao - TAMLEITURA : 0;
+        size_t lidos = copiar_texto(buffer, base, posicao - base, bloco);
+        for (size_t i = lidos; i > 0; i--)
+        {
+            bool quebra = bloco[i - 1] == '\n';
+            if (!quebra && ++comprimento < MAXLINHA - 1)
+                continue;
+            else if (achadas == n)
+                return quebra ? base + i : base + i - 1;
+            achadas++;
+            comprimento = 0;
+        }
+        posicao = base;
+    }
+
+    return 0;
+}
+
+/**
+ * Função: contar_colunas
+ * Uso: col = contar_colunas(buffer, inicio, fim);
+ * -----------------------------------------------
+ * Retorna em quantas colunas são exibidos os caracteres entre as posições
+ * "inicio" e "fim", sendo "inicio" o começo de uma linha: os bytes de
+ * continuação de UTF-8 não contam, exceto no começo da linha, onde aparecem
+ * como '?'.
+ */
+
+static size_t contar_colunas (bufferTAD buffer, size_t inicio, size_t fim)
+{
+    char bloco[TAMLEITURA];
+    size_t colunas = 0;
+    bool primeiro = TRUE;
+
+    while (inicio < fim)
+    {
+        size_t n = fim - inicio < TAMLEITURA ? fim - inicio : TAMLEITURA;
+        size_t lidos = copiar_texto(buffer, inicio, n, bloco);
+        if (lidos == 0)
+            break;
+        for (size_t i = 0; i < lidos; i++, primeiro = FALSE)
+            colunas += ((unsigned char) bloco[i] & 0xC0) != 0x80 || primeiro;
+        inicio += lidos;
+    }
+
+    return colunas;
+}
+
+/**
+ * Função: ler_linha
+ * Uso: n = ler_linha(&janela, buffer, lin, destino);
+ * --------------------------------------------------
+ * Copia para "destino" o texto da linha "lin" da janela (sem a quebra de
+ * linha) até a última coluna visível: no máximo 4 bytes (o maior caractere
+ * UTF-8) por coluna. Retorna quantos bytes foram copiados, nunca mais do que
+ * MAXLINHA.
+ */
+
+static size_t ler_linha (janelaT *janela, bufferTAD buffer, int lin,
+                         char destino[])
+{
+    size_t inicio = janela->inicios[lin];
+    size_t n = janela->fins[lin] - inicio;
+    size_t visivel = 4 * (janela->coluna + (size_t) janela->colunas);
+
+    return copiar_texto(buffer, inicio, n < visivel ? n : visivel, destino);
+}
+
+/**
+ * Procedimento: montar_quadro
+ * Uso: montar_quadro(tela, buffer);
+ * ---------------------------------
+ * Enquadra a janela, mantendo-a onde estava se o cursor continua visível, e
+ * monta no quadro atual a parte visível de cada uma das suas linhas; depois
+ * marca a célula do cursor e escreve a linha de estado.
+ */
+
+static void montar_quadro (telaTAD tela, bufferTAD buffer)
+{
+    janelaT *janela = &tela->janela;
+    char texto[MAXLINHA];
+
+    limpar_celulas(tela->atual, (tela->linhas + 1) * tela->colunas);
+    enquadrar(janela, buffer, TRUE);
+
+    for (int lin = 0; lin < janela->n; lin++)
+    {
+        size_t n = ler_linha(janela, buffer, lin, texto);
+        int col = -(int) janela->coluna;
+        for (size_t i = 0; i < n; i++)
+            colocar(tela, lin, &col, i == 0 && ((unsigned char) texto[i] &
+                                                0xC0) == 0x80 ? '?' : texto[i]);
+    }
+
+    size_t col = janela->col_cursor - janela->coluna;
+    tela->atual[janela->lin_cursor * tela->colunas + col].inverso = 1;
+
+    escrever_estado(tela, posicao_cursor(buffer), tamanho_buffer(buffer));
+}
+
+/**
+ * Procedimento: escrever_estado
+ * Uso: escrever_estado(tela, cursor, tamanho);
+ * --------------------------------------------
+ * Escreve a linha de estado, abaixo do texto: a posição do cursor e o tamanho
+ * do buffer, entre traços.
+ */
+
+static void escrever_estado (telaTAD tela, size_t cursor, size_t tamanho)
+{
+    celulaT *estado = tela->atual + tela->linhas * tela->colunas;
+    char texto[64];
+    int col = 2;
+
+    for (int i = 0; i < tela->colunas; i++)
+        estado[i].bytes[0] = '-';
+
+    int n = snprintf(texto, sizeof(texto), " posição %zu de %zu ", cursor,
+                     tamanho);
+    for (int i = 0; i < n && i < (int) sizeof(texto) - 1; i++)
+        colocar(tela, tela->linhas, &col, texto[i]);
+}
+
+/**
+ * Procedimento: colocar
+ * Uso: colocar(tela, lin, &col, c);
+ * ---------------------------------
+ * Coloca o byte "c" do texto no quadro atual, na linha "lin" e coluna "col",
+ * e avança a coluna. Um byte de continuação de UTF-8 é acrescentado à célula
+ * anterior, sem avançar; os caracteres de controle aparecem como '?' (a
+ * tabulação, como um espaço). Os caracteres fora das colunas do quadro (antes
+ * da coluna 0 ou depois da última) são descartados.
+ */
+
+static void colocar (telaTAD tela, int lin, int *col, char c)
+{
+    unsigned char u = (unsigned char) c;
+    celulaT *linha = tela->atual + lin * tela->colunas;
+
+    if ((u & 0xC0) == 0x80)
+    {
+        if (*col > 0 && *col <= tela->colunas)
+        {
+            celulaT *celula = &linha[*col - 1];
+            if (celula->tamanho < 4)
+                celula->bytes[celula->tamanho++] = c;
+        }
+        return;
+    }
+
+    if (*col >= 0 && *col < tela->colunas)
+    {
+        celulaT *celula = &linha[*col];
+        celula->bytes[0] = u == '\t' ? ' ' : u < 32 || u == 127 ? '?' : c;
+        celula->tamanho = 1;
+    }
+    (*col)++;
+}
+
+/**
+ * Procedimento: limpar_celulas
+ * Uso: limpar_celulas(celulas, n);
+ * --------------------------------
+ * Põe espaços em branco, sem vídeo reverso, em "n" células.
+ */
+
+static void limpar_celulas (celulaT *celulas, int n)
+{
+    celulaT branco = {{' '}, 1, 0};
+
+    for (int i = 0; i < n; i++)
+        celulas[i] = branco;
+}
+
+/**
+ * Predicado: iguais
+ * Uso: if (iguais(a, b)) . . .
+ * ----------------------------
+ * Retorna TRUE se as duas células têm o mesmo caractere e o mesmo vídeo.
+ */
+
+static bool iguais (const celulaT *a, const celulaT *b)
+{
+    return a->tamanho == b->tamanho && a->inverso == b->inverso &&
+           memcmp(a->bytes, b->bytes, a->tamanho) == 0;
+}
+
+/**
+ * Predicado: mesmo_texto
+ * Uso: if (mesmo_texto(a, b, n)) . . .
+ * ------------------------------------
+ * Retorna TRUE se as "n" células de "a" e "b" têm os mesmos caracteres,
+ * ignorando o vídeo reverso.
+ */
+
+static bool mesmo_texto (const celulaT *a, const celulaT *b, int n)
+{
+    for (int i = 0; i < n; i++)
+        if (a[i].tamanho != b[i].tamanho ||
+            memcmp(a[i].bytes, b[i].bytes, a[i].tamanho) != 0)
+            return FALSE;
+
+    return TRUE;
+}
+
+/**
+ * Predicado: em_branco
+ * Uso: if (em_branco(celulas, n)) . . .
+ * -------------------------------------
+ * Retorna TRUE se as "n" células são espaços sem vídeo reverso.
+ */
+
+static bool em_branco (const celulaT *celulas, int n)
+{
+    for (int i = 0; i < n; i++)
+        if (celulas[i].tamanho != 1 || celulas[i].bytes[0] != ' ' ||
+            celulas[i].inverso)
+            return FALSE;
+
+    return TRUE;
+}
+
+/**
+ * Função: hash_linha
+ * Uso: h = hash_linha(celulas, n);
+ * --------------------------------
+ * Retorna um hash (FNV-1a) dos caracteres de uma linha, ignorando o vídeo
+ * reverso, usado para encontrar rapidamente linhas deslocadas.
+ */
+
+static unsigned long hash_linha (const celulaT *celulas, int n)
+{
+    unsigned long h = 2166136261u;
+
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < celulas[i].tamanho; j++)
+            h = (h ^ (unsigned char) celulas[i].bytes[j]) * 16777619u;
+
+    return h;
+}
+
+/**
+ * Procedimento: deslocar_linhas
+ * Uso: deslocar_linhas(tela);
+ * ---------------------------
+ * A partir da primeira linha de texto diferente, procura o menor deslocamento
+ * "d" tal que as linhas seguintes do quadro anterior aparecem "d" linhas mais
+ * abaixo (ou mais acima) no quadro atual. Se houver, insere (ou apaga) "d"
+ * linhas no terminal, com a rolagem temporariamente restrita às linhas de
+ * texto, para que as linhas da região de comandos não se movam.
+ */
+
+static void deslocar_linhas (telaTAD tela)
+{
+    int L = tela->linhas, C = tela->colunas;
+    int p = 0;
+
+    for (int i = 0; i < L; i++)
+    {
+        tela->hash_anterior[i] = hash_linha(tela->anterior + i * C, C);
+        tela->hash_atual[i] = hash_linha(tela->atual + i * C, C);
+    }
+    while (p < L && tela->hash_anterior[p] == tela->hash_atual[p])
+        p++;
+
+    for (int d = 1; d < L - p; d++)
+    {
+        bool desce = TRUE, sobe = TRUE;
+        for (int i = p; i < L - d && (desce || sobe); i++)
+        {
+            desce = desce && tela->hash_atual[i + d] == tela->hash_anterior[i];
+            sobe = sobe && tela->hash_atual[i] == tela->hash_anterior[i + d];
+        }
+
+        int origem = desce ? p : p + d, destino = desce ? p + d : p;
+        if ((!desce && !sobe) ||
+            em_branco(tela->anterior + origem * C, (L - d - p) * C) ||
+            !mesmo_texto(tela->anterior + origem * C,
+                         tela->atual + destino * C, (L - d - p) * C))
+            continue;
+
+        normal(tela);
+        emitir_formato(tela, "\x1b[1;%dr\x1b[%d;1H\x1b[%d%c\x1b[%d;%dr", L,
+                       p + 1, d, desce ? 'L' : 'M', L + 2, tela->altura);
+        tela->lin = -1;
+
+        memmove(tela->anterior + destino * C, tela->anterior + origem * C,
+                (size_t) (L - d - p) * C * sizeof(celulaT));
+        limpar_celulas(tela->anterior + (desce ? p : L - d) * C, d * C);
+        return;
+    }
+}
+
+/**
+ * Procedimento: deslocar_colunas
+ * Uso: deslocar_colunas(tela, lin);
+ * ---------------------------------
+ * Na linha "lin", a partir da primeira célula diferente, procura o menor
+ * deslocamento "k" tal que o resto da linha anterior aparece "k" colunas mais
+ * à direita (ou mais à esquerda) na linha atual; se houver e se inserir (ou
+ * apagar) "k" caracteres no terminal for mais barato do que reescrever a
+ * parte diferente da linha, faz isso. Só é usado quando a janela ocupa toda
+ * a largura do terminal, pois os caracteres deslocados no terminal vão até a
+ * sua última coluna.
+ */
+
+static void deslocar_colunas (telaTAD tela, int lin)
+{
+    int C = tela->colunas;
+    celulaT *antes = tela->anterior + lin * C, *depois = tela->atual + lin * C;
+    int p = 0, u = C - 1;
+
+    while (p < C && iguais(&antes[p], &depois[p]))
+        p++;
+    while (u > p && iguais(&antes[u], &depois[u]))
+        u--;
+
+    for (int k = 1; k + 8 < u - p + 1; k++)
+    {
+        bool direita = mesmo_texto(antes + p, depois + p + k, C - p - k);
+        bool esquerda = !direita &&
+                        mesmo_texto(antes + p + k, depois + p, C - p - k);
+        if ((!direita && !esquerda) ||
+            em_branco(antes + (direita ? p : p + k), C - p - k))
+            continue;
+
+        normal(tela);
+        mover(tela, lin, p);
+        emitir_formato(tela, "\x1b[%d%c", k, direita ? '@' : 'P');
+        if (direita)
+        {
+            memmove(antes + p + k, antes + p, (C - p - k) * sizeof(celulaT));
+            limpar_celulas(antes + p, k);
+        }
+        else
+        {
+            memmove(antes + p, antes + p + k, (C - p - k) * sizeof(celulaT));
+            limpar_celulas(antes + C - k, k);
+        }
+        return;
+    }
+}
+
+/**
+ * Procedimento: atualizar_linha
+ * Uso: atualizar_linha(tela, lin);
+ * --------------------------------
+ * Leva a linha "lin" do terminal ao conteúdo do quadro atual: tenta primeiro
+ * deslocar as colunas e depois reescreve as sequências de células diferentes
+ * (juntando as que estão separadas por poucas células iguais). Se o final da
+ * linha atual está em branco e o anterior não, apaga-o com EL.
+ */
+
+static void atualizar_linha (telaTAD tela, int lin)
+{
+    int C = tela->colunas;
+    celulaT *antes = tela->anterior + lin * C, *depois = tela->atual + lin * C;
+
+    int fim = C;
+    while (fim > 0 && em_branco(&depois[fim - 1], 1))
+        fim--;
+
+    int c = 0;
+    while (c < C && iguais(&antes[c], &depois[c]))
+        c++;
+    if (c == C)
+        return;
+    if (lin < tela->linhas && tela->colunas == tela->largura)
+        deslocar_colunas(tela, lin);
+
+    while (c < C)
+    {
+        if (iguais(&antes[c], &depois[c]))
+        {
+            c++;
+            continue;
+        }
+        else if (c >= fim)
+        {
+            normal(tela);
+            mover(tela, lin, c);
+            emitir(tela, "\x1b[K", 3);
+            limpar_celulas(antes + c, C - c);
+            break;
+        }
+
+        int ultima = c;
+        for (int i = c; i < fim && i - ultima <= INTERVALO_MINIMO; i++)
+            if (!iguais(&antes[i], &depois[i]))
+                ultima = i;
+
+        mover(tela, lin, c);
+        for (; c <= ultima; c++)
+        {
+            emitir_celula(tela, &depois[c]);
+            antes[c] = depois[c];
+        }
+        tela->col = c;
+        if (c >= C)
+            tela->lin = -1;
+    }
+}
+
+/**
+ * Procedimento: mover
+ * Uso: mover(tela, lin, col);
+ * ---------------------------
+ * Posiciona o cursor do terminal (CUP), se ele já não estiver lá.
+ */
+
+static void mover (telaTAD tela, int lin, int col)
+{
+    if (tela->lin == lin && tela->col == col)
+        return;
+
+    emitir_formato(tela, "\x1b[%d;%dH", lin + 1, col + 1);
+    tela->lin = lin;
+    tela->col = col;
+}
+
+/**
+ * Procedimento: normal
+ * Uso: normal(tela);
+ * ------------------
+ * Desliga o vídeo reverso, se estiver ligado.
+ */
+
+static void normal (telaTAD tela)
+{
+    if (tela->invertido)
+    {
+        emitir(tela, "\x1b[m", 3);
+        tela->invertido = FALSE;
+    }
+}
+
+/**
+ * Procedimento: emitir_celula
+ * Uso: emitir_celula(tela, celula);
+ * ---------------------------------
+ * Emite o caractere de uma célula, ligando ou desligando o vídeo reverso. Uma
+ * sequência UTF-8 incompleta ou inválida é emitida como '?', para não
+ * desalinhar o terminal.
+ */
+
+static void emitir_celula (telaTAD tela, const celulaT *celula)
+{
+    if (celula->inverso && !tela->invertido)
+    {
+        emitir(tela, "\x1b[7m", 4);
+        tela->invertido = TRUE;
+    }
+    else if (!celula->inverso)
+        normal(tela);
+
+    unsigned char u = (unsigned char) celula->bytes[0];
+    int esperado = u < 0x80 ? 1 : u >= 0xC2 && u <= 0xDF ? 2 :
+                   u >= 0xE0 && u <= 0xEF ? 3 : u >= 0xF0 && u <= 0xF4 ? 4 : 0;
+    if (esperado == celula->tamanho)
+        emitir(tela, celula->bytes, celula->tamanho);
+    else
+        emitir(tela, "?", 1);
+}
+
+/**
+ * Procedimento: emitir
+ * Uso: emitir(tela, s, n);
+ * ------------------------
+ * Acrescenta "n" bytes à saída do desenho, aumentando o espaço se necessário.
+ */
+
+static void emitir (telaTAD tela, const char *s, size_t n)
+{
+    if (tela->usados + n > tela->capacidade)
+    {
+        size_t nova = tela->capacidade > 0 ? tela->capacidade : 256;
+        while (nova < tela->usados + n)
+            nova *= 2;
+        char *texto = realloc(tela->texto, nova);
+        if (texto == NULL)
+        {
+            fprintf(stderr, "Erro: impossível alocar a saída da tela.\n");
+            exit(1);
+        }
+        tela->texto = texto;
+        tela->capacidade = nova;
+    }
+
+    memcpy(tela->texto + tela->usados, s, n);
+    tela->usados += n;
+}
+
+/**
+ * Procedimento: emitir_formato
+ * Uso: emitir_formato(tela, formato, ...);
+ * ----------------------------------------
+ * Acrescenta à saída do desenho uma sequência de escape formatada como em
+ * printf.
+ */
+
+static void emitir_formato (telaTAD tela, const char *formato, ...)
+{
+    char sequencia[64];
+    va_list args;
+
+    va_start(args, formato);
+    int n = vsnprintf(sequencia, sizeof(sequencia), formato, args);
+    va_end(args);
+
+    if (n > 0)
+        emitir(tela, sequencia, (size_t) n < sizeof(sequencia) ?
+                                (size_t) n : sizeof(sequencia) - 1);
+}
@@ -0,0 +1,141 @@
+/**
+ * Arquivo: tela.h
+ * Versão : 1.1
+ * Data   : 2026-10-18 20:20
+ * -------------------------
+ * Este arquivo define uma interface para exibir um buffer em um terminal
+ * compatível com ANSI/VT100 redesenhando apenas o que mudou. A tela lembra o
+ * que foi desenhado da última vez (um quadro de células) e, a cada desenho,
+ * monta o novo quadro e envia ao terminal somente as células diferentes, com
+ * sequências de escape para posicionar o cursor do terminal, inserir ou apagar
+ * caracteres e linhas inteiras. Mover o cursor do buffer custa alguns bytes de
+ * saída, e inserir texto custa aproximadamente o tamanho do texto inserido.
+ *
+ * A parte de cima do terminal mostra o texto do buffer (uma célula por
+ * caractere, com o cursor do buffer em vídeo reverso), seguida de uma linha de
+ * estado; as linhas restantes formam uma região de rolagem onde o programa
+ * continua escrevendo normalmente (mensagens, prompt e comandos digitados).
+ *
+ * Tanto a tela quanto "exibir_janela" mostram apenas uma janela de linhas e
+ * colunas em volta do cursor. Somente o texto dessa janela é copiado do
+ * buffer, formatado e escrito, e o início da janela é encontrado a partir do
+ * cursor, sem percorrer o buffer, de modo que o custo de exibir não depende do
+ * tamanho do buffer.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _TELA_H
+#define _TELA_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stdio.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: telaTAD
+ * -------------
+ * Representa um terminal e o último quadro desenhado nele.
+ */
+
+typedef struct telaTCD *telaTAD;
+
+/**
+ * TIPO: metricas_telaT
+ * --------------------
+ * Métricas acumuladas pela tela:
+ *
+ *     desenhos       quantidade de desenhos
+ *     bytes          total de bytes enviados ao terminal
+ *     bytes_ultimo   bytes enviados no último desenho
+ */
+
+typedef struct
+{
+    unsigned long desenhos;
+    unsigned long long bytes;
+    size_t bytes_ultimo;
+} metricas_telaT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: criar_tela
+ * Uso: tela = criar_tela(saida);
+ * ------------------------------
+ * Prepara o terminal ligado a "saida": descobre o seu tamanho, limpa o
+ * terminal e reserva as linhas de cima para o buffer. Retorna NULL se não
+ * houver memória ou se o terminal for pequeno demais.
+ */
+
+telaTAD criar_tela (FILE *saida);
+
+/**
+ * PROCEDIMENTO: liberar_tela
+ * Uso: liberar_tela(&tela);
+ * -------------------------
+ * Devolve o terminal ao estado normal (toda a altura rolando) e libera a
+ * tela, atribuindo NULL ao ponteiro original. Note que o argumento é um
+ * PONTEIRO para a tela.
+ */
+
+void liberar_tela (telaTAD *tela);
+
+/**
+ * PROCEDIMENTO: configurar_janela
+ * Uso: configurar_janela(tela, linhas, colunas);
+ * ----------------------------------------------
+ * Define o tamanho da janela do buffer exibida na tela. Um valor menor ou
+ * igual a zero (ou maior do que o terminal) usa todas as linhas ou colunas
+ * disponíveis. O terminal é limpo e o próximo desenho é completo.
+ */
+
+void configurar_janela (telaTAD tela, int linhas, int colunas);
+
+/**
+ * PROCEDIMENTO: desenhar_buffer
+ * Uso: desenhar_buffer(tela, buffer);
+ * -----------------------------------
+ * Desenha o buffer na tela, enviando ao terminal apenas as diferenças em
+ * relação ao desenho anterior. O cursor do terminal volta para onde estava.
+ */
+
+void desenhar_buffer (telaTAD tela, bufferTAD buffer);
+
+/**
+ * PROCEDIMENTO: obter_metricas_tela
+ * Uso: obter_metricas_tela(tela, &m);
+ * -----------------------------------
+ * Copia para "m" as métricas acumuladas pela tela.
+ */
+
+void obter_metricas_tela (telaTAD tela, metricas_telaT *metricas);
+
+/**
+ * PROCEDIMENTO: exibir_janela
+ * Uso: exibir_janela(buffer, linhas, colunas);
+ * --------------------------------------------
+ * Exibe, no mesmo formato de exibir_buffer e sem usar sequências de escape,
+ * uma janela de até "linhas" linhas e "colunas" colunas centrada no cursor.
+ * Se "colunas" for menor ou igual a zero, usa uma largura que cabe em um
+ * terminal de 80 colunas.
+ */
+
+void exibir_janela (bufferTAD buffer, int linhas, int colunas);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -0,0 +1,675 @@
+/**
+ * Arquivo: transacao.c
+ * Versão : 1.1
+ * Data   : 2026-10-19 04:40
+ * -------------------------
+ * Este arquivo implementa a interface transacao.h. Os trechos pendentes ficam
+ * em um array ordenado, e cada um tem o seu próprio array de texto inserido,
+ * que cresce dobrando de tamanho. Uma edição na posição "p" do texto da
+ * transação é localizada percorrendo os trechos e acumulando o deslocamento
+ * (inseridos - removidos) dos anteriores: a posição original de um caractere
+ * que não foi alterado é a sua posição atual menos esse deslocamento. Como
+ * uma transação costuma ter poucos trechos, a busca linear basta.
+ *
+ * Uma inserção que cai dentro (ou nas pontas) do texto de um trecho é
+ * encaixada nele; senão, vira um trecho novo, sem nada removido. Uma remoção
+ * junta em um só trecho todos os trechos que toca: os caracteres originais
+ * entre eles são todos removidos, e do texto inserido sobram apenas o começo
+ * do primeiro trecho (antes da remoção) e o final do último (depois dela).
+ *
+ * O registro para desfazer é um array de trechos aplicados, com os textos
+ * removidos guardados em sequência em um único array de caracteres. Um trecho
+ * com TODOS inseridos representa uma operação que refez o texto inteiro (veja
+ * guardar_texto_para_desfazer): desfazê-lo troca todo o texto do buffer.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define IMPLEMENTANDO_BUFFER
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "transacao.h"
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: pendenteT
+ * ---------------
+ * Um trecho pendente, com o seu texto inserido ("inseridos" caracteres em um
+ * array de "capacidade" caracteres, NULL se a capacidade for 0).
+ */
+
+typedef struct
+{
+    size_t inicio;
+    size_t removidos;
+    size_t inseridos;
+    size_t capacidade;
+    char *texto;
+} pendenteT;
+
+/**
+ * Tipo: aplicadoT
+ * ---------------
+ * Um trecho aplicado, guardado para desfazer: a posição em que ficou, quantos
+ * caracteres inseriu e quantos removeu, e onde o texto removido começa no
+ * array de textos da transação.
+ */
+
+typedef struct
+{
+    size_t posicao;
+    size_t inseridos;
+    size_t removidos;
+    size_t texto;
+} aplicadoT;
+
+/**
+ * Tipo: transacaoTCD
+ * ------------------
+ * A representação concreta da transação:
+ *
+ *     trechos       os trechos pendentes, em ordem de posição
+ *     ntrechos      quantidade de trechos pendentes
+ *     captrechos    capacidade do array de trechos
+ *     ativa         se há edições pendentes (mesmo sem trechos)
+ *     tamanho       tamanho do texto da transação
+ *     cursor        cursor da transação
+ *     profundidade  transações internas ainda abertas
+ *     aplicados     os trechos já aplicados, para desfazer
+ *     naplicados    quantidade de trechos aplicados
+ *     capaplicados  capacidade do array de trechos aplicados
+ *     textos        os textos removidos pelos trechos aplicados
+ *     ntextos       caracteres usados em "textos"
+ *     captextos     capacidade de "textos"
+ *     incompleta    se faltou memória para guardar algum trecho aplicado
+ */
+
+struct transacaoTCD
+{
+    pendenteT *trechos;
+    size_t ntrechos;
+    size_t captrechos;
+    bool ativa;
+    size_t tamanho;
+    size_t cursor;
+    int profundidade;
+    aplicadoT *aplicados;
+    size_t naplicados;
+    size_t capaplicados;
+    char *textos;
+    size_t ntextos;
+    size_t captextos;
+    bool incompleta;
+};
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTE: TODOS
+ * ----------------
+ * Quantidade de inseridos de um trecho aplicado que substituiu o texto
+ * inteiro do buffer.
+ */
+
+#define TODOS SIZE_MAX
+
+/*** Declarações de Subprogramas Privados ***/
+
+static char *reservar_desfazer (transacaoTAD transacao, size_t posicao,
+                                size_t inseridos, size_t n);
+static bool garantir_texto (pendenteT *trecho, size_t n);
+static bool abrir_trecho (transacaoTAD transacao, size_t k, size_t inicio);
+static void fechar_trechos (transacaoTAD transacao, size_t k, size_t n);
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: criar_transacao
+ * Uso: transacao = criar_transacao( );
+ * ------------------------------------
+ * Todos os arrays começam vazios.
+ */
+
+transacaoTAD criar_transacao (void)
+{
+    transacaoTAD T = calloc(1, sizeof(struct transacaoTCD));
+    if (T == NULL)
+        fprintf(stderr, "Erro: impossível alocar a transação.\n");
+    return T;
+}
+
+/**
+ * Procedimento: liberar_transacao
+ * Uso: liberar_transacao(&transacao);
+ * -----------------------------------
+ * Libera o texto de cada trecho pendente, os arrays e a transação.
+ */
+
+void liberar_transacao (transacaoTAD *transacao)
+{
+    if (transacao == NULL || *transacao == NULL)
+        return;
+
+    transacaoTAD T = *transacao;
+    for (size_t k = 0; k < T->ntrechos; k++)
+        free(T->trechos[k].texto);
+    free(T->trechos);
+    free(T->aplicados);
+    free(T->textos);
+    free(T);
+    *transacao = NULL;
+}
+
+/**
+ * Procedimento: aninhar_transacao
+ * Predicado: desaninhar_transacao
+ * Uso: aninhar_transacao(transacao);
+ *      if (desaninhar_transacao(transacao)) . . .
+ * -----------------------------------------------
+ * Incrementam e decrementam a profundidade.
+ */
+
+void aninhar_transacao (transacaoTAD transacao)
+{
+    transacao->profundidade++;
+}
+
+bool desaninhar_transacao (transacaoTAD transacao)
+{
+    if (transacao->profundidade == 0)
+        return FALSE;
+    transacao->profundidade--;
+    return TRUE;
+}
+
+/**
+ * Predicado: transacao_pendente
+ * Uso: if (transacao_pendente(transacao)) . . .
+ * ---------------------------------------------
+ * A transação fica ativa na primeira edição registrada e deixa de estar na
+ * aplicação: mesmo que as edições se anulem, o cursor pode ter mudado.
+ */
+
+bool transacao_pendente (transacaoTAD transacao)
+{
+    return transacao != NULL && transacao->ativa;
+}
+
+/**
+ * Procedimento: sincronizar_transacao
+ * Uso: sincronizar_transacao(transacao, tamanho, cursor);
+ * -------------------------------------------------------
+ * Copia o tamanho e o cursor do buffer se a transação ainda não está ativa.
+ */
+
+void sincronizar_transacao (transacaoTAD transacao, size_t tamanho,
+                            size_t cursor)
+{
+    if (!transacao->ativa)
+    {
+        transacao->tamanho = tamanho;
+        transacao->cursor = cursor;
+    }
+}
+
+/**
+ * Predicado: registrar_insercao
+ * Uso: if (registrar_insercao(transacao, texto, n)) . . .
+ * -------------------------------------------------------
+ * Procura o primeiro trecho cujo texto termina no cursor ou depois dele. Se o
+ * cursor está dentro desse texto (ou em uma das pontas), o texto novo é
+ * encaixado nele; senão, o cursor está em uma parte não alterada, antes do
+ * trecho, e um trecho novo é aberto ali.
+ */
+
+bool registrar_insercao (transacaoTAD transacao, const char *texto, size_t n)
+{
+    transacaoTAD T = transacao;
+    if (n == 0)
+        return TRUE;
+    else if (n > SIZE_MAX / 2 - T->tamanho)
+        return FALSE;
+
+    size_t p = T->cursor, deslocamento = 0, k, logico = 0;
+    for (k = 0; k < T->ntrechos; k++)
+    {
+        logico = T->trechos[k].inicio + deslocamento;
+        if (p <= logico + T->trechos[k].inseridos)
+            break;
+        deslocamento += T->trechos[k].inseridos - T->trechos[k].removidos;
+    }
+    if (k == T->ntrechos || p < logico)
+    {
+        if (!abrir_trecho(T, k, p - deslocamento))
+            return FALSE;
+        logico = p;
+    }
+
+    pendenteT *t = &T->trechos[k];
+    if (!garantir_texto(t, t->inseridos + n))
+    {
+        if (t->inseridos == 0 && t->removidos == 0)
+            fechar_trechos(T, k, 1);
+        return FALSE;
+    }
+    size_t i = p - logico;
+    memmove(t->texto + i + n, t->texto + i, t->inseridos - i);
+    memcpy(t->texto + i, texto, n);
+    t->inseridos += n;
+
+    T->tamanho += n;
+    T->cursor += n;
+    T->ativa = TRUE;
+    return TRUE;
+}
+
+/**
+ * Predicado: registrar_remocao
+ * Uso: if (registrar_remocao(transacao, n)) . . .
+ * -----------------------------------------------
+ * Procura os trechos que a remoção [p, p + n) toca (inclusive nas pontas). Se
+ * não há nenhum, abre um trecho que só remove. Senão, junta todos no
+ * primeiro: o início original é o do primeiro trecho ou, se a remoção começa
+ * antes dele, a posição original de "p"; o final original é o do último
+ * trecho ou, se a remoção termina depois dele, a posição original de p + n; e
+ * o texto é o que sobra do primeiro trecho antes de "p" seguido do que sobra
+ * do último depois de p + n.
+ */
+
+bool registrar_remocao (transacaoTAD transacao, size_t n)
+{
+    transacaoTAD T = transacao;
+    size_t p = T->cursor;
+    if (n > T->tamanho - p)
+        n = T->tamanho - p;
+    if (n == 0)
+        return TRUE;
+
+    size_t fim = p + n, deslocamento = 0, k;
+    size_t primeiro = SIZE_MAX, ultimo = 0;
+    size_t desl_primeiro = 0, desl_ultimo = 0, desl_depois = 0;
+    for (k = 0; k < T->ntrechos; k++)
+    {
+        pendenteT *t = &T->trechos[k];
+        size_t logico = t->inicio + deslocamento;
+        if (logico > fim)
+            break;
+        if (logico + t->inseridos >= p)
+        {
+            if (primeiro == SIZE_MAX)
+            {
+                primeiro = k;
+                desl_primeiro = deslocamento;
+            }
+            ultimo = k;
+            desl_ultimo = deslocamento;
+        }
+        deslocamento += t->inseridos - t->removidos;
+        if (primeiro != SIZE_MAX && ultimo == k)
+            desl_depois = deslocamento;
+    }
+
+    if (primeiro == SIZE_MAX)
+    {
+        if (!abrir_trecho(T, k, p - deslocamento))
+            return FALSE;
+        T->trechos[k].removidos = n;
+    }
+    else
+    {
+        pendenteT *f = &T->trechos[primeiro], *u = &T->trechos[ultimo];
+        size_t logico_f = f->inicio + desl_primeiro;
+        size_t logico_u = u->inicio + desl_ultimo;
+        size_t prefixo = (p > logico_f) ? p - logico_f : 0;
+        size_t corte = fim - logico_u;
+        size_t sufixo = (u->inseridos > corte) ? u->inseridos - corte : 0;
+
+        if (primeiro != ultimo && !garantir_texto(f, prefixo + sufixo))
+            return FALSE;
+
+        size_t inicio = (p < logico_f) ? p - desl_primeiro : f->inicio;
+        size_t final = (fim > logico_u + u->inseridos)
+                       ? fim - desl_depois : u->inicio + u->removidos;
+        if (sufixo > 0)
+            memmove(f->texto + prefixo, u->texto + corte, sufixo);
+        f->inicio = inicio;
+        f->removidos = final - inicio;
+        f->inseridos = prefixo + sufixo;
+
+        fechar_trechos(T, primeiro + 1, ultimo - primeiro);
+        if (f->inseridos == 0 && f->removidos == 0)
+            fechar_trechos(T, primeiro, 1);
+    }
+
+    T->tamanho -= n;
+    T->ativa = TRUE;
+    return TRUE;
+}
+
+/**
+ * Procedimento: mover_cursor_da_transacao
+ * Funções: cursor_da_transacao, tamanho_da_transacao
+ * Uso: mover_cursor_da_transacao(transacao, posicao);
+ *      p = cursor_da_transacao(transacao);
+ *      n = tamanho_da_transacao(transacao);
+ * ---------------------------------------------------
+ * O cursor é apenas um número; mover não altera os trechos.
+ */
+
+void mover_cursor_da_transacao (transacaoTAD transacao, size_t posicao)
+{
+    transacao->cursor = (posicao < transacao->tamanho) ? posicao
+                                                       : transacao->tamanho;
+}
+
+size_t cursor_da_transacao (transacaoTAD transacao)
+{
+    return transacao->cursor;
+}
+
+size_t tamanho_da_transacao (transacaoTAD transacao)
+{
+    return transacao->tamanho;
+}
+
+/**
+ * Funções: quantidade_de_trechos, trecho_da_transacao
+ * Uso: n = quantidade_de_trechos(transacao);
+ *      trecho = trecho_da_transacao(transacao, k);
+ * ------------------------------------------------
+ * O trecho retornado aponta para o texto do trecho pendente.
+ */
+
+size_t quantidade_de_trechos (transacaoTAD transacao)
+{
+    return transacao->ntrechos;
+}
+
+trechoT trecho_da_transacao (transacaoTAD transacao, size_t k)
+{
+    if (k >= transacao->ntrechos)
+    {
+        fprintf(stderr, "Erro: trecho inexistente.\n");
+        exit(1);
+    }
+
+    pendenteT *t = &transacao->trechos[k];
+    trechoT trecho = {t->inicio, t->removidos, t->texto, t->inseridos};
+    return trecho;
+}
+
+/**
+ * Predicado: guardar_para_desfazer
+ * Uso: if (guardar_para_desfazer(transacao, posicao, inseridos, texto, n)) ...
+ * ----------------------------------------------------------------------------
+ * Reserva o trecho com "reservar_desfazer" e copia o texto removido. Um texto
+ * NULL marca a transação como incompleta, como uma falta de memória.
+ */
+
+bool guardar_para_desfazer (transacaoTAD transacao, size_t posicao,
+                            size_t inseridos, const char *texto, size_t n)
+{
+    if (texto == NULL && n > 0)
+        transacao->incompleta = TRUE;
+    char *destino = reservar_desfazer(transacao, posicao, inseridos, n);
+    if (destino == NULL)
+        return FALSE;
+
+    if (n > 0)
+        memcpy(destino, texto, n);
+    return TRUE;
+}
+
+/**
+ * Predicado: guardar_texto_para_desfazer
+ * Uso: if (guardar_texto_para_desfazer(transacao, buffer)) . . .
+ * ---------------------------------------------------------------
+ * O texto é copiado com copiar_texto direto para o array de textos da
+ * transação, sem array temporário.
+ */
+
+bool guardar_texto_para_desfazer (transacaoTAD transacao, bufferTAD buffer)
+{
+    if (transacao == NULL)
+        return TRUE;
+
+    size_t n = tamanho_buffer(buffer);
+    char *destino = reservar_desfazer(transacao, 0, TODOS, n);
+    if (destino == NULL)
+        return FALSE;
+
+    copiar_texto(buffer, 0, n, destino);
+    return TRUE;
+}
+
+/**
+ * Procedimento: concluir_aplicacao
+ * Uso: concluir_aplicacao(transacao);
+ * -----------------------------------
+ * Libera o texto de cada trecho; o array de trechos é mantido para a próxima
+ * leva de edições.
+ */
+
+void concluir_aplicacao (transacaoTAD transacao)
+{
+    for (size_t k = 0; k < transacao->ntrechos; k++)
+        free(transacao->trechos[k].texto);
+    transacao->ntrechos = 0;
+    transacao->ativa = FALSE;
+}
+
+/**
+ * Procedimento: aplicar_trechos
+ * Uso: aplicar_trechos(transacao, buffer);
+ * ----------------------------------------
+ * Cada trecho custa um movimento do cursor (sempre para frente), uma cópia do
+ * texto removido, uma remoção e uma inserção em bloco; o array temporário do
+ * texto removido é reaproveitado de um trecho para o outro.
+ */
+
+void aplicar_trechos (transacaoTAD transacao, bufferTAD buffer)
+{
+    transacaoTAD T = transacao;
+    size_t deslocamento = 0, capacidade = 0;
+    char *removido = NULL;
+
+    for (size_t k = 0; k < T->ntrechos; k++)
+    {
+        pendenteT *t = &T->trechos[k];
+        size_t posicao = t->inicio + deslocamento;
+
+        if (t->removidos > capacidade)
+        {
+            char *novo = realloc(removido, t->removidos);
+            if (novo != NULL)
+            {
+                removido = novo;
+                capacidade = t->removidos;
+            }
+        }
+        if (t->removidos > 0 && t->removidos <= capacidade)
+            copiar_texto(buffer, posicao, t->removidos, removido);
+        guardar_para_desfazer(T, posicao, t->inseridos,
+                              (t->removidos <= capacidade) ? removido : NULL,
+                              t->removidos);
+
+        mover_cursor_para_posicao(buffer, posicao);
+        apagar_texto(buffer, t->removidos);
+        inserir_texto(buffer, t->texto, t->inseridos);
+        deslocamento += t->inseridos - t->removidos;
+    }
+    free(removido);
+
+    mover_cursor_para_posicao(buffer, T->cursor);
+    concluir_aplicacao(T);
+}
+
+/**
+ * Predicado: reverter_transacao
+ * Uso: if (reverter_transacao(transacao, buffer)) . . .
+ * -----------------------------------------------------
+ * Do último trecho aplicado para o primeiro, apaga o texto inserido e insere
+ * de volta o texto removido. Em cada aplicação os trechos estão em ordem de
+ * posição, e desfazer um trecho não muda a posição dos anteriores; as
+ * aplicações são desfeitas da última para a primeira. Quando um trecho com
+ * TODOS inseridos é desfeito, o buffer tem exatamente o texto que a operação
+ * produziu, e todo ele é apagado.
+ */
+
+bool reverter_transacao (transacaoTAD transacao, bufferTAD buffer)
+{
+    transacaoTAD T = transacao;
+    if (T->incompleta)
+        return FALSE;
+
+    for (size_t k = T->naplicados; k-- > 0; )
+    {
+        aplicadoT *a = &T->aplicados[k];
+        size_t inseridos = a->inseridos;
+        if (inseridos == TODOS)
+            inseridos = tamanho_buffer(buffer) - a->posicao;
+        mover_cursor_para_posicao(buffer, a->posicao);
+        apagar_texto(buffer, inseridos);
+        inserir_texto(buffer, T->textos + a->texto, a->removidos);
+    }
+    T->naplicados = 0;
+    T->ntextos = 0;
+    return TRUE;
+}
+
+/*** Definições de Subprogramas Privados ***/
+
+/**
+ * Função: reservar_desfazer
+ * Uso: destino = reservar_desfazer(transacao, posicao, inseridos, n);
+ * -------------------------------------------------------------------
+ * Acrescenta um trecho aplicado ao registro para desfazer e retorna onde os
+ * "n" caracteres removidos devem ser copiados (nunca NULL, mesmo com "n" igual
+ * a 0). Os arrays crescem dobrando de tamanho. Depois de uma falta de memória a transação fica marcada como
+ * incompleta, nada mais é guardado e a função retorna NULL.
+ */
+
+static char *reservar_desfazer (transacaoTAD transacao, size_t posicao,
+                                size_t inseridos, size_t n)
+{
+    transacaoTAD T = transacao;
+    if (T->incompleta)
+        return NULL;
+
+    if (T->naplicados == T->capaplicados)
+    {
+        size_t capacidade = (T->capaplicados > 0) ? 2 * T->capaplicados : 8;
+        aplicadoT *a = realloc(T->aplicados, capacidade * sizeof(aplicadoT));
+        if (a == NULL)
+        {
+            T->incompleta = TRUE;
+            return NULL;
+        }
+        T->aplicados = a;
+        T->capaplicados = capacidade;
+    }
+    if (T->textos == NULL || n > T->captextos - T->ntextos)
+    {
+        size_t capacidade = (T->captextos > 0) ? T->captextos : 256;
+        while (capacidade - T->ntextos < n)
+            capacidade *= 2;
+        char *textos = realloc(T->textos, capacidade);
+        if (textos == NULL)
+        {
+            T->incompleta = TRUE;
+            return NULL;
+        }
+        T->textos = textos;
+        T->captextos = capacidade;
+    }
+
+    char *destino = T->textos + T->ntextos;
+    T->aplicados[T->naplicados++] = (aplicadoT) { posicao, inseridos, n,
+                                                  T->ntextos };
+    T->ntextos += n;
+    return destino;
+}
+
+/**
+ * Predicado: garantir_texto
+ * Uso: if (garantir_texto(trecho, n)) . . .
+ * -----------------------------------------
+ * Garante que o texto do trecho tenha espaço para "n" caracteres, dobrando a
+ * capacidade (a partir de 16). Retorna FALSE se não houver memória.
+ */
+
+static bool garantir_texto (pendenteT *trecho, size_t n)
+{
+    if (n <= trecho->capacidade)
+        return TRUE;
+
+    size_t capacidade = (trecho->capacidade > 0) ? trecho->capacidade : 16;
+    while (capacidade < n)
+        capacidade *= 2;
+    char *texto = realloc(trecho->texto, capacidade);
+    if (texto == NULL)
+        return FALSE;
+    trecho->texto = texto;
+    trecho->capacidade = capacidade;
+    return TRUE;
+}
+
+/**
+ * Predicado: abrir_trecho
+ * Uso: if (abrir_trecho(transacao, k, inicio)) . . .
+ * --------------------------------------------------
+ * Abre um trecho vazio na posição original "inicio", como o k-ésimo trecho.
+ * Retorna FALSE se não houver memória.
+ */
+
+static bool abrir_trecho (transacaoTAD transacao, size_t k, size_t inicio)
+{
+    transacaoTAD T = transacao;
+    if (T->ntrechos == T->captrechos)
+    {
+        size_t capacidade = (T->captrechos > 0) ? 2 * T->captrechos : 8;
+        pendenteT *t = realloc(T->trechos, capacidade * sizeof(pendenteT));
+        if (t == NULL)
+            return FALSE;
+        T->trechos = t;
+        T->captrechos = capacidade;
+    }
+
+    memmove(T->trechos + k + 1, T->trechos + k,
+            (T->ntrechos - k) * sizeof(pendenteT));
+    T->trechos[k] = (pendenteT) { inicio, 0, 0, 0, NULL };
+    T->ntrechos++;
+    return TRUE;
+}
+
+/**
+ * Procedimento: fechar_trechos
+ * Uso: fechar_trechos(transacao, k, n);
+ * -------------------------------------
+ * Retira "n" trechos a partir do k-ésimo, liberando os seus textos.
+ */
+
+static void fechar_trechos (transacaoTAD transacao, size_t k, size_t n)
+{
+    transacaoTAD T = transacao;
+    for (size_t i = k; i < k + n; i++)
+        free(T->trechos[i].texto);
+    memmove(T->trechos + k, T->trechos + k + n,
+            (T->ntrechos - k - n) * sizeof(pendenteT));
+    T->ntrechos -= n;
+}
@@ -0,0 +1,247 @@
+/**
+ * Arquivo: transacao.h
+ * Versão : 1.1
+ * Data   : 2026-10-19 04:40
+ * -------------------------
+ * Este arquivo define o registro de edições usado pelas implementações de
+ * buffer.h para as transações (veja iniciar_transacao e confirmar_transacao
+ * em buffer.h). Ele não faz parte da interface dos programas que usam o
+ * buffer: é um auxiliar das implementações, como o cursor e o texto.
+ *
+ * Dentro de uma transação o buffer não é alterado. As inserções, remoções e
+ * movimentos do cursor apenas atualizam uma lista de "trechos", cada um
+ * dizendo que os "removidos" caracteres a partir da posição "inicio" do texto
+ * ORIGINAL (o texto do buffer antes das edições pendentes) foram trocados por
+ * "inseridos" caracteres novos. Os trechos ficam em ordem de posição e nunca
+ * se tocam: uma edição que encosta em um trecho (ou em vários) é juntada a
+ * ele, de modo que digitar, apagar e corrigir no mesmo lugar resulta em um
+ * único trecho. Registrar uma edição não lê o texto do buffer.
+ *
+ * Ao aplicar os trechos, a implementação guarda, para cada um, a posição em
+ * que ficou, a quantidade de caracteres inseridos e o texto que removeu. É o
+ * registro para desfazer a transação inteira (veja desfazer_transacao em
+ * buffer.h), que continua valendo depois da confirmação. As operações que
+ * alteram o armazenamento diretamente, sem registrar trechos (como
+ * substituir_tudo), também precisam entrar nesse registro quando há uma
+ * transação aberta: com guardar_para_desfazer, se a alteração é uma troca de
+ * um intervalo, ou com guardar_texto_para_desfazer, se refaz o texto inteiro.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _TRANSACAO_H
+#define _TRANSACAO_H
+
+/*** Includes ***/
+
+#include "buffer.h"
+#include "genlib.h"
+#include <stddef.h>
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: transacaoTAD
+ * ------------------
+ * Representa as edições pendentes de uma transação e o registro para
+ * desfazê-la.
+ */
+
+typedef struct transacaoTCD *transacaoTAD;
+
+/**
+ * TIPO: trechoT
+ * -------------
+ * Um trecho pendente: os "removidos" caracteres a partir da posição "inicio"
+ * do texto original são trocados pelos "inseridos" caracteres de "texto". O
+ * texto pertence à transação e só vale até a próxima edição registrada.
+ */
+
+typedef struct
+{
+    size_t inicio;
+    size_t removidos;
+    const char *texto;
+    size_t inseridos;
+} trechoT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: criar_transacao
+ * Uso: transacao = criar_transacao( );
+ * ------------------------------------
+ * Cria uma transação sem edições pendentes e com o registro para desfazer
+ * vazio. Retorna NULL se não houver memória.
+ */
+
+transacaoTAD criar_transacao (void);
+
+/**
+ * PROCEDIMENTO: liberar_transacao
+ * Uso: liberar_transacao(&transacao);
+ * -----------------------------------
+ * Libera a transação e atribui NULL ao ponteiro. Não faz nada se o ponteiro
+ * já for NULL.
+ */
+
+void liberar_transacao (transacaoTAD *transacao);
+
+/**
+ * PROCEDIMENTO: aninhar_transacao
+ * PREDICADO: desaninhar_transacao
+ * Uso: aninhar_transacao(transacao);
+ *      if (desaninhar_transacao(transacao)) . . .
+ * -----------------------------------------------
+ * Contam as transações iniciadas dentro de outra: "aninhar_transacao" é
+ * chamado por iniciar_transacao quando já há uma transação aberta, e
+ * "desaninhar_transacao", por confirmar_transacao, retorna TRUE se a
+ * confirmação encerrou apenas uma transação interna (e a externa continua).
+ */
+
+void aninhar_transacao (transacaoTAD transacao);
+bool desaninhar_transacao (transacaoTAD transacao);
+
+/**
+ * PREDICADO: transacao_pendente
+ * Uso: if (transacao_pendente(transacao)) . . .
+ * ---------------------------------------------
+ * Retorna TRUE se a transação não é NULL e tem edições pendentes (registradas
+ * desde a última aplicação, mesmo que tenham se anulado). Enquanto não há
+ * edições pendentes, o texto e o cursor do buffer são os da transação, e as
+ * operações vão direto para o buffer.
+ */
+
+bool transacao_pendente (transacaoTAD transacao);
+
+/**
+ * PROCEDIMENTO: sincronizar_transacao
+ * Uso: sincronizar_transacao(transacao, tamanho, cursor);
+ * -------------------------------------------------------
+ * Se a transação não tem edições pendentes, passa a partir do tamanho e da
+ * posição do cursor informados (os do buffer); senão, não faz nada. Deve ser
+ * chamado antes de registrar uma edição.
+ */
+
+void sincronizar_transacao (transacaoTAD transacao, size_t tamanho,
+                            size_t cursor);
+
+/**
+ * PREDICADOS: registrar_insercao, registrar_remocao
+ * Uso: if (registrar_insercao(transacao, texto, n)) . . .
+ *      if (registrar_remocao(transacao, n)) . . .
+ * -------------------------------------------------------
+ * Registram a inserção dos "n" caracteres de "texto" no cursor da transação
+ * (que avança para depois deles) ou a remoção de até "n" caracteres após o
+ * cursor. Retornam FALSE, sem registrar nada, se não houver memória.
+ */
+
+bool registrar_insercao (transacaoTAD transacao, const char *texto, size_t n);
+bool registrar_remocao (transacaoTAD transacao, size_t n);
+
+/**
+ * PROCEDIMENTO: mover_cursor_da_transacao
+ * FUNÇÕES: cursor_da_transacao, tamanho_da_transacao
+ * Uso: mover_cursor_da_transacao(transacao, posicao);
+ *      p = cursor_da_transacao(transacao);
+ *      n = tamanho_da_transacao(transacao);
+ * ---------------------------------------------------
+ * Movem e retornam o cursor da transação, e retornam o tamanho que o texto
+ * terá quando as edições pendentes forem aplicadas. Uma posição além do final
+ * é tratada como o final.
+ */
+
+void mover_cursor_da_transacao (transacaoTAD transacao, size_t posicao);
+size_t cursor_da_transacao (transacaoTAD transacao);
+size_t tamanho_da_transacao (transacaoTAD transacao);
+
+/**
+ * FUNÇÕES: quantidade_de_trechos, trecho_da_transacao
+ * Uso: n = quantidade_de_trechos(transacao);
+ *      trecho = trecho_da_transacao(transacao, k);
+ * ------------------------------------------------
+ * Retornam a quantidade de trechos pendentes e o k-ésimo deles (a partir de
+ * 0), em ordem de posição.
+ */
+
+size_t quantidade_de_trechos (transacaoTAD transacao);
+trechoT trecho_da_transacao (transacaoTAD transacao, size_t k);
+
+/**
+ * PREDICADO: guardar_para_desfazer
+ * Uso: if (guardar_para_desfazer(transacao, posicao, inseridos, texto, n)) ...
+ * ----------------------------------------------------------------------------
+ * Acrescenta ao registro para desfazer um trecho aplicado: os "inseridos"
+ * caracteres que ficaram na posição "posicao" substituíram os "n" caracteres
+ * de "texto". Os trechos de uma aplicação são guardados em ordem de posição,
+ * e cada posição já conta com os trechos anteriores. Retorna FALSE se não
+ * houver memória, ou se "texto" for NULL (a implementação não conseguiu
+ * obtê-lo); em ambos os casos a transação deixa de poder ser desfeita.
+ */
+
+bool guardar_para_desfazer (transacaoTAD transacao, size_t posicao,
+                            size_t inseridos, const char *texto, size_t n);
+
+/**
+ * PREDICADO: guardar_texto_para_desfazer
+ * Uso: if (guardar_texto_para_desfazer(transacao, buffer)) . . .
+ * ---------------------------------------------------------------
+ * Acrescenta ao registro para desfazer uma cópia do texto inteiro do buffer,
+ * antes de uma operação que o refaz de uma vez (como substituir_tudo); ao ser
+ * desfeito, esse registro troca todo o texto do buffer pela cópia. Deve ser
+ * chamado depois de aplicar os trechos pendentes. Não faz nada (e retorna
+ * TRUE) se "transacao" for NULL, de modo que pode receber a transação do
+ * buffer, aberta ou não. Retorna FALSE se não houver memória; a transação
+ * deixa de poder ser desfeita.
+ */
+
+bool guardar_texto_para_desfazer (transacaoTAD transacao, bufferTAD buffer);
+
+/**
+ * PROCEDIMENTO: concluir_aplicacao
+ * Uso: concluir_aplicacao(transacao);
+ * -----------------------------------
+ * Descarta os trechos pendentes, depois que a implementação os aplicou ao
+ * buffer (e levou o cursor do buffer ao cursor da transação).
+ */
+
+void concluir_aplicacao (transacaoTAD transacao);
+
+/**
+ * PROCEDIMENTO: aplicar_trechos
+ * Uso: aplicar_trechos(transacao, buffer);
+ * ----------------------------------------
+ * Aplica os trechos pendentes ao buffer com as operações de buffer.h, em
+ * ordem de posição (o cursor só anda para frente), guardando o registro para
+ * desfazer, e leva o cursor ao cursor da transação. Usado pelas
+ * implementações que não têm uma aplicação própria; a implementação precisa
+ * desligar a transação do buffer antes da chamada, para que as operações não
+ * sejam registradas de novo.
+ */
+
+void aplicar_trechos (transacaoTAD transacao, bufferTAD buffer);
+
+/**
+ * PREDICADO: reverter_transacao
+ * Uso: if (reverter_transacao(transacao, buffer)) . . .
+ * -----------------------------------------------------
+ * Desfaz no buffer, com as operações de buffer.h, os trechos guardados para
+ * desfazer, do último para o primeiro. Retorna FALSE se o registro estiver
+ * incompleto (por falta de memória) e nada puder ser desfeito. A transação
+ * deve estar desligada do buffer.
+ */
+
+bool reverter_transacao (transacaoTAD transacao, bufferTAD buffer);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * Arquivo: visor.c
+ * Versão : 1.0
+ * Data   : 2026-10-18 22:50
+ * -------------------------
+ * Este arquivo implementa a interface visor.h. O visor lê primeiro apenas o
+ * cabeçalho da região, para conferir o formato e descobrir o limite, e então
+ * mapeia a região inteira (cabeçalho e limite) apenas para leitura. O
+ * descritor da região é fechado logo após o mapeamento.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Includes ***/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include "genlib.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "visor.h"
+
+/*** Tipos de Dados ***/
+
+/**
+ * Tipo: visorTCD
+ * --------------
+ * O mapeamento da região: o cabeçalho, o texto e o tamanho mapeado.
+ */
+
+struct visorTCD
+{
+    cabecalho_visorT *cabecalho;
+    const char *texto;
+    size_t tammapa;
+};
+
+/*** Definições de Subprogramas Exportados ***/
+
+/**
+ * Função: abrir_visor
+ * Uso: visor = abrir_visor(nome);
+ * -------------------------------
+ * Abre a região, confere o cabeçalho e mapeia a região inteira.
+ */
+
+visorTAD abrir_visor (string nome)
+{
+    if (nome == NULL)
+    {
+        fprintf(stderr, "Erro: visor sem nome.\n");
+        return NULL;
+    }
+
+    int fd = shm_open(nome, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Erro: impossível abrir a região %s.\n", nome);
+        return NULL;
+    }
+
+    struct stat info;
+    cabecalho_visorT *c = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t) info.st_size >= CABECALHO_VISOR)
+        c = mmap(NULL, CABECALHO_VISOR, PROT_READ, MAP_SHARED, fd, 0);
+    if (c == MAP_FAILED || c->magico != MAGICO_VISOR ||
+        c->formato != FORMATO_VISOR)
+    {
+        fprintf(stderr, "Erro: %s não é uma região de buffer.\n", nome);
+        if (c != MAP_FAILED)
+            munmap(c, CABECALHO_VISOR);
+        close(fd);
+        return NULL;
+    }
+    size_t tammapa = CABECALHO_VISOR + c->limite;
+    munmap(c, CABECALHO_VISOR);
+
+    visorTAD V = malloc(sizeof(struct visorTCD));
+    void *mapa = mmap(NULL, tammapa, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (V == NULL || mapa == MAP_FAILED)
+    {
+        fprintf(stderr, "Erro: impossível mapear a região %s.\n", nome);
+        if (mapa != MAP_FAILED)
+            munmap(mapa, tammapa);
+        free(V);
+        return NULL;
+    }
+
+    V->cabecalho = mapa;
+    V->texto = (const char *) mapa + CABECALHO_VISOR;
+    V->tammapa = tammapa;
+
+    return V;
+}
+
+/**
+ * Procedimento: fechar_visor
+ * Uso: fechar_visor(&visor);
+ * --------------------------
+ * Desfaz o mapeamento e libera a estrutura.
+ */
+
+void fechar_visor (visorTAD *visor)
+{
+    if (visor != NULL && *visor != NULL)
+    {
+        munmap((*visor)->cabecalho, (*visor)->tammapa);
+        free(*visor);
+        *visor = NULL;
+    }
+}
+
+/**
+ * Procedimento: obter_vista
+ * Uso: obter_vista(visor, &vista);
+ * --------------------------------
+ * Anota o contador de sequência (cedendo o processador enquanto for ímpar),
+ * lê os campos do cabeçalho e confere o contador de novo. O tamanho lido é
+ * limitado ao limite da região, para que uma vista nunca aponte para fora do
+ * mapeamento.
+ */
+
+void obter_vista (visorTAD visor, vistaT *vista)
+{
+    if (visor == NULL || vista == NULL)
+    {
+        fprintf(stderr, "Erro: vista de visor null.\n");
+        exit(1);
+    }
+
+    cabecalho_visorT *c = visor->cabecalho;
+    while (TRUE)
+    {
+        unsigned s = atomic_load_explicit(&c->sequencia, memory_order_acquire);
+        if (s % 2 == 1)
+        {
+            sched_yield();
+            continue;
+        }
+
+        vista->tamanho = c->tamanho;
+        vista->cursor = c->cursor;
+        vista->versao = c->versao;
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&c->sequencia, memory_order_relaxed) == s)
+        {
+            vista->sequencia = s;
+            break;
+        }
+    }
+
+    if (vista->tamanho > c->limite)
+        vista->tamanho = c->limite;
+    vista->texto = visor->texto;
+}
+
+/**
+ * Função: vista_valida
+ * Uso: if (vista_valida(visor, &vista)) . . .
+ * -------------------------------------------
+ * A barreira impede que as leituras do texto feitas antes sejam adiadas para
+ * depois da leitura do contador.
+ */
+
+bool vista_valida (visorTAD visor, const vistaT *vista)
+{
+    if (visor == NULL || vista == NULL)
+    {
+        fprintf(stderr, "Erro: vista de visor null.\n");
+        exit(1);
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&visor->cabecalho->sequencia,
+                                memory_order_relaxed) == vista->sequencia;
+}
+
+/**
+ * Função: copiar_do_visor
+ * Uso: n = copiar_do_visor(visor, inicio, n, destino, &versao);
+ * -------------------------------------------------------------
+ * Obtém uma vista, copia o trecho com memcpy e repete se a vista deixou de
+ * ser válida durante a cópia.
+ */
+
+size_t copiar_do_visor (visorTAD visor, size_t inicio, size_t n,
+                        char destino[], unsigned long *versao)
+{
+    vistaT vista;
+    size_t copiados;
+
+    do
+    {
+        obter_vista(visor, &vista);
+        copiados = 0;
+        if (inicio < vista.tamanho)
+        {
+            copiados = vista.tamanho - inicio;
+            if (copiados > n)
+                copiados = n;
+            memcpy(destino, vista.texto + inicio, copiados);
+        }
+    }
+    while (!vista_valida(visor, &vista));
+
+    if (versao != NULL)
+        *versao = vista.versao;
+    return copiados;
+}
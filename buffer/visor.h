@@ -0,0 +1,178 @@
+/**
+ * Arquivo: visor.h
+ * Versão : 1.0
+ * Data   : 2026-10-18 22:50
+ * -------------------------
+ * Este arquivo define uma interface para que outros processos (visualizadores,
+ * indexadores) leiam um buffer publicado em memória compartilhada, sem cópias
+ * e sem trocar mensagens com o processo do editor.
+ *
+ * O processo do editor publica o buffer com "compartilhar_buffer" (veja
+ * arraybuff.h): o texto passa a ficar em uma região de memória compartilhada
+ * com nome (shm_open), precedida por um cabeçalho com o formato descrito
+ * abaixo. Um visor mapeia a mesma região apenas para leitura e lê o texto
+ * diretamente dela.
+ *
+ * O cabeçalho tem um contador de sequência (seqlock): o editor o torna ímpar
+ * antes de alterar o texto e par depois. Um visor obtém uma "vista" (o texto,
+ * o tamanho, o cursor e a versão, lidos com o contador par), usa o texto como
+ * quiser (desenha, indexa) e depois pergunta se a vista ainda é válida; se
+ * não for, o editor alterou o texto durante o uso e a vista deve ser
+ * descartada e obtida de novo.
+ *
+ * A região é mapeada de uma só vez com o seu tamanho máximo ("limite"), mas só
+ * ocupa memória à medida que o texto cresce; o texto nunca muda de endereço,
+ * e o visor não precisa remapear a região quando o buffer cresce.
+ *
+ * Prof.: Abrantes Araújo Silva Filho (Computação Raiz)
+ *            www.computacaoraiz.com.br
+ *            www.youtube.com.br/computacaoraiz
+ *            github.com/computacaoraiz
+ *            twitter.com/ComputacaoRaiz
+ *            www.linkedin.com/company/computacaoraiz
+ *            www.abrantes.pro.br
+ *            github.com/abrantesasf
+ */
+
+/*** Inicia Boilerplate da Interface ***/
+
+#ifndef _VISOR_H
+#define _VISOR_H
+
+/*** Includes ***/
+
+#include "genlib.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*** Constantes Simbólicas ***/
+
+/**
+ * CONSTANTES: MAGICO_VISOR, FORMATO_VISOR, CABECALHO_VISOR
+ * --------------------------------------------------------
+ * O número que identifica uma região de buffer ("BUFR"), a versão do formato
+ * do cabeçalho e o deslocamento do texto a partir do início da região.
+ */
+
+#define MAGICO_VISOR 0x52465542u
+#define FORMATO_VISOR 1u
+#define CABECALHO_VISOR 4096
+
+/*** Tipos de Dados ***/
+
+/**
+ * TIPO: cabecalho_visorT
+ * ----------------------
+ * O início da região compartilhada. Os campos "magico", "formato" e "limite"
+ * não mudam depois da criação; os demais são alterados pelo editor e só valem
+ * se lidos com o contador de sequência par e igual antes e depois da leitura.
+ *
+ *     magico       MAGICO_VISOR
+ *     formato      FORMATO_VISOR
+ *     sequencia    contador de sequência (ímpar durante uma escrita)
+ *     limite       maior tamanho que o texto pode ter
+ *     capacidade   bytes de texto já disponíveis na região
+ *     tamanho      quantidade de caracteres do buffer
+ *     cursor       posição do cursor
+ *     versao       versão do buffer (versao_buffer)
+ *
+ * O texto começa CABECALHO_VISOR bytes após o início da região.
+ */
+
+typedef struct
+{
+    uint32_t magico;
+    uint32_t formato;
+    atomic_uint sequencia;
+    uint32_t reservado;
+    uint64_t limite;
+    uint64_t capacidade;
+    uint64_t tamanho;
+    uint64_t cursor;
+    uint64_t versao;
+} cabecalho_visorT;
+
+/**
+ * TIPO: visorTAD
+ * --------------
+ * Representa uma região de buffer mapeada para leitura.
+ */
+
+typedef struct visorTCD *visorTAD;
+
+/**
+ * TIPO: vistaT
+ * ------------
+ * Uma vista do buffer: "texto" aponta diretamente para a região compartilhada
+ * e só deve ser usado até a próxima chamada de "vista_valida".
+ */
+
+typedef struct
+{
+    const char *texto;
+    size_t tamanho;
+    size_t cursor;
+    unsigned long versao;
+    unsigned sequencia;
+} vistaT;
+
+/*** Declarações de Subprogramas ***/
+
+/**
+ * FUNÇÃO: abrir_visor
+ * Uso: visor = abrir_visor(nome);
+ * -------------------------------
+ * Mapeia, apenas para leitura, a região compartilhada com o nome "nome" (por
+ * exemplo "/meu_buffer"). Retorna NULL se a região não existir ou não for uma
+ * região de buffer em um formato conhecido.
+ */
+
+visorTAD abrir_visor (string nome);
+
+/**
+ * PROCEDIMENTO: fechar_visor
+ * Uso: fechar_visor(&visor);
+ * --------------------------
+ * Desfaz o mapeamento e libera o visor (a região continua existindo para o
+ * editor e os outros visores). Note que o argumento é um PONTEIRO.
+ */
+
+void fechar_visor (visorTAD *visor);
+
+/**
+ * PROCEDIMENTO: obter_vista
+ * Uso: obter_vista(visor, &vista);
+ * --------------------------------
+ * Preenche "vista" com o estado atual do buffer, esperando que o editor
+ * termine uma escrita em andamento. Nenhum caractere é copiado.
+ */
+
+void obter_vista (visorTAD visor, vistaT *vista);
+
+/**
+ * FUNÇÃO: vista_valida
+ * Uso: if (vista_valida(visor, &vista)) . . .
+ * -------------------------------------------
+ * Retorna TRUE se o editor não alterou o buffer desde que a vista foi obtida,
+ * ou seja, se tudo o que foi lido de "vista.texto" desde então é coerente.
+ */
+
+bool vista_valida (visorTAD visor, const vistaT *vista);
+
+/**
+ * FUNÇÃO: copiar_do_visor
+ * Uso: n = copiar_do_visor(visor, inicio, n, destino, &versao);
+ * -------------------------------------------------------------
+ * Copia até "n" caracteres a partir da posição "inicio", todos de uma mesma
+ * versão do buffer (refazendo a cópia se o editor alterar o buffer durante
+ * ela), guarda essa versão em "versao" (se não for NULL) e retorna a
+ * quantidade de caracteres copiados.
+ */
+
+size_t copiar_do_visor (visorTAD visor, size_t inicio, size_t n,
+                        char destino[], unsigned long *versao);
+
+/*** Finaliza Boilerplate da Interface ***/
+
+#endif